@@ -0,0 +1,304 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Acceptance Filter Planner Host Tool										 */
+/**
+ *	@file		ACF/acf_tool.c
+ *	@brief		This file contains the host command line tool planning message
+ *				buffers and acceptance masks of a node (see ACF/acf.h of the
+ *				library) and reporting their false accept rate against a
+ *				recorded bus log.
+ *	@details	Usage: acf_tool [-e] [-b BITS] IDS [LOG] <br>
+ *				IDS lists the subscribed CAN IDs (hexadecimal, one per line,
+ *				'#' starts a comment). LOG is a recorded bus log, one frame per
+ *				line, either in candump log format (ID#DATA token) or as the
+ *				hexadecimal ID first on the line (taken in the selected
+ *				format). Option -e selects extended
+ *				IDs (standard by default), -b the reception buffer bits
+ *				(hexadecimal, FF by default). Without LOG, the plan assumes
+ *				uniform traffic. The tool is built with the library include
+ *				directories and ACF/acf_plan.c only, i.e.: <br>
+ *				cc -DACF_MAX_IDS=255 -I LIB/MB90385/include -I LIB/EXTRA/include
+ *				-o acf_tool acf_tool.c LIB/EXTRA/implement/ACF/acf_plan.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <ACF/acf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		ACF_TOOL_MAX_TRAFFIC
+ *	@brief 		Maximum distinct IDs of a bus log.
+ */
+#ifndef ACF_TOOL_MAX_TRAFFIC
+#define ACF_TOOL_MAX_TRAFFIC	(4096U)
+#endif
+
+/**
+ * 	@def		ACF_TOOL_LINE_SIZE
+ *	@brief 		Maximum line size of input files.
+ */
+#define ACF_TOOL_LINE_SIZE		(256U)
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		acfToolIDs
+ *	@brief		Subscribed bit-ordered IDs.
+ */
+static T_dword acfToolIDs[ACF_MAX_IDS];
+
+/**
+ *	@var		acfToolTraffic
+ *	@brief		Bus log as distinct bit-ordered IDs with frame counts.
+ */
+static T_acfTraffic acfToolTraffic[ACF_TOOL_MAX_TRAFFIC];
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_dword toACFToolID(unsigned long, T_canIDFormat)
+ *	@brief 		Converts a CAN ID to a bit-ordered ID.
+ *	@param[in]	value	CAN ID.
+ *	@param[in]	format	ID format.
+ *	@return		bit-ordered ID.
+ */
+static T_dword toACFToolID(unsigned long value, T_canIDFormat format)
+{
+	return COND(EQU(format, CAN_ID_STD_FORMAT), (T_dword)(value & 0x7FFUL) << 18U,
+		(T_dword)(value & ACF_EXT_BITS));
+}
+
+/**
+ *	@fn			int parseACFToolLine(const char*, unsigned long*)
+ *	@brief 		Gets the CAN ID of a line (ID#DATA token or first token).
+ *	@param[in]	line	Input line.
+ *	@param[out]	pValue	CAN ID.
+ *	@return		1 if found, 0 otherwise.
+ */
+static int parseACFToolLine(const char* line, unsigned long* pValue)
+{
+	const char* mark = strchr(line, '#');
+	const char* start;
+	char* end;
+
+	if (NEQ(mark, NULL)) {
+		/* candump log token or comment */
+		start = mark;
+		while (GT(start, line) && NOT(strchr(" \t", start[-1]))) {
+			start--;
+		}
+		if (EQU(start, mark)) {
+			return 0;
+		}
+	} else {
+		start = line + strspn(line, " \t");
+	}
+	*pValue = strtoul(start, &end, 16);
+
+	return NEQ(end, start) && (EQU(end, mark) || EQU(mark, NULL));
+}
+
+/**
+ *	@fn			int readACFToolIDs(const char*, T_canIDFormat)
+ *	@brief 		Reads subscribed IDs (duplicates skipped).
+ *	@param[in]	path	IDs file.
+ *	@param[in]	format	ID format.
+ *	@return		ID count (-1 on error).
+ */
+static int readACFToolIDs(const char* path, T_canIDFormat format)
+{
+	char line[ACF_TOOL_LINE_SIZE];
+	FILE* file = fopen(path, "r");
+	unsigned long value;
+	T_dword id;
+	int count = 0;
+	int index;
+
+	if (EQU(file, NULL)) {
+		return -1;
+	}
+	while (NEQ(fgets(line, sizeof(line), file), NULL)) {
+		line[strcspn(line, "#\r\n")] = '\0';
+		if (EQU(parseACFToolLine(line, &value), 0)) {
+			continue;
+		}
+		id = toACFToolID(value, format);
+		for (index = 0; LT(index, count) && NEQ(acfToolIDs[index], id); index++) {
+		}
+		if (LT(index, count)) {
+			continue;
+		}
+		if (GEQ(count, (int)ACF_MAX_IDS)) {
+			fclose(file);
+			return -1;
+		}
+		acfToolIDs[count++] = id;
+	}
+	fclose(file);
+
+	return count;
+}
+
+/**
+ *	@fn			int readACFToolLog(const char*, T_canIDFormat, T_uint32*)
+ *	@brief 		Reads a bus log into distinct IDs with frame counts.
+ *	@param[in]	path		Log file.
+ *	@param[in]	format		ID format.
+ *	@param[out]	pFrames		Frame count.
+ *	@return		distinct ID count (-1 on error).
+ */
+static int readACFToolLog(const char* path, T_canIDFormat format, T_uint32* pFrames)
+{
+	char line[ACF_TOOL_LINE_SIZE];
+	FILE* file = fopen(path, "r");
+	unsigned long value;
+	T_dword id;
+	int count = 0;
+	int index;
+
+	*pFrames = 0UL;
+	if (EQU(file, NULL)) {
+		return -1;
+	}
+	while (NEQ(fgets(line, sizeof(line), file), NULL)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (EQU(parseACFToolLine(line, &value), 0)) {
+			continue;
+		}
+		id = toACFToolID(value, format);
+		for (index = 0; LT(index, count) && NEQ(acfToolTraffic[index].id, id); index++) {
+		}
+		if (EQU(index, count)) {
+			if (GEQ(count, (int)ACF_TOOL_MAX_TRAFFIC)) {
+				fclose(file);
+				return -1;
+			}
+			acfToolTraffic[count].id = id;
+			acfToolTraffic[count++].frames = 0UL;
+		}
+		acfToolTraffic[index].frames++;
+		(*pFrames)++;
+	}
+	fclose(file);
+
+	return count;
+}
+
+/**
+ *	@fn			T_void printACFToolPlan(const T_acfPlan*)
+ *	@brief 		Prints a plan as library calls.
+ *	@param[in]	plan	ACF plan.
+ *	@return		.
+ */
+static T_void printACFToolPlan(const T_acfPlan* plan)
+{
+	static const char* const options[] = {
+		"CAN_FULL_BIT_CMP", "CAN_FULL_BIT_MASK", "CAN_USE_AMR0", "CAN_USE_AMR1"
+	};
+	T_uint8 buffer;
+	T_uint8 index;
+
+	printf("T_acfPlan plan = {\n");
+	printf("\t{ 0x%08lXUL, 0x%08lXUL },\n", (unsigned long)plan->mask[0],
+		(unsigned long)plan->mask[1]);
+	printf("\t{ ");
+	for (index = 0U; LT(index, CAN_MB_SIZE); index++) {
+		printf("0x%08lXUL%s", (unsigned long)COND(NEQ(ReadBit(plan->buffers, index), 0U),
+			plan->id[index], 0UL), COND(LT(index, CAN_MB_SIZE - 1U), ", ", " },\n"));
+	}
+	printf("\t{ ");
+	for (index = 0U; LT(index, CAN_MB_SIZE); index++) {
+		printf("%s%s", options[COND(NEQ(ReadBit(plan->buffers, index), 0U),
+			plan->option[index], CAN_FULL_BIT_CMP)],
+			COND(LT(index, CAN_MB_SIZE - 1U), ", ", " },\n"));
+	}
+	printf("\t%s, 0x%02XU, %luUL\n};\n",
+		COND(EQU(plan->format, CAN_ID_STD_FORMAT), "CAN_ID_STD_FORMAT", "CAN_ID_EXT_FORMAT"),
+		plan->buffers, (unsigned long)plan->falseAccepts);
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NEQ(ReadBit(plan->buffers, buffer), 0U)) {
+			printf("/* MB%u: %s, ID 0x%08lX */\n", buffer, options[plan->option[buffer]],
+				(unsigned long)plan->id[buffer]);
+		}
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	T_canIDFormat format = CAN_ID_STD_FORMAT;
+	T_byte bits = 0xFFU;
+	const char* idsPath = NULL;
+	const char* logPath = NULL;
+	T_acfPlan plan;
+	T_uint32 frames = 0UL;
+	T_uint32 accepted = 0UL;
+	T_uint32 falseAccepts;
+	int idCount, trafficCount = 0;
+	int arg, index;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-e"), 0)) {
+			format = CAN_ID_EXT_FORMAT;
+		} else if (EQU(strcmp(argv[arg], "-b"), 0) && LT(arg + 1, argc)) {
+			bits = (T_byte)strtoul(argv[++arg], NULL, 16);
+		} else if (EQU(idsPath, NULL)) {
+			idsPath = argv[arg];
+		} else {
+			logPath = argv[arg];
+		}
+	}
+	if (EQU(idsPath, NULL)) {
+		fprintf(stderr, "usage: %s [-e] [-b BITS] IDS [LOG]\n", argv[0]);
+		return 2;
+	}
+	idCount = readACFToolIDs(idsPath, format);
+	if (LT(idCount, 1)) {
+		fprintf(stderr, "%s: no ID or more than %u IDs\n", idsPath, ACF_MAX_IDS);
+		return 1;
+	}
+	if (NEQ(logPath, NULL)) {
+		trafficCount = readACFToolLog(logPath, format, &frames);
+		if (LT(trafficCount, 0)) {
+			fprintf(stderr, "%s: unreadable or more than %u distinct IDs\n", logPath,
+				ACF_TOOL_MAX_TRAFFIC);
+			return 1;
+		}
+	}
+	if (NOT(planACF(&plan, acfToolIDs, (T_uint8)idCount, format, bits,
+			COND(NEQ(logPath, NULL), acfToolTraffic, NULL), (T_uint16)trafficCount))) {
+		fprintf(stderr, "no plan for %d IDs in buffers 0x%02X\n", idCount, bits);
+		return 1;
+	}
+	printACFToolPlan(&plan);
+	if (NEQ(logPath, NULL)) {
+		falseAccepts = countACFFalseAccepts(&plan, acfToolIDs, (T_uint8)idCount,
+			acfToolTraffic, (T_uint16)trafficCount);
+		for (index = 0; LT(index, trafficCount); index++) {
+			if (IS(checkACFAccepted(&plan, acfToolTraffic[index].id))) {
+				accepted += acfToolTraffic[index].frames;
+			}
+		}
+		printf("/* %lu frames, %lu accepted, %lu false accepts"
+			" (%.2f%% of accepted, %.2f%% of bus) */\n",
+			(unsigned long)frames, (unsigned long)accepted, (unsigned long)falseAccepts,
+			COND(EQU(accepted, 0UL), 0.0, (100.0 * falseAccepts) / accepted),
+			COND(EQU(frames, 0UL), 0.0, (100.0 * falseAccepts) / frames));
+	}
+
+	return 0;
+}
+
+/* END OF ACF_TOOL. */
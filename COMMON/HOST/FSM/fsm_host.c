@@ -0,0 +1,93 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Finite State Machine Host Implementation									 */
+/**
+ *	@file		FSM/fsm_host.c
+ *	@brief		This file contains FSM API functions implementation for host
+ *				tools (the target implementation only ships in the EXTRA
+ *				library archives).
+ *	@details	Functions follow FSM/fsm.h: dispatchFSM enters the pending
+ *				state, runs the preprocess, runs state callbacks while chained
+ *				transitions are requested, then runs the postprocess. Logging
+ *				preprocess and postprocess functions are not provided.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <FSM/fsm.h>
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_fsm* initFSM(T_fsm*, const T_fsmProp*, T_fsmData*, T_fsmIndex)
+ *	@brief 		Initialize a finite state machine.
+ *	@param		automaton	FSM control block handler.
+ *	@param[in]	properties  FSM properties handler.
+ *	@param[in]	structData	FSM data.
+ *	@param[in]	initIndex	FSM initial (reset) state index.
+ *	@return		fsm-pointer.
+ */
+T_fsm* initFSM(T_fsm* automaton, const T_fsmProp* properties,
+	T_fsmData* structData, T_fsmIndex initIndex)
+{
+	automaton->properties = properties;
+	automaton->fsmData = structData;
+	automaton->privileged.reset = initIndex;
+	automaton->privileged.next = initIndex;
+	automaton->current = initIndex;
+	automaton->privileged.firstEntry = FALSE;
+	automaton->privileged.transitLock = TRUE;
+
+	return automaton;
+}
+
+/**
+ *	@fn			T_void setFSMPreAndPostFunctions(T_fsm*, T_fsmCB, T_fsmCB)
+ *	@brief		Sets the state's preprocess and postprocess functions.
+ *	@param		automaton	FSM control block handler.
+ *	@param[in]	preProcess  State's preprocess function.
+ *	@param[in]	postProcess State's postprocess function.
+ *	@return		.
+ */
+T_void setFSMPreAndPostFunctions(T_fsm* automaton, T_fsmCB preProcess,
+	T_fsmCB postProcess)
+{
+	automaton->privileged.preProcess = preProcess;
+	automaton->privileged.postProcess = postProcess;
+}
+
+/**
+ *	@fn			T_bit dispatchFSM(T_fsm*)
+ *	@brief		Executes single state (with/without chained transition).
+ *	@param		automaton	FSM control block handler.
+ *	@return		dispatch success (FALSE on state without callback).
+ */
+T_bit dispatchFSM(T_fsm* automaton)
+{
+	T_fsmCB state;
+
+	/* set current state index to next state index */
+	automaton->current = automaton->privileged.next;
+	/* execute state preprocess */
+	if (NEQ(automaton->privileged.preProcess, NULL)) {
+		automaton->privileged.preProcess(automaton);
+	}
+	do {
+		/* clear state transition chain request */
+		automaton->privileged.transitChain = FALSE;
+		/* execute current state */
+		state = automaton->properties->stateLUT[automaton->current].state;
+		if (EQU(state, NULL)) {
+			return FALSE;
+		}
+		state(automaton);
+	} while (IS(automaton->privileged.transitChain));
+	/* execute state postprocess */
+	if (NEQ(automaton->privileged.postProcess, NULL)) {
+		automaton->privileged.postProcess(automaton);
+	}
+
+	return TRUE;
+}
+
+/* END OF FSM_HOST. */
@@ -0,0 +1,316 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Finite State Machine Dispatch Benchmark Host Tool						 */
+/**
+ *	@file		FSM/fsmd_bench.c
+ *	@brief		This file contains the host command line tool comparing the
+ *				specialized FSM dispatcher (FSM_DEFINE) with dispatchFSM.
+ *	@details	Usage: fsmd_bench [-n DISPATCHES] <br>
+ *				The test FSM is a ring of six states driven by a pseudo-random
+ *				input byte: states step forward (chaining the next state on
+ *				request) or backward, stay, or fall into a fault state which
+ *				has no state function (dispatch fails and the driver resets
+ *				the FSM). Preprocess and postprocess count their calls. <br>
+ *				Both dispatchers first run the same input sequence on their
+ *				own FSM, and the tool stops at the first dispatch where the
+ *				return value, FSM control block (pre and post pointers
+ *				excepted) or FSM data differ. Then each dispatcher is timed
+ *				alone. Defaults are 10M dispatches. Built with: <br>
+ *				cc -O2 -I LIB/MB90385/include -I LIB/EXTRA/include -I HOST
+ *				-o fsmd_bench HOST/FSM/fsmd_bench.c HOST/FSM/fsm_host.c
+ *				<br> Code size is compared on the same build, i.e.: <br>
+ *				nm -S --size-sort fsmd_bench | grep -i -e ring -e dispatch
+ *				<br> which lists dispatchFSM (states reached through the state
+ *				table) against dispatchRing (states called directly, inlined
+ *				whenever the compiler chooses to), next to the RING_ state
+ *				functions. Host figures say little about far calls on the
+ *				F2MC-16LX: for target figures, build both paths with Softune
+ *				and compare the map file.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <FSM/fsm.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for ring state indices.
+ */
+typedef enum {
+	S_RING_SELF,					/**< Null-State / Self-Transition Index */
+	S_RING_0,						/**< Ring position 0 */
+	S_RING_1,						/**< Ring position 1 */
+	S_RING_2,						/**< Ring position 2 */
+	S_RING_3,						/**< Ring position 3 */
+	S_RING_4,						/**< Ring position 4 */
+	S_RING_5,						/**< Ring position 5 */
+	S_RING_FAULT					/**< Fault (no state function) */
+} T_ringStates;
+
+/**
+ *	@brief		Data structure for ring FSM data.
+ */
+typedef struct {
+	T_uint32 ticks;
+	T_uint32 entries;
+	T_uint32 exits;
+	T_uint32 pre;
+	T_uint32 post;
+	T_uint8 input;
+} T_ringData;
+
+/* ----------------------------------------------------------------------------
+**	Ring States.
+*/
+
+/**
+ *	@def		RING_STATE
+ *	@brief		Defines a ring state: fault on low nibble 0xF, forward on bit
+ *				0 (chained on bit 1), backward on bit 1, else stay. Transitions
+ *				consume two input bits.
+ *	@param		NAME	State function name.
+ *	@param		STEP	Ticks added by the state action.
+ *	@param		NEXT	Forward state index.
+ *	@param		BACK	Backward state index.
+ *	@return		(function definition).
+ */
+#define RING_STATE(NAME, STEP, NEXT, BACK) \
+static FSM_STATE(NAME) \
+{ \
+	T_ringData* data = (T_ringData*)FSM_THIS.fsmData; \
+	\
+	StateEntry(data->entries++); \
+	StateAction(data->ticks += (STEP)); \
+	StateTransition(EQU(data->input & 0x0FU, 0x0FU), S_RING_FAULT, FSM_NONE); \
+	StateTransition(IS(data->input & 0x01U), (NEXT), { \
+		if (IS(data->input & 0x02U)) { \
+			StateRequestTransitChain(FSM_THIS); \
+		} \
+		data->input >>= 2U; \
+	}); \
+	StateTransition(IS(data->input & 0x02U), (BACK), data->input >>= 2U); \
+	StateTransition(FSM_ELSE, FSM_SELF, FSM_NONE); \
+	StateExit(data->exits++); \
+}
+
+RING_STATE(RING_0, 1U, S_RING_1, S_RING_5)
+RING_STATE(RING_1, 2U, S_RING_2, S_RING_0)
+RING_STATE(RING_2, 3U, S_RING_3, S_RING_1)
+RING_STATE(RING_3, 5U, S_RING_4, S_RING_2)
+RING_STATE(RING_4, 7U, S_RING_5, S_RING_3)
+RING_STATE(RING_5, 11U, S_RING_0, S_RING_4)
+
+static FSM_PRE(RING_PRE)
+{
+	((T_ringData*)FSM_THIS.fsmData)->pre++;
+}
+
+static FSM_POST(RING_POST)
+{
+	((T_ringData*)FSM_THIS.fsmData)->post++;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var 		ringStateTable
+ *	@brief		Ring FSM state table.
+ */
+static const T_fsmState ringStateTable[] = {
+	{ (T_fsmIndex)S_RING_SELF, (T_fsmName)"RING[0] Self-Transition", (T_fsmCB)FSM_SELF },
+	{ (T_fsmIndex)S_RING_0, (T_fsmName)"RING[1] Position 0", (T_fsmCB)&RING_0 },
+	{ (T_fsmIndex)S_RING_1, (T_fsmName)"RING[2] Position 1", (T_fsmCB)&RING_1 },
+	{ (T_fsmIndex)S_RING_2, (T_fsmName)"RING[3] Position 2", (T_fsmCB)&RING_2 },
+	{ (T_fsmIndex)S_RING_3, (T_fsmName)"RING[4] Position 3", (T_fsmCB)&RING_3 },
+	{ (T_fsmIndex)S_RING_4, (T_fsmName)"RING[5] Position 4", (T_fsmCB)&RING_4 },
+	{ (T_fsmIndex)S_RING_5, (T_fsmName)"RING[6] Position 5", (T_fsmCB)&RING_5 },
+	{ (T_fsmIndex)S_RING_FAULT, (T_fsmName)"RING[7] Fault", (T_fsmCB)FSM_SELF }
+};
+
+/**
+ *	@var 		ringProp
+ *	@brief		Ring FSM properties.
+ */
+static const T_fsmProp ringProp = {
+	(T_fsmID)1U,
+	(T_fsmName)"Ring",
+	(T_fsmFlag)FSM_NONHISTORICAL,
+	(const T_fsmState*)ringStateTable,
+	(T_fsmSize)SzElems_(ringStateTable, T_fsmState)
+};
+
+/* ----------------------------------------------------------------------------
+**	Specialized Dispatcher.
+*/
+
+#define RING_STATES(STATE) \
+	STATE(S_RING_0, RING_0) \
+	STATE(S_RING_1, RING_1) \
+	STATE(S_RING_2, RING_2) \
+	STATE(S_RING_3, RING_3) \
+	STATE(S_RING_4, RING_4) \
+	STATE(S_RING_5, RING_5)
+
+static FSM_DEFINE(dispatchRing, RING_STATES, RING_PRE(&FSM_THIS), RING_POST(&FSM_THIS))
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 nextRingInput(T_uint32*)
+ *	@brief 		Generates the next input byte (xorshift32).
+ *	@param		seed	Generator state.
+ *	@return		input byte.
+ */
+static T_uint8 nextRingInput(T_uint32* seed)
+{
+	*seed ^= (*seed << 13U) & 0xFFFFFFFFUL;
+	*seed ^= *seed >> 17U;
+	*seed ^= (*seed << 5U) & 0xFFFFFFFFUL;
+
+	return (T_uint8)*seed;
+}
+
+/**
+ *	@fn			T_void initRing(T_fsm*, T_ringData*, T_bit)
+ *	@brief 		Initializes a ring FSM.
+ *	@param		automaton	FSM control block handler.
+ *	@param		data		FSM data.
+ *	@param[in]	hooks		Set pre and post functions (generic path).
+ *	@return		.
+ */
+static T_void initRing(T_fsm* automaton, T_ringData* data, T_bit hooks)
+{
+	memset(data, 0, SzBytes_(T_ringData));
+	initFSM((T_fsm*)memset(automaton, 0, SzBytes_(T_fsm)), &ringProp,
+		(T_fsmData*)data, S_RING_0);
+	if (IS(hooks)) {
+		setFSMPreAndPostFunctions(automaton, &RING_PRE, &RING_POST);
+	}
+	SetFSMDataSize(*automaton, SzBytes_(T_ringData));
+	ResetStateMachine(*automaton);
+}
+
+/**
+ *	@fn			T_bit isRingEqual(const T_fsm*, const T_fsm*)
+ *	@brief 		Compares FSM control blocks (pre and post pointers excepted)
+ *				and FSM data.
+ *	@param[in]	lhs		First FSM.
+ *	@param[in]	rhs		Second FSM.
+ *	@return		equal.
+ */
+static T_bit isRingEqual(const T_fsm* lhs, const T_fsm* rhs)
+{
+	return EQU(lhs->current, rhs->current)
+		&& EQU(lhs->privileged.next, rhs->privileged.next)
+		&& EQU(lhs->privileged.reset, rhs->privileged.reset)
+		&& EQU(lhs->privileged.firstEntry, rhs->privileged.firstEntry)
+		&& EQU(lhs->privileged.transitConEval, rhs->privileged.transitConEval)
+		&& EQU(lhs->privileged.transitLock, rhs->privileged.transitLock)
+		&& EQU(lhs->privileged.transitChain, rhs->privileged.transitChain)
+		&& EQU(lhs->transitNumber, rhs->transitNumber)
+		&& EQU(memcmp(lhs->fsmData, rhs->fsmData, SzBytes_(T_ringData)), 0);
+}
+
+/**
+ *	@fn			double timeRing(T_bit (*)(T_fsm*), T_bit, unsigned long,
+ *					T_uint32*)
+ *	@brief 		Times a dispatcher over an input sequence.
+ *	@param[in]	dispatch	Dispatcher.
+ *	@param[in]	hooks		Set pre and post functions.
+ *	@param[in]	count		Dispatch count.
+ *	@param[out]	ticks		Final tick count (keeps the work alive).
+ *	@return		time per dispatch (ns).
+ */
+static double timeRing(T_bit (*dispatch)(T_fsm*), T_bit hooks, unsigned long count,
+	T_uint32* ticks)
+{
+	T_fsm automaton;
+	T_ringData data;
+	T_uint32 seed = 0x12345678UL;
+	unsigned long index;
+	clock_t start;
+
+	initRing(&automaton, &data, hooks);
+	start = clock();
+	for (index = 0UL; LT(index, count); index++) {
+		data.input = nextRingInput(&seed);
+		if (NOT(dispatch(&automaton))) {
+			ResetStateMachine(automaton);
+		}
+	}
+	*ticks = data.ticks;
+
+	return (1e9 * (clock() - start)) / CLOCKS_PER_SEC / count;
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	T_fsm generic;
+	T_fsm special;
+	T_ringData genericData;
+	T_ringData specialData;
+	T_uint32 seed = 0x12345678UL;
+	T_uint32 genericTicks;
+	T_uint32 specialTicks;
+	unsigned long count = 10000000UL;
+	unsigned long failed = 0UL;
+	unsigned long index;
+	T_bit genericResult;
+	T_bit specialResult;
+	double genericTime;
+	double specialTime;
+
+	if (EQU(argc, 3) && EQU(strcmp(argv[1], "-n"), 0)) {
+		count = strtoul(argv[2], NULL, 0);
+	} else if (NEQ(argc, 1)) {
+		fprintf(stderr, "usage: %s [-n DISPATCHES]\n", argv[0]);
+		return 2;
+	}
+	if (EQU(count, 0UL)) {
+		fprintf(stderr, "dispatch count must not be 0\n");
+		return 2;
+	}
+	/* lockstep comparison */
+	initRing(&generic, &genericData, TRUE);
+	initRing(&special, &specialData, FALSE);
+	for (index = 0UL; LT(index, count); index++) {
+		genericData.input = specialData.input = nextRingInput(&seed);
+		genericResult = dispatchFSM(&generic);
+		specialResult = dispatchRing(&special);
+		if (NEQ(genericResult, specialResult) || NOT(isRingEqual(&generic, &special))) {
+			printf("mismatch at dispatch %lu (state %u/%u)\n", index,
+				generic.current, special.current);
+			return 1;
+		}
+		if (NOT(genericResult)) {
+			failed++;
+			ResetStateMachine(generic);
+			ResetStateMachine(special);
+		}
+	}
+	printf("%lu dispatches identical (%lu faults, %lu entries, %lu ticks)\n",
+		count, failed, (unsigned long)genericData.entries, (unsigned long)genericData.ticks);
+	/* benchmark */
+	genericTime = timeRing(dispatchFSM, TRUE, count, &genericTicks);
+	specialTime = timeRing(dispatchRing, FALSE, count, &specialTicks);
+	printf("dispatchFSM   %6.2f ns/dispatch\n", genericTime);
+	printf("dispatchRing  %6.2f ns/dispatch (%.2fx)\n", specialTime,
+		genericTime / specialTime);
+
+	return COND(EQU(genericTicks, specialTicks), 0, 1);
+}
+
+/* END OF FSMD_BENCH. */
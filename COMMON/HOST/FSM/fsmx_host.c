@@ -0,0 +1,536 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Finite State Machine Explorer Host Tool									 */
+/**
+ *	@file		FSM/fsmx_host.c
+ *	@brief		This file contains the host command line tool exhaustively
+ *				exploring the FSM of a project (FSMv2 LED application by
+ *				default) on several workers.
+ *	@details	Usage: fsmx_host [-w WORKERS] [-c CAPACITY] <br>
+ *				The project source is included unmodified (FSMX_APP), with its
+ *				main function renamed, and the hardware functions it calls are
+ *				stubbed: readDigital and readAnalog return explorer inputs,
+ *				outputs are empty, and the pushbuttons (P25, P27) are explorer
+ *				inputs written to their port data register before the project
+ *				preprocess runs. Only the Application section below depends on
+ *				the project, and FSM core functions come from FSM/fsm_host.c.
+ *				<br>
+ *				Workers are processes forked once the root configuration is
+ *				stored, not threads, because project callbacks keep their data
+ *				in file scope variables (appLEDData): every worker gets its own
+ *				copy of them, while the configuration pool and the visited
+ *				table are shared memory updated with atomic operations. Each
+ *				worker takes the next configuration of the shared queue,
+ *				dispatches it under every input combination through
+ *				dispatchFSMExplorer, and appends unseen successors. Exploration
+ *				order is therefore only roughly breadth-first, and a successor
+ *				inserted twice by concurrent workers leaves a hole in the pool.
+ *				<br>
+ *				Reports (counters, unreachable, chain-looped and dead-end
+ *				states, then rate) go to standard output. Defaults are one
+ *				worker per online CPU and 8M configurations. Built with: <br>
+ *				cc -O2 -Wno-unknown-pragmas -I LIB/MB90385/include
+ *				-I LIB/EXTRA/include -I HOST -o fsmx_host HOST/FSM/fsmx_host.c
+ *				HOST/FSM/fsm_host.c
+ *				LIB/EXTRA/implement/FSM/fsmExplorer.c
+ *				LIB/MB90385/start/io_mb90385.c
+ *				<br> (on case sensitive file systems, IO must link to the io
+ *				include directory).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <FSM/fsmExplorer.h>
+#include <ADC/adc.h>
+#include <GPIO/dio.h>
+#include <TMR/ppg.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		FSMX_HOST_MAX_WORKERS
+ *	@brief 		Maximum worker processes.
+ */
+#ifndef FSMX_HOST_MAX_WORKERS
+#define FSMX_HOST_MAX_WORKERS		(64U)
+#endif
+
+/**
+ * 	@def		FSMX_HOST_DEF_CAPACITY
+ *	@brief 		Default configuration pool capacity.
+ */
+#ifndef FSMX_HOST_DEF_CAPACITY
+#define FSMX_HOST_DEF_CAPACITY		(0x800000UL)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Application.
+*/
+
+/**
+ * 	@def		FSMX_APP
+ *	@brief 		Project source file holding the FSM to explore.
+ */
+#ifndef FSMX_APP
+#define FSMX_APP					"../../../FSMv2/Source/appLED.c"
+#endif
+
+/* compiler intrinsics used by the project initialization */
+#define __DI()
+#define __EI()
+#define __set_il(LEVEL)
+
+#define main						mainFSMXApp
+#include FSMX_APP
+#undef main
+
+/**
+ *	@brief		Input channel indices.
+ */
+enum {
+	FSMX_IN_P25,					/**< P25 pushbutton level (active LOW) */
+	FSMX_IN_P27,					/**< P27 pushbutton level (active LOW) */
+	FSMX_IN_DIGITAL,				/**< readDigital value */
+	FSMX_IN_ANALOG					/**< readAnalog value */
+};
+
+/**
+ *	@var		fsmxLevels, fsmxAnalog, fsmxChannels
+ *	@brief		Input value domains and channels.
+ */
+static const T_fsmxValue fsmxLevels[] = { PIN_LOW, PIN_HIGH };
+static const T_fsmxValue fsmxAnalog[] = { 0L, 255L };
+static const T_fsmxChannel fsmxChannels[] = {
+	{ fsmxLevels, 2U },
+	{ fsmxLevels, 2U },
+	{ fsmxLevels, 2U },
+	{ fsmxAnalog, 2U }
+};
+
+/**
+ *	@fn			T_void preFSMXApp(T_fsm*)
+ *	@brief 		Preprocess wrapper: clears the pushbutton triggers (static
+ *				variables outside the configuration) with both buttons
+ *				released, so that a pressed input always counts as a new
+ *				press, then applies the inputs and runs the project preprocess.
+ *	@param		automaton	FSM control block handler.
+ *	@return		.
+ */
+static T_void preFSMXApp(T_fsm* automaton)
+{
+	PIN_P25 = PIN_HIGH;
+	PIN_P27 = PIN_HIGH;
+	updatePin25State();
+	updatePin27State();
+	PIN_P25 = (T_pinLevel)readFSMExplorerInput(FSMX_IN_P25);
+	PIN_P27 = (T_pinLevel)readFSMExplorerInput(FSMX_IN_P27);
+	LED_PREPROC(automaton);
+}
+
+/**
+ *	@fn			T_void postFSMXApp(T_fsm*)
+ *	@brief 		Postprocess wrapper: runs the project postprocess, then folds
+ *				the blink counter over the least common multiple of the blink
+ *				periods (states only test it modulo 100, 200, 400, 800 and
+ *				1600), which keeps the configuration space finite.
+ *	@param		automaton	FSM control block handler.
+ *	@return		.
+ */
+static T_void postFSMXApp(T_fsm* automaton)
+{
+	LED_POSTPROC(automaton);
+	appLEDData.blinkCtr %= 1600UL;
+}
+
+/**
+ *	@fn			T_fsm* initFSMXApp(T_void)
+ *	@brief 		Initializes the project FSM at its root configuration.
+ *	@param		.
+ *	@return		FSM to explore.
+ */
+static T_fsm* initFSMXApp(T_void)
+{
+	memset(&appLEDData, 0, SzBytes_(appLEDData));
+	initFSM((T_fsm*)memset(&appLED, 0, SzBytes_(T_fsm)), &appLEDProp,
+		(T_fsmData*)&appLEDData, S_LED_START);
+	setFSMPreAndPostFunctions(&appLED, &preFSMXApp, &postFSMXApp);
+	resetLED();
+
+	return &appLED;
+}
+
+/* ----------------------------------------------------------------------------
+**	Hardware Stubs.
+*/
+
+T_void pinModeDigital(T_pinNumber pin, T_pinDirection mode)
+{
+	(T_void)pin;
+	(T_void)mode;
+}
+
+T_void writeDigital(T_pinNumber pin, T_pinLevel level)
+{
+	(T_void)pin;
+	(T_void)level;
+}
+
+T_bit readDigital(T_pinNumber pin)
+{
+	(T_void)pin;
+
+	return (T_bit)readFSMExplorerInput(FSMX_IN_DIGITAL);
+}
+
+T_bit readDebouncedNegTrig(T_swDebBuffer* sample, T_swDebSampCnt count, T_ioBitPin IOPin)
+{
+	(T_void)sample;
+	(T_void)count;
+
+	return IOPin;
+}
+
+T_void initADC(T_adcCompareTime compareTime, T_adcSampleTime samplingTime,
+	T_adcDataResolution resolution)
+{
+	(T_void)compareTime;
+	(T_void)samplingTime;
+	(T_void)resolution;
+}
+
+T_adcBuffer readAnalog(T_pinNumber pin)
+{
+	(T_void)pin;
+
+	return (T_adcBuffer)readFSMExplorerInput(FSMX_IN_ANALOG);
+}
+
+T_void initPPG(T_void)
+{
+}
+
+T_void stopPPG(T_ppgChannel channel)
+{
+	(T_void)channel;
+}
+
+T_void pulseOutByFrequency(T_ppgChannel channel, T_gptFrequency frequency,
+	T_gptDutyCycle dutyCycle)
+{
+	(T_void)channel;
+	(T_void)frequency;
+	(T_void)dutyCycle;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for state shared by the workers.
+ */
+typedef struct {
+	T_fsmxCount reserved;			/**< pool entries taken */
+	T_fsmxCount head;				/**< next pool entry to expand */
+	T_fsmxCount busy;				/**< workers expanding an entry */
+	T_fsmxCount holes;				/**< entries lost to concurrent insertion */
+	T_bit truncated;				/**< storage ran out */
+	T_fsmxReport reports[FSMX_HOST_MAX_WORKERS];
+} T_fsmxShared;
+
+/**
+ *	@brief		Pool entry states.
+ */
+enum {
+	FSMX_ENTRY_PENDING,				/**< reserved, being written */
+	FSMX_ENTRY_VALID,				/**< stored configuration */
+	FSMX_ENTRY_HOLE					/**< duplicate, never expanded */
+};
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		fsmxShared, fsmxReady
+ *	@brief		Shared counters and reports, and pool entry states.
+ */
+static T_fsmxShared* fsmxShared;
+static T_uint8* fsmxReady;
+
+/**
+ *	@var		fsmxExplorer, fsmxSize
+ *	@brief		Explorer (pool and table in shared memory) and configuration
+ *				size.
+ */
+static T_fsmExplorer fsmxExplorer;
+static T_uint16 fsmxSize;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void* mapFSMXShared(size_t)
+ *	@brief 		Maps zeroed memory shared with forked workers.
+ *	@param[in]	size	Byte size.
+ *	@return		mapping (NULL on failure).
+ */
+static T_void* mapFSMXShared(size_t size)
+{
+	T_void* map = mmap(NULL, size, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+	return COND(EQU(map, MAP_FAILED), NULL, map);
+}
+
+/**
+ *	@fn			T_void insertFSMXConfig(const T_uint8*)
+ *	@brief 		Stores a configuration unless already visited. The entry is
+ *				written before it is published in the table, so that a worker
+ *				finding it there can compare it right away.
+ *	@param[in]	config	Configuration bytes.
+ *	@return		.
+ */
+static T_void insertFSMXConfig(const T_uint8* config)
+{
+	T_fsmxCount mask = fsmxExplorer.tableSize - 1UL;
+	T_fsmxCount slot = hashFSMExplorerConfig(config, fsmxSize) & mask;
+	T_fsmxCount index = FSMX_EMPTY;
+	T_fsmxCount entry;
+	T_fsmxCount probe;
+
+	for (probe = 0UL; LT(probe, fsmxExplorer.tableSize); probe++) {
+		entry = __atomic_load_n(&fsmxExplorer.table[slot], __ATOMIC_ACQUIRE);
+		if (EQU(entry, FSMX_EMPTY)) {
+			/* take a pool entry once, then try to publish it */
+			if (EQU(index, FSMX_EMPTY)) {
+				index = __atomic_load_n(&fsmxShared->reserved, __ATOMIC_RELAXED);
+				do {
+					if (GEQ(index, fsmxExplorer.poolCapacity)) {
+						__atomic_store_n(&fsmxShared->truncated, TRUE, __ATOMIC_RELAXED);
+						return;
+					}
+				} while (NOT(__atomic_compare_exchange_n(&fsmxShared->reserved, &index,
+					index + 1UL, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)));
+				memcpy(fsmxExplorer.pool + index * fsmxSize, config, fsmxSize);
+			}
+			if (__atomic_compare_exchange_n(&fsmxExplorer.table[slot], &entry, index,
+				FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				__atomic_store_n(&fsmxReady[index], FSMX_ENTRY_VALID, __ATOMIC_RELEASE);
+				return;
+			}
+		}
+		/* occupied slot: duplicate or collision */
+		if (EQU(memcmp(fsmxExplorer.pool + entry * fsmxSize, config, fsmxSize), 0)) {
+			if (NEQ(index, FSMX_EMPTY)) {
+				__atomic_add_fetch(&fsmxShared->holes, 1UL, __ATOMIC_RELAXED);
+				__atomic_store_n(&fsmxReady[index], FSMX_ENTRY_HOLE, __ATOMIC_RELEASE);
+			}
+			return;
+		}
+		slot = (slot + 1UL) & mask;
+	}
+	/* full table (the reserved entry is left as a hole) */
+	if (NEQ(index, FSMX_EMPTY)) {
+		__atomic_store_n(&fsmxReady[index], FSMX_ENTRY_HOLE, __ATOMIC_RELEASE);
+	}
+	__atomic_store_n(&fsmxShared->truncated, TRUE, __ATOMIC_RELAXED);
+}
+
+/**
+ *	@fn			T_void expandFSMXConfig(T_fsmxCount, T_uint8*, T_fsmxReport*)
+ *	@brief 		Dispatches a stored configuration under every input
+ *				combination and stores unseen successors.
+ *	@param[in]	entry		Pool entry.
+ *	@param		successor	Scratch configuration.
+ *	@param[out]	report		Worker findings.
+ *	@return		.
+ */
+static T_void expandFSMXConfig(T_fsmxCount entry, T_uint8* successor, T_fsmxReport* report)
+{
+	T_fsmxCount combo;
+
+	for (combo = 0UL; LT(combo, fsmxExplorer.combos); combo++) {
+		if (IS(dispatchFSMExplorer(&fsmxExplorer, fsmxExplorer.pool + entry * fsmxSize,
+			combo, successor, report))) {
+			insertFSMXConfig(successor);
+		}
+	}
+}
+
+/**
+ *	@fn			T_void runFSMXWorker(T_uint8)
+ *	@brief 		Expands queued configurations until the queue is drained with
+ *				every worker idle, or storage ran out.
+ *	@param[in]	worker	Worker index.
+ *	@return		.
+ */
+static T_void runFSMXWorker(T_uint8 worker)
+{
+	T_fsmxReport* report = &fsmxShared->reports[worker];
+	T_uint8* successor = malloc(fsmxSize);
+	T_fsmxCount head;
+	T_fsmxCount reserved;
+	T_uint8 ready;
+
+	while (NOT(__atomic_load_n(&fsmxShared->truncated, __ATOMIC_RELAXED))) {
+		head = __atomic_load_n(&fsmxShared->head, __ATOMIC_SEQ_CST);
+		reserved = __atomic_load_n(&fsmxShared->reserved, __ATOMIC_SEQ_CST);
+		if (LT(head, reserved)) {
+			/* claim the entry while counted busy */
+			__atomic_add_fetch(&fsmxShared->busy, 1UL, __ATOMIC_SEQ_CST);
+			if (__atomic_compare_exchange_n(&fsmxShared->head, &head, head + 1UL,
+				FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+				while (EQU(ready = __atomic_load_n(&fsmxReady[head], __ATOMIC_ACQUIRE),
+					FSMX_ENTRY_PENDING)) {
+					sched_yield();
+				}
+				if (EQU(ready, FSMX_ENTRY_VALID)) {
+					expandFSMXConfig(head, successor, report);
+				}
+			}
+			__atomic_sub_fetch(&fsmxShared->busy, 1UL, __ATOMIC_SEQ_CST);
+		} else if (EQU(__atomic_load_n(&fsmxShared->busy, __ATOMIC_SEQ_CST), 0UL)
+			&& EQU(__atomic_load_n(&fsmxShared->head, __ATOMIC_SEQ_CST), head)
+			&& EQU(__atomic_load_n(&fsmxShared->reserved, __ATOMIC_SEQ_CST), reserved)) {
+			/* nothing queued and nobody left to queue more */
+			break;
+		} else {
+			sched_yield();
+		}
+	}
+	free(successor);
+}
+
+/**
+ *	@fn			T_void mergeFSMXReports(T_uint8, T_fsmxReport*)
+ *	@brief 		Merges worker findings.
+ *	@param[in]	workers		Worker count.
+ *	@param[out]	report		Merged findings.
+ *	@return		.
+ */
+static T_void mergeFSMXReports(T_uint8 workers, T_fsmxReport* report)
+{
+	const T_fsmxReport* worker;
+	T_uint8 index;
+	T_uint8 byte;
+
+	memset(report, 0, SzBytes_(T_fsmxReport));
+	for (index = 0U; LT(index, workers); index++) {
+		worker = &fsmxShared->reports[index];
+		report->dispatched += worker->dispatched;
+		report->chainLoops += worker->chainLoops;
+		for (byte = 0U; LT(byte, FSMX_MAP_SIZE); byte++) {
+			report->reached[byte] |= worker->reached[byte];
+			report->exited[byte] |= worker->exited[byte];
+			report->looped[byte] |= worker->looped[byte];
+		}
+	}
+	report->explored = fsmxShared->reserved - fsmxShared->holes;
+	report->truncated = fsmxShared->truncated;
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	T_fsm* automaton = initFSMXApp();
+	T_fsmxReport report;
+	T_fsmxCount capacity = FSMX_HOST_DEF_CAPACITY;
+	T_fsmxCount tableSize = 1UL;
+	T_fsmxCount slot;
+	struct timeval start;
+	struct timeval end;
+	double seconds;
+	unsigned long count;
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	T_uint8 workers = (T_uint8)MIN(MAX(cpus, 1L), (long)FSMX_HOST_MAX_WORKERS);
+	T_uint8 worker;
+	int status;
+	int failed = 0;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-w"), 0) && LT(arg + 1, argc)) {
+			count = strtoul(argv[++arg], NULL, 0);
+			workers = (T_uint8)MIN(count, FSMX_HOST_MAX_WORKERS);
+		} else if (EQU(strcmp(argv[arg], "-c"), 0) && LT(arg + 1, argc)) {
+			capacity = strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-w WORKERS] [-c CAPACITY]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (EQU(workers, 0U) || LT(capacity, 1UL) || GT(capacity, FSMX_EMPTY / 2UL)) {
+		fprintf(stderr, "workers must not be 0, capacity must be 1 to %lu\n",
+			(unsigned long)(FSMX_EMPTY / 2UL));
+		return 2;
+	}
+	/* table of twice the capacity (power of 2) */
+	while (LT(tableSize, capacity * 2UL)) {
+		tableSize <<= 1U;
+	}
+	fsmxSize = GetFSMXConfigSize(*automaton);
+	fsmxShared = mapFSMXShared(SzBytes_(T_fsmxShared));
+	fsmxReady = mapFSMXShared(capacity);
+	initFSMExplorer(&fsmxExplorer, automaton, fsmxChannels,
+		(T_uint8)SzElems_(fsmxChannels, T_fsmxChannel), mapFSMXShared(capacity * fsmxSize),
+		capacity, mapFSMXShared(tableSize * SzBytes_(T_fsmxCount)), tableSize);
+	if (EQU(fsmxShared, NULL) || EQU(fsmxReady, NULL) || EQU(fsmxExplorer.pool, NULL)
+		|| EQU(fsmxExplorer.table, NULL)) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (slot = 0UL; LT(slot, tableSize); slot++) {
+		fsmxExplorer.table[slot] = FSMX_EMPTY;
+	}
+	/* store root configuration */
+	memcpy(fsmxExplorer.pool, automaton, SzBytes_(T_fsm));
+	memcpy(fsmxExplorer.pool + SzBytes_(T_fsm), automaton->fsmData, automaton->fsmDataSize);
+	slot = hashFSMExplorerConfig(fsmxExplorer.pool, fsmxSize) & (tableSize - 1UL);
+	fsmxExplorer.table[slot] = 0UL;
+	fsmxReady[0] = FSMX_ENTRY_VALID;
+	fsmxShared->reserved = 1UL;
+	/* run workers */
+	fflush(stdout);
+	gettimeofday(&start, NULL);
+	for (worker = 0U; LT(worker, workers); worker++) {
+		if (EQU(fork(), 0)) {
+			runFSMXWorker(worker);
+			_exit(0);
+		}
+	}
+	for (worker = 0U; LT(worker, workers); worker++) {
+		if (LT(wait(&status), 0) || NOT(WIFEXITED(status)) || NEQ(WEXITSTATUS(status), 0)) {
+			failed = 1;
+		}
+	}
+	gettimeofday(&end, NULL);
+	if (failed) {
+		fprintf(stderr, "worker failed\n");
+		return 1;
+	}
+	/* report */
+	seconds = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+	mergeFSMXReports(workers, &report);
+	printf("%s: %u workers, %u bytes per configuration\n",
+		GetStringFSMName(*automaton), workers, fsmxSize);
+	logFSMExplorerReport(automaton, &report);
+	printf("%.2f s, %.0f configurations/s, %.0f dispatches/s\n", seconds,
+		report.explored / seconds, report.dispatched / seconds);
+
+	return COND(IS(report.truncated), 1, 0);
+}
+
+/* END OF FSMX_HOST. */
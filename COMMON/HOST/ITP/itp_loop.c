@@ -0,0 +1,618 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* ISO-TP Loopback Throughput Host Tool										 */
+/**
+ *	@file		ITP/itp_loop.c
+ *	@brief		This file contains the host tool measuring ISO-TP (ITP/itp.h)
+ *				transfers on the virtual CAN bus (VCB/vcb.h).
+ *	@details	Usage: itp_loop [-n COUNT] [-l LENGTH] [-b BLOCK] [-s STMIN]
+ *				[-f] [-t MS] <br>
+ *				Node 0 runs ITP as built for the target, calling manageITP
+ *				every ITP_POLL_MS, with BLOCK (default 8) and raw STMIN
+ *				(default 0) requested to the peer. Node 1 is a minimal ISO-TP
+ *				peer polling its registers every ITP_LOOP_PEER_US, which sends
+ *				as fast as the flow control of node 0 allows (ignoring STmin
+ *				with -f) and grants block size and STmin of 0. COUNT (default
+ *				20) payloads of LENGTH bytes (default ITP_MAX_SIZE) go from node
+ *				0 to the peer, then as many the other way; every payload is
+ *				compared. The tool reports the STmin granted by node 0, then
+ *				per direction failed transfers, time per transfer and
+ *				throughput. The exit status is 1 on any failed or missing
+ *				transfer within MS of virtual time (default 60000). <br>
+ *				The default build polls ITP_RX_BUFFER; with -DITP_CNX=1U
+ *				-DCNX_RX_CALLBACK=1U, the VCB reception handler of node 0 plays
+ *				the CNX reception ISR and calls the callback set by initITP.
+ *				Built as in VCB/vcb.h, i.e.: <br>
+ *				cc -pthread -I LIB/MB90385/include -I LIB/EXTRA/include -I
+ *				HOST -o itp_loop HOST/ITP/itp_loop.c
+ *				LIB/EXTRA/implement/ITP/itp.c HOST/VCB/vcb.c HOST/VCB/vcb_can.c
+ *				HOST/VCB/vcb_tbt.c LIB/MB90385/start/io_mb90385.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <ITP/itp.h>
+#include <VCB/vcb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		ITP_LOOP_NODE, ITP_LOOP_PEER
+ *	@brief 		ID prefixes of node 0 and of the peer.
+ */
+#define ITP_LOOP_NODE			(0x10U)
+#define ITP_LOOP_PEER			(0x20U)
+
+/**
+ * 	@def		ITP_LOOP_PEER_US
+ *	@brief 		Peer poll period in microseconds.
+ */
+#define ITP_LOOP_PEER_US		(10UL)
+
+/**
+ * 	@def		ITP_LOOP_BIT_RATE
+ *	@brief 		Bus bit rate (CAN_DEF_BUS_SPEED).
+ */
+#define ITP_LOOP_BIT_RATE		(1000000UL)
+
+/**
+ * 	@def		ITP_LOOP_TX, ITP_LOOP_RX, ITP_LOOP_END
+ *	@brief 		Test phases (transfers from node 0, to node 0, finished).
+ */
+#define ITP_LOOP_TX				(0U)
+#define ITP_LOOP_RX				(1U)
+#define ITP_LOOP_END			(2U)
+
+/**
+ * 	@def		ITP_LOOP_IDLE, ITP_LOOP_WAIT_FC, ITP_LOOP_SENDING
+ *	@brief 		Peer transmission states.
+ */
+#define ITP_LOOP_IDLE			(0U)
+#define ITP_LOOP_WAIT_FC		(1U)
+#define ITP_LOOP_SENDING		(2U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for direction results.
+ */
+typedef struct {
+	T_uint32 done;
+	T_uint32 failed;
+	uint64_t time;
+} T_itpLoopResult;
+
+/**
+ *	@brief		Data structure for peer state.
+ */
+typedef struct {
+	T_uint8 data[ITP_MAX_SIZE];
+	T_uint16 length;
+	T_uint16 offset;
+	T_uint8 sequence;
+	T_uint8 state;
+	T_uint8 blockSize;
+	T_uint8 blockCount;
+	uint64_t separation;
+	uint64_t next;
+	T_bit spacing;
+	T_bit received;
+} T_itpLoopPeer;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		itpLoopCount, itpLoopLength, itpLoopBlock, itpLoopStMin,
+ *				itpLoopFast
+ *	@brief		Transfer count, payload size, block size and raw STmin
+ *				requested by node 0, and peer ignoring STmin.
+ */
+static T_uint32 itpLoopCount = 20UL;
+static T_uint16 itpLoopLength = ITP_MAX_SIZE;
+static T_uint8 itpLoopBlock = 8U;
+static T_uint8 itpLoopStMin = 0U;
+static T_bit itpLoopFast = FALSE;
+
+/**
+ *	@var		itpLoopPhase, itpLoopActive, itpLoopStart
+ *	@brief		Test phase, transfer in progress and its start time (ns).
+ */
+static T_uint8 itpLoopPhase = ITP_LOOP_TX;
+static T_bit itpLoopActive;
+static uint64_t itpLoopStart;
+
+/**
+ *	@var		itpLoopResults
+ *	@brief		Results per direction.
+ */
+static T_itpLoopResult itpLoopResults[2];
+
+/**
+ *	@var		itpLoopPayload
+ *	@brief		Payload sent by node 0 (kept until transmitted).
+ */
+static T_uint8 itpLoopPayload[ITP_MAX_SIZE];
+
+/**
+ *	@var		itpLoopPeer
+ *	@brief		Peer state.
+ */
+static T_itpLoopPeer itpLoopPeer;
+
+/**
+ *	@var		itpLoopGranted
+ *	@brief		Raw STmin of the last flow control of node 0 (0x100 if none).
+ */
+static T_uint16 itpLoopGranted = 0x100U;
+
+#if ITP_CNX
+/* ----------------------------------------------------------------------------
+**	CAN Extension Stubs.
+*/
+
+/**
+ *	@var		itpLoopCallbacks
+ *	@brief		Reception callbacks of node 0.
+ */
+static T_cnxRxCallback itpLoopCallbacks[CAN_MB_SIZE];
+
+T_void setCNXRxCallback(T_canMsgBuf msgBuf, T_cnxRxCallback callback)
+{
+	itpLoopCallbacks[msgBuf] = callback;
+}
+
+/**
+ *	@fn			T_void handleITPLoopReception(T_void)
+ *	@brief 		Reception handler of node 0 (CNX reception ISR).
+ *	@param		.
+ *	@return		.
+ */
+static T_void handleITPLoopReception(T_void)
+{
+	T_byte received = GetCAN_RCR() & GetCAN_RIER();
+	T_uint8 buffer;
+
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (EQU(ReadBit(received, buffer), 0U)) {
+			continue;
+		}
+		SetCAN_RCR((T_byte)~ToBit(buffer));
+		SetCAN_ROVRR((T_byte)~ToBit(buffer));
+		if (NEQ(itpLoopCallbacks[buffer], NULL)) {
+			itpLoopCallbacks[buffer](buffer, GetCAN_IDR(buffer),
+				(T_uint8)(GetCAN_DLCR(buffer) & 0x0FU), &IO_CANID.DTR[buffer]);
+		}
+	}
+}
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 getITPLoopByte(T_uint32, T_uint16)
+ *	@brief 		Gets a payload byte.
+ *	@param[in]	transfer	Transfer index.
+ *	@param[in]	index		Byte index.
+ *	@return		byte.
+ */
+static T_uint8 getITPLoopByte(T_uint32 transfer, T_uint16 index)
+{
+	return (T_uint8)((transfer * 31UL) + (index * 7U) + (index >> 8U));
+}
+
+/**
+ *	@fn			T_bit checkITPLoopPayload(const T_uint8*, T_uint16, T_uint32)
+ *	@brief 		Compares a received payload.
+ *	@param[in]	pData		Payload.
+ *	@param[in]	length		Payload size in bytes.
+ *	@param[in]	transfer	Transfer index.
+ *	@return		match.
+ */
+static T_bit checkITPLoopPayload(const T_uint8* pData, T_uint16 length,
+	T_uint32 transfer)
+{
+	T_uint16 index;
+
+	if (NEQ(length, itpLoopLength)) {
+		return FALSE;
+	}
+	for (index = 0U; LT(index, length); index++) {
+		if (NEQ(pData[index], getITPLoopByte(transfer, index))) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_void endITPLoopTransfer(T_uint8, T_bit)
+ *	@brief 		Counts the transfer in progress and moves to the next one.
+ *	@param[in]	direction	Transfer direction (test phase).
+ *	@param[in]	success		Transfer success.
+ *	@return		.
+ */
+static T_void endITPLoopTransfer(T_uint8 direction, T_bit success)
+{
+	T_itpLoopResult* result = &itpLoopResults[direction];
+
+	if (IS(success)) {
+		result->time += getVCBTime() - itpLoopStart;
+	} else {
+		result->failed++;
+	}
+	itpLoopActive = FALSE;
+	if (GEQ(++result->done, itpLoopCount)) {
+		itpLoopPhase++;
+	}
+}
+
+/**
+ *	@fn			T_void sendITPLoopFrame(const T_uint8*)
+ *	@brief 		Sends a peer frame (8 bytes).
+ *	@param[in]	pFrame	Frame data.
+ *	@return		.
+ */
+static T_void sendITPLoopFrame(const T_uint8* pFrame)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_WORD_SIZE); index++) {
+		SetCAN_DTR_WORD(ITP_TX_BUFFER, index,
+			(T_word)pFrame[index * 2U] | ((T_word)pFrame[(index * 2U) + 1U] << 8U));
+	}
+	RequestCANTransmit(ITP_TX_BUFFER);
+	itpLoopPeer.spacing = TRUE;
+}
+
+/**
+ *	@fn			T_void receiveITPLoopFrame(const T_uint8*)
+ *	@brief 		Processes a frame received by the peer.
+ *	@param[in]	pData	Frame data (8 bytes).
+ *	@return		.
+ */
+static T_void receiveITPLoopFrame(const T_uint8* pData)
+{
+	T_itpLoopPeer* peer = &itpLoopPeer;
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 index;
+
+	switch (pData[0] & 0xF0U) {
+	case 0x00U:
+		peer->length = pData[0] & 0x0FU;
+		for (index = 0U; LT(index, peer->length); index++) {
+			peer->data[index] = pData[1U + index];
+		}
+		peer->received = TRUE;
+		break;
+	case 0x10U:
+		peer->length = (T_uint16)(((pData[0] & 0x0FU) << 8U) | pData[1]);
+		peer->offset = 0U;
+		peer->sequence = 1U;
+		for (index = 2U; LT(index, CAN_MB_BYTE_SIZE); index++) {
+			peer->data[peer->offset++] = pData[index];
+		}
+		/* clear to send, no block, no separation time */
+		memset(frame, ITP_PADDING, sizeof(frame));
+		frame[0] = 0x30U;
+		frame[1] = 0U;
+		frame[2] = 0U;
+		sendITPLoopFrame(frame);
+		break;
+	case 0x20U:
+		if (NEQ(pData[0] & 0x0FU, peer->sequence & 0x0FU)) {
+			endITPLoopTransfer(ITP_LOOP_TX, FALSE);
+			break;
+		}
+		peer->sequence++;
+		for (index = 1U; LT(index, CAN_MB_BYTE_SIZE) && LT(peer->offset, peer->length);
+			index++) {
+			peer->data[peer->offset++] = pData[index];
+		}
+		peer->received = GEQ(peer->offset, peer->length);
+		break;
+	case 0x30U:
+		itpLoopGranted = pData[2];
+		if (NEQ(peer->state, ITP_LOOP_WAIT_FC)) {
+			break;
+		}
+		if (EQU(pData[0] & 0x0FU, 0U)) {
+			peer->blockSize = pData[1];
+			peer->blockCount = pData[1];
+			if (IS(itpLoopFast) || EQU(pData[2], 0U)) {
+				peer->separation = 0ULL;
+			} else if (LEQ(pData[2], 0x7FU)) {
+				peer->separation = pData[2] * 1000000ULL;
+			} else if (GEQ(pData[2], 0xF1U) && LEQ(pData[2], 0xF9U)) {
+				peer->separation = (pData[2] - 0xF0U) * 100000ULL;
+			} else {
+				peer->separation = 127000000ULL;
+			}
+			peer->next = getVCBTime();
+			peer->state = ITP_LOOP_SENDING;
+		} else if (NEQ(pData[0] & 0x0FU, 1U)) {
+			peer->state = ITP_LOOP_IDLE;
+			endITPLoopTransfer(ITP_LOOP_RX, FALSE);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ *	@fn			T_void transmitITPLoopNext(T_void)
+ *	@brief 		Sends the next peer payload frame when due.
+ *	@param		.
+ *	@return		.
+ */
+static T_void transmitITPLoopNext(T_void)
+{
+	T_itpLoopPeer* peer = &itpLoopPeer;
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 index = 1U;
+
+	if (NEQ(ReadBit(GetCAN_TREQR(), ITP_TX_BUFFER), 0U)) {
+		return;
+	}
+	/* separation time runs from the end of the previous frame */
+	if (IS(peer->spacing)) {
+		peer->spacing = FALSE;
+		peer->next = getVCBTime() + peer->separation;
+	}
+	if (NEQ(peer->state, ITP_LOOP_SENDING) || LT(getVCBTime(), peer->next)) {
+		return;
+	}
+	memset(frame, ITP_PADDING, sizeof(frame));
+	frame[0] = (T_uint8)(0x20U | (peer->sequence++ & 0x0FU));
+	while (LT(index, CAN_MB_BYTE_SIZE) && LT(peer->offset, peer->length)) {
+		frame[index++] = peer->data[peer->offset++];
+	}
+	sendITPLoopFrame(frame);
+	if (GEQ(peer->offset, peer->length)) {
+		peer->state = ITP_LOOP_IDLE;
+	} else if (NEQ(peer->blockSize, 0U) && EQU(--peer->blockCount, 0U)) {
+		peer->state = ITP_LOOP_WAIT_FC;
+	}
+}
+
+/**
+ *	@fn			T_void startITPLoopPeer(T_uint32)
+ *	@brief 		Starts a peer transfer to node 0.
+ *	@param[in]	transfer	Transfer index.
+ *	@return		.
+ */
+static T_void startITPLoopPeer(T_uint32 transfer)
+{
+	T_itpLoopPeer* peer = &itpLoopPeer;
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 index = 1U;
+
+	for (peer->offset = 0U; LT(peer->offset, itpLoopLength); peer->offset++) {
+		peer->data[peer->offset] = getITPLoopByte(transfer, peer->offset);
+	}
+	peer->length = itpLoopLength;
+	peer->offset = 0U;
+	memset(frame, ITP_PADDING, sizeof(frame));
+	if (LEQ(peer->length, 7U)) {
+		frame[0] = (T_uint8)peer->length;
+		peer->state = ITP_LOOP_IDLE;
+	} else {
+		frame[0] = (T_uint8)(0x10U | (peer->length >> 8U));
+		frame[1] = (T_uint8)peer->length;
+		index = 2U;
+		peer->sequence = 1U;
+		peer->state = ITP_LOOP_WAIT_FC;
+	}
+	while (LT(index, CAN_MB_BYTE_SIZE) && LT(peer->offset, peer->length)) {
+		frame[index++] = peer->data[peer->offset++];
+	}
+	sendITPLoopFrame(frame);
+}
+
+/**
+ *	@fn			T_void setupITPLoopBuffers(T_byte, T_byte)
+ *	@brief 		Sets up message buffers as initITP does.
+ *	@param[in]	txPrefix	Prefix of transmitted frames.
+ *	@param[in]	rxPrefix	Prefix of received frames.
+ *	@return		.
+ */
+static T_void setupITPLoopBuffers(T_byte txPrefix, T_byte rxPrefix)
+{
+	setupCANMessageBuffer(ITP_TX_BUFFER, CAN_ID_EXT_FORMAT, txPrefix, ITP_SUFFIX,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	DisableCANMsgBuff(ITP_TX_BUFFER);
+	SetCAN_IDR(ITP_TX_BUFFER, toIDRegMap(formattedCANID(ITP_RX_BUFFER, txPrefix,
+		ITP_SUFFIX)));
+	setupCANMessageBuffer(ITP_RX_BUFFER, CAN_ID_EXT_FORMAT, rxPrefix, ITP_SUFFIX,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	EnableCANMsgBuff(ITP_TX_BUFFER);
+	EnableCANMsgBuff(ITP_RX_BUFFER);
+}
+
+/**
+ *	@fn			T_void runITPLoopPeer(T_void)
+ *	@brief 		Peer application.
+ *	@param		.
+ *	@return		.
+ */
+static T_void runITPLoopPeer(T_void)
+{
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 index;
+
+	initCAN(CAN_DEF_BUS_SPEED, 0U, 0U);
+	setupITPLoopBuffers(ITP_LOOP_PEER, ITP_LOOP_NODE);
+	startCAN();
+	for (;;) {
+		if (IS(IsCANReceiveComp(ITP_RX_BUFFER))) {
+			for (index = 0U; LT(index, CAN_MB_BYTE_SIZE); index++) {
+				frame[index] = GetCAN_DTR_BYTE(ITP_RX_BUFFER, index);
+			}
+			SetCAN_RCR((T_byte)~ToBit(ITP_RX_BUFFER));
+			receiveITPLoopFrame(frame);
+		}
+		if (EQU(itpLoopPhase, ITP_LOOP_RX) && NOT(itpLoopActive)) {
+			itpLoopActive = TRUE;
+			itpLoopStart = getVCBTime();
+			startITPLoopPeer(itpLoopResults[ITP_LOOP_RX].done);
+		}
+		transmitITPLoopNext();
+		waitVCB(COND(EQU(itpLoopPhase, ITP_LOOP_END), 1000000UL, ITP_LOOP_PEER_US));
+	}
+}
+
+/**
+ *	@fn			T_void runITPLoopNode(T_void)
+ *	@brief 		Node application (ITP under test).
+ *	@param		.
+ *	@return		.
+ */
+static T_void runITPLoopNode(T_void)
+{
+	T_uint8 payload[ITP_MAX_SIZE];
+	T_uint32 transfer;
+	T_itpStatus status;
+	T_uint16 index;
+	T_uint16 length;
+
+	initCAN(CAN_DEF_BUS_SPEED, 0U, 0U);
+#if ITP_CNX
+	setVCBHandlers(handleITPLoopReception, handleVCBTransmission);
+#endif
+	initITP(ITP_LOOP_NODE, ITP_LOOP_PEER, itpLoopBlock, itpLoopStMin);
+	startCAN();
+	for (;;) {
+		manageITP();
+		if (EQU(itpLoopPhase, ITP_LOOP_TX)) {
+			transfer = itpLoopResults[ITP_LOOP_TX].done;
+			status = getITPTxStatus();
+			if (NOT(itpLoopActive)) {
+				for (index = 0U; LT(index, itpLoopLength); index++) {
+					itpLoopPayload[index] = getITPLoopByte(transfer, index);
+				}
+				itpLoopPeer.received = FALSE;
+				itpLoopActive = sendITP(itpLoopPayload, itpLoopLength);
+				itpLoopStart = getVCBTime();
+			} else if (EQU(status, ITP_DONE) && IS(itpLoopPeer.received)) {
+				endITPLoopTransfer(ITP_LOOP_TX, checkITPLoopPayload(itpLoopPeer.data,
+					itpLoopPeer.length, transfer));
+			} else if (NEQ(status, ITP_DONE) && NEQ(status, ITP_BUSY)) {
+				endITPLoopTransfer(ITP_LOOP_TX, FALSE);
+			}
+		} else if (EQU(itpLoopPhase, ITP_LOOP_RX) && IS(itpLoopActive)) {
+			transfer = itpLoopResults[ITP_LOOP_RX].done;
+			status = getITPRxStatus();
+			if (EQU(status, ITP_DONE)) {
+				length = readITP(payload, sizeof(payload));
+				endITPLoopTransfer(ITP_LOOP_RX, checkITPLoopPayload(payload, length,
+					transfer));
+			} else if (NEQ(status, ITP_IDLE) && NEQ(status, ITP_BUSY)) {
+				/* next first frame restarts reception */
+				endITPLoopTransfer(ITP_LOOP_RX, FALSE);
+			}
+		}
+		waitVCB(ITP_POLL_MS * 1000UL);
+	}
+}
+
+/**
+ *	@fn			T_void runITPLoop(T_uint8)
+ *	@brief 		Node entry point.
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void runITPLoop(T_uint8 index)
+{
+	if (EQU(index, 0U)) {
+		runITPLoopNode();
+	} else {
+		runITPLoopPeer();
+	}
+}
+
+/**
+ *	@fn			T_void printITPLoopResult(const char*, T_uint8)
+ *	@brief 		Prints the results of a direction.
+ *	@param[in]	name		Direction name.
+ *	@param[in]	direction	Transfer direction.
+ *	@return		.
+ */
+static T_void printITPLoopResult(const char* name, T_uint8 direction)
+{
+	const T_itpLoopResult* result = &itpLoopResults[direction];
+	T_uint32 passed = result->done - result->failed;
+	double seconds = result->time / 1e9;
+
+	printf("%s: %lu/%lu transfers, %lu failed", name, (unsigned long)result->done,
+		(unsigned long)itpLoopCount, (unsigned long)result->failed);
+	if (NEQ(passed, 0UL)) {
+		printf(", %.2f ms per transfer, %.2f kB/s", (seconds * 1e3) / passed,
+			((double)passed * itpLoopLength) / (seconds * 1e3));
+	}
+	printf("\n");
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	T_uint32 duration = 60000UL;
+	unsigned long value;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-f"), 0)) {
+			itpLoopFast = TRUE;
+		} else if (EQU(strcmp(argv[arg], "-n"), 0) && LT(arg + 1, argc)) {
+			itpLoopCount = strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-l"), 0) && LT(arg + 1, argc)) {
+			value = strtoul(argv[++arg], NULL, 0);
+			itpLoopLength = (T_uint16)MIN(value, ITP_MAX_SIZE);
+		} else if (EQU(strcmp(argv[arg], "-b"), 0) && LT(arg + 1, argc)) {
+			itpLoopBlock = (T_uint8)strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-s"), 0) && LT(arg + 1, argc)) {
+			itpLoopStMin = (T_uint8)strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-t"), 0) && LT(arg + 1, argc)) {
+			duration = strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n COUNT] [-l LENGTH] [-b BLOCK] [-s STMIN]"
+				" [-f] [-t MS]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (EQU(itpLoopLength, 0U) || EQU(itpLoopCount, 0UL)) {
+		fprintf(stderr, "length and count must not be 0\n");
+		return 2;
+	}
+	runVCB(2U, runITPLoop, ITP_LOOP_BIT_RATE, duration);
+	printf("%s reception, manageITP every %u ms, %u bytes per transfer\n",
+		COND(ITP_CNX, "CNX", "polled"), (unsigned)ITP_POLL_MS, (unsigned)itpLoopLength);
+	if (GT(itpLoopGranted, 0xFFU)) {
+		printf("STmin requested 0x%02X, no flow control from node\n", itpLoopStMin);
+	} else {
+		printf("STmin requested 0x%02X, granted 0x%02X%s\n", itpLoopStMin,
+			itpLoopGranted, COND(IS(itpLoopFast), " (ignored by peer)", ""));
+	}
+	printITPLoopResult("node -> peer", ITP_LOOP_TX);
+	printITPLoopResult("peer -> node", ITP_LOOP_RX);
+
+	return NEQ(itpLoopResults[ITP_LOOP_TX].failed, 0UL)
+		|| NEQ(itpLoopResults[ITP_LOOP_RX].failed, 0UL)
+		|| NEQ(itpLoopPhase, ITP_LOOP_END);
+}
+
+/* END OF ITP_LOOP. */
@@ -0,0 +1,398 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Multi-Drop Bus Simulation Host Tool										 */
+/**
+ *	@file		MDB/mdb_bus.c
+ *	@brief		This file contains the host tool measuring the reception work
+ *				of MDB nodes (MDB/mdb.h) on a simulated RS-485 bus.
+ *	@details	Usage: mdb_bus [-n NODES] [-r REQUESTS] [-e PERMILLE] [-s SEED]
+ *				<br>
+ *				A master polls NODES slaves (default 16, addresses 1 to NODES)
+ *				REQUESTS times (default 10000) in random order: an address
+ *				frame, then 4 to 32 request data frames, then 4 to 32 response
+ *				data frames from the selected slave. One request out of 16 is
+ *				broadcast (MDB_BROADCAST_ADDRESS, no response). PERMILLE data
+ *				frames (default 1) carry a framing error. <br>
+ *				The frame trace is replayed through MDB_IRQHandler of the
+ *				library for every node in turn (initMDB resets the node, and a
+ *				node does not receive its own response): the frame, its A/D bit
+ *				and error flag are set in the SER registers before each call,
+ *				and writeSERReceivedData below stands for the SER reception
+ *				buffer. Every node must receive exactly the request bytes sent
+ *				while it was selected or broadcast. The same trace is replayed
+ *				through the plain reception path (SERRX_IRQHandler: every frame
+ *				enters the buffer) for comparison. <br>
+ *				Per node, the tool reports frames seen, address frames, foreign
+ *				data frames (rejected in the ISR) and selected data frames (sent
+ *				to the buffer and the application) against the plain path, then
+ *				the ISR time per frame of both paths. Every node still takes an
+ *				interrupt per frame (the UART does not filter address frames):
+ *				the saving is that only the data frames of its own requests and
+ *				of broadcasts reach the buffer and the NSC parsing (1/15 of them
+ *				on 16 nodes), while a foreign frame costs a few compares more
+ *				than the plain ISR. The exit status is 1 on
+ *				any reception mismatch. Built with the MDB ISR enabled, i.e.:
+ *				<br>
+ *				cc -O2 -DUSE_PREDEF_MDB_ISR -I LIB/MB90385/include -I
+ *				LIB/EXTRA/include -o mdb_bus HOST/MDB/mdb_bus.c
+ *				LIB/EXTRA/implement/MDB/mdb.c LIB/MB90385/start/io_mb90385.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <MDB/mdb.h>
+
+#if NOT(USE_MDB_ISR)
+#error "MDB_IRQHandler is needed (build with -DUSE_PREDEF_MDB_ISR)"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		MDB_BUS_NODES
+ *	@brief 		Default slave count.
+ */
+#define MDB_BUS_NODES			(16U)
+
+/**
+ * 	@def		MDB_BUS_REQUESTS
+ *	@brief 		Default request count.
+ */
+#define MDB_BUS_REQUESTS		(10000UL)
+
+/**
+ * 	@def		MDB_BUS_ERRORS
+ *	@brief 		Default framing errors per thousand data frames.
+ */
+#define MDB_BUS_ERRORS			(1U)
+
+/**
+ * 	@def		MDB_BUS_MASTER
+ *	@brief 		Source of frames sent by the master.
+ */
+#define MDB_BUS_MASTER			(0U)
+
+/**
+ * 	@def		MDB_BUS_RX_SIZE
+ *	@brief 		SER reception buffer size (as in the library).
+ */
+#define MDB_BUS_RX_SIZE			(256U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for a bus frame.
+ */
+typedef struct {
+	T_uint8 data;				/**< frame data */
+	T_uint8 source;				/**< sending node address (0 for master) */
+	T_bit address;				/**< A/D bit set */
+	T_bit error;				/**< framing error */
+} T_mdbBusFrame;
+
+/**
+ *	@brief		Data structure for the reception of a node.
+ */
+typedef struct {
+	unsigned long frames;		/**< frames seen */
+	unsigned long addresses;	/**< address frames seen */
+	unsigned long foreign;		/**< data frames rejected by the ISR */
+	unsigned long selected;		/**< data frames sent to the buffer */
+	unsigned long plain;		/**< data frames of the plain path */
+	unsigned long expected;		/**< request bytes sent to the node */
+	unsigned long sum;			/**< checksum of received bytes */
+	unsigned long expectedSum;	/**< checksum of request bytes */
+	double mdbNanos;			/**< MDB ISR time */
+	double plainNanos;			/**< plain ISR time */
+} T_mdbBusNode;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		mdbBusTrace, mdbBusTraceCount
+ *	@brief		Bus frames in transmission order.
+ */
+static T_mdbBusFrame* mdbBusTrace;
+static unsigned long mdbBusTraceCount;
+
+/**
+ *	@var		mdbBusNodes
+ *	@brief		Reception of every node (index 0 is address 1).
+ */
+static T_mdbBusNode mdbBusNodes[MDB_BROADCAST_ADDRESS];
+
+/**
+ *	@var		mdbBusNode
+ *	@brief		Node under replay.
+ */
+static T_mdbBusNode* mdbBusNode;
+
+/**
+ *	@var		mdbBusRx, mdbBusRxTail
+ *	@brief		SER reception buffer of the node under replay.
+ */
+static T_uint8 mdbBusRx[MDB_BUS_RX_SIZE];
+static T_uint8 mdbBusRxTail;
+
+/* ----------------------------------------------------------------------------
+**	Serial Stubs.
+*/
+
+T_void writeSERReceivedData(T_uint8 data)
+{
+	mdbBusRx[mdbBusRxTail++] = data;
+	mdbBusNode->selected++;
+	mdbBusNode->sum = (mdbBusNode->sum * 31UL + data) & 0xFFFFFFFFUL;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void receiveMDBBusPlain(T_void)
+ *	@brief 		Plain reception path (as SERRX_IRQHandler).
+ *	@param		.
+ *	@return		.
+ */
+static T_void receiveMDBBusPlain(T_void)
+{
+	T_uint8 data = GetSER_SIDR();
+
+	if (IsSERFramingError() || IsSEROverrunError() || IsSERParityError()) {
+		ClearSERReceiveErrorFlag();
+		return;
+	}
+	mdbBusRx[mdbBusRxTail++] = data;
+}
+
+/**
+ *	@fn			T_void putMDBBusFrame(T_uint8, T_uint8, T_bit, T_bit)
+ *	@brief 		Appends a frame to the trace.
+ *	@param[in]	data		Frame data.
+ *	@param[in]	source		Sending node address (0 for master).
+ *	@param[in]	address		Address frame.
+ *	@param[in]	error		Framing error.
+ *	@return		.
+ */
+static T_void putMDBBusFrame(T_uint8 data, T_uint8 source, T_bit address, T_bit error)
+{
+	T_mdbBusFrame* frame = &mdbBusTrace[mdbBusTraceCount++];
+
+	frame->data = data;
+	frame->source = source;
+	frame->address = address;
+	frame->error = error;
+}
+
+/**
+ *	@fn			T_void buildMDBBusTrace(T_uint8, unsigned long, unsigned)
+ *	@brief 		Builds the frame trace and the expected reception of nodes.
+ *	@param[in]	nodes		Slave count.
+ *	@param[in]	requests	Request count.
+ *	@param[in]	errors		Framing errors per thousand data frames.
+ *	@return		.
+ */
+static T_void buildMDBBusTrace(T_uint8 nodes, unsigned long requests, unsigned errors)
+{
+	unsigned long request;
+	T_uint8 target, length, index, data, node;
+	T_bit error;
+
+	for (request = 0UL; request < requests; request++) {
+		target = EQU(rand() % 16, 0) ? MDB_BROADCAST_ADDRESS : (T_uint8)(1 + rand() % nodes);
+		putMDBBusFrame(target, MDB_BUS_MASTER, TRUE, FALSE);
+		length = (T_uint8)(4 + rand() % 29);
+		for (index = 0U; LT(index, length); index++) {
+			data = (T_uint8)rand();
+			error = (T_bit)LT((unsigned)(rand() % 1000), errors);
+			putMDBBusFrame(data, MDB_BUS_MASTER, FALSE, error);
+			if (IS(error)) {
+				continue;
+			}
+			/* request bytes reach the target or every node */
+			for (node = 1U; LEQ(node, nodes); node++) {
+				if (EQU(target, node) || EQU(target, MDB_BROADCAST_ADDRESS)) {
+					mdbBusNodes[node - 1U].expected++;
+					mdbBusNodes[node - 1U].expectedSum =
+						(mdbBusNodes[node - 1U].expectedSum * 31UL + data) & 0xFFFFFFFFUL;
+				}
+			}
+		}
+		if (EQU(target, MDB_BROADCAST_ADDRESS)) {
+			continue;
+		}
+		length = (T_uint8)(4 + rand() % 29);
+		for (index = 0U; LT(index, length); index++) {
+			putMDBBusFrame((T_uint8)rand(), target,
+				FALSE, (T_bit)LT((unsigned)(rand() % 1000), errors));
+		}
+	}
+}
+
+/**
+ *	@fn			double getMDBBusNanos(T_void)
+ *	@brief 		Gets monotonic time.
+ *	@param		.
+ *	@return		time in nanoseconds.
+ */
+static double getMDBBusNanos(T_void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/**
+ *	@fn			T_void replayMDBBus(T_uint8, T_bit)
+ *	@brief 		Replays the trace through the reception path of a node.
+ *	@param[in]	address		Node address.
+ *	@param[in]	plain		Plain path instead of MDB_IRQHandler.
+ *	@return		.
+ */
+static T_void replayMDBBus(T_uint8 address, T_bit plain)
+{
+	const T_mdbBusFrame* frame;
+	unsigned long index;
+	double start;
+
+	mdbBusNode = &mdbBusNodes[address - 1U];
+	mdbBusRxTail = 0U;
+	initMDB(address);
+	start = getMDBBusNanos();
+	for (index = 0UL; index < mdbBusTraceCount; index++) {
+		frame = &mdbBusTrace[index];
+		/* own response is not received */
+		if (EQU(frame->source, address)) {
+			continue;
+		}
+		SetIOREGByte(IO_SIODR1, frame->data);
+		SetIOREGBitVar(IO_SCR1, AD, COND(IS(frame->address), SER_FRAME_ADDRESS,
+			SER_FRAME_DATA));
+		SetIOREGBitVar(IO_SSR1, FRE, COND(IS(frame->error), SER_ERR_FRAME,
+			NOT(SER_ERR_FRAME)));
+		if (IS(plain)) {
+			receiveMDBBusPlain();
+		} else {
+			MDB_IRQHandler();
+		}
+	}
+	if (IS(plain)) {
+		mdbBusNode->plainNanos = getMDBBusNanos() - start;
+	} else {
+		mdbBusNode->mdbNanos = getMDBBusNanos() - start;
+	}
+}
+
+/**
+ *	@fn			T_void countMDBBusFrames(T_uint8)
+ *	@brief 		Counts frames seen by a node.
+ *	@param[in]	address		Node address.
+ *	@return		.
+ */
+static T_void countMDBBusFrames(T_uint8 address)
+{
+	T_mdbBusNode* node = &mdbBusNodes[address - 1U];
+	unsigned long index;
+
+	for (index = 0UL; index < mdbBusTraceCount; index++) {
+		if (EQU(mdbBusTrace[index].source, address)) {
+			continue;
+		}
+		node->frames++;
+		if (IS(mdbBusTrace[index].address)) {
+			node->addresses++;
+		} else if (NOT(mdbBusTrace[index].error)) {
+			node->plain++;
+		}
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	unsigned long requests = MDB_BUS_REQUESTS;
+	unsigned long selected = 0UL, plain = 0UL, frames = 0UL;
+	double mdbNanos = 0.0, plainNanos = 0.0;
+	unsigned nodes = MDB_BUS_NODES, errors = MDB_BUS_ERRORS;
+	unsigned seed = 1U;
+	T_mdbBusNode* node;
+	T_uint8 address;
+	int failed = 0;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if ((strcmp(argv[arg], "-n") == 0) && (arg + 1 < argc)) {
+			nodes = (unsigned)strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-r") == 0) && (arg + 1 < argc)) {
+			requests = strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-e") == 0) && (arg + 1 < argc)) {
+			errors = (unsigned)strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-s") == 0) && (arg + 1 < argc)) {
+			seed = (unsigned)strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n NODES] [-r REQUESTS] [-e PERMILLE] [-s SEED]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+	if ((nodes == 0U) || (nodes >= MDB_BROADCAST_ADDRESS)) {
+		fprintf(stderr, "mdb_bus: 1 to %u nodes\n", MDB_BROADCAST_ADDRESS - 1U);
+		return 2;
+	}
+	/* address frame and up to 64 data frames per request */
+	mdbBusTrace = malloc(sizeof(T_mdbBusFrame) * (requests * 65UL + 1UL));
+	if (mdbBusTrace == NULL) {
+		perror("mdb_bus");
+		return 1;
+	}
+	srand(seed);
+	buildMDBBusTrace((T_uint8)nodes, requests, errors);
+	printf("%4s %9s %8s %9s %9s %9s %6s %8s %8s\n", "node", "frames", "address",
+		"foreign", "selected", "plain", "share", "mdb ns", "plain ns");
+	for (address = 1U; LEQ(address, nodes); address++) {
+		node = &mdbBusNodes[address - 1U];
+		countMDBBusFrames(address);
+		replayMDBBus(address, TRUE);
+		replayMDBBus(address, FALSE);
+		node->foreign = node->frames - node->addresses - node->selected;
+		if (NEQ(node->selected, node->expected) || NEQ(node->sum, node->expectedSum)
+			|| NEQ(countMDBDiscarded(), (T_uint16)(node->plain - node->selected))) {
+			printf("node %u: received %lu bytes for %lu, discarded %u\n", address,
+				node->selected, node->expected, countMDBDiscarded());
+			failed = 1;
+		}
+		printf("%4u %9lu %8lu %9lu %9lu %9lu %5.1f%% %8.1f %8.1f\n", address, node->frames,
+			node->addresses, node->foreign, node->selected, node->plain,
+			100.0 * node->selected / node->plain, node->mdbNanos / node->frames,
+			node->plainNanos / node->frames);
+		frames += node->frames;
+		selected += node->selected;
+		plain += node->plain;
+		mdbNanos += node->mdbNanos;
+		plainNanos += node->plainNanos;
+	}
+	printf("all  %9lu data frames to buffers %lu (plain %lu, %.1f%%, 1/%.1f)\n", frames,
+		selected, plain, 100.0 * selected / plain, (double)plain / selected);
+	printf("isr  %.1f ns per frame (plain %.1f ns)\n", mdbNanos / frames, plainNanos / frames);
+	free(mdbBusTrace);
+
+	return failed;
+}
+
+/* END OF MDB_BUS. */
@@ -0,0 +1,528 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing CAN Transport Loopback Host Tool						 */
+/**
+ *	@file		NDS/nds_can_loop.c
+ *	@brief		This file contains the host tool checking NDS CAN transfers
+ *				(NDS/ndsCan.h) on the virtual CAN bus (VCB/vcb.h).
+ *	@details	Usage: nds_can_loop [-n COUNT] <br>
+ *				Node 0 runs NDS CAN as built for the target, calling
+ *				manageNDSCanIncoming and manageNDSCanOutgoing every
+ *				NDS_CAN_LOOP_POLL_US, with an incoming and an outgoing region of
+ *				NDS_CAN_LOOP_SIZE bytes (3 segments). Node 1 is a minimal NDS
+ *				peer polling its registers every NDS_CAN_LOOP_PEER_US, which
+ *				sends COUNT (10 to 65535, default 100) transfers of the incoming
+ *				region and reassembles the outgoing one. Segments are sent
+ *				halfway between two polls of node 0:
+ *				- polled (default build): one segment per poll, except for the
+ *				  middle transfer whose last two segments are sent back to back,
+ *				  so that the second one overwrites the first one before it is
+ *				  polled. That transfer must be dropped and counted as an error,
+ *				  and every other transfer received;
+ *				- with -DNDS_CAN_CNX=1U -DCNX_RX_CALLBACK=1U: the three
+ *				  segments of a transfer back to back, i.e. three segments per
+ *				  poll. The VCB reception handler of node 0 plays the CNX
+ *				  reception ISR and calls the callback set by initNDSCan. Every
+ *				  transfer must be received without error.
+ *				Each region carries its transfer number and a pattern derived
+ *				from it, so that a region mixing two transfers (torn) is
+ *				detected on both sides. The exit status is 1 on any torn or
+ *				unexpected missing transfer, on an error count other than
+ *				expected, or if the peer did not receive every transfer node 0
+ *				counted. Built as in VCB/vcb.h, i.e.: <br>
+ *				cc -pthread -I LIB/MB90385/include -I LIB/EXTRA/include -I
+ *				HOST -o nds_can_loop HOST/NDS/nds_can_loop.c
+ *				LIB/EXTRA/implement/NDS/nds_can.c HOST/VCB/vcb.c
+ *				HOST/VCB/vcb_can.c HOST/VCB/vcb_tbt.c
+ *				LIB/MB90385/start/io_mb90385.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NDS/ndsCan.h>
+#include <VCB/vcb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NDS_CAN_LOOP_NODE, NDS_CAN_LOOP_PEER
+ *	@brief 		ID prefixes of node 0 and of the peer.
+ */
+#define NDS_CAN_LOOP_NODE		(0x10U)
+#define NDS_CAN_LOOP_PEER		(0x20U)
+
+/**
+ * 	@def		NDS_CAN_LOOP_IN, NDS_CAN_LOOP_OUT
+ *	@brief 		Region IDs of node 0 incoming and outgoing regions.
+ */
+#define NDS_CAN_LOOP_IN			(0U)
+#define NDS_CAN_LOOP_OUT		(1U)
+
+/**
+ * 	@def		NDS_CAN_LOOP_SIZE
+ *	@brief 		Region size in bytes (3 segments).
+ */
+#define NDS_CAN_LOOP_SIZE		(20U)
+
+/**
+ * 	@def		NDS_CAN_LOOP_POLL_US
+ *	@brief 		Poll period of node 0 in microseconds.
+ */
+#define NDS_CAN_LOOP_POLL_US	(1000UL)
+
+/**
+ * 	@def		NDS_CAN_LOOP_PEER_US
+ *	@brief 		Peer poll period in microseconds.
+ */
+#define NDS_CAN_LOOP_PEER_US	(10UL)
+
+/**
+ * 	@def		NDS_CAN_LOOP_DRAIN_US
+ *	@brief 		Peer reception time after its last transfer in microseconds.
+ */
+#define NDS_CAN_LOOP_DRAIN_US	(10000UL)
+
+/**
+ * 	@def		NDS_CAN_LOOP_BIT_RATE
+ *	@brief 		Bus bit rate (CAN_DEF_BUS_SPEED).
+ */
+#define NDS_CAN_LOOP_BIT_RATE	(1000000UL)
+
+/**
+ * 	@def		NDS_CAN_LOOP_NONE
+ *	@brief 		No segment expected by the peer (reassembly dropped).
+ */
+#define NDS_CAN_LOOP_NONE		(0xFFU)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for direction results.
+ */
+typedef struct {
+	T_uint32 received;
+	T_uint32 missing;
+	T_uint32 torn;
+	T_uint32 errors;
+	T_uint32 next;
+	T_uint32 firstMissing;
+} T_ndsCanLoopResult;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsCanLoopCount, ndsCanLoopDrop
+ *	@brief		Transfer count sent by the peer and transfer dropped on
+ *				purpose (polled build).
+ */
+static T_uint32 ndsCanLoopCount = 100UL;
+static T_uint32 ndsCanLoopDrop;
+
+/**
+ *	@var		ndsCanLoopIn, ndsCanLoopOut
+ *	@brief		Incoming and outgoing regions of node 0.
+ */
+static T_uint8 ndsCanLoopIn[NDS_CAN_LOOP_SIZE];
+static T_uint8 ndsCanLoopOut[NDS_CAN_LOOP_SIZE];
+
+/**
+ *	@var		ndsCanLoopValue
+ *	@brief		Transfer number written into the outgoing region.
+ */
+static T_uint32 ndsCanLoopValue;
+
+/**
+ *	@var		ndsCanLoopSent, ndsCanLoopEnd
+ *	@brief		Peer sent every transfer, and peer reception ended.
+ */
+static T_bit ndsCanLoopSent;
+static T_bit ndsCanLoopEnd;
+
+/**
+ *	@var		ndsCanLoopResults
+ *	@brief		Results of peer to node and node to peer transfers.
+ */
+static T_ndsCanLoopResult ndsCanLoopResults[2];
+
+/**
+ *	@var		ndsCanLoopStage, ndsCanLoopOffset
+ *	@brief		Peer reassembly of the outgoing region and next offset.
+ */
+static T_uint8 ndsCanLoopStage[NDS_CAN_LOOP_SIZE];
+static T_uint8 ndsCanLoopOffset = NDS_CAN_LOOP_NONE;
+
+#if NDS_CAN_CNX
+/* ----------------------------------------------------------------------------
+**	CAN Extension Stubs.
+*/
+
+/**
+ *	@var		ndsCanLoopCallbacks
+ *	@brief		Reception callbacks of node 0.
+ */
+static T_cnxRxCallback ndsCanLoopCallbacks[CAN_MB_SIZE];
+
+T_void setCNXRxCallback(T_canMsgBuf msgBuf, T_cnxRxCallback callback)
+{
+	ndsCanLoopCallbacks[msgBuf] = callback;
+}
+
+/**
+ *	@fn			T_void handleNDSCanLoopReception(T_void)
+ *	@brief 		Reception handler of node 0 (CNX reception ISR).
+ *	@param		.
+ *	@return		.
+ */
+static T_void handleNDSCanLoopReception(T_void)
+{
+	T_byte received = GetCAN_RCR() & GetCAN_RIER();
+	T_uint8 buffer;
+
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (EQU(ReadBit(received, buffer), 0U)) {
+			continue;
+		}
+		SetCAN_RCR((T_byte)~ToBit(buffer));
+		SetCAN_ROVRR((T_byte)~ToBit(buffer));
+		if (NEQ(ndsCanLoopCallbacks[buffer], NULL)) {
+			ndsCanLoopCallbacks[buffer](buffer, GetCAN_IDR(buffer),
+				(T_uint8)(GetCAN_DLCR(buffer) & 0x0FU), &IO_CANID.DTR[buffer]);
+		}
+	}
+}
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void fillNDSCanLoopRegion(T_uint8*, T_uint32)
+ *	@brief 		Writes a transfer number (2 bytes, little-endian) and the
+ *				pattern derived from it into a region.
+ *	@param[out]	pData		Region data.
+ *	@param[in]	transfer	Transfer number.
+ *	@return		.
+ */
+static T_void fillNDSCanLoopRegion(T_uint8* pData, T_uint32 transfer)
+{
+	T_uint8 index;
+
+	pData[0] = (T_uint8)transfer;
+	pData[1] = (T_uint8)(transfer >> 8U);
+	for (index = 2U; LT(index, NDS_CAN_LOOP_SIZE); index++) {
+		pData[index] = (T_uint8)((transfer * 31UL) + (index * 7U));
+	}
+}
+
+/**
+ *	@fn			T_void checkNDSCanLoopRegion(const T_uint8*, T_uint8)
+ *	@brief 		Checks a received region and counts missing incoming
+ *				transfers.
+ *	@param[in]	pData		Region data.
+ *	@param[in]	direction	Result index (NDS_CAN_LOOP_IN or NDS_CAN_LOOP_OUT).
+ *	@return		.
+ */
+static T_void checkNDSCanLoopRegion(const T_uint8* pData, T_uint8 direction)
+{
+	T_ndsCanLoopResult* result = &ndsCanLoopResults[direction];
+	T_uint8 expected[NDS_CAN_LOOP_SIZE];
+	T_uint32 transfer = (T_uint32)pData[0] | ((T_uint32)pData[1] << 8U);
+
+	fillNDSCanLoopRegion(expected, transfer);
+	if (NEQ(memcmp(pData, expected, NDS_CAN_LOOP_SIZE), 0)) {
+		result->torn++;
+		return;
+	}
+	/* transfer numbers wrap at 16 bits */
+	transfer |= result->next & ~0xFFFFUL;
+	if (LT(transfer, result->next)) {
+		transfer += 0x10000UL;
+	}
+	/* outgoing numbers skip the polls spent on each transfer */
+	if (EQU(direction, NDS_CAN_LOOP_IN) && GT(transfer, result->next)) {
+		if (EQU(result->missing, 0UL)) {
+			result->firstMissing = result->next;
+		}
+		result->missing += transfer - result->next;
+	}
+	result->next = transfer + 1UL;
+	result->received++;
+}
+
+/**
+ *	@fn			T_void setupNDSCanLoopBuffers(T_void)
+ *	@brief 		Sets up peer message buffers as initNDSCan does.
+ *	@param		.
+ *	@return		.
+ */
+static T_void setupNDSCanLoopBuffers(T_void)
+{
+	setupCANMessageBuffer(NDS_CAN_TX_BUFFER, CAN_ID_EXT_FORMAT, NDS_CAN_LOOP_PEER, 0U,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	setupCANAcceptanceMask(CAN_USE_AMR1, 0x00U, 0xFFFFU);
+	setupCANMessageBuffer(NDS_CAN_RX_BUFFER, CAN_ID_EXT_FORMAT, NDS_CAN_LOOP_NODE, 0U,
+		CAN_USE_AMR1, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	EnableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	EnableCANMsgBuff(NDS_CAN_RX_BUFFER);
+}
+
+/**
+ *	@fn			T_void receiveNDSCanLoopSegment(T_void)
+ *	@brief 		Reassembles a segment of the outgoing region of node 0.
+ *	@param		.
+ *	@return		.
+ */
+static T_void receiveNDSCanLoopSegment(T_void)
+{
+	T_ndsCanLoopResult* result = &ndsCanLoopResults[NDS_CAN_LOOP_OUT];
+	T_word suffix;
+	T_uint8 offset;
+	T_uint8 length;
+	T_uint8 index;
+
+	if (NOT(IsCANReceiveComp(NDS_CAN_RX_BUFFER))) {
+		return;
+	}
+	if (IS(IsCANReceiveOvr(NDS_CAN_RX_BUFFER))) {
+		SetCAN_ROVRR((T_byte)~ToBit(NDS_CAN_RX_BUFFER));
+		result->errors++;
+	}
+	suffix = (T_word)toIDBitOrder(GetCAN_IDR(NDS_CAN_RX_BUFFER));
+	offset = (T_uint8)suffix;
+	length = (T_uint8)MIN(GetCAN_DLCR(NDS_CAN_RX_BUFFER) & 0x0FU, CAN_MB_BYTE_SIZE);
+	if (EQU(offset, 0U)) {
+		ndsCanLoopOffset = 0U;
+	}
+	if (NEQ(suffix >> 8U, NDS_CAN_LOOP_OUT) || NEQ(offset, ndsCanLoopOffset)
+			|| GT(offset + length, NDS_CAN_LOOP_SIZE)) {
+		ndsCanLoopOffset = NDS_CAN_LOOP_NONE;
+		result->errors++;
+	} else {
+		for (index = 0U; LT(index, length); index++) {
+			ndsCanLoopStage[offset + index] = GetCAN_DTR_BYTE(NDS_CAN_RX_BUFFER, index);
+		}
+		ndsCanLoopOffset += length;
+		if (GEQ(ndsCanLoopOffset, NDS_CAN_LOOP_SIZE)) {
+			checkNDSCanLoopRegion(ndsCanLoopStage, NDS_CAN_LOOP_OUT);
+			ndsCanLoopOffset = NDS_CAN_LOOP_NONE;
+		}
+	}
+	SetCAN_RCR((T_byte)~ToBit(NDS_CAN_RX_BUFFER));
+}
+
+/**
+ *	@fn			T_void waitNDSCanLoopPeer(uint64_t)
+ *	@brief 		Lets the peer receive until a virtual time.
+ *	@param[in]	time	Virtual time (ns).
+ *	@return		.
+ */
+static T_void waitNDSCanLoopPeer(uint64_t time)
+{
+	do {
+		receiveNDSCanLoopSegment();
+		waitVCB(NDS_CAN_LOOP_PEER_US);
+	} while (LT(getVCBTime(), time));
+}
+
+/**
+ *	@fn			T_void sendNDSCanLoopSegment(const T_uint8*, T_uint8)
+ *	@brief 		Sends a segment of the incoming region of node 0 once the
+ *				transmit buffer is free.
+ *	@param[in]	pData		Region data.
+ *	@param[in]	offset		Segment offset in bytes.
+ *	@return		.
+ */
+static T_void sendNDSCanLoopSegment(const T_uint8* pData, T_uint8 offset)
+{
+	T_uint8 length = (T_uint8)MIN(NDS_CAN_LOOP_SIZE - offset, CAN_MB_BYTE_SIZE);
+	T_uint8 index;
+
+	while (NEQ(ReadBit(GetCAN_TREQR(), NDS_CAN_TX_BUFFER), 0U)) {
+		waitNDSCanLoopPeer(0ULL);
+	}
+	DisableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	for (index = 0U; LT(index, length); index += 2U) {
+		SetCAN_DTR_WORD(NDS_CAN_TX_BUFFER, index / 2U, (T_word)pData[offset + index]
+			| ((T_word)COND(LT(index + 1U, length), pData[offset + index + 1U], 0U) << 8U));
+	}
+	SetCAN_IDR(NDS_CAN_TX_BUFFER, toIDRegMap(formattedCANID(NDS_CAN_RX_BUFFER,
+		NDS_CAN_LOOP_PEER, GetWordNDSCanSuffix(NDS_CAN_LOOP_IN, offset))));
+	SetCAN_DLCR(NDS_CAN_TX_BUFFER, length);
+	EnableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	RequestCANTransmit(NDS_CAN_TX_BUFFER);
+}
+
+/**
+ *	@fn			T_void runNDSCanLoopPeer(T_void)
+ *	@brief 		Peer application.
+ *	@param		.
+ *	@return		.
+ */
+static T_void runNDSCanLoopPeer(T_void)
+{
+	T_uint8 data[NDS_CAN_LOOP_SIZE];
+	uint64_t slot = (NDS_CAN_LOOP_POLL_US * 1000ULL) / 2U;
+	T_uint32 transfer;
+	T_uint8 offset;
+
+	initCAN(CAN_DEF_BUS_SPEED, 0U, 0U);
+	setupNDSCanLoopBuffers();
+	startCAN();
+	for (transfer = 0UL; LT(transfer, ndsCanLoopCount); transfer++) {
+		fillNDSCanLoopRegion(data, transfer);
+		for (offset = 0U; LT(offset, NDS_CAN_LOOP_SIZE); offset += CAN_MB_BYTE_SIZE) {
+			/* polled: a segment per poll, but the last two of the dropped
+			   transfer in the same one; CNX: three segments per poll */
+			if (EQU(offset, 0U) || (NOT(NDS_CAN_CNX) && (NEQ(transfer, ndsCanLoopDrop)
+					|| NEQ(offset, 2U * CAN_MB_BYTE_SIZE)))) {
+				waitNDSCanLoopPeer(slot);
+				slot += NDS_CAN_LOOP_POLL_US * 1000ULL;
+			}
+			sendNDSCanLoopSegment(data, offset);
+		}
+	}
+	ndsCanLoopSent = TRUE;
+	waitNDSCanLoopPeer(getVCBTime() + (NDS_CAN_LOOP_DRAIN_US * 1000ULL));
+	ndsCanLoopEnd = TRUE;
+	for (;;) {
+		waitVCB(1000000UL);
+	}
+}
+
+/**
+ *	@fn			T_void runNDSCanLoopNode(T_void)
+ *	@brief 		Node application (NDS CAN under test).
+ *	@param		.
+ *	@return		.
+ */
+static T_void runNDSCanLoopNode(T_void)
+{
+	initCAN(CAN_DEF_BUS_SPEED, 0U, 0U);
+#if NDS_CAN_CNX
+	setVCBHandlers(handleNDSCanLoopReception, handleVCBTransmission);
+#endif
+	initNDSCan(NDS_CAN_LOOP_NODE, NDS_CAN_LOOP_PEER);
+	(T_void)addNDSCanRegion(NDS_CAN_LOOP_IN, ndsCanLoopIn, NDS_CAN_LOOP_SIZE, NDS_IN);
+	(T_void)addNDSCanRegion(NDS_CAN_LOOP_OUT, ndsCanLoopOut, NDS_CAN_LOOP_SIZE, NDS_OUT);
+	startCAN();
+	for (;;) {
+		if (IS(manageNDSCanIncoming())) {
+			checkNDSCanLoopRegion(ndsCanLoopIn, NDS_CAN_LOOP_IN);
+		}
+		/* region changes on every poll, copied at transfer start */
+		if (NOT(ndsCanLoopSent)) {
+			fillNDSCanLoopRegion(ndsCanLoopOut, ndsCanLoopValue++);
+			(T_void)manageNDSCanOutgoing();
+		}
+		waitVCB(NDS_CAN_LOOP_POLL_US);
+	}
+}
+
+/**
+ *	@fn			T_void runNDSCanLoop(T_uint8)
+ *	@brief 		Node entry point.
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void runNDSCanLoop(T_uint8 index)
+{
+	if (EQU(index, 0U)) {
+		runNDSCanLoopNode();
+	} else {
+		runNDSCanLoopPeer();
+	}
+}
+
+/**
+ *	@fn			T_void printNDSCanLoopResult(const char*, T_uint8, T_uint32)
+ *	@brief 		Prints the results of a direction.
+ *	@param[in]	name		Direction name.
+ *	@param[in]	direction	Result index.
+ *	@param[in]	sent		Transfers sent.
+ *	@return		.
+ */
+static T_void printNDSCanLoopResult(const char* name, T_uint8 direction, T_uint32 sent)
+{
+	const T_ndsCanLoopResult* result = &ndsCanLoopResults[direction];
+
+	printf("%s: %lu/%lu transfers, %lu missing", name, (unsigned long)result->received,
+		(unsigned long)sent, (unsigned long)result->missing);
+	if (NEQ(result->missing, 0UL)) {
+		printf(" (first %lu)", (unsigned long)result->firstMissing);
+	}
+	printf(", %lu torn, %lu errors\n", (unsigned long)result->torn,
+		(unsigned long)result->errors);
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	T_ndsCanLoopResult* in = &ndsCanLoopResults[NDS_CAN_LOOP_IN];
+	const T_ndsCanLoopResult* out = &ndsCanLoopResults[NDS_CAN_LOOP_OUT];
+	T_uint32 expected;
+	T_uint32 sent;
+	T_bit passed;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-n"), 0) && LT(arg + 1, argc)) {
+			ndsCanLoopCount = strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n COUNT]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (LT(ndsCanLoopCount, 10UL) || GT(ndsCanLoopCount, 0xFFFFUL)) {
+		fprintf(stderr, "count must be 10 to 65535\n");
+		return 2;
+	}
+	ndsCanLoopDrop = ndsCanLoopCount / 2UL;
+	runVCB(2U, runNDSCanLoop, NDS_CAN_LOOP_BIT_RATE,
+		(ndsCanLoopCount * 3UL) + (NDS_CAN_LOOP_DRAIN_US / 1000UL) + 100UL);
+	in->errors = countNDSCanErrors();
+	/* transfers lost after the last one received */
+	if (LT(in->next, ndsCanLoopCount)) {
+		if (EQU(in->missing, 0UL)) {
+			in->firstMissing = in->next;
+		}
+		in->missing += ndsCanLoopCount - in->next;
+	}
+	sent = countNDSCanUpdates(NDS_CAN_LOOP_OUT);
+	printf("%s reception, NDS CAN polled every %lu us, %u bytes (%u segments) per"
+		" transfer\n", COND(NDS_CAN_CNX, "CNX", "polled"), NDS_CAN_LOOP_POLL_US,
+		(unsigned)NDS_CAN_LOOP_SIZE, (unsigned)GetByteNDSCanSegments(NDS_CAN_LOOP_SIZE));
+	printNDSCanLoopResult("peer -> node", NDS_CAN_LOOP_IN, ndsCanLoopCount);
+	printNDSCanLoopResult("node -> peer", NDS_CAN_LOOP_OUT, sent);
+	/* polled: the overwritten segment drops exactly its transfer */
+	if (NDS_CAN_CNX) {
+		expected = ndsCanLoopCount;
+		passed = EQU(in->missing, 0UL) && EQU(in->errors, 0UL);
+	} else {
+		expected = ndsCanLoopCount - 1UL;
+		passed = EQU(in->missing, 1UL) && EQU(in->firstMissing, ndsCanLoopDrop)
+			&& NEQ(in->errors, 0UL);
+	}
+	passed = passed && IS(ndsCanLoopEnd) && EQU(in->received, expected)
+		&& EQU(in->torn, 0UL) && EQU(out->received, sent) && NEQ(sent, 0UL)
+		&& EQU(out->missing, 0UL) && EQU(out->torn, 0UL) && EQU(out->errors, 0UL);
+	if (NOT(passed)) {
+		printf("FAILED\n");
+	}
+
+	return NOT(passed);
+}
+
+/* END OF NDS_CAN_LOOP. */
@@ -0,0 +1,183 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Snapshot Stress Host Tool								 */
+/**
+ *	@file		NDS/nds_stress.c
+ *	@brief		This file contains the host tool checking that NDS snapshots
+ *				(NDS/ndsSnapshot.h) are never torn by a preempting writer.
+ *	@details	Usage: nds_stress [-n READS] [-u INTERVAL_US] <br>
+ *				A timer signal plays the reception ISR: every INTERVAL_US
+ *				(default 50) it calls manageNDSSnapshot, whose
+ *				manageNDSIncoming stub below rewrites the whole RX buffer byte
+ *				per byte with the update count, as message buffers are copied
+ *				one by one on the node. The main loop plays the application:
+ *				READS times (default 20M) it takes a snapshot with
+ *				readNDSSnapshot, then a plain copy of the same buffer, and
+ *				counts copies whose bytes differ (torn). <br>
+ *				Torn plain copies show that the writer did preempt the reader;
+ *				a torn snapshot is a failure. Failed snapshots (data kept
+ *				changing over NDS_SNAPSHOT_RETRIES attempts) are counted apart,
+ *				as they return FALSE and are never used. The exit status is 1
+ *				on any torn snapshot or if the writer never ran. Built with:
+ *				<br>
+ *				cc -O2 -I LIB/MB90385/include -I LIB/EXTRA/include -o
+ *				nds_stress HOST/NDS/nds_stress.c
+ *				LIB/EXTRA/implement/NDS/nds_snapshot.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#define _DEFAULT_SOURCE
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <NDS/ndsSnapshot.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NDS_STRESS_READS
+ *	@brief 		Default read count.
+ */
+#define NDS_STRESS_READS		(20000000UL)
+
+/**
+ * 	@def		NDS_STRESS_INTERVAL
+ *	@brief 		Default writer interval in microseconds.
+ */
+#define NDS_STRESS_INTERVAL		(50L)
+
+/**
+ * 	@def		NDS_STRESS_SIZE
+ *	@brief 		RX buffer size in bytes (four message buffers of 8 bytes).
+ */
+#define NDS_STRESS_SIZE			(32U)
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsStressRx
+ *	@brief		Incoming data (NDSAllocIncoming space of the node).
+ */
+static volatile T_uint8 ndsStressRx[NDS_STRESS_SIZE];
+
+/**
+ *	@var		ndsStressUpdates
+ *	@brief		Update count of the writer.
+ */
+static volatile sig_atomic_t ndsStressUpdates;
+
+/* ----------------------------------------------------------------------------
+**	Node Data Sharing Stubs.
+*/
+
+T_void manageNDSIncoming(T_uint8 rxWaitCount)
+{
+	T_uint8 index;
+
+	(T_void)rxWaitCount;
+	ndsStressUpdates++;
+	for (index = 0U; LT(index, NDS_STRESS_SIZE); index++) {
+		ndsStressRx[index] = (T_uint8)ndsStressUpdates;
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void writeNDSStress(int)
+ *	@brief 		Timer signal handler (reception ISR).
+ *	@param[in]	signal	Signal number.
+ *	@return		.
+ */
+static T_void writeNDSStress(int signal)
+{
+	(T_void)signal;
+	manageNDSSnapshot(0U);
+}
+
+/**
+ *	@fn			T_bit isNDSStressTorn(const T_uint8*)
+ *	@brief 		Checks if a copy mixes two updates.
+ *	@param[in]	pData	Copy of RX buffer.
+ *	@return		torn.
+ */
+static T_bit isNDSStressTorn(const T_uint8* pData)
+{
+	T_uint8 index;
+
+	for (index = 1U; LT(index, NDS_STRESS_SIZE); index++) {
+		if (NEQ(pData[index], pData[0])) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	struct itimerval timer;
+	T_uint8 copy[NDS_STRESS_SIZE];
+	unsigned long reads = NDS_STRESS_READS;
+	unsigned long read, torn = 0UL, failed = 0UL, tornPlain = 0UL;
+	long interval = NDS_STRESS_INTERVAL;
+	T_uint8 index;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if ((strcmp(argv[arg], "-n") == 0) && (arg + 1 < argc)) {
+			reads = strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-u") == 0) && (arg + 1 < argc)) {
+			interval = strtol(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n READS] [-u INTERVAL_US]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (interval <= 0L) {
+		interval = NDS_STRESS_INTERVAL;
+	}
+	timer.it_interval.tv_sec = interval / 1000000L;
+	timer.it_interval.tv_usec = interval % 1000000L;
+	timer.it_value = timer.it_interval;
+	signal(SIGALRM, writeNDSStress);
+	setitimer(ITIMER_REAL, &timer, NULL);
+	for (read = 0UL; read < reads; read++) {
+		if (NOT(readNDSSnapshot(copy, ndsStressRx, NDS_STRESS_SIZE))) {
+			failed++;
+		} else if (IS(isNDSStressTorn(copy))) {
+			torn++;
+		}
+		/* same read without snapshot */
+		for (index = 0U; LT(index, NDS_STRESS_SIZE); index++) {
+			copy[index] = ndsStressRx[index];
+		}
+		if (IS(isNDSStressTorn(copy))) {
+			tornPlain++;
+		}
+	}
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_REAL, &timer, NULL);
+	printf("reads %lu updates %ld\n", reads, (long)ndsStressUpdates);
+	printf("snapshot torn %lu failed %lu\n", torn, failed);
+	printf("plain copy torn %lu\n", tornPlain);
+	if (EQU(tornPlain, 0UL)) {
+		printf("warning: no plain copy was torn, raise -n or lower -u\n");
+	}
+
+	return NEQ(torn, 0UL) || EQU(ndsStressUpdates, 0);
+}
+
+/* END OF NDS_STRESS. */
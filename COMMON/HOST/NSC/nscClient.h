@@ -0,0 +1,390 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Host Client									     */
+/**
+ *	@file		NSC/nscClient.h
+ *	@brief		This file contains host-side NSC client types and functions for
+ *				talking to nodes in NSC binary mode (see NSC/nscBinary.h of the
+ *				library) over any byte stream.
+ *	@details	Plain C99 with fixed width types (stdint.h) so that it builds
+ *				with any host compiler. The byte stream (serial port, socket,
+ *				pipe) is given as read and write callbacks. Every request waits
+ *				for the response with the same sequence number; other frames are
+ *				skipped, except batch frames while a batch read is pending.
+ *	@note		The node must first be switched to binary mode by executing
+ *				NSC_BINARY_MODE_ADDRESS in text mode (through the host terminal
+ *				or tool already in use). Commands other than session commands
+ *				are answered with NSC_ERR_SESSION until a session is opened
+ *				(masterNSCClient or slaveNSCClient).
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NSC_CLIENT_H
+#define NSC_CLIENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+**	NSC Client Flags.
+*/
+
+/**
+ * 	@def		NSC_CLIENT_CHANNEL
+ *	@brief 		Channel ID of binary requests (NSC_BINARY_CHANNEL of the node).
+ */
+#ifndef NSC_CLIENT_CHANNEL
+#define NSC_CLIENT_CHANNEL		(0x30U)
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_BATCH_CHANNEL
+ *	@brief 		Channel ID of list responses (NSC_BATCH_CHANNEL of the node).
+ */
+#ifndef NSC_CLIENT_BATCH_CHANNEL
+#define NSC_CLIENT_BATCH_CHANNEL	(0x20U)
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_BATCH_ADDRESS
+ *	@brief 		Address of list read (NSC_BATCH_LIST_ADDRESS of the node).
+ */
+#ifndef NSC_CLIENT_BATCH_ADDRESS
+#define NSC_CLIENT_BATCH_ADDRESS	(0xFFFFFF00UL)
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_FRAME_SIZE
+ *	@brief 		Maximum encoded frame size accepted from the node.
+ */
+#ifndef NSC_CLIENT_FRAME_SIZE
+#define NSC_CLIENT_FRAME_SIZE	(256U)
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_WINDOW
+ *	@brief 		Maximum requests sent ahead of their responses (bounded by the
+ *				node SER receive buffer).
+ */
+#ifndef NSC_CLIENT_WINDOW
+#define NSC_CLIENT_WINDOW		(4U)
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_BLOCK_VALUES
+ *	@brief 		Value count per block request (NSC_BINARY_MAX_VALUES of the
+ *				node, 22 with default TLM_MAX_PAYLOAD).
+ */
+#ifndef NSC_CLIENT_BLOCK_VALUES
+#define NSC_CLIENT_BLOCK_VALUES	(22U)
+#endif
+
+#if (NSC_CLIENT_BLOCK_VALUES > 60U)
+#error "NSC_CLIENT_BLOCK_VALUES exceeds 60 (NSC_BINARY_MAX_VALUES limit of the node)"
+#endif
+
+/**
+ * 	@def		NSC_CLIENT_ERR_IO
+ *	@brief 		Stream closed or read timed out.
+ */
+#define NSC_CLIENT_ERR_IO		(-1)
+
+/**
+ * 	@def		NSC_CLIENT_ERR_STACK_EMPTY, NSC_CLIENT_ERR_BLOCK_SIZE
+ *	@brief 		Node error codes handled by block functions (NSC_ERR_STACK_EMPTY
+ *				and NSC_ERR_BLOCK_SIZE of the node).
+ */
+#define NSC_CLIENT_ERR_STACK_EMPTY	(1)
+#define NSC_CLIENT_ERR_BLOCK_SIZE	(7)
+
+/* ----------------------------------------------------------------------------
+**	NSC Client Types.
+*/
+
+/**
+ * 	@brief		Command codes (same order as T_nscCommand of the node).
+ */
+typedef enum {
+	NSC_CLIENT_INV,
+	NSC_CLIENT_ERR,
+	NSC_CLIENT_EXE,
+	NSC_CLIENT_LNK,
+	NSC_CLIENT_PSH,
+	NSC_CLIENT_POP,
+	NSC_CLIENT_TXD,
+	NSC_CLIENT_RXD,
+	NSC_CLIENT_RC0,
+	NSC_CLIENT_RC1,
+	NSC_CLIENT_RC2,
+	NSC_CLIENT_RC3,
+	NSC_CLIENT_MSR,
+	NSC_CLIENT_SLV,
+	NSC_CLIENT_REL
+} T_nscClientCommand;
+
+/**
+ * 	@brief		Type tags (same order as T_nscRepType of the node).
+ */
+typedef enum {
+	NSC_CLIENT_SINT,
+	NSC_CLIENT_UINT,
+	NSC_CLIENT_UHEX,
+	NSC_CLIENT_FLOAT
+} T_nscClientType;
+
+/**
+ *	@brief 		Callback type for byte stream writing.
+ *	@param		context		Stream context.
+ *	@param		pBuff		Bytes to write.
+ *	@param		len			Byte count.
+ *	@return		bytes written (negative on failure).
+ */
+typedef long (*T_nscClientWrite)(void* context, const uint8_t* pBuff, size_t len);
+
+/**
+ *	@brief 		Callback type for byte stream reading.
+ *	@param		context		Stream context.
+ *	@param		pBuff		Buffer to fill.
+ *	@param		len			Buffer size.
+ *	@return		bytes read (zero or negative on timeout or failure).
+ */
+typedef long (*T_nscClientRead)(void* context, uint8_t* pBuff, size_t len);
+
+/**
+ *	@brief		Data structure for NSC parameter data of a response.
+ */
+typedef struct {
+	T_nscClientType type;
+	union {
+		int32_t si32;
+		uint32_t ui32;
+		float fl32;
+	} value;
+} T_nscClientValue;
+
+/**
+ *	@brief		Data structure for NSC client.
+ */
+typedef struct {
+	T_nscClientWrite write;
+	T_nscClientRead read;
+	void* context;
+	uint8_t sequence;
+	uint8_t tag;
+	/* received frame */
+	uint8_t rx[NSC_CLIENT_FRAME_SIZE];
+	size_t rxLength;
+	/* statistics */
+	unsigned long requests;
+	unsigned long skipped;
+} T_nscClient;
+
+/* ----------------------------------------------------------------------------
+**	NSC Client Functions.
+*/
+
+/**
+ *	@fn			void initNSCClient(T_nscClient*, T_nscClientWrite, T_nscClientRead, void*)
+ *	@brief 		Initialize client on a byte stream.
+ *	@param[out]	client		NSC client.
+ *	@param[in]	write		Stream writing callback.
+ *	@param[in]	read		Stream reading callback (should time out).
+ *	@param[in]	context		Stream context passed to callbacks.
+ *	@return		.
+ */
+extern void initNSCClient(T_nscClient* client, T_nscClientWrite write,
+	T_nscClientRead read, void* context);
+
+/**
+ *	@fn			int requestNSCClient(T_nscClient*, T_nscClientCommand, T_nscClientType,
+ *					uint32_t, uint32_t, T_nscClientValue*)
+ *	@brief 		Sends a request and waits for its response.
+ *	@param		client		NSC client.
+ *	@param[in]	command		Command.
+ *	@param[in]	type		Type tag of value.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Parameter data (raw 32 bits).
+ *	@param[out]	response	Response data (or NULL).
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int requestNSCClient(T_nscClient* client, T_nscClientCommand command,
+	T_nscClientType type, uint32_t address, uint32_t value, T_nscClientValue* response);
+
+/**
+ *	@fn			int pushNSCClientInteger(T_nscClient*, int32_t)
+ *	@brief 		Pushes an integer on the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	value		Value.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int pushNSCClientInteger(T_nscClient* client, int32_t value);
+
+/**
+ *	@fn			int pushNSCClientFloat(T_nscClient*, float)
+ *	@brief 		Pushes a float on the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	value		Value.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int pushNSCClientFloat(T_nscClient* client, float value);
+
+/**
+ *	@fn			int popNSCClient(T_nscClient*, T_nscClientType, T_nscClientValue*)
+ *	@brief 		Pops a value from the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[out]	value		Value.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int popNSCClient(T_nscClient* client, T_nscClientType type, T_nscClientValue* value);
+
+/**
+ *	@fn			int executeNSCClient(T_nscClient*, uint32_t)
+ *	@brief 		Executes a function of the node.
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int executeNSCClient(T_nscClient* client, uint32_t address);
+
+/**
+ *	@fn			int storeNSCClient(T_nscClient*, uint32_t, const T_nscClientValue*)
+ *	@brief 		Transmits a value to a node address (NSC_CMD_TXD).
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Value and type.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int storeNSCClient(T_nscClient* client, uint32_t address, const T_nscClientValue* value);
+
+/**
+ *	@fn			int fetchNSCClient(T_nscClient*, uint32_t, T_nscClientValue*)
+ *	@brief 		Requests the value of a node address (NSC_CMD_RXD).
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@param[out]	value		Value and type.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int fetchNSCClient(T_nscClient* client, uint32_t address, T_nscClientValue* value);
+
+/**
+ *	@fn			int pushNSCClientBlock(T_nscClient*, T_nscClientType,
+ *					const T_nscClientValue*, size_t)
+ *	@brief 		Pushes values on the node stack in order (one block request per
+ *				NSC_CLIENT_BLOCK_VALUES values).
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[in]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int pushNSCClientBlock(T_nscClient* client, T_nscClientType type,
+	const T_nscClientValue* values, size_t count);
+
+/**
+ *	@fn			int popNSCClientBlock(T_nscClient*, T_nscClientType, T_nscClientValue*,
+ *					size_t, size_t*)
+ *	@brief 		Pops up to count values from the node stack, top first, one block
+ *				request per NSC_CLIENT_BLOCK_VALUES values.
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[out]	values		Values in pushing order (oldest first).
+ *	@param[in]	count		Maximum value count.
+ *	@param[out]	popped		Value count popped (fewer if the stack emptied).
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int popNSCClientBlock(T_nscClient* client, T_nscClientType type,
+	T_nscClientValue* values, size_t count, size_t* popped);
+
+/**
+ *	@fn			int storeNSCClientBlock(T_nscClient*, uint32_t, uint16_t,
+ *					const T_nscClientValue*, size_t)
+ *	@brief 		Copies values into array elements of the node without going
+ *				through the stack (one block request per NSC_CLIENT_BLOCK_VALUES
+ *				values, so the array handler runs once per request).
+ *	@param		client		NSC client.
+ *	@param[in]	address		Array address.
+ *	@param[in]	offset		First element.
+ *	@param[in]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int storeNSCClientBlock(T_nscClient* client, uint32_t address, uint16_t offset,
+	const T_nscClientValue* values, size_t count);
+
+/**
+ *	@fn			int fetchNSCClientBlock(T_nscClient*, uint32_t, uint16_t,
+ *					T_nscClientValue*, size_t)
+ *	@brief 		Reads array elements of the node in a single request (answered
+ *				in one frame per NSC_BINARY_MAX_VALUES values of the node).
+ *	@param		client		NSC client.
+ *	@param[in]	address		Array address.
+ *	@param[in]	offset		First element.
+ *	@param[out]	values		Values and types.
+ *	@param[in]	count		Value count (up to 65535).
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int fetchNSCClientBlock(T_nscClient* client, uint32_t address, uint16_t offset,
+	T_nscClientValue* values, size_t count);
+
+/**
+ *	@fn			int fetchNSCClientList(T_nscClient*, const uint32_t*, size_t,
+ *					T_nscClientValue*, int*)
+ *	@brief 		Requests the values of several node addresses in a single
+ *				transaction (batch list read of the node).
+ *	@param		client		NSC client.
+ *	@param[in]	addresses	Addresses.
+ *	@param[in]	count		Address count (up to NSC_BATCH_MAX_ENTRIES of node).
+ *	@param[out]	values		Values and types.
+ *	@param[out]	errors		Error code per address (zero on success).
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int fetchNSCClientList(T_nscClient* client, const uint32_t* addresses,
+	size_t count, T_nscClientValue* values, int* errors);
+
+/**
+ *	@fn			int masterNSCClient(T_nscClient*)
+ *	@brief 		Opens a master session (NSC_CMD_MSR), clearing the node stack.
+ *	@param		client		NSC client.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int masterNSCClient(T_nscClient* client);
+
+/**
+ *	@fn			int slaveNSCClient(T_nscClient*)
+ *	@brief 		Opens a slave session (NSC_CMD_SLV), clearing the node stack.
+ *	@param		client		NSC client.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int slaveNSCClient(T_nscClient* client);
+
+/**
+ *	@fn			int releaseNSCClient(T_nscClient*)
+ *	@brief 		Releases the session and switches the node back to text mode.
+ *	@param		client		NSC client.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+extern int releaseNSCClient(T_nscClient* client);
+
+#endif /* NSC_CLIENT_H. */
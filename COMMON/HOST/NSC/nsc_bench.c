@@ -0,0 +1,875 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Loopback Benchmark Host Tool					 */
+/**
+ *	@file		NSC/nsc_bench.c
+ *	@brief		This file contains the host tool measuring NSC binary mode
+ *				through the node code and the host client over a loopback.
+ *	@details	Usage: nsc_bench [-n COUNT] [-p] [-b FILE] [-g FILE [-t PERCENT]]
+ *				<br>
+ *				The node (nsc_binary.c, nsc_batch.c and nsc_api_table.c of the
+ *				library, with the dispatch table below) runs in a child process
+ *				fed by SER stubs through pipes, or through a raw pseudo
+ *				terminal with -p (the path of a serial port), the host client
+ *				(nscClient.h) in the parent. The client first checks that
+ *				requests are refused outside of session, then opens a master
+ *				session. A float variable is stored and fetched back. Block
+ *				operations move NSC_BENCH_BLOCK array elements or stack values
+ *				through the block functions of the client. Each operation is
+ *				run COUNT times (default 10000) and reported as operations per
+ *				second, latency percentiles (50, 99, maximum) and line bytes
+ *				per operation. The loopback has no line rate, so figures are
+ *				the protocol and code cost: at 38461 baud the line adds 0.26 ms
+ *				per byte. <br>
+ *				Text mode is not measured: its parser and responder
+ *				(manageNSCRequest, manageNSCResponse) only ship in the EXTRA
+ *				library archives, which do not link on host (see nsc_host.c),
+ *				and the tree documents no text line syntax a client could use
+ *				to drive a target through -p instead. <br>
+ *				-b writes the operations per second to FILE as a baseline ("name
+ *				rate" lines); -g reads such a FILE and fails any operation
+ *				slower than the baseline by more than PERCENT (default 25). The
+ *				exit status is 1 on any value mismatch or protocol error, 3 on
+ *				a regression. Built with: <br>
+ *				cc -DTLM_STX=1 -I LIB/MB90385/include -I LIB/EXTRA/include -I
+ *				HOST -o nsc_bench HOST/NSC/nsc_bench.c HOST/NSC/nsc_client.c
+ *				HOST/NSC/nsc_host.c LIB/EXTRA/implement/NSC/nsc_binary.c
+ *				LIB/EXTRA/implement/NSC/nsc_batch.c
+ *				LIB/EXTRA/implement/NSC/nsc_api_table.c
+ *				LIB/EXTRA/implement/TLM/tlm.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#define _XOPEN_SOURCE 700
+#define _DEFAULT_SOURCE
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <NSC/nscClient.h>
+#include <NSC/nscBinary.h>
+#include <NSC/nscBatch.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NSC_BENCH_COUNT
+ *	@brief 		Default operation count.
+ */
+#define NSC_BENCH_COUNT			(10000UL)
+
+/**
+ * 	@def		NSC_BENCH_LIST
+ *	@brief 		Address count of list read.
+ */
+#define NSC_BENCH_LIST			(16U)
+
+/**
+ * 	@def		NSC_BENCH_BLOCK
+ *	@brief 		Element count of block operations.
+ */
+#define NSC_BENCH_BLOCK			(64U)
+
+/**
+ * 	@def		NSC_BENCH_RX_SIZE
+ *	@brief 		SER reception buffer size of the node.
+ */
+#define NSC_BENCH_RX_SIZE		(256U)
+
+/**
+ * 	@def		NSC_BENCH_TIMEOUT_MS
+ *	@brief 		Client read timeout.
+ */
+#define NSC_BENCH_TIMEOUT_MS	(1000)
+
+/**
+ * 	@def		NSC_BENCH_TOLERANCE
+ *	@brief 		Default regression tolerance in percent of baseline rate.
+ */
+#define NSC_BENCH_TOLERANCE		(25.0)
+
+/**
+ * 	@def		NSC_BENCH_NAME_SIZE
+ *	@brief 		Operation name buffer size of baseline files.
+ */
+#define NSC_BENCH_NAME_SIZE		(32U)
+
+/**
+ * 	@def		NSC_BENCH_EXECUTE
+ *	@brief 		Address of executable entry.
+ */
+#define NSC_BENCH_EXECUTE		(0x0010UL)
+
+/**
+ * 	@def		NSC_BENCH_INTEGER, NSC_BENCH_FLOAT, NSC_BENCH_ARRAY,
+ *				NSC_BENCH_BLOCK_ARRAY
+ *	@brief 		Addresses of variables (list read elements follow
+ *				NSC_BENCH_ARRAY) and of the block array.
+ */
+#define NSC_BENCH_INTEGER		(0x0100UL)
+#define NSC_BENCH_FLOAT			(0x0102UL)
+#define NSC_BENCH_ARRAY			(0x0200UL)
+#define NSC_BENCH_BLOCK_ARRAY	(0x0300UL)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for the client side of the loopback.
+ */
+typedef struct {
+	int in;
+	int out;
+	uint8_t buffer[4096];
+	size_t head;
+	size_t count;
+	unsigned long written;
+	unsigned long read;
+} T_nscBenchStream;
+
+/**
+ *	@brief		Callback type of a measured operation.
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+typedef int (*T_nscBenchOperation)(T_nscClient* client, unsigned long index);
+
+/**
+ *	@brief		Data structure for a measured operation.
+ */
+typedef struct {
+	const char* name;
+	T_nscBenchOperation operation;
+	double rate;
+} T_nscBenchEntry;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		nscBenchInteger, nscBenchFloat, nscBenchArray, nscBenchBlock
+ *	@brief		Node variables.
+ */
+static T_sint16 nscBenchInteger = -3;
+static T_float32 nscBenchFloat = 1.5F;
+static T_uint32 nscBenchArray[NSC_BENCH_LIST];
+static T_uint16 nscBenchBlock[NSC_BENCH_BLOCK];
+
+/**
+ *	@var		nscBenchRx, nscBenchRxHead, nscBenchRxCount
+ *	@brief		Node SER reception buffer.
+ */
+static T_uint8 nscBenchRx[NSC_BENCH_RX_SIZE];
+static T_uint16 nscBenchRxHead, nscBenchRxCount;
+
+/**
+ *	@var		nscBenchNodeOut
+ *	@brief		Node SER transmission descriptor.
+ */
+static int nscBenchNodeOut;
+
+/**
+ *	@var		nscBenchAddresses
+ *	@brief		Addresses of list read.
+ */
+static uint32_t nscBenchAddresses[NSC_BENCH_LIST];
+
+/* ----------------------------------------------------------------------------
+**	Node Dispatch Table.
+*/
+
+/**
+ *	@fn			T_nscErrCode executeNSCBench(T_nscAddress)
+ *	@brief 		Executable entry (does nothing).
+ *	@param[in]	address 	Address of command.
+ *	@return		error code.
+ */
+static T_nscErrCode executeNSCBench(T_nscAddress address)
+{
+	(T_void)address;
+
+	return NSC_ERR_NONE;
+}
+
+#define NSC_BENCH_ELEMENT(INDEX) \
+	NSC_VARIABLE(NSC_BENCH_ARRAY + (INDEX), nscBenchArray[INDEX], NSC_UINT, NSC_ACC_RW)
+
+NSC_TABLE_BEGIN
+	NSC_FUNCTION(NSC_BENCH_EXECUTE, executeNSCBench),
+	NSC_VARIABLE(NSC_BENCH_INTEGER, nscBenchInteger, NSC_SINT, NSC_ACC_RW),
+	NSC_VARIABLE(NSC_BENCH_FLOAT, nscBenchFloat, NSC_FLOAT, NSC_ACC_RW),
+	NSC_BENCH_ELEMENT(0U), NSC_BENCH_ELEMENT(1U), NSC_BENCH_ELEMENT(2U),
+	NSC_BENCH_ELEMENT(3U), NSC_BENCH_ELEMENT(4U), NSC_BENCH_ELEMENT(5U),
+	NSC_BENCH_ELEMENT(6U), NSC_BENCH_ELEMENT(7U), NSC_BENCH_ELEMENT(8U),
+	NSC_BENCH_ELEMENT(9U), NSC_BENCH_ELEMENT(10U), NSC_BENCH_ELEMENT(11U),
+	NSC_BENCH_ELEMENT(12U), NSC_BENCH_ELEMENT(13U), NSC_BENCH_ELEMENT(14U),
+	NSC_BENCH_ELEMENT(15U),
+	NSC_ARRAY(NSC_BENCH_BLOCK_ARRAY, nscBenchBlock, NSC_UINT, NSC_ACC_RW),
+	NSC_BATCH_FUNCTIONS,
+	NSC_BINARY_FUNCTIONS
+NSC_TABLE_END
+
+/* ----------------------------------------------------------------------------
+**	Node Serial Stubs.
+*/
+
+T_uint8 countSERReceived(T_void)
+{
+	return (T_uint8)MIN(nscBenchRxCount, 255U);
+}
+
+T_uint8 readSERBytes(T_uint8* pBuff, T_uint8 len, T_uint8 term, T_bit checkTerm)
+{
+	T_uint8 count = 0U;
+
+	(T_void)term;
+	(T_void)checkTerm;
+	while (LT(count, len) && NEQ(nscBenchRxCount, 0U)) {
+		pBuff[count++] = nscBenchRx[nscBenchRxHead];
+		nscBenchRxHead = (T_uint16)((nscBenchRxHead + 1U) % NSC_BENCH_RX_SIZE);
+		nscBenchRxCount--;
+	}
+
+	return count;
+}
+
+T_uint16 writeSTXBytes(const T_uint8* pBuff, T_uint16 len)
+{
+	T_uint16 offset = 0U;
+	ssize_t written;
+
+	while (LT(offset, len)) {
+		written = write(nscBenchNodeOut, pBuff + offset, len - offset);
+		if (LEQ(written, 0)) {
+			break;
+		}
+		offset += (T_uint16)written;
+	}
+
+	return offset;
+}
+
+T_uint16 countSTXFree(T_void)
+{
+	return STX_BUFFER_SIZE;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void runNSCBenchNode(int, int)
+ *	@brief 		Runs the node until its input is closed.
+ *	@param[in]	in		Node SER reception descriptor.
+ *	@param[in]	out		Node SER transmission descriptor.
+ *	@return		.
+ */
+static T_void runNSCBenchNode(int in, int out)
+{
+	T_uint8 buffer[NSC_BENCH_RX_SIZE];
+	T_uint16 tail;
+	ssize_t count;
+	ssize_t index;
+
+	nscBenchNodeOut = out;
+	for (index = 0; LT(index, NSC_BENCH_LIST); index++) {
+		nscBenchArray[index] = 1000UL + (T_uint32)index;
+	}
+	for (index = 0; LT(index, NSC_BENCH_BLOCK); index++) {
+		nscBenchBlock[index] = (T_uint16)(2000U + index);
+	}
+	/* binary mode as switched in text mode, session left to the client */
+	initNSC();
+	(T_void)NSCExecute(NSC_BINARY_MODE_ADDRESS);
+	for (;;) {
+		count = read(in, buffer, NSC_BENCH_RX_SIZE - nscBenchRxCount);
+		if (LEQ(count, 0)) {
+			break;
+		}
+		for (index = 0; LT(index, count); index++) {
+			tail = (T_uint16)((nscBenchRxHead + nscBenchRxCount) % NSC_BENCH_RX_SIZE);
+			nscBenchRx[tail] = buffer[index];
+			nscBenchRxCount++;
+		}
+		manageNSCBinaryRequest();
+	}
+}
+
+/**
+ *	@fn			long writeNSCBenchStream(void*, const uint8_t*, size_t)
+ *	@brief 		Client stream writing callback.
+ *	@param		context		Stream.
+ *	@param[in]	pBuff		Bytes to write.
+ *	@param[in]	len			Byte count.
+ *	@return		bytes written.
+ */
+static long writeNSCBenchStream(void* context, const uint8_t* pBuff, size_t len)
+{
+	T_nscBenchStream* stream = (T_nscBenchStream*)context;
+	size_t offset = 0U;
+	ssize_t written;
+
+	while (offset < len) {
+		written = write(stream->out, pBuff + offset, len - offset);
+		if (written <= 0) {
+			return -1;
+		}
+		offset += (size_t)written;
+	}
+	stream->written += len;
+
+	return (long)len;
+}
+
+/**
+ *	@fn			long readNSCBenchStream(void*, uint8_t*, size_t)
+ *	@brief 		Client stream reading callback (buffered, with timeout).
+ *	@param		context		Stream.
+ *	@param[out]	pBuff		Buffer to fill.
+ *	@param[in]	len			Buffer size.
+ *	@return		bytes read.
+ */
+static long readNSCBenchStream(void* context, uint8_t* pBuff, size_t len)
+{
+	T_nscBenchStream* stream = (T_nscBenchStream*)context;
+	struct pollfd fd;
+	ssize_t count;
+	size_t copied;
+
+	if (stream->count == 0U) {
+		fd.fd = stream->in;
+		fd.events = POLLIN;
+		if (poll(&fd, 1, NSC_BENCH_TIMEOUT_MS) <= 0) {
+			return 0;
+		}
+		count = read(stream->in, stream->buffer, sizeof(stream->buffer));
+		if (count <= 0) {
+			return 0;
+		}
+		stream->head = 0U;
+		stream->count = (size_t)count;
+		stream->read += (unsigned long)count;
+	}
+	copied = (len < stream->count) ? len : stream->count;
+	memcpy(pBuff, stream->buffer + stream->head, copied);
+	stream->head += copied;
+	stream->count -= copied;
+
+	return (long)copied;
+}
+
+/**
+ *	@fn			int compareNSCBenchLatency(const void*, const void*)
+ *	@brief 		Orders latencies.
+ *	@param[in]	left	Latency.
+ *	@param[in]	right	Latency.
+ *	@return		order.
+ */
+static int compareNSCBenchLatency(const void* left, const void* right)
+{
+	double difference = *(const double*)left - *(const double*)right;
+
+	return (difference > 0.0) - (difference < 0.0);
+}
+
+/**
+ *	@fn			double getNSCBenchMicros(T_void)
+ *	@brief 		Gets monotonic time in microseconds.
+ *	@param		.
+ *	@return		time.
+ */
+static double getNSCBenchMicros(T_void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec * 1e6 + (double)now.tv_nsec / 1e3;
+}
+
+/**
+ *	@fn			int operateNSCBenchFetch(T_nscClient*, unsigned long)
+ *	@brief 		Reads a variable (NSC_CMD_RXD).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchFetch(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue value;
+	int status = fetchNSCClient(client, NSC_BENCH_ARRAY + (index % NSC_BENCH_LIST), &value);
+
+	return (status != 0) ? status
+		: (value.value.ui32 != 1000UL + (index % NSC_BENCH_LIST));
+}
+
+/**
+ *	@fn			int operateNSCBenchStore(T_nscClient*, unsigned long)
+ *	@brief 		Writes a variable (NSC_CMD_TXD).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchStore(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue value;
+
+	value.type = NSC_CLIENT_SINT;
+	value.value.si32 = (int32_t)(index % 1000UL);
+
+	return storeNSCClient(client, NSC_BENCH_INTEGER, &value);
+}
+
+/**
+ *	@fn			int operateNSCBenchFloat(T_nscClient*, unsigned long)
+ *	@brief 		Writes and reads back a float variable (NSC_CMD_TXD,
+ *				NSC_CMD_RXD).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchFloat(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue value;
+	float expected = (float)(index % 1000UL) * 0.5F - 1.25F;
+	int status;
+
+	value.type = NSC_CLIENT_FLOAT;
+	value.value.fl32 = expected;
+	status = storeNSCClient(client, NSC_BENCH_FLOAT, &value);
+	if (status == 0) {
+		status = fetchNSCClient(client, NSC_BENCH_FLOAT, &value);
+	}
+
+	return (status != 0) ? status
+		: ((value.type != NSC_CLIENT_FLOAT) || (value.value.fl32 != expected));
+}
+
+/**
+ *	@fn			int operateNSCBenchStack(T_nscClient*, unsigned long)
+ *	@brief 		Pushes and pops a value (NSC_CMD_PSH, NSC_CMD_POP).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchStack(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue value;
+	int status = pushNSCClientInteger(client, (int32_t)index);
+
+	if (status == 0) {
+		status = popNSCClient(client, NSC_CLIENT_SINT, &value);
+	}
+
+	return (status != 0) ? status : (value.value.si32 != (int32_t)index);
+}
+
+/**
+ *	@fn			int operateNSCBenchExecute(T_nscClient*, unsigned long)
+ *	@brief 		Executes a function (NSC_CMD_EXE).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchExecute(T_nscClient* client, unsigned long index)
+{
+	(void)index;
+
+	return executeNSCClient(client, NSC_BENCH_EXECUTE);
+}
+
+/**
+ *	@fn			int operateNSCBenchList(T_nscClient*, unsigned long)
+ *	@brief 		Reads NSC_BENCH_LIST variables at once (batch list read).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchList(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue values[NSC_BENCH_LIST];
+	int errors[NSC_BENCH_LIST];
+	int status = fetchNSCClientList(client, nscBenchAddresses, NSC_BENCH_LIST, values, errors);
+
+	(void)index;
+	for (index = 0UL; (status == 0) && (index < NSC_BENCH_LIST); index++) {
+		status = (errors[index] != 0) || (values[index].value.ui32 != 1000UL + index);
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int operateNSCBenchFetchBlock(T_nscClient*, unsigned long)
+ *	@brief 		Reads NSC_BENCH_BLOCK array elements (NSC_CMD_RXD block).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchFetchBlock(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue values[NSC_BENCH_BLOCK];
+	int status = fetchNSCClientBlock(client, NSC_BENCH_BLOCK_ARRAY, 0U, values, NSC_BENCH_BLOCK);
+
+	(void)index;
+	for (index = 0UL; (status == 0) && (index < NSC_BENCH_BLOCK); index++) {
+		status = (values[index].value.ui32 != 2000UL + index);
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int operateNSCBenchStoreBlock(T_nscClient*, unsigned long)
+ *	@brief 		Writes NSC_BENCH_BLOCK array elements (NSC_CMD_TXD blocks).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchStoreBlock(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue values[NSC_BENCH_BLOCK];
+	unsigned long element;
+
+	for (element = 0UL; element < NSC_BENCH_BLOCK; element++) {
+		values[element].type = NSC_CLIENT_UINT;
+		values[element].value.ui32 = (uint32_t)((index + element) % 60000UL);
+	}
+
+	return storeNSCClientBlock(client, NSC_BENCH_BLOCK_ARRAY, 0U, values, NSC_BENCH_BLOCK);
+}
+
+/**
+ *	@fn			int operateNSCBenchStackBlock(T_nscClient*, unsigned long)
+ *	@brief 		Pushes and pops NSC_BENCH_BLOCK values (NSC_CMD_PSH and
+ *				NSC_CMD_POP blocks).
+ *	@param		client		NSC client.
+ *	@param[in]	index		Operation number.
+ *	@return		zero on success.
+ */
+static int operateNSCBenchStackBlock(T_nscClient* client, unsigned long index)
+{
+	T_nscClientValue values[NSC_BENCH_BLOCK];
+	unsigned long element;
+	size_t popped = 0U;
+	int status;
+
+	for (element = 0UL; element < NSC_BENCH_BLOCK; element++) {
+		values[element].value.si32 = (int32_t)(index + element);
+	}
+	status = pushNSCClientBlock(client, NSC_CLIENT_SINT, values, NSC_BENCH_BLOCK);
+	if (status == 0) {
+		memset(values, 0, sizeof(values));
+		status = popNSCClientBlock(client, NSC_CLIENT_SINT, values, NSC_BENCH_BLOCK, &popped);
+	}
+	status |= (popped != NSC_BENCH_BLOCK);
+	for (element = 0UL; (status == 0) && (element < NSC_BENCH_BLOCK); element++) {
+		status = (values[element].value.si32 != (int32_t)(index + element));
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int checkNSCBenchBlocks(T_nscClient*, unsigned long)
+ *	@brief 		Checks the last block store and a pop beyond the stack depth
+ *				ending at a block request boundary.
+ *	@param		client		NSC client.
+ *	@param[in]	count		Operation count.
+ *	@return		zero on success.
+ */
+static int checkNSCBenchBlocks(T_nscClient* client, unsigned long count)
+{
+	T_nscClientValue values[NSC_BENCH_BLOCK + NSC_CLIENT_BLOCK_VALUES];
+	unsigned long element;
+	size_t depth = (NSC_BENCH_BLOCK / NSC_CLIENT_BLOCK_VALUES) * NSC_CLIENT_BLOCK_VALUES;
+	size_t popped = 0U;
+	int status = fetchNSCClientBlock(client, NSC_BENCH_BLOCK_ARRAY, 0U, values, NSC_BENCH_BLOCK);
+
+	for (element = 0UL; (status == 0) && (element < NSC_BENCH_BLOCK); element++) {
+		status = (values[element].value.ui32 != (count - 1UL + element) % 60000UL);
+	}
+	for (element = 0UL; element < depth; element++) {
+		values[element].value.si32 = (int32_t)element;
+	}
+	if (status == 0) {
+		status = pushNSCClientBlock(client, NSC_CLIENT_SINT, values, depth);
+	}
+	if (status == 0) {
+		status = popNSCClientBlock(client, NSC_CLIENT_SINT, values, depth + 1U, &popped);
+	}
+	status |= (popped != depth);
+	for (element = 0UL; (status == 0) && (element < depth); element++) {
+		status = (values[element].value.si32 != (int32_t)element);
+	}
+
+	return status;
+}
+
+/**
+ *	@var		nscBenchEntries
+ *	@brief		Measured operations.
+ */
+static T_nscBenchEntry nscBenchEntries[] = {
+	{"fetch", operateNSCBenchFetch, 0.0},
+	{"store", operateNSCBenchStore, 0.0},
+	{"float", operateNSCBenchFloat, 0.0},
+	{"push+pop", operateNSCBenchStack, 0.0},
+	{"execute", operateNSCBenchExecute, 0.0},
+	{"list16", operateNSCBenchList, 0.0},
+	{"fetch64", operateNSCBenchFetchBlock, 0.0},
+	{"store64", operateNSCBenchStoreBlock, 0.0},
+	{"stack64", operateNSCBenchStackBlock, 0.0}
+};
+
+/**
+ *	@fn			int measureNSCBench(T_nscClient*, T_nscBenchStream*, T_nscBenchEntry*,
+ *					unsigned long, double*)
+ *	@brief 		Runs an operation, keeps its rate and prints its figures.
+ *	@param		client		NSC client.
+ *	@param		stream		Client stream.
+ *	@param		entry		Operation.
+ *	@param[in]	count		Operation count.
+ *	@param		latencies	Latency buffer (count entries).
+ *	@return		zero on success.
+ */
+static int measureNSCBench(T_nscClient* client, T_nscBenchStream* stream,
+	T_nscBenchEntry* entry, unsigned long count, double* latencies)
+{
+	unsigned long bytes = stream->written + stream->read;
+	double start = getNSCBenchMicros();
+	double total;
+	unsigned long index;
+	int status;
+
+	for (index = 0UL; index < count; index++) {
+		latencies[index] = getNSCBenchMicros();
+		status = entry->operation(client, index);
+		latencies[index] = getNSCBenchMicros() - latencies[index];
+		if (status != 0) {
+			fprintf(stderr, "%s: operation %lu failed (%d)\n", entry->name, index, status);
+			return 1;
+		}
+	}
+	total = getNSCBenchMicros() - start;
+	entry->rate = count * 1e6 / total;
+	qsort(latencies, count, sizeof(double), compareNSCBenchLatency);
+	printf("%-10s %10.0f %9.1f %9.1f %9.1f %9.1f\n", entry->name, entry->rate,
+		latencies[count / 2UL], latencies[(count * 99UL) / 100UL], latencies[count - 1UL],
+		(double)(stream->written + stream->read - bytes) / count);
+
+	return 0;
+}
+
+/**
+ *	@fn			int saveNSCBenchBaseline(const char*)
+ *	@brief 		Writes the measured rates as a baseline.
+ *	@param[in]	path	Baseline file.
+ *	@return		zero on success.
+ */
+static int saveNSCBenchBaseline(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	size_t index;
+
+	if (file == NULL) {
+		perror(path);
+		return 1;
+	}
+	for (index = 0U; index < SzElems_(nscBenchEntries, T_nscBenchEntry); index++) {
+		fprintf(file, "%s %.0f\n", nscBenchEntries[index].name, nscBenchEntries[index].rate);
+	}
+
+	return (fclose(file) != 0);
+}
+
+/**
+ *	@fn			int gateNSCBench(const char*, double)
+ *	@brief 		Compares the measured rates to a baseline.
+ *	@param[in]	path		Baseline file.
+ *	@param[in]	tolerance	Allowed slowdown in percent.
+ *	@return		zero without regression, 3 on regression, 1 on file error.
+ */
+static int gateNSCBench(const char* path, double tolerance)
+{
+	FILE* file = fopen(path, "r");
+	char name[NSC_BENCH_NAME_SIZE];
+	double baseline;
+	double floor;
+	size_t index;
+	int status = 0;
+
+	if (file == NULL) {
+		perror(path);
+		return 1;
+	}
+	while (fscanf(file, "%31s %lf", name, &baseline) == 2) {
+		for (index = 0U; index < SzElems_(nscBenchEntries, T_nscBenchEntry); index++) {
+			if (strcmp(name, nscBenchEntries[index].name) != 0) {
+				continue;
+			}
+			floor = baseline * (100.0 - tolerance) / 100.0;
+			if (nscBenchEntries[index].rate < floor) {
+				fprintf(stderr, "%s: %.0f op/s below %.0f (baseline %.0f)\n", name,
+					nscBenchEntries[index].rate, floor, baseline);
+				status = 3;
+			}
+		}
+	}
+	fclose(file);
+
+	return status;
+}
+
+/**
+ *	@fn			int openNSCBenchTerminal(int*, int*)
+ *	@brief 		Opens a raw pseudo terminal pair.
+ *	@param[out]	master	Client side.
+ *	@param[out]	slave	Node side.
+ *	@return		zero on success.
+ */
+static int openNSCBenchTerminal(int* master, int* slave)
+{
+	struct termios mode;
+
+	*master = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((*master < 0) || (grantpt(*master) != 0) || (unlockpt(*master) != 0)) {
+		return -1;
+	}
+	*slave = open(ptsname(*master), O_RDWR | O_NOCTTY);
+	if ((*slave < 0) || (tcgetattr(*slave, &mode) != 0)) {
+		return -1;
+	}
+	cfmakeraw(&mode);
+
+	return tcsetattr(*slave, TCSANOW, &mode);
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	static T_nscBenchStream stream;
+	T_nscClient client;
+	T_nscClientValue value;
+	const char* baseline = NULL;
+	const char* gate = NULL;
+	double tolerance = NSC_BENCH_TOLERANCE;
+	unsigned long count = NSC_BENCH_COUNT;
+	double* latencies;
+	int toNode[2], toHost[2];
+	int terminal = 0;
+	int status = 0;
+	size_t index;
+	pid_t node;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if ((strcmp(argv[arg], "-n") == 0) && (arg + 1 < argc)) {
+			count = strtoul(argv[++arg], NULL, 0);
+		} else if (strcmp(argv[arg], "-p") == 0) {
+			terminal = 1;
+		} else if ((strcmp(argv[arg], "-b") == 0) && (arg + 1 < argc)) {
+			baseline = argv[++arg];
+		} else if ((strcmp(argv[arg], "-g") == 0) && (arg + 1 < argc)) {
+			gate = argv[++arg];
+		} else if ((strcmp(argv[arg], "-t") == 0) && (arg + 1 < argc)) {
+			tolerance = strtod(argv[++arg], NULL);
+		} else {
+			fprintf(stderr, "usage: %s [-n COUNT] [-p] [-b FILE] [-g FILE [-t PERCENT]]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+	latencies = malloc(sizeof(double) * (count + 1UL));
+	if ((latencies == NULL) || (count == 0UL)) {
+		perror("nsc_bench");
+		return 1;
+	}
+	if (terminal) {
+		if (openNSCBenchTerminal(&toHost[0], &toNode[0]) != 0) {
+			perror("nsc_bench: pseudo terminal");
+			return 1;
+		}
+		toHost[1] = toNode[0];
+		toNode[1] = toHost[0];
+	} else if ((pipe(toNode) != 0) || (pipe(toHost) != 0)) {
+		perror("nsc_bench: pipe");
+		return 1;
+	}
+	node = fork();
+	if (node == 0) {
+		if (NOT(terminal)) {
+			close(toNode[1]);
+			close(toHost[0]);
+		} else {
+			close(toHost[0]);
+		}
+		runNSCBenchNode(toNode[0], toHost[1]);
+		_exit(0);
+	}
+	close(toNode[0]);
+	if (NOT(terminal)) {
+		close(toHost[1]);
+	}
+	stream.in = toHost[0];
+	stream.out = toNode[1];
+	for (arg = 0; arg < (int)NSC_BENCH_LIST; arg++) {
+		nscBenchAddresses[arg] = NSC_BENCH_ARRAY + (uint32_t)arg;
+	}
+	initNSCClient(&client, writeNSCBenchStream, readNSCBenchStream, &stream);
+	/* requests are refused until a session is opened */
+	if ((fetchNSCClient(&client, NSC_BENCH_INTEGER, &value) != (int)NSC_ERR_SESSION)
+			|| (masterNSCClient(&client) != 0)) {
+		fprintf(stderr, "session: not negotiated\n");
+		status = 1;
+	}
+	printf("%-10s %10s %9s %9s %9s %9s\n", "operation", "op/s", "p50 us", "p99 us",
+		"max us", "bytes/op");
+	for (index = 0U; (status == 0) && (index < SzElems_(nscBenchEntries, T_nscBenchEntry)); index++) {
+		status = measureNSCBench(&client, &stream, &nscBenchEntries[index], count, latencies);
+	}
+	/* last store must have reached the node, slave session clears the stack */
+	if ((status == 0) && (checkNSCBenchBlocks(&client, count) != 0)) {
+		fprintf(stderr, "block: node values differ\n");
+		status = 1;
+	}
+	if ((status == 0) && ((fetchNSCClient(&client, NSC_BENCH_INTEGER, &value) != 0)
+			|| (value.value.si32 != (int32_t)((count - 1UL) % 1000UL))
+			|| (pushNSCClientInteger(&client, 1) != 0) || (slaveNSCClient(&client) != 0)
+			|| (popNSCClient(&client, NSC_CLIENT_SINT, &value) != (int)NSC_ERR_STACK_EMPTY))) {
+		fprintf(stderr, "store or session: node value %d\n", value.value.si32);
+		status = 1;
+	}
+	status |= (releaseNSCClient(&client) != 0);
+	if ((status == 0) && (baseline != NULL)) {
+		status = saveNSCBenchBaseline(baseline);
+	}
+	if ((status == 0) && (gate != NULL)) {
+		status = gateNSCBench(gate, tolerance);
+	}
+	close(stream.out);
+	if (terminal) {
+		kill(node, SIGTERM);
+	}
+	waitpid(node, NULL, 0);
+	free(latencies);
+
+	return status;
+}
+
+/* END OF NSC_BENCH. */
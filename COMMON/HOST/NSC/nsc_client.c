@@ -0,0 +1,656 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Host Client Implementation						 */
+/**
+ *	@file		NSC/nsc_client.c
+ *	@brief		This file contains host-side NSC client functions implementation.
+ *	@details	Frames are the TLM frames of the node: channel, sequence number,
+ *				payload and CRC-16/CCITT-FALSE (little-endian), COBS encoded and
+ *				terminated by a zero byte. Anything else on the stream (i.e.
+ *				text responses) is skipped at the next zero byte.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/nscClient.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NSC_CLIENT_REQUEST_SIZE
+ *	@brief 		Decoded request size in bytes (CRC-16 included).
+ */
+#define NSC_CLIENT_REQUEST_SIZE	(14U)
+
+/**
+ * 	@def		NSC_CLIENT_LAST_FRAME
+ *	@brief 		Frame index flag of last batch frame.
+ */
+#define NSC_CLIENT_LAST_FRAME	(0x80U)
+
+/**
+ * 	@def		NSC_CLIENT_ERROR
+ *	@brief 		Entry status flag of failed batch entry.
+ */
+#define NSC_CLIENT_ERROR		(0x80U)
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			uint16_t computeNSCClientCRC(const uint8_t*, size_t)
+ *	@brief 		Computes CRC-16/CCITT-FALSE.
+ *	@param[in]	pBuff	Data to check.
+ *	@param[in]	len		Data size.
+ *	@return		CRC-16.
+ */
+static uint16_t computeNSCClientCRC(const uint8_t* pBuff, size_t len)
+{
+	uint16_t crc = 0xFFFFU;
+	int bit;
+
+	while (len--) {
+		crc ^= (uint16_t)(*pBuff++ << 8);
+		for (bit = 0; bit < 8; bit++) {
+			crc = (uint16_t)((crc << 1) ^ ((crc & 0x8000U) ? 0x1021U : 0U));
+		}
+	}
+
+	return crc;
+}
+
+/**
+ *	@fn			uint32_t getNSCClientDWord(const uint8_t*)
+ *	@brief 		Assembles a little-endian double word.
+ *	@param[in]	pBuff	Pointer to least significant byte.
+ *	@return		double word.
+ */
+static uint32_t getNSCClientDWord(const uint8_t* pBuff)
+{
+	return (uint32_t)pBuff[0] | ((uint32_t)pBuff[1] << 8)
+		| ((uint32_t)pBuff[2] << 16) | ((uint32_t)pBuff[3] << 24);
+}
+
+/**
+ *	@fn			int sendNSCClientBlock(T_nscClient*, T_nscClientCommand, T_nscClientType,
+ *					uint32_t, uint32_t, const T_nscClientValue*, size_t)
+ *	@brief 		Encodes and writes a request with block values without waiting.
+ *	@param		client		NSC client.
+ *	@param[in]	command		Command.
+ *	@param[in]	type		Type tag.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Parameter data.
+ *	@param[in]	values		Block values (or NULL).
+ *	@param[in]	count		Block value count (up to NSC_CLIENT_BLOCK_VALUES).
+ *	@return		request sequence number or NSC_CLIENT_ERR_IO.
+ */
+static int sendNSCClientBlock(T_nscClient* client, T_nscClientCommand command,
+	T_nscClientType type, uint32_t address, uint32_t value,
+	const T_nscClientValue* values, size_t count)
+{
+	uint8_t request[NSC_CLIENT_REQUEST_SIZE + (NSC_CLIENT_BLOCK_VALUES * 4U)];
+	uint8_t encoded[sizeof(request) + 2U];
+	size_t length = NSC_CLIENT_REQUEST_SIZE + (count * 4U);
+	size_t codeIndex = 0U, size = 1U, index;
+	uint8_t code = 1U;
+	uint16_t crc;
+	int shift;
+
+	request[0] = NSC_CLIENT_CHANNEL;
+	request[1] = client->sequence;
+	request[2] = (uint8_t)command;
+	request[3] = (uint8_t)type;
+	for (shift = 0; shift < 4; shift++) {
+		request[4 + shift] = (uint8_t)(address >> (8 * shift));
+		request[8 + shift] = (uint8_t)(value >> (8 * shift));
+		for (index = 0U; index < count; index++) {
+			request[12U + (index * 4U) + shift] = (uint8_t)(values[index].value.ui32 >> (8 * shift));
+		}
+	}
+	crc = computeNSCClientCRC(request, length - 2U);
+	request[length - 2U] = (uint8_t)crc;
+	request[length - 1U] = (uint8_t)(crc >> 8);
+	/* COBS encoding (no run over 254 bytes) and zero delimiter */
+	for (index = 0U; index < length; index++) {
+		if (request[index] == 0U) {
+			encoded[codeIndex] = code;
+			codeIndex = size++;
+			code = 1U;
+		} else {
+			encoded[size++] = request[index];
+			code++;
+		}
+	}
+	encoded[codeIndex] = code;
+	encoded[size++] = 0U;
+	if (client->write(client->context, encoded, size) != (long)size) {
+		return NSC_CLIENT_ERR_IO;
+	}
+	client->requests++;
+
+	return client->sequence++;
+}
+
+/**
+ *	@fn			int sendNSCClient(T_nscClient*, T_nscClientCommand, T_nscClientType,
+ *					uint32_t, uint32_t)
+ *	@brief 		Encodes and writes a request without waiting.
+ *	@param		client		NSC client.
+ *	@param[in]	command		Command.
+ *	@param[in]	type		Type tag.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Parameter data.
+ *	@return		request sequence number or NSC_CLIENT_ERR_IO.
+ */
+static int sendNSCClient(T_nscClient* client, T_nscClientCommand command,
+	T_nscClientType type, uint32_t address, uint32_t value)
+{
+	return sendNSCClientBlock(client, command, type, address, value, NULL, 0U);
+}
+
+/**
+ *	@fn			int receiveNSCClient(T_nscClient*)
+ *	@brief 		Reads the next valid frame into client receive buffer.
+ *	@param		client		NSC client.
+ *	@return		decoded size (CRC-16 excluded) or NSC_CLIENT_ERR_IO.
+ */
+static int receiveNSCClient(T_nscClient* client)
+{
+	uint8_t data;
+	size_t index, size;
+	uint8_t code;
+	int valid;
+
+	for (;;) {
+		/* collect frame until delimiter */
+		client->rxLength = 0U;
+		for (;;) {
+			if (client->read(client->context, &data, 1U) <= 0) {
+				return NSC_CLIENT_ERR_IO;
+			}
+			if (data == 0U) {
+				break;
+			}
+			if (client->rxLength < NSC_CLIENT_FRAME_SIZE) {
+				client->rx[client->rxLength] = data;
+			}
+			client->rxLength++;
+		}
+		/* decode in place */
+		valid = (client->rxLength != 0U) && (client->rxLength <= NSC_CLIENT_FRAME_SIZE);
+		index = 0U;
+		size = 0U;
+		while (valid && (index < client->rxLength)) {
+			code = client->rx[index++];
+			if ((index + code - 1U) > client->rxLength) {
+				valid = 0;
+				break;
+			}
+			memmove(&client->rx[size], &client->rx[index], code - 1U);
+			size += code - 1U;
+			index += code - 1U;
+			if ((code != 0xFFU) && (index < client->rxLength)) {
+				client->rx[size++] = 0U;
+			}
+		}
+		/* check header and CRC-16 */
+		if (valid && (size > 4U) && (computeNSCClientCRC(client->rx, size - 2U)
+				== (uint16_t)(client->rx[size - 2U] | (client->rx[size - 1U] << 8)))) {
+			return (int)(size - 2U);
+		}
+		client->skipped++;
+	}
+}
+
+/**
+ *	@fn			int waitNSCClient(T_nscClient*, uint8_t, T_nscClientValue*)
+ *	@brief 		Waits for the response of a request.
+ *	@param		client		NSC client.
+ *	@param[in]	sequence	Request sequence number.
+ *	@param[out]	response	Response data (or NULL).
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+static int waitNSCClient(T_nscClient* client, uint8_t sequence, T_nscClientValue* response)
+{
+	int size;
+
+	for (;;) {
+		size = receiveNSCClient(client);
+		if (size < 0) {
+			return NSC_CLIENT_ERR_IO;
+		}
+		if ((size >= 9) && (client->rx[0] == NSC_CLIENT_CHANNEL) && (client->rx[2] == sequence)) {
+			break;
+		}
+		client->skipped++;
+	}
+	if (client->rx[3] == NSC_CLIENT_ERR) {
+		return (int)getNSCClientDWord(&client->rx[5]);
+	}
+	if (response != NULL) {
+		response->type = (T_nscClientType)client->rx[4];
+		response->value.ui32 = getNSCClientDWord(&client->rx[5]);
+	}
+
+	return 0;
+}
+
+/**
+ *	@fn			int waitNSCClientBlock(T_nscClient*, uint8_t, uint32_t, T_nscClientValue*,
+ *					size_t, size_t*)
+ *	@brief 		Waits for a block response frame of a request and copies its
+ *				values at their element position.
+ *	@param		client		NSC client.
+ *	@param[in]	sequence	Request sequence number.
+ *	@param[in]	offset		Element of values[0].
+ *	@param[out]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@param[out]	received	Value count of the frame.
+ *	@return		zero on success, node error code or NSC_CLIENT_ERR_IO.
+ */
+static int waitNSCClientBlock(T_nscClient* client, uint8_t sequence, uint32_t offset,
+	T_nscClientValue* values, size_t count, size_t* received)
+{
+	uint32_t block, first;
+	size_t index;
+	int size;
+
+	for (;;) {
+		size = receiveNSCClient(client);
+		if (size < 0) {
+			return NSC_CLIENT_ERR_IO;
+		}
+		if ((size >= 9) && (client->rx[0] == NSC_CLIENT_CHANNEL) && (client->rx[2] == sequence)) {
+			break;
+		}
+		client->skipped++;
+	}
+	block = getNSCClientDWord(&client->rx[5]);
+	if (client->rx[3] == NSC_CLIENT_ERR) {
+		return (int)block;
+	}
+	/* block parameter: first element (high word) and length (low word) */
+	first = block >> 16;
+	*received = (uint16_t)block;
+	if ((client->rx[3] != NSC_CLIENT_PSH) || (*received == 0U) || (first < offset)
+			|| ((first - offset + *received) > count) || ((9U + (*received * 4U)) > (size_t)size)) {
+		return NSC_CLIENT_ERR_IO;
+	}
+	for (index = 0U; index < *received; index++) {
+		values[first - offset + index].type = (T_nscClientType)client->rx[4];
+		values[first - offset + index].value.ui32 = getNSCClientDWord(&client->rx[9U + (index * 4U)]);
+	}
+
+	return 0;
+}
+
+/* ----------------------------------------------------------------------------
+**	Functions.
+*/
+
+/**
+ *	@fn			void initNSCClient(T_nscClient*, T_nscClientWrite, T_nscClientRead, void*)
+ *	@brief 		Initialize client on a byte stream.
+ *	@param[out]	client		NSC client.
+ *	@param[in]	write		Stream writing callback.
+ *	@param[in]	read		Stream reading callback.
+ *	@param[in]	context		Stream context.
+ *	@return		.
+ */
+void initNSCClient(T_nscClient* client, T_nscClientWrite write,
+	T_nscClientRead read, void* context)
+{
+	memset(client, 0, sizeof(*client));
+	client->write = write;
+	client->read = read;
+	client->context = context;
+}
+
+/**
+ *	@fn			int requestNSCClient(T_nscClient*, T_nscClientCommand, T_nscClientType,
+ *					uint32_t, uint32_t, T_nscClientValue*)
+ *	@brief 		Sends a request and waits for its response.
+ *	@param		client		NSC client.
+ *	@param[in]	command		Command.
+ *	@param[in]	type		Type tag.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Parameter data.
+ *	@param[out]	response	Response data.
+ *	@return		status.
+ */
+int requestNSCClient(T_nscClient* client, T_nscClientCommand command,
+	T_nscClientType type, uint32_t address, uint32_t value, T_nscClientValue* response)
+{
+	int sequence = sendNSCClient(client, command, type, address, value);
+
+	if (sequence < 0) {
+		return NSC_CLIENT_ERR_IO;
+	}
+
+	return waitNSCClient(client, (uint8_t)sequence, response);
+}
+
+/**
+ *	@fn			int pushNSCClientInteger(T_nscClient*, int32_t)
+ *	@brief 		Pushes an integer on the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	value		Value.
+ *	@return		status.
+ */
+int pushNSCClientInteger(T_nscClient* client, int32_t value)
+{
+	return requestNSCClient(client, NSC_CLIENT_PSH, NSC_CLIENT_SINT, 0U, (uint32_t)value, NULL);
+}
+
+/**
+ *	@fn			int pushNSCClientFloat(T_nscClient*, float)
+ *	@brief 		Pushes a float on the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	value		Value.
+ *	@return		status.
+ */
+int pushNSCClientFloat(T_nscClient* client, float value)
+{
+	T_nscClientValue data;
+
+	data.value.fl32 = value;
+
+	return requestNSCClient(client, NSC_CLIENT_PSH, NSC_CLIENT_FLOAT, 0U, data.value.ui32, NULL);
+}
+
+/**
+ *	@fn			int popNSCClient(T_nscClient*, T_nscClientType, T_nscClientValue*)
+ *	@brief 		Pops a value from the node stack.
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[out]	value		Value.
+ *	@return		status.
+ */
+int popNSCClient(T_nscClient* client, T_nscClientType type, T_nscClientValue* value)
+{
+	return requestNSCClient(client, NSC_CLIENT_POP, type, 0U, 0U, value);
+}
+
+/**
+ *	@fn			int executeNSCClient(T_nscClient*, uint32_t)
+ *	@brief 		Executes a function of the node.
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@return		status.
+ */
+int executeNSCClient(T_nscClient* client, uint32_t address)
+{
+	return requestNSCClient(client, NSC_CLIENT_EXE, NSC_CLIENT_SINT, address, 0U, NULL);
+}
+
+/**
+ *	@fn			int storeNSCClient(T_nscClient*, uint32_t, const T_nscClientValue*)
+ *	@brief 		Transmits a value to a node address.
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@param[in]	value		Value and type.
+ *	@return		status.
+ */
+int storeNSCClient(T_nscClient* client, uint32_t address, const T_nscClientValue* value)
+{
+	return requestNSCClient(client, NSC_CLIENT_TXD, value->type, address, value->value.ui32, NULL);
+}
+
+/**
+ *	@fn			int fetchNSCClient(T_nscClient*, uint32_t, T_nscClientValue*)
+ *	@brief 		Requests the value of a node address.
+ *	@param		client		NSC client.
+ *	@param[in]	address		Address.
+ *	@param[out]	value		Value and type.
+ *	@return		status.
+ */
+int fetchNSCClient(T_nscClient* client, uint32_t address, T_nscClientValue* value)
+{
+	return requestNSCClient(client, NSC_CLIENT_RXD, NSC_CLIENT_SINT, address, 0U, value);
+}
+
+/**
+ *	@fn			int pushNSCClientBlock(T_nscClient*, T_nscClientType,
+ *					const T_nscClientValue*, size_t)
+ *	@brief 		Pushes values on the node stack in order.
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[in]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@return		status.
+ */
+int pushNSCClientBlock(T_nscClient* client, T_nscClientType type,
+	const T_nscClientValue* values, size_t count)
+{
+	size_t index, chunk;
+	int sequence, status = 0;
+
+	for (index = 0U; (status == 0) && (index < count); index += chunk) {
+		chunk = ((count - index) < NSC_CLIENT_BLOCK_VALUES) ? (count - index) : NSC_CLIENT_BLOCK_VALUES;
+		sequence = sendNSCClientBlock(client, NSC_CLIENT_PSH, type, 0U, (uint32_t)chunk,
+			&values[index], chunk);
+		status = (sequence < 0) ? NSC_CLIENT_ERR_IO : waitNSCClient(client, (uint8_t)sequence, NULL);
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int popNSCClientBlock(T_nscClient*, T_nscClientType, T_nscClientValue*,
+ *					size_t, size_t*)
+ *	@brief 		Pops up to count values from the node stack in pushing order.
+ *	@param		client		NSC client.
+ *	@param[in]	type		Value type.
+ *	@param[out]	values		Values (oldest first).
+ *	@param[in]	count		Maximum value count.
+ *	@param[out]	popped		Value count popped.
+ *	@return		status.
+ */
+int popNSCClientBlock(T_nscClient* client, T_nscClientType type,
+	T_nscClientValue* values, size_t count, size_t* popped)
+{
+	size_t position = count, chunk, received = 0U;
+	int sequence, status = 0;
+
+	/* top of stack first, into the tail of values */
+	while ((status == 0) && (position != 0U)) {
+		chunk = (position < NSC_CLIENT_BLOCK_VALUES) ? position : NSC_CLIENT_BLOCK_VALUES;
+		sequence = sendNSCClient(client, NSC_CLIENT_POP, type, 0U, (uint32_t)chunk);
+		if (sequence < 0) {
+			return NSC_CLIENT_ERR_IO;
+		}
+		status = waitNSCClientBlock(client, (uint8_t)sequence, 0U, &values[position - chunk],
+			chunk, &received);
+		if (status != 0) {
+			break;
+		}
+		/* short block means empty stack, values go right below the others */
+		memmove(&values[position - received], &values[position - chunk], received * sizeof(*values));
+		position -= received;
+		if (received < chunk) {
+			break;
+		}
+	}
+	/* stack emptied at a block boundary */
+	if ((status == NSC_CLIENT_ERR_STACK_EMPTY) && (position != count)) {
+		status = 0;
+	}
+	*popped = count - position;
+	memmove(values, &values[position], *popped * sizeof(*values));
+
+	return status;
+}
+
+/**
+ *	@fn			int storeNSCClientBlock(T_nscClient*, uint32_t, uint16_t,
+ *					const T_nscClientValue*, size_t)
+ *	@brief 		Transmits values into array elements (no stack).
+ *	@param		client		NSC client.
+ *	@param[in]	address		Array address.
+ *	@param[in]	offset		First element.
+ *	@param[in]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@return		status.
+ */
+int storeNSCClientBlock(T_nscClient* client, uint32_t address, uint16_t offset,
+	const T_nscClientValue* values, size_t count)
+{
+	size_t index, chunk;
+	int sequence, status = 0;
+
+	for (index = 0U; (status == 0) && (index < count); index += chunk) {
+		chunk = ((count - index) < NSC_CLIENT_BLOCK_VALUES) ? (count - index) : NSC_CLIENT_BLOCK_VALUES;
+		sequence = sendNSCClientBlock(client, NSC_CLIENT_TXD, values[index].type, address,
+			((uint32_t)(offset + index) << 16) | (uint32_t)chunk, &values[index], chunk);
+		status = (sequence < 0) ? NSC_CLIENT_ERR_IO : waitNSCClient(client, (uint8_t)sequence, NULL);
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int fetchNSCClientBlock(T_nscClient*, uint32_t, uint16_t,
+ *					T_nscClientValue*, size_t)
+ *	@brief 		Requests the values of array elements in a single request.
+ *	@param		client		NSC client.
+ *	@param[in]	address		Array address.
+ *	@param[in]	offset		First element.
+ *	@param[out]	values		Values and types.
+ *	@param[in]	count		Value count.
+ *	@return		status.
+ */
+int fetchNSCClientBlock(T_nscClient* client, uint32_t address, uint16_t offset,
+	T_nscClientValue* values, size_t count)
+{
+	size_t total = 0U, received;
+	int sequence, status = 0;
+
+	if ((count == 0U) || (count > 0xFFFFU)) {
+		return NSC_CLIENT_ERR_BLOCK_SIZE;
+	}
+	sequence = sendNSCClient(client, NSC_CLIENT_RXD, NSC_CLIENT_SINT, address,
+		((uint32_t)offset << 16) | (uint32_t)count);
+	if (sequence < 0) {
+		return NSC_CLIENT_ERR_IO;
+	}
+	/* one frame per NSC_BINARY_MAX_VALUES of the node */
+	while ((status == 0) && (total < count)) {
+		status = waitNSCClientBlock(client, (uint8_t)sequence, offset, values, count, &received);
+		total += received;
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int fetchNSCClientList(T_nscClient*, const uint32_t*, size_t,
+ *					T_nscClientValue*, int*)
+ *	@brief 		Requests the values of several node addresses at once.
+ *	@param		client		NSC client.
+ *	@param[in]	addresses	Addresses.
+ *	@param[in]	count		Address count.
+ *	@param[out]	values		Values and types.
+ *	@param[out]	errors		Error code per address.
+ *	@return		status.
+ */
+int fetchNSCClientList(T_nscClient* client, const uint32_t* addresses,
+	size_t count, T_nscClientValue* values, int* errors)
+{
+	uint8_t pending[NSC_CLIENT_WINDOW];
+	size_t sent = 0U, acked = 0U, entry = 0U, total = count + 2U;
+	int status = 0, result, sequence, size, index;
+	uint8_t tag = client->tag++;
+
+	/* pipeline pushes (addresses then tag) and execution within window */
+	while (acked < total) {
+		while ((sent < total) && ((sent - acked) < NSC_CLIENT_WINDOW)) {
+			if (sent < count) {
+				sequence = sendNSCClient(client, NSC_CLIENT_PSH, NSC_CLIENT_UHEX, 0U, addresses[sent]);
+			} else if (sent == count) {
+				sequence = sendNSCClient(client, NSC_CLIENT_PSH, NSC_CLIENT_UINT, 0U, tag);
+			} else {
+				sequence = sendNSCClient(client, NSC_CLIENT_EXE, NSC_CLIENT_SINT,
+					NSC_CLIENT_BATCH_ADDRESS, 0U);
+			}
+			if (sequence < 0) {
+				return NSC_CLIENT_ERR_IO;
+			}
+			pending[sent % NSC_CLIENT_WINDOW] = (uint8_t)sequence;
+			sent++;
+		}
+		if ((acked + 1U) < total) {
+			result = waitNSCClient(client, pending[acked % NSC_CLIENT_WINDOW], NULL);
+		} else {
+			/* batch frames come ahead of the response of execution */
+			for (;;) {
+				size = receiveNSCClient(client);
+				if (size < 0) {
+					return NSC_CLIENT_ERR_IO;
+				}
+				if ((client->rx[0] == NSC_CLIENT_BATCH_CHANNEL) && (size >= 4) && (client->rx[2] == tag)) {
+					for (index = 4; (index + 5) <= size; index += 5) {
+						if (entry < count) {
+							result = (client->rx[index] & NSC_CLIENT_ERROR) ? (client->rx[index] & 0x7F) : 0;
+							errors[entry] = result;
+							values[entry].type = result ? NSC_CLIENT_UHEX : (T_nscClientType)client->rx[index];
+							values[entry].value.ui32 = getNSCClientDWord(&client->rx[index + 1]);
+						}
+						entry++;
+					}
+				} else if ((client->rx[0] == NSC_CLIENT_CHANNEL) && (size >= 9)
+						&& (client->rx[2] == pending[acked % NSC_CLIENT_WINDOW])) {
+					result = (client->rx[3] == NSC_CLIENT_ERR) ? (int)getNSCClientDWord(&client->rx[5]) : 0;
+					break;
+				} else {
+					client->skipped++;
+				}
+			}
+		}
+		if (result == NSC_CLIENT_ERR_IO) {
+			return result;
+		}
+		if ((status == 0) && (result != 0)) {
+			status = result;
+		}
+		acked++;
+	}
+
+	return status;
+}
+
+/**
+ *	@fn			int masterNSCClient(T_nscClient*)
+ *	@brief 		Opens a master session (NSC_CMD_MSR), clearing the node stack.
+ *	@param		client		NSC client.
+ *	@return		status.
+ */
+int masterNSCClient(T_nscClient* client)
+{
+	return requestNSCClient(client, NSC_CLIENT_MSR, NSC_CLIENT_SINT, 0U, 0U, NULL);
+}
+
+/**
+ *	@fn			int slaveNSCClient(T_nscClient*)
+ *	@brief 		Opens a slave session (NSC_CMD_SLV), clearing the node stack.
+ *	@param		client		NSC client.
+ *	@return		status.
+ */
+int slaveNSCClient(T_nscClient* client)
+{
+	return requestNSCClient(client, NSC_CLIENT_SLV, NSC_CLIENT_SINT, 0U, 0U, NULL);
+}
+
+/**
+ *	@fn			int releaseNSCClient(T_nscClient*)
+ *	@brief 		Releases the session and switches the node back to text mode.
+ *	@param		client		NSC client.
+ *	@return		status.
+ */
+int releaseNSCClient(T_nscClient* client)
+{
+	return requestNSCClient(client, NSC_CLIENT_REL, NSC_CLIENT_SINT, 0U, 0U, NULL);
+}
+
+/* END OF NSC_CLIENT. */
@@ -0,0 +1,201 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Host Implementation							 */
+/**
+ *	@file		NSC/nsc_host.c
+ *	@brief		This file contains NSC stack and session functions
+ *				implementation for host tools (the target implementation only
+ *				ships in the EXTRA library archives).
+ *	@details	Functions follow NSC/nsc.h: NSC_CMD_MSR and NSC_CMD_SLV open a
+ *				session and NSC_CMD_REL closes it, all clearing the stack, and
+ *				other commands are only accepted in session. The text parser
+ *				and responder (manageNSCRequest, manageNSCResponse) are not
+ *				provided; manageNSCResponse does nothing.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/nsc.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NSC_HOST_STACK_SIZE
+ *	@brief 		Stack depth in entries.
+ */
+#ifndef NSC_HOST_STACK_SIZE
+#define NSC_HOST_STACK_SIZE		(64U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		nscHostStack, nscHostStackTop
+ *	@brief		Stack entries and entry count.
+ */
+static T_nscParamData nscHostStack[NSC_HOST_STACK_SIZE];
+static T_uint8 nscHostStackTop;
+
+/**
+ *	@var		nscHostSession
+ *	@brief		Current session.
+ */
+static T_nscSession nscHostSession = NSC_SSN_IDLE;
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initNSC(T_void)
+ *	@brief 		Initialize node serial communication.
+ *	@param		.
+ *	@return		.
+ */
+T_void initNSC(T_void)
+{
+	nscHostStackTop = 0U;
+	nscHostSession = NSC_SSN_IDLE;
+}
+
+/**
+ *	@fn			T_nscCommand evaluateNSCSession(T_nscCommand)
+ *	@brief 		Session command evaluation and manager.
+ *	@param[in]	command		Command to evaluate.
+ *	@return		command index (NSC_CMD_INV outside of session).
+ */
+T_nscCommand evaluateNSCSession(T_nscCommand command)
+{
+	switch (command) {
+		case NSC_CMD_MSR:
+		case NSC_CMD_SLV:
+		case NSC_CMD_REL:
+			nscHostSession = (T_nscSession)command;
+			nscHostStackTop = 0U;
+			return command;
+		default:
+			return COND(EQU(nscHostSession, NSC_SSN_IDLE), NSC_CMD_INV, command);
+	}
+}
+
+/**
+ *	@fn			T_void manageNSCResponse(T_nscCommand, T_nscParamData, T_nscRepType)
+ *	@brief 		Message responder (text mode, not provided).
+ *	@param[in]	command 	Instruction to execute.
+ *	@param[in]	parameter	Parameter of command.
+ *	@param[in]	type		Data type parameter format.
+ *	@return		.
+ */
+T_void manageNSCResponse(T_nscCommand command, T_nscParamData parameter,
+	T_nscRepType type)
+{
+	(T_void)command;
+	(T_void)parameter;
+	(T_void)type;
+}
+
+/**
+ *  @fn 		T_nscSession getNSCRxSession(T_void)
+ *  @brief 		Gets reception / incoming message session type.
+ *  @param		.
+ *  @return		session type.
+ */
+T_nscSession getNSCRxSession(T_void)
+{
+	return nscHostSession;
+}
+
+/**
+ *	@fn			T_bit pushNSCStackInteger(T_sint32)
+ *	@brief 		Push integral data to NSC stack.
+ *	@param[in]	data	Integral data to push in stack.
+ *	@return		push success.
+ */
+T_bit pushNSCStackInteger(T_sint32 data)
+{
+	if (GEQ(nscHostStackTop, NSC_HOST_STACK_SIZE)) {
+		return FALSE;
+	}
+	nscHostStack[nscHostStackTop++].si32 = data;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_bit pushNSCStackFloat(T_float32)
+ *	@brief 		Push floating data to NSC stack.
+ *	@param[in]	data	Floating data to push in stack.
+ *	@return		push success.
+ */
+T_bit pushNSCStackFloat(T_float32 data)
+{
+	if (GEQ(nscHostStackTop, NSC_HOST_STACK_SIZE)) {
+		return FALSE;
+	}
+	nscHostStack[nscHostStackTop++].fl32 = data;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_sint32 popNSCStackInteger(T_void)
+ *	@brief 		Pop integral data from NSC stack.
+ *	@param		.
+ *	@return		data [returns EOF (-1) if stack is empty].
+ */
+T_sint32 popNSCStackInteger(T_void)
+{
+	return COND(EQU(nscHostStackTop, 0U), -1L, nscHostStack[--nscHostStackTop].si32);
+}
+
+/**
+ *	@fn			T_float32 popNSCStackFloat(T_void)
+ *	@brief 		Pop floating data from NSC stack.
+ *	@param		.
+ *	@return		data [returns NaN if stack is empty].
+ */
+T_float32 popNSCStackFloat(T_void)
+{
+	T_nscParamData nan;
+
+	nan.ui32 = 0x7FC00000UL;
+
+	return COND(EQU(nscHostStackTop, 0U), nan.fl32, nscHostStack[--nscHostStackTop].fl32);
+}
+
+/**
+ *	@fn			T_bit fullNSCStackSpace(T_void)
+ *	@brief 		Returns TRUE if all NSC stack buffer entries are occupied.
+ *	@param		.
+ *	@return		full.
+ */
+T_bit fullNSCStackSpace(T_void)
+{
+	return GEQ(nscHostStackTop, NSC_HOST_STACK_SIZE);
+}
+
+/**
+ *	@fn			T_bit emptyNSCStackSpace(T_void)
+ *	@brief 		Returns TRUE if all NSC stack buffer entries are available.
+ *	@param		.
+ *	@return		empty.
+ */
+T_bit emptyNSCStackSpace(T_void)
+{
+	return EQU(nscHostStackTop, 0U);
+}
+
+/**
+ *	@fn 		T_void clearNSCStackSpace(T_void)
+ *	@brief 		Resets NSC stack top and bottom pointer location.
+ *	@param		.
+ *	@return		.
+ */
+T_void clearNSCStackSpace(T_void)
+{
+	nscHostStackTop = 0U;
+}
+
+/* END OF NSC_HOST. */
@@ -0,0 +1,424 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Fast Number to String Conversion Benchmark Host Tool						 */
+/**
+ *	@file		NSC/tostring_bench.c
+ *	@brief		This file contains the host tool checking the fast and
+ *				fixed-point converters of NSC/toString.h against printf and
+ *				comparing their run time.
+ *	@details	Usage: tostring_bench [-n COUNT] [-s SEED] <br>
+ *				COUNT (default 1M) random inputs per converter are converted
+ *				with each decimal count and compared with the printf output of
+ *				the same value: "%ld", "%lu", "0x%lX" for integers, "%.*f" of
+ *				the exact value for fixFlt32ToStr (any exponent up to 2^32,
+ *				subnormals, NaN and infinities included), q15ToStr and
+ *				q16ToStr. Halves are rounded away from zero by the converters
+ *				and to even by printf, so the reference of an exact half is
+ *				printed one step away from zero, and printf "-0" is taken
+ *				without its sign. <br>
+ *				Then each converter and its printf reference are run over the
+ *				same inputs and the time per call is printed with the ratio.
+ *				The original int32ToStr, hex32ToStr and flt32ToStr ship in the
+ *				prebuilt library only and are not measured: the flt32ToStr
+ *				below is a stub for numbers beyond 32-bit integer range, which
+ *				are not drawn. The exit status is 1 on any mismatch. Built
+ *				with: <br>
+ *				cc -O2 -I LIB/MB90385/include -I LIB/EXTRA/include -o
+ *				tostring_bench HOST/NSC/tostring_bench.c
+ *				LIB/EXTRA/implement/NSC/fast_int32tostr.c
+ *				LIB/EXTRA/implement/NSC/fast_hex32tostr.c
+ *				LIB/EXTRA/implement/NSC/fixedtostr.c
+ *				LIB/EXTRA/implement/NSC/fix_flt32tostr.c
+ *				LIB/EXTRA/implement/NSC/q15tostr.c
+ *				LIB/EXTRA/implement/NSC/q16tostr.c -lm
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		TOSTRING_BENCH_COUNT
+ *	@brief 		Default input count per converter.
+ */
+#define TOSTRING_BENCH_COUNT	(1000000UL)
+
+/**
+ * 	@def		TOSTRING_BENCH_SIZE
+ *	@brief 		Conversion buffer size.
+ */
+#define TOSTRING_BENCH_SIZE		(64U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Callback type of a converter under test.
+ *	@param[out]	buffer		Destination.
+ *	@param[in]	input		Raw input (integer or float bits).
+ *	@param[in]	decimals	Digits after decimal point.
+ *	@return		printed characters.
+ */
+typedef size_t (*T_toStringBenchConvert)(char* buffer, uint32_t input, unsigned decimals);
+
+/**
+ *	@brief		Data structure for a converter under test.
+ */
+typedef struct {
+	const char* name;
+	T_toStringBenchConvert fast;
+	T_toStringBenchConvert reference;
+	unsigned maxDecimals;
+} T_toStringBenchEntry;
+
+/* ----------------------------------------------------------------------------
+**	Library Stubs.
+*/
+
+size_t flt32ToStr(T_char* buffer, T_float32 number)
+{
+	return (size_t)sprintf(buffer, "%e", (double)number);
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		toStringBenchSink
+ *	@brief		Timing result sink (keeps loops from being optimized out).
+ */
+static volatile size_t toStringBenchSink;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			size_t printToStringBenchFixed(char*, double, unsigned)
+ *	@brief 		Prints an exact value with fixed decimals through printf,
+ *				halves rounded away from zero.
+ *	@param[out]	buffer		Destination.
+ *	@param[in]	value		Value (exact in double once scaled).
+ *	@param[in]	decimals	Digits after decimal point.
+ *	@return		printed characters.
+ */
+static size_t printToStringBenchFixed(char* buffer, double value, unsigned decimals)
+{
+	double scaled = fabs(value) * pow(10.0, (double)decimals);
+	size_t count;
+	size_t index;
+
+	if ((scaled - floor(scaled)) == 0.5) {
+		value = nextafter(value, (value < 0.0) ? -INFINITY : INFINITY);
+	}
+	count = (size_t)sprintf(buffer, "%.*f", (int)decimals, value);
+	/* no sign if rounded to zero */
+	if (buffer[0] == '-') {
+		for (index = 1U; (index < count) && ((buffer[index] == '0') || (buffer[index] == '.'));
+			index++) {
+			/* do nothing */
+		}
+		if (index == count) {
+			memmove(buffer, buffer + 1, count--);
+		}
+	}
+
+	return count;
+}
+
+/**
+ *	@fn			size_t convertToStringBenchInt(char*, uint32_t, unsigned)
+ *	@brief 		fastInt32ToStr (signed).
+ */
+static size_t convertToStringBenchInt(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return fastInt32ToStr(buffer, (T_sint32)(int32_t)input, TRUE);
+}
+
+/**
+ *	@fn			size_t printToStringBenchInt(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of fastInt32ToStr (signed).
+ */
+static size_t printToStringBenchInt(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return (size_t)sprintf(buffer, "%ld", (long)(int32_t)input);
+}
+
+/**
+ *	@fn			size_t convertToStringBenchUInt(char*, uint32_t, unsigned)
+ *	@brief 		fastInt32ToStr (unsigned).
+ */
+static size_t convertToStringBenchUInt(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return fastInt32ToStr(buffer, (T_sint32)input, FALSE);
+}
+
+/**
+ *	@fn			size_t printToStringBenchUInt(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of fastInt32ToStr (unsigned).
+ */
+static size_t printToStringBenchUInt(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return (size_t)sprintf(buffer, "%lu", (unsigned long)input);
+}
+
+/**
+ *	@fn			size_t convertToStringBenchHex(char*, uint32_t, unsigned)
+ *	@brief 		fastHex32ToStr.
+ */
+static size_t convertToStringBenchHex(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return fastHex32ToStr(buffer, "0x", "", input);
+}
+
+/**
+ *	@fn			size_t printToStringBenchHex(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of fastHex32ToStr.
+ */
+static size_t printToStringBenchHex(char* buffer, uint32_t input, unsigned decimals)
+{
+	(void)decimals;
+
+	return (size_t)sprintf(buffer, "0x%lX", (unsigned long)input);
+}
+
+/**
+ *	@fn			float getToStringBenchFloat(uint32_t)
+ *	@brief 		Gives the float of IEEE 754 bits.
+ */
+static float getToStringBenchFloat(uint32_t input)
+{
+	float value;
+
+	memcpy(&value, &input, sizeof(value));
+
+	return value;
+}
+
+/**
+ *	@fn			size_t convertToStringBenchFix(char*, uint32_t, unsigned)
+ *	@brief 		fixFlt32ToStr.
+ */
+static size_t convertToStringBenchFix(char* buffer, uint32_t input, unsigned decimals)
+{
+	return fixFlt32ToStr(buffer, getToStringBenchFloat(input), (T_uint8)decimals);
+}
+
+/**
+ *	@fn			size_t printToStringBenchFix(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of fixFlt32ToStr.
+ */
+static size_t printToStringBenchFix(char* buffer, uint32_t input, unsigned decimals)
+{
+	float value = getToStringBenchFloat(input);
+
+	if (isnan(value)) {
+		return (size_t)sprintf(buffer, "NaN");
+	}
+	if (isinf(value)) {
+		return (size_t)sprintf(buffer, "%cInf", (value < 0.0F) ? '-' : '+');
+	}
+
+	return printToStringBenchFixed(buffer, (double)value, decimals);
+}
+
+/**
+ *	@fn			size_t convertToStringBenchQ15(char*, uint32_t, unsigned)
+ *	@brief 		q15ToStr.
+ */
+static size_t convertToStringBenchQ15(char* buffer, uint32_t input, unsigned decimals)
+{
+	return q15ToStr(buffer, (T_sint16)(int16_t)input, (T_uint8)decimals);
+}
+
+/**
+ *	@fn			size_t printToStringBenchQ15(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of q15ToStr.
+ */
+static size_t printToStringBenchQ15(char* buffer, uint32_t input, unsigned decimals)
+{
+	return printToStringBenchFixed(buffer, (int16_t)input / 32768.0, decimals);
+}
+
+/**
+ *	@fn			size_t convertToStringBenchQ16(char*, uint32_t, unsigned)
+ *	@brief 		q16ToStr.
+ */
+static size_t convertToStringBenchQ16(char* buffer, uint32_t input, unsigned decimals)
+{
+	return q16ToStr(buffer, (T_sint32)(int32_t)input, (T_uint8)decimals);
+}
+
+/**
+ *	@fn			size_t printToStringBenchQ16(char*, uint32_t, unsigned)
+ *	@brief 		printf reference of q16ToStr.
+ */
+static size_t printToStringBenchQ16(char* buffer, uint32_t input, unsigned decimals)
+{
+	return printToStringBenchFixed(buffer, (int32_t)input / 65536.0, decimals);
+}
+
+/**
+ *	@var		toStringBenchEntries
+ *	@brief		Converters under test.
+ */
+static const T_toStringBenchEntry toStringBenchEntries[] = {
+	{"int", convertToStringBenchInt, printToStringBenchInt, 0U},
+	{"uint", convertToStringBenchUInt, printToStringBenchUInt, 0U},
+	{"hex", convertToStringBenchHex, printToStringBenchHex, 0U},
+	{"fixflt", convertToStringBenchFix, printToStringBenchFix, 6U},
+	{"q15", convertToStringBenchQ15, printToStringBenchQ15, 5U},
+	{"q16", convertToStringBenchQ16, printToStringBenchQ16, 5U}
+};
+
+/**
+ *	@fn			uint32_t drawToStringBench(const T_toStringBenchEntry*)
+ *	@brief 		Gives a random input of a converter.
+ *	@param[in]	entry	Converter.
+ *	@return		input.
+ */
+static uint32_t drawToStringBench(const T_toStringBenchEntry* entry)
+{
+	uint32_t input = ((uint32_t)rand() << 16U) ^ (uint32_t)rand();
+	uint32_t exponent;
+
+	if (entry->fast == convertToStringBenchFix) {
+		/* exponents below 2^32, now and then NaN or infinity */
+		exponent = (uint32_t)rand() % 170U;
+		exponent = (exponent >= 159U) ? ((exponent >= 165U) ? 255U : 0U) : exponent;
+		input = (input & 0x807FFFFFUL) | (exponent << 23U);
+	} else if ((input & 0x100U) != 0U) {
+		/* short numbers as often as long ones */
+		input >>= (uint32_t)rand() % 32U;
+	}
+
+	return input;
+}
+
+/**
+ *	@fn			double getToStringBenchNanos(T_void)
+ *	@brief 		Gets monotonic time.
+ *	@param		.
+ *	@return		time in nanoseconds.
+ */
+static double getToStringBenchNanos(T_void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/**
+ *	@fn			double timeToStringBench(T_toStringBenchConvert, const uint32_t*,
+ *					unsigned long, unsigned)
+ *	@brief 		Runs a conversion over inputs.
+ *	@param[in]	convert		Conversion.
+ *	@param[in]	inputs		Inputs.
+ *	@param[in]	count		Input count.
+ *	@param[in]	decimals	Digits after decimal point.
+ *	@return		time per call in nanoseconds.
+ */
+static double timeToStringBench(T_toStringBenchConvert convert, const uint32_t* inputs,
+	unsigned long count, unsigned decimals)
+{
+	char buffer[TOSTRING_BENCH_SIZE];
+	double start = getToStringBenchNanos();
+	unsigned long index;
+
+	for (index = 0UL; index < count; index++) {
+		toStringBenchSink += convert(buffer, inputs[index], decimals);
+	}
+
+	return (getToStringBenchNanos() - start) / count;
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	char fast[TOSTRING_BENCH_SIZE], reference[TOSTRING_BENCH_SIZE];
+	const T_toStringBenchEntry* entry;
+	unsigned long count = TOSTRING_BENCH_COUNT;
+	unsigned long index, failed, total = 0UL;
+	unsigned seed = 1U;
+	unsigned decimals;
+	uint32_t* inputs;
+	double fastTime, referenceTime;
+	size_t length;
+	size_t item;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if ((strcmp(argv[arg], "-n") == 0) && (arg + 1 < argc)) {
+			count = strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-s") == 0) && (arg + 1 < argc)) {
+			seed = (unsigned)strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n COUNT] [-s SEED]\n", argv[0]);
+			return 2;
+		}
+	}
+	inputs = malloc(sizeof(uint32_t) * (count + 1UL));
+	if ((inputs == NULL) || (count == 0UL)) {
+		perror("tostring_bench");
+		return 1;
+	}
+	srand(seed);
+	printf("%-7s %3s %10s %8s %10s %10s %6s\n", "conv", "dec", "inputs", "failed",
+		"fast ns", "printf ns", "ratio");
+	for (item = 0U; item < SzElems_(toStringBenchEntries, T_toStringBenchEntry); item++) {
+		entry = &toStringBenchEntries[item];
+		for (decimals = 0U; decimals <= entry->maxDecimals; decimals++) {
+			failed = 0UL;
+			for (index = 0UL; index < count; index++) {
+				inputs[index] = drawToStringBench(entry);
+				length = entry->fast(fast, inputs[index], decimals);
+				entry->reference(reference, inputs[index], decimals);
+				if ((length != strlen(fast)) || (strcmp(fast, reference) != 0)) {
+					if (failed == 0UL) {
+						printf("%s: 0x%08lX with %u decimals gives \"%s\" for \"%s\"\n",
+							entry->name, (unsigned long)inputs[index], decimals, fast,
+							reference);
+					}
+					failed++;
+				}
+			}
+			fastTime = timeToStringBench(entry->fast, inputs, count, decimals);
+			referenceTime = timeToStringBench(entry->reference, inputs, count, decimals);
+			printf("%-7s %3u %10lu %8lu %10.1f %10.1f %6.1f\n", entry->name, decimals,
+				count, failed, fastTime, referenceTime, referenceTime / fastTime);
+			total += failed;
+		}
+	}
+	free(inputs);
+
+	return (total != 0UL);
+}
+
+/* END OF TOSTRING_BENCH. */
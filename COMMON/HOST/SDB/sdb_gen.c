@@ -0,0 +1,500 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Signal Database Code Generator Host Tool									 */
+/**
+ *	@file		SDB/sdb_gen.c
+ *	@brief		This file contains the host command line tool generating pack
+ *				and unpack macro functions of CAN messages from a signal
+ *				description.
+ *	@details	Usage: sdb_gen [-n NAME] DBC <br>
+ *				DBC is a signal description in DBC syntax, of which message
+ *				(BO_) and signal (SG_) lines are read: <br>
+ *				BO_ 256 Engine: 8 ECU <br>
+ *				 SG_ Speed : 7|12@0+ (0.1,0) [0|409.5] "km/h" Vector__XXX <br>
+ *				 SG_ Torque : 16|16@1- (1,0) [-32768|32767] "Nm" Vector__XXX <br>
+ *				Intel (@1, start bit is the LSB) and Motorola (@0, start bit is
+ *				the MSB, sawtooth numbering) signals of up to 32 bits, signed
+ *				(-) or unsigned (+), are supported. Multiplexed signals are not.
+ *				The tool prints a header (NAME.h, sdb.h by default) holding, per
+ *				message, a structure of raw signal values, its ID, format and
+ *				DLC, and Pack and Unpack macro functions working on a message
+ *				buffer data (T_canid_dtr) such as pTXCANBuffer[MBX] or
+ *				pRXCANBuffer[MBX], i.e.: <br>
+ *				PackEngine(pTXCANBuffer[CAN_MB_0], engine); <br>
+ *				UnpackEngine(pRXCANBuffer[CAN_MB_1], engine); <br>
+ *				Every data byte is written (or read) once, as one expression of
+ *				precomputed shifts and masks of the signals it holds: there is no
+ *				loop and no bit copy at run time, and byte order does not depend
+ *				on the CPU. The tool is built with the library include directory
+ *				only, i.e.: <br>
+ *				cc -I LIB/MB90385/include -o sdb_gen sdb_gen.c <br>
+ *				SDB/sdb_test.c checks the output of SDB/sdb_test.dbc against a
+ *				generic bit copy and compares their run time.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <LIB/bitmanip.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		SDB_MAX_MESSAGES
+ *	@brief 		Maximum messages of a signal description.
+ */
+#ifndef SDB_MAX_MESSAGES
+#define SDB_MAX_MESSAGES		(256U)
+#endif
+
+/**
+ * 	@def		SDB_MAX_SIGNALS
+ *	@brief 		Maximum signals of a message (one per data bit).
+ */
+#define SDB_MAX_SIGNALS			(64U)
+
+/**
+ * 	@def		SDB_NAME_SIZE, SDB_TEXT_SIZE, SDB_LINE_SIZE
+ *	@brief 		Maximum sizes of names, signal comments and input lines.
+ */
+#define SDB_NAME_SIZE			(64U)
+#define SDB_TEXT_SIZE			(128U)
+#define SDB_LINE_SIZE			(512U)
+
+/**
+ * 	@def		SDB_DATA_SIZE
+ *	@brief 		Maximum data bytes of a message.
+ */
+#define SDB_DATA_SIZE			(8U)
+
+/**
+ * 	@def		SDB_EXT_FLAG
+ *	@brief 		DBC message ID flag of extended format.
+ */
+#define SDB_EXT_FLAG			(0x80000000UL)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for a signal part held by one data byte.
+ */
+typedef struct {
+	T_uint8 sigBit;					/**< lowest signal bit */
+	T_uint8 byteBit;				/**< its bit in the data byte */
+	T_uint8 mask;					/**< mask in the data byte */
+} T_sdbPart;
+
+/**
+ *	@brief		Data structure for a signal.
+ */
+typedef struct {
+	char name[SDB_NAME_SIZE];
+	char text[SDB_TEXT_SIZE];		/**< DBC definition, for comment */
+	T_sdbPart part[SDB_DATA_SIZE];	/**< part per data byte */
+	T_uint8 length;					/**< bit length */
+	T_bit sign;						/**< signed */
+} T_sdbSignal;
+
+/**
+ *	@brief		Data structure for a message.
+ */
+typedef struct {
+	char name[SDB_NAME_SIZE];
+	T_sdbSignal signal[SDB_MAX_SIGNALS];
+	T_dword id;
+	T_uint8 dlc;
+	T_uint8 count;					/**< signal count */
+	T_bit extended;
+} T_sdbMessage;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		sdbMessages, sdbMessageCount
+ *	@brief		Messages of the signal description.
+ */
+static T_sdbMessage sdbMessages[SDB_MAX_MESSAGES];
+static T_uint16 sdbMessageCount;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			const char* getSDBType(T_uint8, T_bit)
+ *	@brief 		Gets the smallest library type holding a signal.
+ *	@param[in]	length	Bit length.
+ *	@param[in]	sign	Signed.
+ *	@return		type name.
+ */
+static const char* getSDBType(T_uint8 length, T_bit sign)
+{
+	if (LEQ(length, 8U)) {
+		return COND(IS(sign), "T_sint8", "T_uint8");
+	}
+	if (LEQ(length, 16U)) {
+		return COND(IS(sign), "T_sint16", "T_uint16");
+	}
+
+	return COND(IS(sign), "T_sint32", "T_uint32");
+}
+
+/**
+ *	@fn			const char* getSDBRawType(T_uint8)
+ *	@brief 		Gets the unsigned library type of a signal container.
+ *	@param[in]	length	Bit length.
+ *	@return		type name.
+ */
+static const char* getSDBRawType(T_uint8 length)
+{
+	return getSDBType(length, FALSE);
+}
+
+/**
+ *	@fn			int mapSDBSignal(T_sdbMessage*, T_sdbSignal*, unsigned, T_bit,
+ *					T_byte*)
+ *	@brief 		Maps signal bits to data byte parts.
+ *	@param		message		Message.
+ *	@param		signal		Signal (length set).
+ *	@param[in]	start		DBC start bit.
+ *	@param[in]	motorola	Big-endian (DBC @0).
+ *	@param		used		Data bits used by previous signals.
+ *	@return		0, or -1 if out of DLC or overlapping.
+ */
+static int mapSDBSignal(T_sdbMessage* message, T_sdbSignal* signal, unsigned start,
+	T_bit motorola, T_byte* used)
+{
+	T_sdbPart* part;
+	unsigned pos = start;
+	T_uint8 bit;
+	T_uint8 step;
+	T_uint8 byte;
+
+	memset(signal->part, 0, sizeof(signal->part));
+	for (step = 0U; LT(step, signal->length); step++) {
+		/* Motorola walks from MSB down, Intel from LSB up */
+		bit = (T_uint8)COND(IS(motorola), signal->length - 1U - step, step);
+		byte = (T_uint8)(pos >> 3U);
+		if (GEQ(byte, message->dlc) || NEQ(used[byte] & ToBit(pos & 7U), 0U)) {
+			return -1;
+		}
+		used[byte] |= (T_byte)ToBit(pos & 7U);
+		part = &signal->part[byte];
+		if (EQU(part->mask, 0U) || LT(bit, part->sigBit)) {
+			part->sigBit = bit;
+			part->byteBit = (T_uint8)(pos & 7U);
+		}
+		part->mask |= (T_uint8)ToBit(pos & 7U);
+		if (IS(motorola)) {
+			pos = COND(EQU(pos & 7U, 0U), pos + 15U, pos - 1U);
+		} else {
+			pos++;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ *	@fn			int readSDB(const char*)
+ *	@brief 		Reads messages and signals of a DBC file.
+ *	@param[in]	path	DBC file.
+ *	@return		0, or -1 on error (reported).
+ */
+static int readSDB(const char* path)
+{
+	char line[SDB_LINE_SIZE];
+	char name[SDB_NAME_SIZE];
+	char mux[SDB_NAME_SIZE];
+	char order[4];
+	T_byte used[SDB_DATA_SIZE];
+	FILE* file = fopen(path, "r");
+	T_sdbMessage* message = NULL;
+	T_sdbSignal* signal;
+	const char* text;
+	const char* unit;
+	unsigned long id;
+	unsigned start, length, dlc;
+	unsigned number = 0U;
+
+	if (EQU(file, NULL)) {
+		fprintf(stderr, "%s: unreadable\n", path);
+		return -1;
+	}
+	while (NEQ(fgets(line, sizeof(line), file), NULL)) {
+		number++;
+		line[strcspn(line, "\r\n")] = '\0';
+		if (EQU(sscanf(line, " BO_ %lu %63[A-Za-z0-9_]: %u", &id, name, &dlc), 3)) {
+			if (GEQ(sdbMessageCount, SDB_MAX_MESSAGES) || GT(dlc, SDB_DATA_SIZE)) {
+				fprintf(stderr, "%s:%u: too many messages or DLC over 8\n", path, number);
+				fclose(file);
+				return -1;
+			}
+			message = &sdbMessages[sdbMessageCount++];
+			strcpy(message->name, name);
+			message->extended = NEQ(id & SDB_EXT_FLAG, 0UL);
+			message->id = (T_dword)(id & ~SDB_EXT_FLAG);
+			message->dlc = (T_uint8)dlc;
+			message->count = 0U;
+			memset(used, 0, sizeof(used));
+			continue;
+		}
+		if (NEQ(sscanf(line, " SG_ %63s", name), 1)) {
+			continue;
+		}
+		if (EQU(message, NULL)) {
+			fprintf(stderr, "%s:%u: signal outside of a message\n", path, number);
+			fclose(file);
+			return -1;
+		}
+		if (NEQ(sscanf(line, " SG_ %63s %63s", name, mux), 2) || NEQ(strcmp(mux, ":"), 0)) {
+			fprintf(stderr, "%s:%u: multiplexed signal %s not supported\n", path, number,
+				name);
+			fclose(file);
+			return -1;
+		}
+		if (NEQ(sscanf(strchr(line, ':') + 1, " %u|%u@%3[01+-]", &start, &length, order), 3)
+			|| NEQ(strlen(order), 2U) || EQU(length, 0U) || GT(length, 32U)
+			|| GEQ(message->count, SDB_MAX_SIGNALS)) {
+			fprintf(stderr, "%s:%u: bad signal or over 32 bits\n", path, number);
+			fclose(file);
+			return -1;
+		}
+		signal = &message->signal[message->count++];
+		strcpy(signal->name, name);
+		/* definition up to the unit */
+		text = strchr(line, ':') + 1;
+		text += strspn(text, " \t");
+		unit = strchr(text, '"');
+		unit = COND(NEQ(unit, NULL), strchr(unit + 1, '"'), NULL);
+		snprintf(signal->text, sizeof(signal->text), "%.*s",
+			(int)COND(NEQ(unit, NULL), unit + 1 - text, (long)strlen(text)), text);
+		signal->length = (T_uint8)length;
+		signal->sign = EQU(order[1], '-');
+		if (NEQ(mapSDBSignal(message, signal, start, EQU(order[0], '0'), used), 0)) {
+			fprintf(stderr, "%s:%u: signal %s out of DLC or overlapping\n", path, number,
+				name);
+			fclose(file);
+			return -1;
+		}
+	}
+	fclose(file);
+
+	return 0;
+}
+
+/**
+ *	@fn			T_void printSDBPack(const T_sdbMessage*)
+ *	@brief 		Prints the pack macro function of a message.
+ *	@param[in]	message		Message.
+ *	@return		.
+ */
+static T_void printSDBPack(const T_sdbMessage* message)
+{
+	const T_sdbSignal* signal;
+	const T_sdbPart* part;
+	T_uint8 byte;
+	T_uint8 index;
+	T_bit first;
+
+	printf("/**\n *\t@def \t\tPack%s\n", message->name);
+	printf(" *\t@brief \t\tWrites %s signals into message buffer data.\n", message->name);
+	printf(" * \t@param\t\tDTR \tMessage buffer data (i.e. pTXCANBuffer[MBX]).\n");
+	printf(" * \t@param[in]\tMSG \tSignals (T_%s).\n * \t@return\t\t.\n */\n", message->name);
+	printf("#define Pack%s(DTR, MSG) { \\\n", message->name);
+	for (byte = 0U; LT(byte, message->dlc); byte++) {
+		printf("\t(DTR).BYTE[%u] = (T_byte)(", byte);
+		first = TRUE;
+		for (index = 0U; LT(index, message->count); index++) {
+			signal = &message->signal[index];
+			part = &signal->part[byte];
+			if (EQU(part->mask, 0U)) {
+				continue;
+			}
+			/* a full byte mask is left to the byte cast */
+			printf("%s%s(%s)(MSG).%s", COND(IS(first), "", " \\\n\t\t| "),
+				COND(EQU(part->mask, 0xFFU), "(", "(("), getSDBRawType(signal->length),
+				signal->name);
+			if (GT(part->sigBit, part->byteBit)) {
+				printf(" >> %uU", part->sigBit - part->byteBit);
+			} else if (LT(part->sigBit, part->byteBit)) {
+				printf(" << %uU", part->byteBit - part->sigBit);
+			}
+			if (NEQ(part->mask, 0xFFU)) {
+				printf(") & 0x%02XU", part->mask);
+			}
+			printf(")");
+			first = FALSE;
+		}
+		printf("%s); \\\n", COND(IS(first), "0U", ""));
+	}
+	printf("}\n\n");
+}
+
+/**
+ *	@fn			T_void printSDBUnpack(const T_sdbMessage*)
+ *	@brief 		Prints the unpack macro function of a message.
+ *	@param[in]	message		Message.
+ *	@return		.
+ */
+static T_void printSDBUnpack(const T_sdbMessage* message)
+{
+	const T_sdbSignal* signal;
+	const T_sdbPart* part;
+	const char* raw;
+	T_byte read = 0U;
+	T_uint8 byte;
+	T_uint8 index;
+	T_uint8 count;
+	T_bit extend;
+
+	printf("/**\n *\t@def \t\tUnpack%s\n", message->name);
+	printf(" *\t@brief \t\tReads %s signals from message buffer data.\n", message->name);
+	printf(" * \t@param[in]\tDTR \tMessage buffer data (i.e. pRXCANBuffer[MBX]).\n");
+	printf(" * \t@param[out]\tMSG \tSignals (T_%s).\n * \t@return\t\t.\n */\n", message->name);
+	printf("#define Unpack%s(DTR, MSG) { \\\n", message->name);
+	/* every used byte is read once */
+	for (index = 0U; LT(index, message->count); index++) {
+		for (byte = 0U; LT(byte, message->dlc); byte++) {
+			read |= (T_byte)COND(NEQ(message->signal[index].part[byte].mask, 0U),
+				ToBit(byte), 0U);
+		}
+	}
+	for (byte = 0U; LT(byte, message->dlc); byte++) {
+		if (NEQ(ReadBit(read, byte), 0U)) {
+			printf("\tT_byte b%u_ = (DTR).BYTE[%u]; \\\n", byte, byte);
+		}
+	}
+	for (index = 0U; LT(index, message->count); index++) {
+		signal = &message->signal[index];
+		raw = getSDBRawType(signal->length);
+		/* sign extension unless the container is just as long (T_sint32 is
+		 * long, wider than 32 bits on most hosts) */
+		extend = IS(signal->sign) && NEQ(signal->length, 8U) && NEQ(signal->length, 16U);
+		printf("\t(MSG).%s = (%s)(%s", signal->name, getSDBType(signal->length, signal->sign),
+			COND(IS(extend), "((", ""));
+		count = 0U;
+		for (byte = 0U; LT(byte, message->dlc); byte++) {
+			part = &signal->part[byte];
+			if (EQU(part->mask, 0U)) {
+				continue;
+			}
+			if (EQU(part->mask, 0xFFU)) {
+				printf("%s((%s)b%u_", COND(EQU(count, 0U), "", " \\\n\t\t| "), raw, byte);
+			} else {
+				printf("%s((%s)(b%u_ & 0x%02XU)", COND(EQU(count, 0U), "", " \\\n\t\t| "),
+					raw, byte, part->mask);
+			}
+			if (GT(part->sigBit, part->byteBit)) {
+				printf(" << %uU", part->sigBit - part->byteBit);
+			} else if (LT(part->sigBit, part->byteBit)) {
+				printf(" >> %uU", part->byteBit - part->sigBit);
+			}
+			printf(")");
+			count++;
+		}
+		if (IS(extend)) {
+			printf(") ^ 0x%lXUL) - 0x%lXUL", 1UL << (signal->length - 1U),
+				1UL << (signal->length - 1U));
+		}
+		printf("); \\\n");
+	}
+	printf("}\n\n");
+}
+
+/**
+ *	@fn			T_void printSDB(const char*, const char*)
+ *	@brief 		Prints the generated header.
+ *	@param[in]	name	Header name.
+ *	@param[in]	path	DBC file.
+ *	@return		.
+ */
+static T_void printSDB(const char* name, const char* path)
+{
+	const T_sdbMessage* message;
+	const T_sdbSignal* signal;
+	char guard[SDB_NAME_SIZE];
+	char upper[SDB_NAME_SIZE];
+	T_uint16 index;
+	T_uint8 sig;
+	size_t pos;
+
+	for (pos = 0U; LT(pos, SDB_NAME_SIZE - 3U) && NEQ(name[pos], '\0'); pos++) {
+		guard[pos] = (char)COND(isalnum((unsigned char)name[pos]),
+			toupper((unsigned char)name[pos]), '_');
+	}
+	strcpy(guard + pos, "_H");
+	printf("/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/\n");
+	printf("/**\n *\t@file\t\t%s.h\n", name);
+	printf(" *\t@brief\t\tThis file contains CAN message signals generated by sdb_gen\n");
+	printf(" *\t\t\t\tfrom %s (do not edit).\n**/\n", path);
+	printf("/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/\n\n");
+	printf("#ifndef %s\n#define %s\n\n#include <COM/can.h>\n\n", guard, guard);
+	for (index = 0U; LT(index, sdbMessageCount); index++) {
+		message = &sdbMessages[index];
+		for (pos = 0U; NEQ(message->name[pos], '\0'); pos++) {
+			upper[pos] = (char)toupper((unsigned char)message->name[pos]);
+		}
+		upper[pos] = '\0';
+		printf("/* ----------------------------------------------------------------------------\n");
+		printf("**\t%s Message.\n*/\n\n", message->name);
+		printf("/**\n *\t@def\t\t%s_ID, %s_FORMAT, %s_DLC\n", upper, upper, upper);
+		printf(" *\t@brief\t\tID, format and data length of %s.\n */\n", message->name);
+		printf("#define %s_ID\t\t(0x%lXUL)\n", upper, (unsigned long)message->id);
+		printf("#define %s_FORMAT\t%s\n", upper,
+			COND(IS(message->extended), "CAN_ID_EXT_FORMAT", "CAN_ID_STD_FORMAT"));
+		printf("#define %s_DLC\t\t(%uU)\n\n", upper, message->dlc);
+		printf("/**\n *\t@brief\t\tData structure for %s raw signal values.\n */\n",
+			message->name);
+		printf("typedef struct {\n");
+		for (sig = 0U; LT(sig, message->count); sig++) {
+			signal = &message->signal[sig];
+			printf("\t%s %s;\t/**< %s */\n", getSDBType(signal->length, signal->sign),
+				signal->name, signal->text);
+		}
+		if (EQU(message->count, 0U)) {
+			printf("\tT_uint8 unused;\n");
+		}
+		printf("} T_%s;\n\n", message->name);
+		printSDBPack(message);
+		printSDBUnpack(message);
+	}
+	printf("#endif /* %s. */\n", guard);
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	const char* name = "sdb";
+	const char* path = NULL;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-n"), 0) && LT(arg + 1, argc)) {
+			name = argv[++arg];
+		} else {
+			path = argv[arg];
+		}
+	}
+	if (EQU(path, NULL)) {
+		fprintf(stderr, "usage: %s [-n NAME] DBC\n", argv[0]);
+		return 2;
+	}
+	if (NEQ(readSDB(path), 0)) {
+		return 1;
+	}
+	printSDB(name, path);
+
+	return 0;
+}
+
+/* END OF SDB_GEN. */
@@ -0,0 +1,501 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Signal Database Round-Trip Test Host Tool								 */
+/**
+ *	@file		SDB/sdb_test.c
+ *	@brief		This file contains the host tool checking the pack and unpack
+ *				macro functions generated by sdb_gen against a generic bit
+ *				copy, and comparing their run time.
+ *	@details	Usage: sdb_test [-n ROUNDS] [-c CYCLES] [-s SEED] <br>
+ *				The header is generated from HOST/SDB/sdb_test.dbc, whose
+ *				messages hold every signal kind sdb_gen supports: Intel and
+ *				Motorola, signed and unsigned, 1 to 32 bits, byte aligned or
+ *				not, with a padding bit and a short DLC. The signal table below
+ *				repeats the DBC signals for the reference bit copy, which walks
+ *				the data bit per bit as table driven libraries do. <br>
+ *				For ROUNDS (default 100000) random value sets per message, Pack
+ *				must give the reference bytes (padding bits cleared) up to DLC,
+ *				and Unpack of the reference bytes, with random padding bits,
+ *				must give the values back. Then each message is packed and
+ *				unpacked CYCLES times (default 2M) by both ways and the time
+ *				per message is printed with the ratio. The exit status is 1 on
+ *				any mismatch. Built with: <br>
+ *				cc -I LIB/MB90385/include -o sdb_gen HOST/SDB/sdb_gen.c <br>
+ *				./sdb_gen -n sdb_test HOST/SDB/sdb_test.dbc > sdb_test.h <br>
+ *				cc -O2 -I LIB/MB90385/include -I . -o sdb_test
+ *				HOST/SDB/sdb_test.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sdb_test.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		SDB_TEST_ROUNDS
+ *	@brief 		Default round-trip count per message.
+ */
+#define SDB_TEST_ROUNDS			(100000UL)
+
+/**
+ * 	@def		SDB_TEST_CYCLES
+ *	@brief 		Default timing cycle count per message.
+ */
+#define SDB_TEST_CYCLES			(2000000UL)
+
+/**
+ * 	@def		SDB_TEST_SIGNALS
+ *	@brief 		Maximum signal count of a message.
+ */
+#define SDB_TEST_SIGNALS		(8U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Signal layout (as in the DBC).
+ */
+typedef struct {
+	T_uint8 start;		/**< Start bit. */
+	T_uint8 length;		/**< Length in bits. */
+	T_bit motorola;		/**< Motorola (@0) byte order. */
+	T_bit sign;			/**< Signed (-) value. */
+} T_sdbTestSignal;
+
+/**
+ *	@brief		Message under test.
+ */
+typedef struct {
+	const char* name;						/**< Message name. */
+	const T_sdbTestSignal* signals;			/**< Signal layouts. */
+	T_uint8 count;							/**< Signal count. */
+	T_uint8 dlc;							/**< Data length. */
+	T_void (*pack)(T_canid_dtr*, const long long*);	/**< Generated Pack. */
+	T_void (*unpack)(const T_canid_dtr*, long long*);	/**< Generated Unpack. */
+} T_sdbTestMessage;
+
+/* ----------------------------------------------------------------------------
+**	Generated Code Wrappers.
+*/
+
+/**
+ *	@fn			T_void packSDBTestEngine(T_canid_dtr*, const long long*)
+ *	@brief 		Packs Engine values with the generated macro.
+ *	@param[out]	pData	Message data.
+ *	@param[in]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void packSDBTestEngine(T_canid_dtr* pData, const long long* pValues)
+{
+	T_Engine engine;
+
+	engine.Speed = (T_uint16)pValues[0];
+	engine.Torque = (T_sint16)pValues[1];
+	engine.Gear = (T_sint8)pValues[2];
+	engine.Flag = (T_uint8)pValues[3];
+	engine.Odo = (T_uint32)pValues[4];
+	engine.Temp = (T_sint8)pValues[5];
+	PackEngine(*pData, engine);
+}
+
+/**
+ *	@fn			T_void unpackSDBTestEngine(const T_canid_dtr*, long long*)
+ *	@brief 		Unpacks Engine values with the generated macro.
+ *	@param[in]	pData	Message data.
+ *	@param[out]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void unpackSDBTestEngine(const T_canid_dtr* pData, long long* pValues)
+{
+	T_Engine engine;
+
+	UnpackEngine(*pData, engine);
+	pValues[0] = engine.Speed;
+	pValues[1] = engine.Torque;
+	pValues[2] = engine.Gear;
+	pValues[3] = engine.Flag;
+	pValues[4] = engine.Odo;
+	pValues[5] = engine.Temp;
+}
+
+/**
+ *	@fn			T_void packSDBTestExt(T_canid_dtr*, const long long*)
+ *	@brief 		Packs Ext values with the generated macro.
+ *	@param[out]	pData	Message data.
+ *	@param[in]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void packSDBTestExt(T_canid_dtr* pData, const long long* pValues)
+{
+	T_Ext ext;
+
+	ext.A = (T_uint32)pValues[0];
+	ext.B = (T_sint16)pValues[1];
+	ext.C = (T_uint8)pValues[2];
+	ext.D = (T_uint8)pValues[3];
+	PackExt(*pData, ext);
+}
+
+/**
+ *	@fn			T_void unpackSDBTestExt(const T_canid_dtr*, long long*)
+ *	@brief 		Unpacks Ext values with the generated macro.
+ *	@param[in]	pData	Message data.
+ *	@param[out]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void unpackSDBTestExt(const T_canid_dtr* pData, long long* pValues)
+{
+	T_Ext ext;
+
+	UnpackExt(*pData, ext);
+	pValues[0] = ext.A;
+	pValues[1] = ext.B;
+	pValues[2] = ext.C;
+	pValues[3] = ext.D;
+}
+
+/**
+ *	@fn			T_void packSDBTestWide(T_canid_dtr*, const long long*)
+ *	@brief 		Packs Wide values with the generated macro.
+ *	@param[out]	pData	Message data.
+ *	@param[in]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void packSDBTestWide(T_canid_dtr* pData, const long long* pValues)
+{
+	T_Wide wide;
+
+	wide.Level = (T_sint32)pValues[0];
+	wide.Count = (T_uint32)pValues[1];
+	wide.Mode = (T_sint8)pValues[2];
+	wide.Valid = (T_uint8)pValues[3];
+	PackWide(*pData, wide);
+}
+
+/**
+ *	@fn			T_void unpackSDBTestWide(const T_canid_dtr*, long long*)
+ *	@brief 		Unpacks Wide values with the generated macro.
+ *	@param[in]	pData	Message data.
+ *	@param[out]	pValues	Signal values in table order.
+ *	@return		.
+ */
+static T_void unpackSDBTestWide(const T_canid_dtr* pData, long long* pValues)
+{
+	T_Wide wide;
+
+	UnpackWide(*pData, wide);
+	pValues[0] = wide.Level;
+	pValues[1] = wide.Count;
+	pValues[2] = wide.Mode;
+	pValues[3] = wide.Valid;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		sdbTestEngine
+ *	@brief		Engine signals of sdb_test.dbc.
+ */
+static const T_sdbTestSignal sdbTestEngine[] = {
+	{7U, 12U, TRUE, FALSE}, {16U, 16U, FALSE, TRUE}, {11U, 4U, TRUE, TRUE},
+	{32U, 1U, FALSE, FALSE}, {33U, 27U, FALSE, FALSE}, {63U, 3U, TRUE, TRUE}
+};
+
+/**
+ *	@var		sdbTestExt
+ *	@brief		Ext signals of sdb_test.dbc.
+ */
+static const T_sdbTestSignal sdbTestExt[] = {
+	{7U, 32U, TRUE, FALSE}, {39U, 9U, TRUE, TRUE}, {40U, 7U, FALSE, FALSE},
+	{50U, 5U, FALSE, FALSE}
+};
+
+/**
+ *	@var		sdbTestWide
+ *	@brief		Wide signals of sdb_test.dbc.
+ */
+static const T_sdbTestSignal sdbTestWide[] = {
+	{0U, 32U, FALSE, TRUE}, {39U, 24U, TRUE, FALSE}, {56U, 7U, FALSE, TRUE},
+	{63U, 1U, TRUE, FALSE}
+};
+
+/**
+ *	@var		sdbTestMessages
+ *	@brief		Messages of sdb_test.dbc.
+ */
+static const T_sdbTestMessage sdbTestMessages[] = {
+	{"Engine", sdbTestEngine, SzElems_(sdbTestEngine, T_sdbTestSignal),
+		ENGINE_DLC, packSDBTestEngine, unpackSDBTestEngine},
+	{"Ext", sdbTestExt, SzElems_(sdbTestExt, T_sdbTestSignal),
+		EXT_DLC, packSDBTestExt, unpackSDBTestExt},
+	{"Wide", sdbTestWide, SzElems_(sdbTestWide, T_sdbTestSignal),
+		WIDE_DLC, packSDBTestWide, unpackSDBTestWide}
+};
+
+/**
+ *	@var		sdbTestSink
+ *	@brief		Timing result sink (keeps loops from being optimized out).
+ */
+static volatile long long sdbTestSink;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 nextSDBTestBit(T_uint8, T_bit)
+ *	@brief 		Gives the bit following a bit towards the LSB of a signal.
+ *	@param[in]	position	Bit position.
+ *	@param[in]	motorola	Motorola byte order.
+ *	@return		next position.
+ */
+static T_uint8 nextSDBTestBit(T_uint8 position, T_bit motorola)
+{
+	if (NOT(motorola)) {
+		return (T_uint8)(position + 1U);
+	}
+
+	return (T_uint8)(EQU(position & 7U, 0U) ? (position + 15U) : (position - 1U));
+}
+
+/**
+ *	@fn			T_void putSDBTestBits(T_byte*, const T_sdbTestSignal*,
+ *				long long)
+ *	@brief 		Writes a signal bit per bit (reference).
+ *	@param[out]	pData	Message data.
+ *	@param[in]	pSignal	Signal layout.
+ *	@param[in]	value	Signal value.
+ *	@return		.
+ */
+static T_void putSDBTestBits(T_byte* pData, const T_sdbTestSignal* pSignal,
+	long long value)
+{
+	T_uint8 position = pSignal->start, bit, index;
+	T_bit set;
+
+	for (index = 0U; LT(index, pSignal->length); index++) {
+		/* Intel walks from the LSB, Motorola from the MSB */
+		bit = IS(pSignal->motorola) ? (T_uint8)(pSignal->length - 1U - index)
+			: index;
+		set = (T_bit)(((unsigned long long)value >> bit) & 1U);
+		if (IS(set)) {
+			pData[position >> 3U] |= (T_byte)(1U << (position & 7U));
+		} else {
+			pData[position >> 3U] &= (T_byte)~(1U << (position & 7U));
+		}
+		position = nextSDBTestBit(position, pSignal->motorola);
+	}
+}
+
+/**
+ *	@fn			long long getSDBTestBits(const T_byte*,
+ *				const T_sdbTestSignal*)
+ *	@brief 		Reads a signal bit per bit (reference).
+ *	@param[in]	pData	Message data.
+ *	@param[in]	pSignal	Signal layout.
+ *	@return		signal value.
+ */
+static long long getSDBTestBits(const T_byte* pData,
+	const T_sdbTestSignal* pSignal)
+{
+	unsigned long long value = 0ULL, sign;
+	T_uint8 position = pSignal->start, bit, index;
+
+	for (index = 0U; LT(index, pSignal->length); index++) {
+		bit = IS(pSignal->motorola) ? (T_uint8)(pSignal->length - 1U - index)
+			: index;
+		if (IS((pData[position >> 3U] >> (position & 7U)) & 1U)) {
+			value |= 1ULL << bit;
+		}
+		position = nextSDBTestBit(position, pSignal->motorola);
+	}
+	if (IS(pSignal->sign)) {
+		sign = 1ULL << (pSignal->length - 1U);
+		return (long long)((value ^ sign) - sign);
+	}
+
+	return (long long)value;
+}
+
+/**
+ *	@fn			long long randomSDBTestValue(const T_sdbTestSignal*)
+ *	@brief 		Gives a random value in signal range.
+ *	@param[in]	pSignal	Signal layout.
+ *	@return		value.
+ */
+static long long randomSDBTestValue(const T_sdbTestSignal* pSignal)
+{
+	unsigned long long value, sign;
+
+	value = ((unsigned long long)rand() << 16U) ^ (unsigned long long)rand();
+	value &= (1ULL << pSignal->length) - 1ULL;
+	if (IS(pSignal->sign)) {
+		sign = 1ULL << (pSignal->length - 1U);
+		return (long long)((value ^ sign) - sign);
+	}
+
+	return (long long)value;
+}
+
+/**
+ *	@fn			unsigned long checkSDBTestMessage(const T_sdbTestMessage*,
+ *				unsigned long)
+ *	@brief 		Runs round trips of a message.
+ *	@param[in]	pMessage	Message under test.
+ *	@param[in]	rounds		Round count.
+ *	@return		failed rounds.
+ */
+static unsigned long checkSDBTestMessage(const T_sdbTestMessage* pMessage,
+	unsigned long rounds)
+{
+	long long values[SDB_TEST_SIGNALS], unpacked[SDB_TEST_SIGNALS];
+	T_byte reference[8];
+	T_canid_dtr data;
+	unsigned long round, failed = 0UL;
+	T_uint8 index;
+
+	for (round = 0UL; round < rounds; round++) {
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			values[index] = randomSDBTestValue(&pMessage->signals[index]);
+		}
+		/* Pack writes every byte, padding bits are cleared */
+		for (index = 0U; LT(index, 8U); index++) {
+			data.BYTE[index] = (T_byte)rand();
+			reference[index] = 0U;
+		}
+		pMessage->pack(&data, values);
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			putSDBTestBits(reference, &pMessage->signals[index], values[index]);
+		}
+		if (NEQ(memcmp(data.BYTE, reference, pMessage->dlc), 0)) {
+			if (EQU(failed, 0UL)) {
+				printf("%s: pack mismatch at round %lu\n", pMessage->name, round);
+			}
+			failed++;
+			continue;
+		}
+		/* Unpack ignores padding bits */
+		for (index = 0U; LT(index, 8U); index++) {
+			data.BYTE[index] = (T_byte)rand();
+		}
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			putSDBTestBits(data.BYTE, &pMessage->signals[index], values[index]);
+		}
+		pMessage->unpack(&data, unpacked);
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			if (NEQ(unpacked[index], values[index])
+				|| NEQ(getSDBTestBits(data.BYTE, &pMessage->signals[index]),
+					values[index])) {
+				if (EQU(failed, 0UL)) {
+					printf("%s: unpack mismatch at round %lu, signal %u\n",
+						pMessage->name, round, (unsigned)index);
+				}
+				failed++;
+				break;
+			}
+		}
+	}
+
+	return failed;
+}
+
+/**
+ *	@fn			T_void timeSDBTestMessage(const T_sdbTestMessage*,
+ *				unsigned long)
+ *	@brief 		Prints pack and unpack time of a message by both ways.
+ *	@param[in]	pMessage	Message under test.
+ *	@param[in]	cycles		Cycle count.
+ *	@return		.
+ */
+static T_void timeSDBTestMessage(const T_sdbTestMessage* pMessage,
+	unsigned long cycles)
+{
+	long long values[SDB_TEST_SIGNALS];
+	T_canid_dtr data;
+	unsigned long cycle;
+	clock_t start;
+	double generated, bitCopy;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, pMessage->count); index++) {
+		values[index] = randomSDBTestValue(&pMessage->signals[index]);
+	}
+	memset(&data, 0, sizeof(data));
+	start = clock();
+	for (cycle = 0UL; cycle < cycles; cycle++) {
+		values[0] ^= (long long)(cycle & 1UL);
+		pMessage->pack(&data, values);
+		pMessage->unpack(&data, values);
+		sdbTestSink += values[pMessage->count - 1U];
+	}
+	generated = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / cycles;
+	start = clock();
+	for (cycle = 0UL; cycle < cycles; cycle++) {
+		values[0] ^= (long long)(cycle & 1UL);
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			putSDBTestBits(data.BYTE, &pMessage->signals[index], values[index]);
+		}
+		for (index = 0U; LT(index, pMessage->count); index++) {
+			values[index] = getSDBTestBits(data.BYTE, &pMessage->signals[index]);
+		}
+		sdbTestSink += values[pMessage->count - 1U];
+	}
+	bitCopy = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / cycles;
+	printf("%-8s generated %7.1f ns  bit copy %7.1f ns  ratio %.1f\n",
+		pMessage->name, generated, bitCopy,
+		(generated > 0.0) ? (bitCopy / generated) : 0.0);
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	unsigned long rounds = SDB_TEST_ROUNDS, cycles = SDB_TEST_CYCLES;
+	unsigned long failed, total = 0UL;
+	unsigned seed = 1U;
+	T_uint8 index;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if ((strcmp(argv[arg], "-n") == 0) && (arg + 1 < argc)) {
+			rounds = strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-c") == 0) && (arg + 1 < argc)) {
+			cycles = strtoul(argv[++arg], NULL, 0);
+		} else if ((strcmp(argv[arg], "-s") == 0) && (arg + 1 < argc)) {
+			seed = (unsigned)strtoul(argv[++arg], NULL, 0);
+		} else {
+			fprintf(stderr, "usage: %s [-n ROUNDS] [-c CYCLES] [-s SEED]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+	srand(seed);
+	for (index = 0U; LT(index, SzElems_(sdbTestMessages, T_sdbTestMessage));
+		index++) {
+		failed = checkSDBTestMessage(&sdbTestMessages[index], rounds);
+		printf("%-8s %u signals, %lu rounds, %lu failed\n",
+			sdbTestMessages[index].name, (unsigned)sdbTestMessages[index].count,
+			rounds, failed);
+		total += failed;
+	}
+	if (cycles > 0UL) {
+		for (index = 0U;
+			LT(index, SzElems_(sdbTestMessages, T_sdbTestMessage)); index++) {
+			timeSDBTestMessage(&sdbTestMessages[index], cycles);
+		}
+	}
+
+	return NEQ(total, 0UL);
+}
+
+/* END OF SDB_TEST. */
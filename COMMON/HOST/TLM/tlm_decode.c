@@ -0,0 +1,430 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Binary Telemetry Decoder Host Tool										 */
+/**
+ *	@file		TLM/tlm_decode.c
+ *	@brief		This file contains the host command line tool turning a TLM
+ *				stream into CSV, and measuring TLM against the ASCII output.
+ *	@details	Usage: tlm_decode [-n VALUES] [-t TYPE] [FILE] <br>
+ *				tlm_decode -b [-n VALUES] <br>
+ *				The stream is read from FILE (i.e. the serial device,
+ *				configured beforehand with stty) or standard input. Every valid
+ *				frame (COBS decoded, CRC-16 checked) gives one CSV line per
+ *				sample: channel, sequence, sample index within the frame, then
+ *				the values. VALUES is the value count per sample (0, the
+ *				default, takes the whole payload as one sample) and TYPE is f
+ *				(float, default), u8, s8, u16, s16, u32 or s32. Invalid frames
+ *				and sequence gaps are counted on standard error at the end. The
+ *				CSV can be plotted live, i.e. through
+ *				tail -f out.csv | feedgnuplot --stream. <br>
+ *				With -b, the tool encodes 10000 PID demo samples (setpoint and
+ *				process value, or VALUES floats) through the TLM library with
+ *				1 to 32 samples per frame, decodes them back, and prints bytes
+ *				per sample, samples per second at 38461 baud and the ratio to
+ *				the ASCII line of the PID demo carrying the same values
+ *				("setPoint : processValue = ", then values printed with two
+ *				decimals as dPrint does and separated by " : ", CR LF ended).
+ *				It fails on any value not decoded back. Built with: <br>
+ *				cc -I LIB/MB90385/include -I LIB/EXTRA/include -o tlm_decode
+ *				HOST/TLM/tlm_decode.c LIB/EXTRA/implement/TLM/tlm.c
+ *				<br> (TLM_MAX_PAYLOAD as for the target, e.g. -DTLM_MAX_PAYLOAD=
+ *				249U).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <TLM/tlm.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		TLM_DECODE_BAUD
+ *	@brief 		Link speed of the rate comparison (bit/s, 10 bits per byte).
+ */
+#define TLM_DECODE_BAUD				(38461UL)
+
+/**
+ * 	@def		TLM_DECODE_SAMPLES
+ *	@brief 		Sample count of the comparison.
+ */
+#define TLM_DECODE_SAMPLES			(10000UL)
+
+/**
+ * 	@def		TLM_DECODE_MAX_FRAME
+ *	@brief 		Largest encoded frame without delimiter.
+ */
+#define TLM_DECODE_MAX_FRAME		(254U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for a payload value type.
+ */
+typedef struct {
+	const char* name;
+	T_uint8 size;
+	T_bit isSigned;
+	T_bit isFloat;
+} T_tlmDecodeType;
+
+/**
+ *	@brief		Data structure for decoder counters.
+ */
+typedef struct {
+	unsigned long frames;
+	unsigned long invalid;
+	unsigned long gaps;
+	T_sint16 sequence[256];
+} T_tlmDecodeStats;
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		tlmDecodeTypes
+ *	@brief		Payload value types.
+ */
+static const T_tlmDecodeType tlmDecodeTypes[] = {
+	{ "f", 4U, TRUE, TRUE },
+	{ "u8", 1U, FALSE, FALSE },
+	{ "s8", 1U, TRUE, FALSE },
+	{ "u16", 2U, FALSE, FALSE },
+	{ "s16", 2U, TRUE, FALSE },
+	{ "u32", 4U, FALSE, FALSE },
+	{ "s32", 4U, TRUE, FALSE }
+};
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		tlmCapture, tlmCaptureSize
+ *	@brief		Bytes written by the TLM library in the comparison.
+ */
+static T_uint8* tlmCapture;
+static size_t tlmCaptureSize;
+
+/* ----------------------------------------------------------------------------
+**	Serial Stub.
+*/
+
+T_uint8 writeSERBytes(const T_uint8* pBuff, T_uint8 len)
+{
+	memcpy(tlmCapture + tlmCaptureSize, pBuff, len);
+	tlmCaptureSize += len;
+
+	return len;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint32 readTLMValue(const T_uint8*, T_uint8)
+ *	@brief 		Reads a little-endian value.
+ *	@param[in]	pBuff	Value bytes.
+ *	@param[in]	size	Value size.
+ *	@return		value bits.
+ */
+static T_uint32 readTLMValue(const T_uint8* pBuff, T_uint8 size)
+{
+	T_uint32 value = 0UL;
+
+	while (NEQ(size, 0U)) {
+		size--;
+		value = (value << 8U) | pBuff[size];
+	}
+
+	return value;
+}
+
+/**
+ *	@fn			T_uint8 checkTLMFrame(const T_uint8*, T_uint8, T_uint8*)
+ *	@brief 		Decodes a received frame and checks its CRC-16.
+ *	@param[in]	pSrc	Encoded frame (without delimiter).
+ *	@param[in]	len		Encoded frame size.
+ *	@param[out]	pDest	Decoded frame.
+ *	@return		decoded size without CRC (zero if invalid).
+ */
+static T_uint8 checkTLMFrame(const T_uint8* pSrc, T_uint8 len, T_uint8* pDest)
+{
+	T_uint8 size = decodeTLMCOBS(pDest, pSrc, len);
+
+	if (LT(size, TLM_HEADER_SIZE + TLM_CRC_SIZE)) {
+		return 0U;
+	}
+	size -= TLM_CRC_SIZE;
+	if (NEQ(computeTLMCRC(pDest, size), (T_uint16)readTLMValue(pDest + size, TLM_CRC_SIZE))) {
+		return 0U;
+	}
+
+	return size;
+}
+
+/**
+ *	@fn			T_void printTLMFrame(const T_uint8*, T_uint8, T_uint8,
+ *					const T_tlmDecodeType*, T_tlmDecodeStats*)
+ *	@brief 		Prints the samples of a valid frame as CSV lines.
+ *	@param[in]	frame	Decoded frame (without CRC).
+ *	@param[in]	size	Decoded frame size.
+ *	@param[in]	values	Values per sample (0 for the whole payload).
+ *	@param[in]	type	Value type.
+ *	@param		stats	Decoder counters.
+ *	@return		.
+ */
+static T_void printTLMFrame(const T_uint8* frame, T_uint8 size, T_uint8 values,
+	const T_tlmDecodeType* type, T_tlmDecodeStats* stats)
+{
+	union {
+		T_float32 value;
+		T_uint32 bits;
+	} binary;
+	T_uint8 count = (T_uint8)((size - TLM_HEADER_SIZE) / type->size);
+	T_uint8 index;
+	T_uint32 bits;
+
+	/* count sequence gaps per channel */
+	if (GEQ(stats->sequence[frame[0]], 0) && NEQ(frame[1],
+		(T_uint8)(stats->sequence[frame[0]] + 1))) {
+		stats->gaps++;
+	}
+	stats->sequence[frame[0]] = frame[1];
+	stats->frames++;
+	if (EQU(values, 0U)) {
+		values = count;
+	}
+	for (index = 0U; LT(index, count); index++) {
+		if (EQU(index % values, 0U)) {
+			printf("%u,%u,%u", frame[0], frame[1], index / values);
+		}
+		bits = readTLMValue(frame + TLM_HEADER_SIZE + index * type->size, type->size);
+		if (IS(type->isFloat)) {
+			binary.bits = bits;
+			printf(",%.7g", binary.value);
+		} else if (IS(type->isSigned)) {
+			/* sign extend */
+			bits ^= 1UL << (type->size * 8U - 1U);
+			printf(",%ld", (long)bits - (1L << (type->size * 8U - 1U)));
+		} else {
+			printf(",%lu", (unsigned long)bits);
+		}
+		if (EQU(index % values, values - 1U) || EQU(index, count - 1U)) {
+			printf("\n");
+		}
+	}
+}
+
+/**
+ *	@fn			int decodeTLMStream(FILE*, T_uint8, const T_tlmDecodeType*)
+ *	@brief 		Turns a TLM stream into CSV lines.
+ *	@param		input	Stream.
+ *	@param[in]	values	Values per sample.
+ *	@param[in]	type	Value type.
+ *	@return		exit status.
+ */
+static int decodeTLMStream(FILE* input, T_uint8 values, const T_tlmDecodeType* type)
+{
+	T_tlmDecodeStats stats;
+	T_uint8 encoded[TLM_DECODE_MAX_FRAME];
+	T_uint8 frame[TLM_DECODE_MAX_FRAME];
+	unsigned int length = 0U;
+	T_uint8 size;
+	int byte;
+
+	memset(&stats, 0, SzBytes_(stats));
+	memset(stats.sequence, 0xFF, SzBytes_(stats.sequence));
+	while (NEQ(byte = fgetc(input), EOF)) {
+		if (NEQ(byte, 0)) {
+			/* oversized frames are kept counting until their delimiter */
+			if (LT(length, TLM_DECODE_MAX_FRAME)) {
+				encoded[length] = (T_uint8)byte;
+			}
+			length++;
+			continue;
+		}
+		if (EQU(length, 0U)) {
+			continue;
+		}
+		size = 0U;
+		if (LEQ(length, TLM_DECODE_MAX_FRAME)) {
+			size = checkTLMFrame(encoded, (T_uint8)length, frame);
+		}
+		if (EQU(size, 0U)) {
+			stats.invalid++;
+		} else {
+			printTLMFrame(frame, size, values, type, &stats);
+		}
+		length = 0U;
+	}
+	fflush(stdout);
+	fprintf(stderr, "%lu frames, %lu invalid, %lu sequence gaps\n", stats.frames,
+		stats.invalid, stats.gaps);
+
+	return 0;
+}
+
+/**
+ *	@fn			T_float32 getTLMSampleValue(unsigned long, T_uint8)
+ *	@brief 		Gets a value of a comparison sample (exact in binary and with
+ *				two decimals).
+ *	@param[in]	count	Sample number.
+ *	@param[in]	index	Value index.
+ *	@return		value.
+ */
+static T_float32 getTLMSampleValue(unsigned long count, T_uint8 index)
+{
+	return (T_float32)((count * (index + 1UL)) % 1024UL) + 0.5F;
+}
+
+/**
+ *	@fn			int compareTLMOutput(T_uint8)
+ *	@brief 		Encodes PID demo samples with several batch sizes, checks the
+ *				decoded values and compares line usage with the ASCII output.
+ *	@param[in]	values	Floats per sample (2 for the PID demo).
+ *	@return		exit status.
+ */
+static int compareTLMOutput(T_uint8 values)
+{
+	static const T_uint8 batches[] = { 1U, 2U, 4U, 8U, 16U, 32U };
+	T_float32 sample[TLM_MAX_PAYLOAD / 4U];
+	T_uint8 frame[TLM_DECODE_MAX_FRAME];
+	char line[32];
+	unsigned long ascii = 0UL;
+	unsigned long failed = 0UL;
+	unsigned long count;
+	unsigned long decoded;
+	unsigned long errors;
+	size_t start;
+	size_t end;
+	T_tlmFrame tlm;
+	T_uint8 batch;
+	T_uint8 offset;
+	T_uint8 index;
+	T_uint8 size;
+	double perSample;
+	union {
+		T_float32 value;
+		T_uint32 bits;
+	} binary;
+
+	if (EQU(values, 0U) || GT(values, TLM_MAX_PAYLOAD / 4U)) {
+		fprintf(stderr, "1 to %u values per sample\n", TLM_MAX_PAYLOAD / 4U);
+		return 2;
+	}
+	/* ASCII output of the PID demo (dPrint with two decimals) */
+	for (count = 0UL; LT(count, TLM_DECODE_SAMPLES); count++) {
+		ascii += strlen("setPoint : processValue = ") + strlen("\r\n");
+		for (index = 0U; LT(index, values); index++) {
+			ascii += (unsigned long)snprintf(line, SzBytes_(line), "%s%.2f",
+				COND(EQU(index, 0U), "", " : "), getTLMSampleValue(count, index));
+		}
+	}
+	tlmCapture = malloc(TLM_DECODE_SAMPLES * (values * 4UL + 8UL));
+	printf("TLM_MAX_PAYLOAD %u, %u floats per sample, ASCII %.2f bytes per sample"
+		" (%.0f samples/s)\n", TLM_MAX_PAYLOAD, values, (double)ascii / TLM_DECODE_SAMPLES,
+		TLM_DECODE_BAUD / 10.0 / ((double)ascii / TLM_DECODE_SAMPLES));
+	printf("batch  frame  bytes/sample  samples/s  ratio  errors\n");
+	for (index = 0U; LT(index, SzElems_(batches, T_uint8)); index++) {
+		batch = batches[index];
+		if (GT((T_uint16)batch * values * 4U, TLM_MAX_PAYLOAD)) {
+			break;
+		}
+		/* encode */
+		initTLM();
+		tlmCaptureSize = 0U;
+		beginTLMFrame(&tlm, 1U);
+		for (count = 0UL; LT(count, TLM_DECODE_SAMPLES); count++) {
+			for (size = 0U; LT(size, values); size++) {
+				sample[size] = getTLMSampleValue(count, size);
+			}
+			(T_void)batchTLMFloats(&tlm, sample, values, batch);
+		}
+		(T_void)sendTLMFrame(&tlm);
+		/* decode and check every value */
+		decoded = 0UL;
+		errors = 0UL;
+		for (start = 0U; LT(start, tlmCaptureSize); start = end + 1U) {
+			for (end = start; NEQ(tlmCapture[end], 0U); end++) {
+			}
+			size = checkTLMFrame(tlmCapture + start, (T_uint8)(end - start), frame);
+			if (EQU(size, 0U)) {
+				continue;
+			}
+			for (offset = TLM_HEADER_SIZE; LT(offset, size); offset += 4U, decoded++) {
+				binary.bits = readTLMValue(frame + offset, 4U);
+				if (NEQ(binary.value, getTLMSampleValue(decoded / values,
+					(T_uint8)(decoded % values)))) {
+					errors++;
+				}
+			}
+		}
+		errors += TLM_DECODE_SAMPLES * values - decoded;
+		perSample = (double)tlmCaptureSize / TLM_DECODE_SAMPLES;
+		printf("%5u  %5u  %12.2f  %9.0f  %4.2fx  %6lu\n", batch,
+			(unsigned int)(batch * values * 4U + 6U), perSample,
+			TLM_DECODE_BAUD / 10.0 / perSample, (double)ascii / tlmCaptureSize, errors);
+		failed += errors;
+	}
+	free(tlmCapture);
+
+	return COND(EQU(failed, 0UL), 0, 1);
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	const T_tlmDecodeType* type = &tlmDecodeTypes[0];
+	FILE* input = stdin;
+	T_bit compare = FALSE;
+	T_uint8 values = 0U;
+	T_uint8 index;
+	int status;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-b"), 0)) {
+			compare = TRUE;
+		} else if (EQU(strcmp(argv[arg], "-n"), 0) && LT(arg + 1, argc)) {
+			values = (T_uint8)strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-t"), 0) && LT(arg + 1, argc)) {
+			arg++;
+			for (index = 0U; LT(index, SzElems_(tlmDecodeTypes, T_tlmDecodeType)); index++) {
+				if (EQU(strcmp(argv[arg], tlmDecodeTypes[index].name), 0)) {
+					type = &tlmDecodeTypes[index];
+				}
+			}
+		} else if (NEQ(argv[arg][0], '-') && EQU(input, stdin)) {
+			input = fopen(argv[arg], "rb");
+			if (EQU(input, NULL)) {
+				perror(argv[arg]);
+				return 1;
+			}
+		} else {
+			fprintf(stderr, "usage: %s [-n VALUES] [-t TYPE] [FILE]\n"
+				"       %s -b [-n VALUES]\n", argv[0], argv[0]);
+			return 2;
+		}
+	}
+	if (IS(compare)) {
+		return compareTLMOutput(COND(EQU(values, 0U), 2U, values));
+	}
+	status = decodeTLMStream(input, values, type);
+	if (NEQ(input, stdin)) {
+		fclose(input);
+	}
+
+	return status;
+}
+
+/* END OF TLM_DECODE. */
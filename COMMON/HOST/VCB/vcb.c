@@ -0,0 +1,777 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Host Simulation Implementation							 */
+/**
+ *	@file		VCB/vcb.c
+ *	@brief		This file contains VCB scheduler and bus functions
+ *				implementation.
+ *	@details	Node threads hand control over to each other through the
+ *				scheduler (one mutex, one condition per node), so exactly one
+ *				thread runs at a time and the register variables of the library
+ *				need no locking. The register variables are plain memory on the
+ *				host, so completion bits (RCR, TCR, RRTRR, ROVRR) are settled
+ *				after every handler and at every swap out: a bit stays set only
+ *				if it was set before and still reads set (writing 0 clears,
+ *				writing 1 has no effect), TREQR keeps its bits, and TCANR
+ *				cancels every request pending before the run but the one on
+ *				the bus (a buffer cancelled and requested again in the same run
+ *				stays cancelled, as if the cancel took effect late).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCB/vcb.h>
+#include <pthread.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		VCB_SCHEDULER
+ *	@brief 		Turn of the scheduler thread.
+ */
+#define VCB_SCHEDULER			(-1)
+
+/**
+ * 	@def		VCB_STD_BITS, VCB_EXT_BITS
+ *	@brief 		Compared bits of bit-ordered IDs per format.
+ */
+#define VCB_STD_BITS			(0x1FFC0000UL)
+#define VCB_EXT_BITS			(0x1FFFFFFFUL)
+
+/**
+ * 	@def		VCB_FRAME_TAIL
+ *	@brief 		Frame bits after CRC (CRC delimiter, ACK, EOF and interframe
+ *				space).
+ */
+#define VCB_FRAME_TAIL			(13U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for completion registers as last settled.
+ */
+typedef struct {
+	T_byte treqr;
+	T_byte tcr;
+	T_byte rcr;
+	T_byte rrtrr;
+	T_byte rovrr;
+} T_vcbSettled;
+
+/**
+ *	@brief		Data structure for simulated node.
+ */
+typedef struct {
+	pthread_t thread;
+	pthread_cond_t turn;
+	T_vcbISR rx;
+	T_vcbISR tx;
+	uint64_t wake;
+	uint64_t requested[CAN_MB_SIZE];
+	T_bvalr bvalr;
+	T_treqr treqr;
+	T_tcanr tcanr;
+	T_tcr tcr;
+	T_rcr rcr;
+	T_rrtrr rrtrr;
+	T_rovrr rovrr;
+	T_rier rier;
+	T_canid canid;
+	T_canct canct;
+	T_vcbDriver driver;
+	T_vcbSettled settled;
+	T_uint8 index;
+	T_bit irq;
+	T_bit finished;
+} T_vcbNode;
+
+/**
+ *	@brief		Data structure for frame on the bus.
+ */
+typedef struct {
+	T_dword id;
+	T_canid_dtr data;
+	uint64_t end;
+	T_uint8 node;
+	T_uint8 buffer;
+	T_uint8 dlc;
+	T_bit extended;
+	T_bit remote;
+	T_bit active;
+} T_vcbFrame;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		vcbNodes, vcbNodeCount
+ *	@brief		Simulated nodes.
+ */
+static T_vcbNode vcbNodes[VCB_MAX_NODES];
+static T_uint8 vcbNodeCount;
+
+/**
+ *	@var		vcbMain
+ *	@brief		Node entry point.
+ */
+static T_vcbMain vcbMain;
+
+/**
+ *	@var		vcbLock, vcbSchedule, vcbTurn
+ *	@brief		Hand over lock, scheduler condition, and running thread.
+ */
+static pthread_mutex_t vcbLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vcbSchedule = PTHREAD_COND_INITIALIZER;
+static int vcbTurn = VCB_SCHEDULER;
+
+/**
+ *	@var		vcbCurrent
+ *	@brief		Node whose registers are in the register variables.
+ */
+static T_uint8 vcbCurrent;
+
+/**
+ *	@var		vcbTime, vcbBitTime, vcbEnd
+ *	@brief		Global virtual clock, bit time and end of run (ns).
+ */
+static uint64_t vcbTime;
+static uint64_t vcbBitTime;
+static uint64_t vcbEnd;
+
+/**
+ *	@var		vcbStop
+ *	@brief		End of run (node threads exit when resumed).
+ */
+static volatile T_bit vcbStop;
+
+/**
+ *	@var		vcbBus
+ *	@brief		Frame on the bus.
+ */
+static T_vcbFrame vcbBus;
+
+/**
+ *	@var		vcbStats
+ *	@brief		Bus statistics.
+ */
+static T_vcbStats vcbStats;
+
+/* ----------------------------------------------------------------------------
+**	External Variables.
+*/
+
+/**
+ * 	@var		vcbTBTCount
+ *	@brief		Timebase timer count of the global virtual clock.
+ */
+T_gptCount vcbTBTCount;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void setVCBTime(uint64_t)
+ *	@brief 		Sets the global virtual clock and the timebase timer count.
+ *	@param[in]	time	Virtual time (ns).
+ *	@return		.
+ */
+static T_void setVCBTime(uint64_t time)
+{
+	vcbTime = time;
+	vcbTBTCount = (T_gptCount)(time / 1024000ULL);
+}
+
+/**
+ *	@fn			T_void settleVCBRegisters(T_vcbNode*)
+ *	@brief 		Applies write semantics of completion, request and cancel
+ *				registers of the selected node.
+ *	@param		node	Selected node.
+ *	@return		.
+ */
+static T_void settleVCBRegisters(T_vcbNode* node)
+{
+	T_vcbSettled* settled = &node->settled;
+	T_byte cancel = GetCAN_TCANR();
+	T_byte requests;
+	T_uint8 buffer;
+
+	if (IS(vcbBus.active) && EQU(vcbBus.node, node->index)) {
+		cancel &= (T_byte)~ToBit(vcbBus.buffer);
+	}
+	/* cancel applies to requests pending before the node run */
+	requests = (T_byte)((settled->treqr | GetCAN_TREQR()) & ~(cancel & settled->treqr));
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NEQ(ReadBit(requests & ~settled->treqr, buffer), 0U)) {
+			node->requested[buffer] = vcbTime;
+		}
+	}
+	settled->treqr = requests;
+	settled->tcr &= GetCAN_TCR();
+	settled->rcr &= GetCAN_RCR();
+	settled->rrtrr &= GetCAN_RRTRR();
+	settled->rovrr &= GetCAN_ROVRR();
+	SetCAN_TREQR(settled->treqr);
+	SetCAN_TCANR(0U);
+	SetCAN_TCR(settled->tcr);
+	SetCAN_RCR(settled->rcr);
+	SetCAN_RRTRR(settled->rrtrr);
+	SetCAN_ROVRR(settled->rovrr);
+}
+
+/**
+ *	@fn			T_void selectVCBNode(T_uint8)
+ *	@brief 		Swaps the registers and driver state of a node in.
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void selectVCBNode(T_uint8 index)
+{
+	T_vcbNode* node;
+
+	if (EQU(index, vcbCurrent)) {
+		return;
+	}
+	/* swap current node out */
+	node = &vcbNodes[vcbCurrent];
+	settleVCBRegisters(node);
+	node->bvalr = IO_BVALR;
+	node->treqr = IO_TREQR;
+	node->tcanr = IO_TCANR;
+	node->tcr = IO_TCR;
+	node->rcr = IO_RCR;
+	node->rrtrr = IO_RRTRR;
+	node->rovrr = IO_ROVRR;
+	node->rier = IO_RIER;
+	node->canid = IO_CANID;
+	node->canct = IO_CANCT;
+	node->driver = vcbDriver;
+	/* swap node in */
+	node = &vcbNodes[index];
+	IO_BVALR = node->bvalr;
+	IO_TREQR = node->treqr;
+	IO_TCANR = node->tcanr;
+	IO_TCR = node->tcr;
+	IO_RCR = node->rcr;
+	IO_RRTRR = node->rrtrr;
+	IO_ROVRR = node->rovrr;
+	IO_RIER = node->rier;
+	IO_CANID = node->canid;
+	IO_CANCT = node->canct;
+	vcbDriver = node->driver;
+	vcbCurrent = index;
+}
+
+/**
+ *	@fn			T_void resumeVCBNode(T_uint8)
+ *	@brief 		Runs a node thread until it waits or returns.
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void resumeVCBNode(T_uint8 index)
+{
+	selectVCBNode(index);
+	pthread_mutex_lock(&vcbLock);
+	vcbTurn = index;
+	pthread_cond_signal(&vcbNodes[index].turn);
+	while (NEQ(vcbTurn, VCB_SCHEDULER)) {
+		pthread_cond_wait(&vcbSchedule, &vcbLock);
+	}
+	pthread_mutex_unlock(&vcbLock);
+	settleVCBRegisters(&vcbNodes[index]);
+}
+
+/**
+ *	@fn			T_void yieldVCBNode(T_vcbNode*)
+ *	@brief 		Hands control back to the scheduler until resumed (the
+ *				thread exits if the run is over).
+ *	@param		node	Calling node.
+ *	@return		.
+ */
+static T_void yieldVCBNode(T_vcbNode* node)
+{
+	pthread_mutex_lock(&vcbLock);
+	vcbTurn = VCB_SCHEDULER;
+	pthread_cond_signal(&vcbSchedule);
+	while (NEQ(vcbTurn, node->index)) {
+		pthread_cond_wait(&node->turn, &vcbLock);
+	}
+	if (IS(vcbStop)) {
+		node->finished = TRUE;
+		vcbTurn = VCB_SCHEDULER;
+		pthread_cond_signal(&vcbSchedule);
+		pthread_mutex_unlock(&vcbLock);
+		pthread_exit(NULL);
+	}
+	pthread_mutex_unlock(&vcbLock);
+}
+
+/**
+ *	@fn			T_void* runVCBNode(T_void*)
+ *	@brief 		Node thread.
+ *	@param		arg		Node.
+ *	@return		NULL.
+ */
+static T_void* runVCBNode(T_void* arg)
+{
+	T_vcbNode* node = (T_vcbNode*)arg;
+
+	pthread_mutex_lock(&vcbLock);
+	while (NEQ(vcbTurn, node->index)) {
+		pthread_cond_wait(&node->turn, &vcbLock);
+	}
+	pthread_mutex_unlock(&vcbLock);
+	if (NOT(vcbStop)) {
+		vcbMain(node->index);
+	}
+	pthread_mutex_lock(&vcbLock);
+	node->finished = TRUE;
+	vcbTurn = VCB_SCHEDULER;
+	pthread_cond_signal(&vcbSchedule);
+	pthread_mutex_unlock(&vcbLock);
+
+	return NULL;
+}
+
+/**
+ *	@fn			T_bit checkVCBAccepted(T_uint8, const T_vcbFrame*)
+ *	@brief 		Checks if a message buffer of the selected node accepts a
+ *				frame.
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	frame	Frame on the bus.
+ *	@return		accepted.
+ */
+static T_bit checkVCBAccepted(T_uint8 buffer, const T_vcbFrame* frame)
+{
+	T_dword bits = COND(IS(frame->extended), VCB_EXT_BITS, VCB_STD_BITS);
+	T_dword mask;
+
+	if (EQU(ReadBit(GetCAN_BVALR(), buffer), 0U)
+		|| NEQ(ReadBit(GetCAN_IDER(), buffer), (T_dword)frame->extended)) {
+		return FALSE;
+	}
+	switch ((GetCAN_AMSR() >> (buffer << 1U)) & 0x3U) {
+	case CAN_FULL_BIT_MASK:
+		return TRUE;
+	case CAN_USE_AMR0:
+		mask = toIDBitOrder(GetCAN_AMR0());
+		break;
+	case CAN_USE_AMR1:
+		mask = toIDBitOrder(GetCAN_AMR1());
+		break;
+	default:
+		mask = 0UL;
+		break;
+	}
+
+	return EQU((toIDBitOrder(GetCAN_IDR(buffer)) ^ frame->id) & bits & ~mask, 0UL);
+}
+
+/**
+ *	@fn			T_dword getVCBArbitration(const T_vcbFrame*)
+ *	@brief 		Gets the arbitration field of a frame (lower wins).
+ *	@param[in]	frame	Frame.
+ *	@return		base ID, RTR or SRR, IDE, extended ID and RTR, from MSB.
+ */
+static T_dword getVCBArbitration(const T_vcbFrame* frame)
+{
+	T_dword base = (frame->id >> 18U) & 0x7FFUL;
+
+	if (NOT(frame->extended)) {
+		return (base << 21U) | ((T_dword)frame->remote << 20U);
+	}
+
+	return (base << 21U) | (1UL << 20U) | (1UL << 19U) | ((frame->id & 0x3FFFFUL) << 1U)
+		| frame->remote;
+}
+
+/**
+ *	@fn			T_uint16 countVCBFrameBits(const T_vcbFrame*)
+ *	@brief 		Counts bits of a frame with bit stuffing of its actual CRC.
+ *	@param[in]	frame	Frame.
+ *	@return		frame bits (interframe space included).
+ */
+static T_uint16 countVCBFrameBits(const T_vcbFrame* frame)
+{
+	T_bit stream[160];
+	T_uint16 length = 0U;
+	T_uint16 crc = 0U;
+	T_uint16 stuffed = 0U;
+	T_uint16 index;
+	T_uint8 bytes = COND(IS(frame->remote), 0U, MIN(frame->dlc, CAN_MB_BYTE_SIZE));
+	T_uint8 run = 0U;
+	T_bit last = 2U;
+	T_bit bit;
+	int pos;
+
+#define VCB_PUSH(VALUE, BITS) \
+	for (pos = (int)(BITS) - 1; GEQ(pos, 0); pos--) { \
+		stream[length++] = (T_bit)(((VALUE) >> pos) & 1UL); \
+	}
+	VCB_PUSH(0UL, 1U);
+	VCB_PUSH(frame->id >> 18U, 11U);
+	if (IS(frame->extended)) {
+		VCB_PUSH(3UL, 2U);
+		VCB_PUSH(frame->id & 0x3FFFFUL, 18U);
+		VCB_PUSH((T_dword)frame->remote << 2U, 3U);
+	} else {
+		VCB_PUSH((T_dword)frame->remote << 2U, 3U);
+	}
+	VCB_PUSH(frame->dlc, 4U);
+	for (index = 0U; LT(index, bytes); index++) {
+		VCB_PUSH(frame->data.BYTE[index], 8U);
+	}
+	/* CRC-15 (poly 0x4599) */
+	for (index = 0U; LT(index, length); index++) {
+		bit = (T_bit)(stream[index] ^ ((crc >> 14U) & 1U));
+		crc = (T_uint16)((crc << 1U) & 0x7FFFU);
+		if (IS(bit)) {
+			crc ^= 0x4599U;
+		}
+	}
+	VCB_PUSH(crc, 15U);
+#undef VCB_PUSH
+	/* a complement bit follows every 5 equal bits (stuff bits included) */
+	for (index = 0U; LT(index, length); index++) {
+		run = COND(EQU(stream[index], last), run + 1U, 1U);
+		last = stream[index];
+		if (EQU(run, 5U)) {
+			stuffed++;
+			last = (T_bit)!last;
+			run = 1U;
+		}
+	}
+
+	return (T_uint16)(length + stuffed + VCB_FRAME_TAIL);
+}
+
+/**
+ *	@fn			T_void startVCBFrame(T_void)
+ *	@brief 		Arbitrates pending message buffers and puts the winner on the
+ *				bus.
+ *	@param		.
+ *	@return		.
+ */
+static T_void startVCBFrame(T_void)
+{
+	T_vcbFrame frame;
+	T_dword field;
+	T_dword best = 0UL;
+	T_byte pending;
+	T_uint8 contenders = 0U;
+	T_uint8 index;
+	T_uint8 buffer;
+
+	vcbBus.active = FALSE;
+	for (index = 0U; LT(index, vcbNodeCount); index++) {
+		selectVCBNode(index);
+		if (IS(IsCANBusOpHalted())) {
+			continue;
+		}
+		/* buffers waiting for a remote frame are not eligible yet */
+		pending = GetCAN_TREQR() & GetCAN_BVALR()
+			& (T_byte)~(GetCAN_RFWTR() & (T_byte)~GetCAN_RRTRR());
+		for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+			if (NEQ(ReadBit(pending, buffer), 0U)) {
+				break;
+			}
+		}
+		if (EQU(buffer, CAN_MB_SIZE)) {
+			continue;
+		}
+		frame.id = toIDBitOrder(GetCAN_IDR(buffer));
+		frame.extended = (T_bit)ReadBit(GetCAN_IDER(), buffer);
+		frame.remote = (T_bit)ReadBit(GetCAN_TRTRR(), buffer);
+		frame.dlc = (T_uint8)(GetCAN_DLCR(buffer) & 0x0FU);
+		frame.data = IO_CANID.DTR[buffer];
+		frame.node = index;
+		frame.buffer = buffer;
+		frame.active = TRUE;
+		field = getVCBArbitration(&frame);
+		contenders++;
+		if (NOT(vcbBus.active) || LT(field, best)) {
+			best = field;
+			vcbBus = frame;
+		}
+	}
+	if (IS(vcbBus.active)) {
+		vcbBus.end = vcbTime + countVCBFrameBits(&vcbBus) * vcbBitTime;
+		vcbStats.busyTime += MIN(vcbBus.end, vcbEnd) - vcbTime;
+		if (GT(contenders, 1U)) {
+			vcbStats.arbitrations++;
+		}
+	}
+}
+
+/**
+ *	@fn			T_void receiveVCBFrame(T_vcbNode*)
+ *	@brief 		Stores the frame on the bus into the selected node.
+ *	@param		node	Selected node.
+ *	@return		.
+ */
+static T_void receiveVCBFrame(T_vcbNode* node)
+{
+	T_byte requests = GetCAN_TREQR();
+	T_uint8 target = CAN_MB_SIZE;
+	T_uint8 buffer;
+
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NOT(checkVCBAccepted(buffer, &vcbBus))) {
+			continue;
+		}
+		if (NEQ(ReadBit(requests, buffer), 0U)) {
+			/* remote frame releases matching transmission buffer */
+			if (IS(vcbBus.remote)) {
+				node->settled.rrtrr |= (T_byte)ToBit(buffer);
+			}
+			continue;
+		}
+		if (EQU(target, CAN_MB_SIZE)
+			|| (NEQ(ReadBit(node->settled.rcr, target), 0U)
+			&& EQU(ReadBit(node->settled.rcr, buffer), 0U))) {
+			target = buffer;
+		}
+	}
+	if (NEQ(target, CAN_MB_SIZE)) {
+		if (NEQ(ReadBit(node->settled.rcr, target), 0U)) {
+			node->settled.rovrr |= (T_byte)ToBit(target);
+		}
+		node->settled.rcr |= (T_byte)ToBit(target);
+		if (IS(vcbBus.remote)) {
+			node->settled.rrtrr |= (T_byte)ToBit(target);
+		}
+		SetCAN_IDR(target, toIDRegMap(vcbBus.id));
+		SetCAN_DLCR(target, vcbBus.dlc);
+		if (NOT(vcbBus.remote)) {
+			IO_CANID.DTR[target] = vcbBus.data;
+		}
+		if (NEQ(ReadBit(GetCAN_RIER(), target), 0U)) {
+			node->irq = TRUE;
+		}
+	}
+	SetCAN_RCR(node->settled.rcr);
+	SetCAN_RRTRR(node->settled.rrtrr);
+	SetCAN_ROVRR(node->settled.rovrr);
+}
+
+/**
+ *	@fn			T_void completeVCBFrame(T_void)
+ *	@brief 		Ends the frame on the bus: transmission completion on its node,
+ *				reception on every other running node.
+ *	@param		.
+ *	@return		.
+ */
+static T_void completeVCBFrame(T_void)
+{
+	T_vcbNode* node;
+	T_byte bit = (T_byte)ToBit(vcbBus.buffer);
+	T_uint8 index;
+
+	vcbBus.active = FALSE;
+	vcbStats.frames++;
+	for (index = 0U; LT(index, vcbNodeCount); index++) {
+		node = &vcbNodes[index];
+		selectVCBNode(index);
+		if (NEQ(index, vcbBus.node)) {
+			if (NOT(IsCANBusOpHalted())) {
+				receiveVCBFrame(node);
+			}
+			continue;
+		}
+		/* transmission completion */
+		node->settled.treqr &= (T_byte)~bit;
+		node->settled.rrtrr &= (T_byte)~bit;
+		node->settled.tcr |= bit;
+		SetCAN_TREQR(node->settled.treqr);
+		SetCAN_RRTRR(node->settled.rrtrr);
+		SetCAN_TCR(node->settled.tcr);
+		vcbStats.maxWait = MAX(vcbStats.maxWait, vcbTime - node->requested[vcbBus.buffer]);
+		if (NEQ(GetCAN_TIER() & bit, 0U)) {
+			node->irq = TRUE;
+		}
+	}
+}
+
+/**
+ *	@fn			T_void deliverVCBInterrupts(T_vcbNode*)
+ *	@brief 		Calls the handlers of pending interrupts of the calling node.
+ *	@param		node	Calling node.
+ *	@return		.
+ */
+static T_void deliverVCBInterrupts(T_vcbNode* node)
+{
+	if (NOT(node->irq)) {
+		return;
+	}
+	node->irq = FALSE;
+	if (NEQ(GetCAN_RCR() & GetCAN_RIER(), 0U) && NEQ(node->rx, NULL)) {
+		node->rx();
+		settleVCBRegisters(node);
+	}
+	if (NEQ(GetCAN_TCR() & GetCAN_TIER(), 0U) && NEQ(node->tx, NULL)) {
+		node->tx();
+		settleVCBRegisters(node);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Functions.
+*/
+
+/**
+ * 	@fn 		T_void runVCB(T_uint8, T_vcbMain, T_uint32, T_uint32)
+ *	@brief 		Runs nodes on the virtual bus, then stops them.
+ * 	@param[in]	nodes		Node count.
+ * 	@param[in]	nodeMain	Node entry point.
+ * 	@param[in]	bitRate		Bus bit rate (bit/s).
+ * 	@param[in]	duration	Virtual run time (ms).
+ * 	@return		.
+ */
+T_void runVCB(T_uint8 nodes, T_vcbMain nodeMain, T_uint32 bitRate, T_uint32 duration)
+{
+	uint64_t next;
+	T_vcbNode* node;
+	T_uint8 index;
+
+	vcbNodeCount = MIN(nodes, VCB_MAX_NODES);
+	vcbMain = nodeMain;
+	vcbBitTime = 1000000000ULL / MAX(bitRate, 1UL);
+	setVCBTime(0ULL);
+	vcbEnd = (uint64_t)duration * 1000000ULL;
+	vcbStop = FALSE;
+	vcbTurn = VCB_SCHEDULER;
+	memset(&vcbBus, 0, sizeof(vcbBus));
+	memset(&vcbStats, 0, sizeof(vcbStats));
+	for (index = 0U; LT(index, vcbNodeCount); index++) {
+		node = &vcbNodes[index];
+		memset(node, 0, sizeof(*node));
+		node->index = index;
+		node->rx = handleVCBReception;
+		node->tx = handleVCBTransmission;
+		/* controller halted until startCAN */
+		node->canct = IO_CANCT;
+		pthread_cond_init(&node->turn, NULL);
+	}
+	/* register variables hold node 0 */
+	vcbCurrent = 0U;
+	IO_CANCT = vcbNodes[0].canct;
+	StopCANBusOp();
+	for (index = 0U; LT(index, vcbNodeCount); index++) {
+		vcbNodes[index].canct = IO_CANCT;
+		pthread_create(&vcbNodes[index].thread, NULL, runVCBNode, &vcbNodes[index]);
+	}
+	for (;;) {
+		if (IS(vcbBus.active) && LEQ(vcbBus.end, vcbTime)) {
+			completeVCBFrame();
+		}
+		for (index = 0U; LT(index, vcbNodeCount); index++) {
+			node = &vcbNodes[index];
+			if (NOT(node->finished) && (LEQ(node->wake, vcbTime) || IS(node->irq))) {
+				resumeVCBNode(index);
+			}
+		}
+		if (NOT(vcbBus.active)) {
+			startVCBFrame();
+		}
+		/* advance to next wake up or frame end */
+		next = COND(IS(vcbBus.active), vcbBus.end, UINT64_MAX);
+		for (index = 0U; LT(index, vcbNodeCount); index++) {
+			if (NOT(vcbNodes[index].finished)) {
+				next = MIN(next, vcbNodes[index].wake);
+			}
+		}
+		if (GEQ(next, vcbEnd)) {
+			break;
+		}
+		setVCBTime(next);
+	}
+	setVCBTime(vcbEnd);
+	vcbStop = TRUE;
+	for (index = 0U; LT(index, vcbNodeCount); index++) {
+		if (NOT(vcbNodes[index].finished)) {
+			resumeVCBNode(index);
+		}
+		pthread_join(vcbNodes[index].thread, NULL);
+		pthread_cond_destroy(&vcbNodes[index].turn);
+	}
+}
+
+/**
+ * 	@fn 		T_void waitVCB(T_uint32)
+ *	@brief 		Lets virtual time run for the calling node.
+ * 	@param[in]	micros		Wait time (us).
+ * 	@return		.
+ */
+T_void waitVCB(T_uint32 micros)
+{
+	T_vcbNode* node = &vcbNodes[vcbCurrent];
+
+	node->wake = vcbTime + MAX((uint64_t)micros * 1000ULL, 1ULL);
+	do {
+		yieldVCBNode(node);
+		deliverVCBInterrupts(node);
+	} while (LT(vcbTime, node->wake));
+}
+
+/**
+ * 	@fn 		uint64_t getVCBTime(T_void)
+ *	@brief 		Gets the global virtual clock.
+ * 	@param		.
+ * 	@return		virtual time (ns).
+ */
+uint64_t getVCBTime(T_void)
+{
+	return vcbTime;
+}
+
+/**
+ * 	@fn 		T_uint32 getVCBMillis(T_void)
+ *	@brief 		Gets the global virtual clock in milliseconds.
+ * 	@param		.
+ * 	@return		virtual time (ms).
+ */
+T_uint32 getVCBMillis(T_void)
+{
+	return (T_uint32)(vcbTime / 1000000ULL);
+}
+
+/**
+ * 	@fn 		T_uint8 getVCBNode(T_void)
+ *	@brief 		Gets the index of the running node.
+ * 	@param		.
+ * 	@return		node index.
+ */
+T_uint8 getVCBNode(T_void)
+{
+	return vcbCurrent;
+}
+
+/**
+ * 	@fn 		T_void setVCBHandlers(T_vcbISR, T_vcbISR)
+ *	@brief 		Replaces the interrupt handlers of the running node.
+ * 	@param[in]	rx		Reception handler.
+ * 	@param[in]	tx		Transmission and node status handler.
+ * 	@return		.
+ */
+T_void setVCBHandlers(T_vcbISR rx, T_vcbISR tx)
+{
+	vcbNodes[vcbCurrent].rx = rx;
+	vcbNodes[vcbCurrent].tx = tx;
+}
+
+/**
+ * 	@fn 		const T_vcbStats* getVCBStats(T_void)
+ *	@brief 		Gets bus statistics of the last run.
+ * 	@param		.
+ * 	@return		statistics.
+ */
+const T_vcbStats* getVCBStats(T_void)
+{
+	return &vcbStats;
+}
+
+/* END OF VCB. */
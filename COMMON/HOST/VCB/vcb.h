@@ -0,0 +1,245 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Host Simulation										     */
+/**
+ *	@file		VCB/vcb.h
+ *	@brief		This file contains VCB flags, types and functions for running
+ *				several nodes built against COM/can.h of the library in one host
+ *				process, on a virtual CAN bus.
+ *	@details	Every node runs its application code (initCAN, requestCANTransmit,
+ *				checkCANReceived, or the IO register macros of IO/can_io.h) on
+ *				its own thread. Nodes run one at a time in virtual time: a node
+ *				runs in zero virtual time until it calls waitVCB, and the bus
+ *				advances the global virtual clock to the next node wake up or
+ *				frame end. Before a node runs, its CAN registers (and pRXCANBuffer
+ *				and pTXCANBuffer contents) are swapped into the register
+ *				variables of the library, so that unmodified code sees its own
+ *				controller. Runs are deterministic. <br>
+ *				When the bus is idle, the pending message buffer of lowest
+ *				number of every running node enters arbitration, which is won by
+ *				the lowest arbitration field (identifier, RTR or SRR, IDE, and
+ *				extended identifier, dominant bits first). The frame lasts its
+ *				exact bit count (bit stuffing of the actual CRC included) plus
+ *				interframe space. Every other running node stores it into its
+ *				lowest valid message buffer of same format accepting the ID
+ *				(full-bit comparison, full-bit mask, AMR0 or AMR1), preferring a
+ *				free one, and sets ROVRR on overwrite. Remote frames set RRTRR of
+ *				accepting buffers and release buffers waiting for them (RFWTR).
+ *				Interrupts (RCR and RIER, TCR and TIER) are delivered when the
+ *				node gets back control in waitVCB, so code between two waitVCB
+ *				calls never gets interrupted. Bus errors are not simulated. <br>
+ *				HOST/VCB/vcb_tbt.c stands for the timebase timer of the library
+ *				(TMR/tbt.h): delay waits through waitVCB and pTBTCount counts
+ *				virtual time, so that node code written for the target runs
+ *				unchanged (see HOST/VCB/vcb_demo.c).
+ *	@attention	Node code must wait through waitVCB (or delay of vcb_tbt.c),
+ *				never by busy-waiting on registers, and must not use
+ *				peripherals other than CAN and TBT. The build needs the IO
+ *				variables of the library (start/io_mb90385.c), i.e.: <br>
+ *				cc -pthread -I LIB/MB90385/include -I HOST -o app app.c
+ *				HOST/VCB/vcb.c HOST/VCB/vcb_can.c LIB/MB90385/start/io_mb90385.c
+ *				<br> (on case sensitive file systems, IO must link to the io
+ *				include directory).
+ *	@code
+ *		static T_void node(T_uint8 index)
+ *		{
+ *			initCAN(CAN_DEF_BUS_SPEED, 0x0FU, 0xF0U);
+ *			setupCANMessageBuffer(CAN_MB_4, CAN_ID_STD_FORMAT, index, 0U,
+ *				CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_ENABLED,
+ *				CAN_RX_INT_DISABLED, CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+ *			setupCANMessageBuffer(CAN_MB_0, CAN_ID_STD_FORMAT, 0U, 0U,
+ *				CAN_FULL_BIT_MASK, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED,
+ *				CAN_RX_INT_ENABLED, CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+ *			startCAN();
+ *			for (;;) {
+ *				WriteCANTXDWord(CAN_MB_4, 0U, getVCBMillis());
+ *				requestCANTransmit();
+ *				waitVCB(1000U);
+ *				(T_void)checkCANReceived();
+ *			}
+ *		}
+ *		...
+ *		runVCB(32U, node, 1000000UL, 1000U);
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef VCB_H
+#define VCB_H
+
+#include <COM/can.h>
+#include <TMR/tbt.h>
+#include <stdint.h>
+
+/* ----------------------------------------------------------------------------
+**	VCB Flags.
+*/
+
+/**
+ * 	@def		VCB_MAX_NODES
+ *	@brief 		Maximum simulated nodes.
+ */
+#ifndef VCB_MAX_NODES
+#define VCB_MAX_NODES			(64U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	VCB Types.
+*/
+
+/**
+ *	@brief		Node entry point (node index as argument).
+ */
+typedef T_void (*T_vcbMain)(T_uint8 node);
+
+/**
+ *	@brief		Node interrupt handler.
+ */
+typedef T_void (*T_vcbISR)(T_void);
+
+/**
+ *	@brief		Data structure for driver state of the running node (swapped
+ *				with its registers).
+ */
+typedef struct {
+	T_canid_dtr tx[CAN_MB_SIZE];	/**< pTXCANBuffer contents */
+	T_canid_dtr rx[CAN_MB_SIZE];	/**< pRXCANBuffer contents */
+	T_byte txBits;					/**< transmission buffer bits */
+	T_byte rxBits;					/**< reception buffer bits */
+	T_byte received;				/**< buffers received by the RX handler */
+} T_vcbDriver;
+
+/**
+ *	@brief		Data structure for bus statistics.
+ */
+typedef struct {
+	T_uint32 frames;				/**< frames carried */
+	T_uint32 arbitrations;			/**< arbitrations with several nodes */
+	uint64_t busyTime;				/**< time with a frame on the bus (ns) */
+	uint64_t maxWait;				/**< peak request to completion time (ns) */
+} T_vcbStats;
+
+/* ----------------------------------------------------------------------------
+**	VCB External Variables.
+*/
+
+/**
+ * 	@var		vcbDriver
+ *	@brief		Driver state of the running node.
+ */
+extern T_vcbDriver vcbDriver;
+
+/**
+ * 	@var		vcbTBTCount
+ *	@brief		Timebase timer count of the global virtual clock (1.024 ms
+ *				ticks, see pTBTCount).
+ */
+extern T_gptCount vcbTBTCount;
+
+/* ----------------------------------------------------------------------------
+**	VCB Functions.
+*/
+
+/**
+ * 	@fn 		T_void runVCB(T_uint8, T_vcbMain, T_uint32, T_uint32)
+ *	@brief 		Runs nodes on the virtual bus, then stops them.
+ * 	@param[in]	nodes		Node count (up to VCB_MAX_NODES).
+ * 	@param[in]	nodeMain	Node entry point (may never return).
+ * 	@param[in]	bitRate		Bus bit rate (bit/s).
+ * 	@param[in]	duration	Virtual run time (ms).
+ * 	@return		.
+ */
+extern T_void runVCB(T_uint8 nodes, T_vcbMain nodeMain, T_uint32 bitRate,
+	T_uint32 duration);
+
+/**
+ * 	@fn 		T_void waitVCB(T_uint32)
+ *	@brief 		Lets virtual time run for the calling node, delivering its
+ *				interrupts meanwhile.
+ * 	@param[in]	micros		Wait time (us).
+ * 	@return		.
+ */
+extern T_void waitVCB(T_uint32 micros);
+
+/**
+ * 	@fn 		uint64_t getVCBTime(T_void)
+ *	@brief 		Gets the global virtual clock.
+ * 	@param		.
+ * 	@return		virtual time (ns).
+ */
+extern uint64_t getVCBTime(T_void);
+
+/**
+ * 	@fn 		T_uint32 getVCBMillis(T_void)
+ *	@brief 		Gets the global virtual clock in milliseconds.
+ * 	@param		.
+ * 	@return		virtual time (ms).
+ */
+extern T_uint32 getVCBMillis(T_void);
+
+/**
+ * 	@fn 		T_uint8 getVCBNode(T_void)
+ *	@brief 		Gets the index of the running node.
+ * 	@param		.
+ * 	@return		node index.
+ */
+extern T_uint8 getVCBNode(T_void);
+
+/**
+ * 	@fn 		T_void setVCBHandlers(T_vcbISR, T_vcbISR)
+ *	@brief 		Replaces the interrupt handlers of the running node (i.e. with
+ *				the ISRs of another driver).
+ * 	@param[in]	rx		Reception handler (RCR and RIER).
+ * 	@param[in]	tx		Transmission and node status handler (TCR and TIER).
+ * 	@return		.
+ */
+extern T_void setVCBHandlers(T_vcbISR rx, T_vcbISR tx);
+
+/**
+ * 	@fn 		const T_vcbStats* getVCBStats(T_void)
+ *	@brief 		Gets bus statistics of the last run.
+ * 	@param		.
+ * 	@return		statistics.
+ */
+extern const T_vcbStats* getVCBStats(T_void);
+
+/**
+ * 	@fn 		T_void handleVCBReception(T_void)
+ *	@brief 		Default reception handler (as CANRX_IRQHandler): appends
+ *				reception bits, then clears reception and overrun bits.
+ * 	@param		.
+ * 	@return		.
+ */
+extern T_void handleVCBReception(T_void);
+
+/**
+ * 	@fn 		T_void handleVCBTransmission(T_void)
+ *	@brief 		Default transmission handler (as CANTX_IRQHandler): clears
+ *				transmission completion and node status transition bits.
+ * 	@param		.
+ * 	@return		.
+ */
+extern T_void handleVCBTransmission(T_void);
+
+#endif /* VCB_H. */
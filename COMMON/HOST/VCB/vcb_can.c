@@ -0,0 +1,285 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Host Driver Implementation								 */
+/**
+ *	@file		VCB/vcb_can.c
+ *	@brief		This file contains the host implementation of COM/can.h API
+ *				functions over the registers of the running node.
+ *	@details	Functions follow the documented behaviour of the library:
+ *				initCAN sets up standard data frames of 8 bytes with full-bit
+ *				comparison, and IDs formatted with message buffer index only
+ *				(prefix and suffix of 0), so that nodes with default settings
+ *				talk to each other. Bus operation stays halted until startCAN.
+ *				Driver state lives in vcbDriver, which is swapped with the
+ *				registers of every node. Completion bits are cleared by
+ *				read-modify-write so that they read back right within the same
+ *				run of the node (plain memory keeps the ones written).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCB/vcb.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		VCB_CAN_RESERVED
+ *	@brief 		Reserved bits (17 and 16) of formatted IDs.
+ */
+#define VCB_CAN_RESERVED		(0x00030000UL)
+
+/* ----------------------------------------------------------------------------
+**	External Variables.
+*/
+
+/**
+ *	@var		vcbDriver
+ *	@brief		Driver state of the running node.
+ */
+T_vcbDriver vcbDriver;
+
+/**
+ * 	@var		pRXCANBuffer
+ *	@brief		Read-only access to CAN reception buffer (DTR copy).
+ */
+volatile T_canid_dtr const * const pRXCANBuffer = vcbDriver.rx;
+
+/**
+ * 	@var		pTXCANBuffer
+ *	@brief		Write-permitted access to CAN transmission buffer (DTR copy).
+ */
+volatile T_canid_dtr * const pTXCANBuffer = vcbDriver.tx;
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initCAN(T_canBitTimingSpeed, T_byte, T_byte)
+ *	@brief 		Performs default initialization of CAN peripheral.
+ * 	@param[in]	speed			Bit timing speed (bus bit rate is set by runVCB).
+ * 	@param[in]	rxBufferBits 	Reception message buffer bits.
+ * 	@param[in]	txBufferBits 	Transmission message buffer bits.
+ * 	@return		.
+ */
+T_void initCAN(T_canBitTimingSpeed speed, T_byte rxBufferBits, T_byte txBufferBits)
+{
+	T_uint8 buffer;
+
+	StopCANBusOp();
+	SetCAN_BTR(speed);
+	SetCAN_BVALR(0U);
+	SetCAN_TCANR(0xFFU);
+	SetCAN_TCR(0U);
+	SetCAN_RCR(0U);
+	SetCAN_RRTRR(0U);
+	SetCAN_ROVRR(0U);
+	SetCAN_IDER(0U);
+	SetCAN_TRTRR(0U);
+	SetCAN_RFWTR(0U);
+	SetCAN_AMSR(0U);
+	SetCAN_AMR0(0UL);
+	SetCAN_AMR1(0UL);
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		SetCAN_IDR(buffer, toIDRegMap(formattedCANID((T_canMsgBuf)buffer, 0U, 0U)));
+		SetCAN_DLCR(buffer, CAN_DLC_8BYTES);
+	}
+	SetCAN_RIER(rxBufferBits);
+	SetCAN_TIER(txBufferBits);
+	EnableCANNSInterrupt();
+	SetCAN_BVALR(rxBufferBits | txBufferBits);
+	vcbDriver.rxBits = rxBufferBits;
+	vcbDriver.txBits = txBufferBits;
+	vcbDriver.received = 0U;
+}
+
+/**
+ * 	@fn 		T_void setupCANAcceptanceMask(T_canAccMaskOp, T_byte, T_word)
+ *	@brief 		Set up CAN's acceptance mask registers AMR0 or AMR1.
+ * 	@param[in]	maskNumber	Acceptance mask register number.
+ * 	@param[in]	maskPrefix	Standard ID priority "prefix" mask.
+ * 	@param[in]	maskSuffix	Extended ID priority "suffix" mask.
+ * 	@return		.
+ */
+T_void setupCANAcceptanceMask(T_canAccMaskOp maskNumber, T_byte maskPrefix,
+	T_word maskSuffix)
+{
+	T_dword mask = toIDRegMap(((T_dword)maskPrefix << 21U) | maskSuffix);
+
+	if (EQU(maskNumber, CAN_USE_AMR0)) {
+		SetCAN_AMR0(mask);
+	} else if (EQU(maskNumber, CAN_USE_AMR1)) {
+		SetCAN_AMR1(mask);
+	}
+}
+
+/**
+ * 	@fn 		T_void setupCANMessageBuffer(T_canMsgBuf, T_canIDFormat, T_byte,
+ * 					T_word, T_canAccMaskOp, T_canDataLength, T_canTXINT,
+ * 					T_canRXINT, T_canTXRemoteFrameWait, T_canTXFrame)
+ *	@brief 		Set up CAN's ID, acceptance mask option, data length,
+ *				RX and TX interrupt, and some remote frame options.
+ * 	@return		.
+ */
+T_void setupCANMessageBuffer(T_canMsgBuf msgBuf, T_canIDFormat idFormat,
+	T_byte idPrefix, T_word idSuffix, T_canAccMaskOp maskOption,
+	T_canDataLength dataLength, T_canTXINT txINTEnable, T_canRXINT rxINTEnable,
+	T_canTXRemoteFrameWait remoteWait, T_canTXFrame frame)
+{
+	T_byte valid = GetCAN_BVALR();
+
+	DisableCANMsgBuff(msgBuf);
+	SetCAN_IDER((T_byte)ModBit(GetCAN_IDER(), msgBuf, idFormat));
+	SetCAN_IDR(msgBuf, toIDRegMap(formattedCANID(msgBuf, idPrefix, idSuffix)));
+	SetCAN_AMSR((T_word)((GetCAN_AMSR() & ~(0x3U << (msgBuf << 1U)))
+		| ((T_word)maskOption << (msgBuf << 1U))));
+	SetCAN_DLCR(msgBuf, dataLength);
+	SetCAN_TIER((T_byte)ModBit(GetCAN_TIER(), msgBuf, txINTEnable));
+	SetCAN_RIER((T_byte)ModBit(GetCAN_RIER(), msgBuf, rxINTEnable));
+	SetCAN_RFWTR((T_byte)ModBit(GetCAN_RFWTR(), msgBuf, remoteWait));
+	SetCAN_TRTRR((T_byte)ModBit(GetCAN_TRTRR(), msgBuf, frame));
+	SetCAN_BVALR(valid);
+}
+
+/**
+ * 	@fn 		T_void startCAN(T_void)
+ *	@brief 		Cancels halt or start bus operation.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void startCAN(T_void)
+{
+	StartCANBusOp();
+}
+
+/**
+ * 	@fn 		T_void stopCAN(T_void)
+ *	@brief 		Halt bus operation.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void stopCAN(T_void)
+{
+	StopCANBusOp();
+}
+
+/**
+ * 	@fn 		T_void requestCANTransmit(T_void)
+ *	@brief 		Loads TX buffer to DTR then performs transmission request
+ *				of specified message buffers.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void requestCANTransmit(T_void)
+{
+	T_uint8 buffer;
+	T_uint8 index;
+
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (EQU(ReadBit(vcbDriver.txBits, buffer), 0U)) {
+			continue;
+		}
+		for (index = 0U; LT(index, CAN_MB_WORD_SIZE); index++) {
+			SetCAN_DTR_WORD(buffer, index, vcbDriver.tx[buffer].WORD[index]);
+		}
+		RequestCANTransmit(buffer);
+	}
+}
+
+/**
+ * 	@fn 		T_uint8 checkCANReceived(T_void)
+ *	@brief 		Copies DTR of received message buffers to RX buffer.
+ * 	@param		.
+ * 	@return		received message buffer count.
+ */
+T_uint8 checkCANReceived(T_void)
+{
+	T_byte received = vcbDriver.received;
+	T_uint8 count = 0U;
+	T_uint8 buffer;
+
+	/* reception without interrupt is polled */
+	received |= GetCAN_RCR() & vcbDriver.rxBits & (T_byte)~GetCAN_RIER();
+	SetCAN_RCR(GetCAN_RCR() & (T_byte)~received);
+	vcbDriver.received = 0U;
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NEQ(ReadBit(received, buffer), 0U)) {
+			vcbDriver.rx[buffer] = IO_CANID.DTR[buffer];
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * 	@fn 		T_dword formattedCANID(T_canMsgBuf, T_byte, T_word)
+ *	@brief 		Creates a customized formatted ID.
+ * 	@param[in]	msgBuf		Mailbox or message buffer.
+ * 	@param[in]	idPrefix	Standard ID priority "prefix".
+ * 	@param[in]	idSuffix	Extended ID priority "suffix".
+ * 	@return		formatted ID.
+ */
+T_dword formattedCANID(T_canMsgBuf msgBuf, T_byte idPrefix, T_word idSuffix)
+{
+	return ((T_dword)idPrefix << 21U) | ((T_dword)msgBuf << 18U) | VCB_CAN_RESERVED
+		| idSuffix;
+}
+
+/**
+ * 	@fn 		T_dword toIDRegMap(T_dword)
+ *	@brief 		Converts bit-ordered ID to register-mapped ID.
+ * 	@param[in]	ID 		Bit-ordered ID.
+ * 	@return		register-mapped ID.
+ */
+T_dword toIDRegMap(T_dword ID)
+{
+	return ((ID >> 21U) & 0xFFUL) | (((ID >> 13U) & 0xFFUL) << 8U)
+		| (((ID >> 5U) & 0xFFUL) << 16U) | ((ID & 0x1FUL) << 27U);
+}
+
+/**
+ * 	@fn 		T_dword toIDBitOrder(T_dword)
+ *	@brief 		Converts register-mapped ID to bit-ordered ID.
+ * 	@param[in]	ID 		Register-mapped ID.
+ * 	@return		bit-ordered ID.
+ */
+T_dword toIDBitOrder(T_dword ID)
+{
+	return ((ID & 0xFFUL) << 21U) | (((ID >> 8U) & 0xFFUL) << 13U)
+		| (((ID >> 16U) & 0xFFUL) << 5U) | ((ID >> 27U) & 0x1FUL);
+}
+
+/**
+ * 	@fn 		T_void handleVCBReception(T_void)
+ *	@brief 		Default reception handler.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void handleVCBReception(T_void)
+{
+	T_byte received = GetCAN_RCR() & GetCAN_RIER();
+
+	vcbDriver.received |= received;
+	SetCAN_RCR(GetCAN_RCR() & (T_byte)~received);
+	SetCAN_ROVRR(GetCAN_ROVRR() & (T_byte)~received);
+}
+
+/**
+ * 	@fn 		T_void handleVCBTransmission(T_void)
+ *	@brief 		Default transmission handler.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void handleVCBTransmission(T_void)
+{
+	SetCAN_TCR(0U);
+	if (IS(IsCANNSTransition())) {
+		ClearCANNSTransition();
+		if (IS(IsCANBusOpHalted())) {
+			StartCANBusOp();
+		}
+	}
+}
+
+/* END OF VCB_CAN. */
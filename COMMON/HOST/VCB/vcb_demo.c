@@ -0,0 +1,313 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Two Node Demo Host Tool									 */
+/**
+ *	@file		VCB/vcb_demo.c
+ *	@brief		This file contains the CAN sample test program (CAN/Source/
+ *				can.c) running NODE A and NODE B on the virtual CAN bus.
+ *	@details	Usage: vcb_demo [-t MS] [-p NODE] [-w] <br>
+ *				Node 0 is NODE A and node 1 is NODE B, both running the
+ *				init and debug code of the sample unchanged (default CAN
+ *				settings, delay of 100 ms per iteration), with the MDE watch of
+ *				DTR(0) to DTR(7) replaced by a check of the reception buffers.
+ *				Every 100 ms, each node transmits its counter plus the buffer
+ *				index from its four transmission buffers into the same buffers
+ *				of the other node. With -p, NODE (A or B) is paused for the
+ *				second quarter of the run, as in step (7) of the sample: the
+ *				buffers of the other node must freeze meanwhile, then move
+ *				again. With -w, the reception buffers of both nodes are printed
+ *				every iteration. The run lasts MS of virtual time (default
+ *				1000). The exit status is 1 if a reception buffer holds a value
+ *				of the wrong buffer, is not up to date at the end, or moved
+ *				while the other node was paused. Dwords of the sample go
+ *				through word pairs, since T_uint32 is 8 bytes on 64-bit hosts
+ *				and DWORD[1] of T_canid_dtr falls outside the data bytes.
+ *				Built as in VCB/vcb.h, i.e.:
+ *				<br>
+ *				cc -pthread -I LIB/MB90385/include -I HOST -o vcb_demo
+ *				HOST/VCB/vcb_demo.c HOST/VCB/vcb.c HOST/VCB/vcb_can.c
+ *				HOST/VCB/vcb_tbt.c LIB/MB90385/start/io_mb90385.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCB/vcb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		CAN_NODE_A, CAN_NODE_B
+ *	@brief 		Node indices on the virtual bus.
+ */
+#define CAN_NODE_A				(0U)
+#define CAN_NODE_B				(1U)
+
+/**
+ * 	@def		CAN_NODE_A_RX_BUFFS, CAN_NODE_A_TX_BUFFS, CAN_NODE_A_TX_DWORD
+ *	@brief 		Reception and transmission message buffers, and transmission
+ *				dword index for NODE A.
+ */
+#define CAN_NODE_A_RX_BUFFS		(0x0FU)
+#define CAN_NODE_A_TX_BUFFS		(0xF0U)
+#define CAN_NODE_A_TX_DWORD		(0x01U)
+
+/**
+ * 	@def		CAN_NODE_B_RX_BUFFS, CAN_NODE_B_TX_BUFFS, CAN_NODE_B_TX_DWORD
+ *	@brief 		Reception and transmission message buffers, and transmission
+ *				dword index for NODE B.
+ */
+#define CAN_NODE_B_RX_BUFFS		(0xF0U)
+#define CAN_NODE_B_TX_BUFFS		(0x0FU)
+#define CAN_NODE_B_TX_DWORD		(0x00U)
+
+/**
+ * 	@def		VCB_DEMO_PERIOD
+ *	@brief 		Iteration delay in milliseconds (reception delay of the sample).
+ */
+#define VCB_DEMO_PERIOD			(100U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for node settings and state.
+ */
+typedef struct {
+	const char* name;
+	T_byte rxBuffs;
+	T_byte txBuffs;
+	T_uint8 txDWord;
+	T_uint8 rxDWord;
+	T_uint32 data;
+	T_uint32 rx[CAN_MB_SIZE];
+} T_vcbDemoNode;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		vcbDemoNodes
+ *	@brief		NODE A and NODE B.
+ */
+static T_vcbDemoNode vcbDemoNodes[2U] = {
+	{ "A", CAN_NODE_A_RX_BUFFS, CAN_NODE_A_TX_BUFFS, CAN_NODE_A_TX_DWORD,
+		CAN_NODE_B_TX_DWORD, 0UL, { 0UL } },
+	{ "B", CAN_NODE_B_RX_BUFFS, CAN_NODE_B_TX_BUFFS, CAN_NODE_B_TX_DWORD,
+		CAN_NODE_A_TX_DWORD, 0UL, { 0UL } }
+};
+
+/**
+ *	@var		vcbDemoDuration, vcbDemoPaused, vcbDemoWatch
+ *	@brief		Run time (ms), paused node (none if above CAN_NODE_B) and
+ *				watch output.
+ */
+static T_uint32 vcbDemoDuration = 1000UL;
+static T_uint8 vcbDemoPaused = 0xFFU;
+static T_bit vcbDemoWatch = FALSE;
+
+/**
+ *	@var		vcbDemoErrors
+ *	@brief		Check failures.
+ */
+static T_uint32 vcbDemoErrors;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void writeVCBDemoDWord(T_uint8, T_uint8, T_uint32)
+ *	@brief 		Writes a dword to the TX buffer (as WriteCANTXDWord).
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	index	Dword index.
+ *	@param[in]	value	Dword.
+ *	@return		.
+ */
+static T_void writeVCBDemoDWord(T_uint8 buffer, T_uint8 index, T_uint32 value)
+{
+	WriteCANTXWord(buffer, index * 2U, (T_word)value);
+	WriteCANTXWord(buffer, (index * 2U) + 1U, (T_word)(value >> 16U));
+}
+
+/**
+ *	@fn			T_uint32 readVCBDemoDWord(T_uint8, T_uint8)
+ *	@brief 		Reads a dword from the RX buffer (as ReadCANRXDWord).
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	index	Dword index.
+ *	@return		dword.
+ */
+static T_uint32 readVCBDemoDWord(T_uint8 buffer, T_uint8 index)
+{
+	return (T_uint32)ReadCANRXWord(buffer, index * 2U)
+		| ((T_uint32)ReadCANRXWord(buffer, (index * 2U) + 1U) << 16U);
+}
+
+/**
+ *	@fn			T_void checkVCBDemo(T_vcbDemoNode*)
+ *	@brief 		Checks reception buffers (the MDE watch of the sample).
+ *	@param		node	Running node.
+ *	@return		.
+ */
+static T_void checkVCBDemo(T_vcbDemoNode* node)
+{
+	T_uint32 now = getVCBMillis();
+	T_bit pausing = LT(vcbDemoPaused, 2U) && NEQ(vcbDemoPaused, getVCBNode())
+		&& GEQ(now, vcbDemoDuration / 4UL) && LT(now, vcbDemoDuration / 2UL);
+	T_uint32 value;
+	T_uint8 count;
+
+	if (IS(vcbDemoWatch)) {
+		printf("%6lu ms  node %s:", (unsigned long)now, node->name);
+	}
+	for (count = 0U; LT(count, CAN_MB_SIZE); count++) {
+		if (EQU(ReadBit(node->rxBuffs, count), 0U)) {
+			continue;
+		}
+		value = readVCBDemoDWord(count, node->rxDWord);
+		if (IS(vcbDemoWatch)) {
+			printf(" DTR(%u)=%lu", count, (unsigned long)value);
+		}
+		/* counter plus buffer index of the other node */
+		if (NEQ(value, 0UL) && NEQ(value % CAN_MB_SIZE, count)) {
+			vcbDemoErrors++;
+		}
+		/* frozen while the other node is paused (after one period) */
+		if (IS(pausing) && GEQ(now, (vcbDemoDuration / 4UL) + VCB_DEMO_PERIOD)
+				&& NEQ(value, node->rx[count])) {
+			vcbDemoErrors++;
+		}
+		node->rx[count] = value;
+	}
+	if (IS(vcbDemoWatch)) {
+		printf("\n");
+	}
+}
+
+/**
+ *	@fn			T_void init(T_vcbDemoNode*)
+ *	@brief 		Initialization / setup code runs once.
+ *	@param		node	Running node.
+ *	@return		.
+ */
+static T_void init(T_vcbDemoNode* node)
+{
+	/* initialize variables */
+	node->data = 0UL;
+	/* initialize helper modules */
+	initTBT();
+	/* initialize CAN (default settings) */
+	initCAN(CAN_DEF_BUS_SPEED, node->rxBuffs, node->txBuffs);
+	/* attempt starting CAN */
+	startCAN();
+}
+
+/**
+ *	@fn			T_void debug(T_vcbDemoNode*)
+ *	@brief 		Iteration / loop code runs repeatedly.
+ *	@param		node	Running node.
+ *	@return		.
+ */
+static T_void debug(T_vcbDemoNode* node)
+{
+	T_uint8 count;
+
+	/* reception delay */
+	delay(VCB_DEMO_PERIOD);
+	/* paused node does nothing */
+	if (EQU(vcbDemoPaused, getVCBNode())
+			&& GEQ(getVCBMillis(), vcbDemoDuration / 4UL)
+			&& LT(getVCBMillis(), vcbDemoDuration / 2UL)) {
+		return;
+	}
+	/* check received data */
+	(T_void)checkCANReceived();
+	checkVCBDemo(node);
+	/* loop throughout message buffers */
+	for (count = 0U; LT(count, CAN_MB_SIZE); count++) {
+		/* check if correct transmit buffer */
+		if (ReadBit(node->txBuffs, count)) {
+			/* prepare data to transmit to the other node */
+			writeVCBDemoDWord(count, node->txDWord, node->data + count);
+		}
+	}
+	/* attempt transmit data */
+	requestCANTransmit();
+	/* update data to transmit next */
+	node->data += CAN_MB_SIZE;
+}
+
+/**
+ *	@fn			T_void runVCBDemoNode(T_uint8)
+ *	@brief 		Node entry point (main of the sample).
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void runVCBDemoNode(T_uint8 index)
+{
+	T_vcbDemoNode* node = &vcbDemoNodes[index];
+
+	/* initialize first */
+	init(node);
+	/* then iterate indefinitely */
+	for (;;) {
+		debug(node);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	const T_vcbDemoNode* node;
+	T_uint32 oldest;
+	T_uint8 index, count;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-w"), 0)) {
+			vcbDemoWatch = TRUE;
+		} else if (EQU(strcmp(argv[arg], "-t"), 0) && LT(arg + 1, argc)) {
+			vcbDemoDuration = strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-p"), 0) && LT(arg + 1, argc)
+				&& (EQU(strcmp(argv[arg + 1], "A"), 0)
+				|| EQU(strcmp(argv[arg + 1], "B"), 0))) {
+			vcbDemoPaused = COND(EQU(argv[++arg][0], 'A'), CAN_NODE_A, CAN_NODE_B);
+		} else {
+			fprintf(stderr, "usage: %s [-t MS] [-p NODE] [-w]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (LT(vcbDemoDuration, 4UL * VCB_DEMO_PERIOD)) {
+		fprintf(stderr, "run time must be at least %u ms\n", 4U * VCB_DEMO_PERIOD);
+		return 2;
+	}
+	runVCB(2U, runVCBDemoNode, 1000000UL, vcbDemoDuration);
+	/* last check got one of the last two transmissions of the other node */
+	for (index = 0U; LT(index, 2U); index++) {
+		node = &vcbDemoNodes[index];
+		oldest = vcbDemoNodes[1U - index].data - (2U * CAN_MB_SIZE);
+		printf("node %s:", node->name);
+		for (count = 0U; LT(count, CAN_MB_SIZE); count++) {
+			if (EQU(ReadBit(node->rxBuffs, count), 0U)) {
+				continue;
+			}
+			printf(" DTR(%u)=%lu", count, (unsigned long)node->rx[count]);
+			if (LT(node->rx[count], oldest + count)) {
+				vcbDemoErrors++;
+			}
+		}
+		printf("\n");
+	}
+	printf("%lu check failures\n", (unsigned long)vcbDemoErrors);
+
+	return NEQ(vcbDemoErrors, 0UL);
+}
+
+/* END OF VCB_DEMO. */
@@ -0,0 +1,193 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Load Test Host Tool										 */
+/**
+ *	@file		VCB/vcb_load.c
+ *	@brief		This file contains the host command line tool load testing a
+ *				periodic bus schedule on the virtual CAN bus.
+ *	@details	Usage: vcb_load [-n NODES] [-t MS] [-b BITRATE] [-p PERIOD]
+ *				[-s] <br>
+ *				Every node transmits one 8 bytes standard data frame from MB0
+ *				every PERIOD ms (ID prefix is the node index, so lower nodes
+ *				win arbitration), and receives every frame in MB7 (full-bit
+ *				mask). With -s, nodes start staggered over the period instead
+ *				of all at once (critical instant). The tool reports per node
+ *				frames sent and received, worst request to completion latency
+ *				and missed periods (previous frame still pending), then bus
+ *				load. Defaults are 32 nodes, 1000 ms, 500 kbit/s and 10 ms. The
+ *				tool is built as in VCB/vcb.h, i.e.: <br>
+ *				cc -pthread -I LIB/MB90385/include -I HOST -o vcb_load
+ *				HOST/VCB/vcb_load.c HOST/VCB/vcb.c HOST/VCB/vcb_can.c
+ *				LIB/MB90385/start/io_mb90385.c
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCB/vcb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for node results.
+ */
+typedef struct {
+	uint64_t requested;
+	uint64_t maxLatency;
+	T_uint32 sent;
+	T_uint32 received;
+	T_uint32 missed;
+} T_vcbLoadNode;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		vcbLoadNodes
+ *	@brief		Node results.
+ */
+static T_vcbLoadNode vcbLoadNodes[VCB_MAX_NODES];
+
+/**
+ *	@var		vcbLoadPeriod, vcbLoadStagger, vcbLoadCount
+ *	@brief		Transmission period (us), staggered start, and node count.
+ */
+static T_uint32 vcbLoadPeriod = 10000UL;
+static T_bit vcbLoadStagger = FALSE;
+static T_uint8 vcbLoadCount = 32U;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void handleVCBLoadReception(T_void)
+ *	@brief 		Counts received frames.
+ *	@param		.
+ *	@return		.
+ */
+static T_void handleVCBLoadReception(T_void)
+{
+	T_byte received = GetCAN_RCR() & GetCAN_RIER();
+
+	if (NEQ(received, 0U)) {
+		vcbLoadNodes[getVCBNode()].received++;
+	}
+	SetCAN_RCR(GetCAN_RCR() & (T_byte)~received);
+	SetCAN_ROVRR(GetCAN_ROVRR() & (T_byte)~received);
+}
+
+/**
+ *	@fn			T_void handleVCBLoadTransmission(T_void)
+ *	@brief 		Measures request to completion latency.
+ *	@param		.
+ *	@return		.
+ */
+static T_void handleVCBLoadTransmission(T_void)
+{
+	T_vcbLoadNode* node = &vcbLoadNodes[getVCBNode()];
+
+	if (NEQ(ReadBit(GetCAN_TCR(), CAN_MB_0), 0U)) {
+		node->sent++;
+		node->maxLatency = MAX(node->maxLatency, getVCBTime() - node->requested);
+	}
+	handleVCBTransmission();
+}
+
+/**
+ *	@fn			T_void runVCBLoadNode(T_uint8)
+ *	@brief 		Node application.
+ *	@param[in]	index	Node index.
+ *	@return		.
+ */
+static T_void runVCBLoadNode(T_uint8 index)
+{
+	T_vcbLoadNode* node = &vcbLoadNodes[index];
+	T_uint32 count = 0UL;
+
+	initCAN(CAN_BTR_500K, ToBit(CAN_MB_7), ToBit(CAN_MB_0));
+	setupCANMessageBuffer(CAN_MB_0, CAN_ID_STD_FORMAT, index, 0U, CAN_FULL_BIT_CMP,
+		CAN_DLC_8BYTES, CAN_TX_INT_ENABLED, CAN_RX_INT_DISABLED, CAN_TX_IMMEDIATELY,
+		CAN_TX_DATA_FRAME);
+	setupCANMessageBuffer(CAN_MB_7, CAN_ID_STD_FORMAT, 0U, 0U, CAN_FULL_BIT_MASK,
+		CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_ENABLED, CAN_TX_IMMEDIATELY,
+		CAN_TX_DATA_FRAME);
+	setVCBHandlers(handleVCBLoadReception, handleVCBLoadTransmission);
+	startCAN();
+	if (IS(vcbLoadStagger)) {
+		waitVCB((vcbLoadPeriod / vcbLoadCount) * index);
+	}
+	for (;;) {
+		if (NEQ(ReadBit(GetCAN_TREQR(), CAN_MB_0), 0U)) {
+			node->missed++;
+		} else {
+			WriteCANTXDWord(CAN_MB_0, CAN_MB_DWORD_0, count++);
+			WriteCANTXDWord(CAN_MB_0, CAN_MB_DWORD_1, getVCBMillis());
+			node->requested = getVCBTime();
+			requestCANTransmit();
+		}
+		waitVCB(vcbLoadPeriod);
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	const T_vcbStats* stats;
+	T_uint32 bitRate = 500000UL;
+	T_uint32 duration = 1000UL;
+	T_uint32 sent = 0UL;
+	uint64_t worst = 0ULL;
+	unsigned long count;
+	T_uint8 index;
+	int arg;
+
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-s"), 0)) {
+			vcbLoadStagger = TRUE;
+		} else if (EQU(strcmp(argv[arg], "-n"), 0) && LT(arg + 1, argc)) {
+			count = strtoul(argv[++arg], NULL, 0);
+			vcbLoadCount = (T_uint8)MIN(count, VCB_MAX_NODES);
+		} else if (EQU(strcmp(argv[arg], "-t"), 0) && LT(arg + 1, argc)) {
+			duration = strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-b"), 0) && LT(arg + 1, argc)) {
+			bitRate = strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-p"), 0) && LT(arg + 1, argc)) {
+			vcbLoadPeriod = strtoul(argv[++arg], NULL, 0) * 1000UL;
+		} else {
+			fprintf(stderr, "usage: %s [-n NODES] [-t MS] [-b BITRATE] [-p PERIOD] [-s]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+	if (EQU(vcbLoadCount, 0U) || EQU(vcbLoadPeriod, 0UL) || EQU(bitRate, 0UL)) {
+		fprintf(stderr, "nodes, period and bit rate must not be 0\n");
+		return 2;
+	}
+	runVCB(vcbLoadCount, runVCBLoadNode, bitRate, duration);
+	stats = getVCBStats();
+	printf("node      sent  received  missed  max latency (us)\n");
+	for (index = 0U; LT(index, vcbLoadCount); index++) {
+		printf("%4u  %8lu  %8lu  %6lu  %16.1f\n", index,
+			(unsigned long)vcbLoadNodes[index].sent,
+			(unsigned long)vcbLoadNodes[index].received,
+			(unsigned long)vcbLoadNodes[index].missed,
+			vcbLoadNodes[index].maxLatency / 1000.0);
+		sent += vcbLoadNodes[index].sent;
+		worst = MAX(worst, vcbLoadNodes[index].maxLatency);
+	}
+	printf("%lu frames (%lu sent), %lu arbitrations, bus load %.1f%%,"
+		" worst latency %.1f us\n", (unsigned long)stats->frames, (unsigned long)sent,
+		(unsigned long)stats->arbitrations,
+		(100.0 * stats->busyTime) / ((uint64_t)duration * 1000000ULL), worst / 1000.0);
+
+	return 0;
+}
+
+/* END OF VCB_LOAD. */
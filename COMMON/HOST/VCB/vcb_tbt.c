@@ -0,0 +1,55 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Virtual CAN Bus Host Timebase Timer Implementation						 */
+/**
+ *	@file		VCB/vcb_tbt.c
+ *	@brief		This file contains the host implementation of TMR/tbt.h API
+ *				functions over the global virtual clock.
+ *	@details	pTBTCount reads vcbTBTCount, which the scheduler keeps at the
+ *				virtual time in 1.024 ms ticks, so the TBT getters (i.e.
+ *				GetDWordTBTMillis) work as on the target. The count does not
+ *				move while a node runs, only across waits. delay lets virtual
+ *				time run through waitVCB (interrupts of the node are delivered
+ *				meanwhile), and initTBT does nothing since the count starts
+ *				with the run.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCB/vcb.h>
+
+/* ----------------------------------------------------------------------------
+**	External Constants.
+*/
+
+/**
+ * 	@var		pTBTCount
+ *	@brief		Read-only access to time near-millisecond tick count.
+ */
+volatile T_gptCount const * const pTBTCount = &vcbTBTCount;
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initTBT(T_void)
+ *	@brief 		Initializes and starts timebase timer (count runs with the
+ *				virtual bus).
+ * 	@param		.
+ * 	@return		.
+ */
+T_void initTBT(T_void)
+{
+}
+
+/**
+ * 	@fn 		T_void delay(T_gptCount)
+ *	@brief 		Millisecond delay in virtual time.
+ * 	@param[in]	milliseconds 	Delay time.
+ * 	@return		.
+ */
+T_void delay(T_gptCount milliseconds)
+{
+	waitVCB((T_uint32)(milliseconds * 1000UL));
+}
+
+/* END OF VCB_TBT. */
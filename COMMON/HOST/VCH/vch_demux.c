@@ -0,0 +1,478 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* KernelUART Virtual Channels Demultiplexer Host Tool						 */
+/**
+ *	@file		VCH/vch_demux.c
+ *	@brief		This file contains the host tool splitting the KernelUART
+ *				shared by VCH into one pty for the monitor host and one pty per
+ *				application channel.
+ *	@details	Usage: vch_demux [-c CHANNELS] [-g GUARD_MS] [-s BAUD] DEVICE
+ *				<br>
+ *				The pty paths are printed at start: the Accemic MDE is pointed
+ *				at the monitor pty, and channel readers (i.e. tlm_decode or a
+ *				terminal) at the channel ptys. Outside monitor windows, valid
+ *				TLM frames of the application channels have their payload
+ *				written to the channel pty, and bytes written to a channel pty
+ *				are sent to the target (read by the application through SER).
+ *				When a window is announced (VCH_CONTROL_CHANNEL frame), the
+ *				target bytes of the window go to the monitor pty, and monitor
+ *				host bytes, held until then, are sent from GUARD_MS after the
+ *				announcement up to GUARD_MS before the window end so that none
+ *				reach the target during an application window. Target bytes go
+ *				to the monitor pty up to the first delimiter received after
+ *				that point, which is the one opening the next application
+ *				window (monitor bytes may hold zeros earlier). Counters are
+ *				printed on standard error at exit (SIGINT). Built with: <br>
+ *				cc -I LIB/MB90385/include -I LIB/EXTRA/include -o vch_demux
+ *				HOST/VCH/vch_demux.c LIB/EXTRA/implement/TLM/tlm.c
+ *				<br> (VCH and TLM flags as for the target).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#define _XOPEN_SOURCE 700
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <VCH/vch.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		VCH_DEMUX_MAX_FRAME
+ *	@brief 		Largest encoded frame without delimiter.
+ */
+#define VCH_DEMUX_MAX_FRAME			(254U)
+
+/**
+ * 	@def		VCH_DEMUX_HOLD_SIZE
+ *	@brief 		Monitor host bytes held between windows.
+ */
+#define VCH_DEMUX_HOLD_SIZE			(4096U)
+
+/**
+ * 	@def		VCH_DEMUX_GUARD_MS
+ *	@brief 		Default guard time at both ends of a monitor window.
+ */
+#define VCH_DEMUX_GUARD_MS			(5U)
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for a pty.
+ */
+typedef struct {
+	int master;
+	int slave;
+	unsigned long dropped;
+} T_vchDemuxPty;
+
+/**
+ *	@brief		Data structure for demultiplexer state.
+ */
+typedef struct {
+	int serial;
+	T_vchDemuxPty monitor;
+	T_vchDemuxPty channels[VCH_MAX_CHANNELS];
+	T_uint8 channelCount;
+	/* frame reception */
+	T_uint8 encoded[VCH_DEMUX_MAX_FRAME];
+	unsigned int length;
+	/* monitor window */
+	T_bit window;
+	long long windowOpen;
+	long long windowClose;
+	unsigned int guard;
+	T_uint8 hold[VCH_DEMUX_HOLD_SIZE];
+	size_t holdCount;
+	/* counters */
+	unsigned long frames;
+	unsigned long invalid;
+	unsigned long windows;
+	unsigned long monitorBytes;
+} T_vchDemux;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		vchDemuxStop
+ *	@brief		Stop request (SIGINT, SIGTERM).
+ */
+static volatile sig_atomic_t vchDemuxStop;
+
+/* ----------------------------------------------------------------------------
+**	Serial Stub.
+*/
+
+T_uint8 writeSERBytes(const T_uint8* pBuff, T_uint8 len)
+{
+	(T_void)pBuff;
+
+	return len;
+}
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void stopVCHDemux(int)
+ *	@brief 		Signal handler requesting the stop.
+ *	@param[in]	signum	Signal number.
+ *	@return		.
+ */
+static T_void stopVCHDemux(int signum)
+{
+	(T_void)signum;
+	vchDemuxStop = 1;
+}
+
+/**
+ *	@fn			long long getVCHDemuxMillis(T_void)
+ *	@brief 		Gets monotonic time in milliseconds.
+ *	@param		.
+ *	@return		time.
+ */
+static long long getVCHDemuxMillis(T_void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (long long)now.tv_sec * 1000LL + now.tv_nsec / 1000000L;
+}
+
+/**
+ *	@fn			int openVCHDemuxPty(T_vchDemuxPty*, const char*)
+ *	@brief 		Opens a raw pty (its slave kept open so that writes never
+ *				fail while no reader is attached) and prints its path.
+ *	@param		pty		Pty.
+ *	@param[in]	name	Pty name.
+ *	@return		zero on success.
+ */
+static int openVCHDemuxPty(T_vchDemuxPty* pty, const char* name)
+{
+	struct termios attr;
+	const char* path;
+
+	pty->master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (LT(pty->master, 0) || NEQ(grantpt(pty->master), 0)
+		|| NEQ(unlockpt(pty->master), 0)) {
+		perror(name);
+		return -1;
+	}
+	path = ptsname(pty->master);
+	pty->slave = open(path, O_RDWR | O_NOCTTY);
+	if (LT(pty->slave, 0) || NEQ(tcgetattr(pty->slave, &attr), 0)) {
+		perror(path);
+		return -1;
+	}
+	cfmakeraw(&attr);
+	(T_void)tcsetattr(pty->slave, TCSANOW, &attr);
+	pty->dropped = 0UL;
+	printf("%s: %s\n", name, path);
+
+	return 0;
+}
+
+/**
+ *	@fn			int openVCHDemuxSerial(const char*, speed_t)
+ *	@brief 		Opens the serial device in raw mode.
+ *	@param[in]	path	Serial device.
+ *	@param[in]	speed	Baud rate.
+ *	@return		descriptor (negative on failure).
+ */
+static int openVCHDemuxSerial(const char* path, speed_t speed)
+{
+	struct termios attr;
+	int serial = open(path, O_RDWR | O_NOCTTY);
+
+	if (LT(serial, 0)) {
+		perror(path);
+		return -1;
+	}
+	if (EQU(tcgetattr(serial, &attr), 0)) {
+		cfmakeraw(&attr);
+		(T_void)cfsetispeed(&attr, speed);
+		(T_void)cfsetospeed(&attr, speed);
+		(T_void)tcsetattr(serial, TCSANOW, &attr);
+	}
+
+	return serial;
+}
+
+/**
+ *	@fn			T_void writeVCHDemuxPty(T_vchDemuxPty*, const T_uint8*, size_t)
+ *	@brief 		Writes bytes to a pty, counting those not accepted.
+ *	@param		pty		Pty.
+ *	@param[in]	pBuff	Bytes.
+ *	@param[in]	len		Byte count.
+ *	@return		.
+ */
+static T_void writeVCHDemuxPty(T_vchDemuxPty* pty, const T_uint8* pBuff, size_t len)
+{
+	ssize_t written = write(pty->master, pBuff, len);
+
+	pty->dropped += (unsigned long)(len - COND(GT(written, 0), (size_t)written, 0U));
+}
+
+/**
+ *	@fn			T_void writeVCHDemuxSerial(T_vchDemux*, const T_uint8*, size_t)
+ *	@brief 		Writes all bytes to the serial device.
+ *	@param		demux	Demultiplexer state.
+ *	@param[in]	pBuff	Bytes.
+ *	@param[in]	len		Byte count.
+ *	@return		.
+ */
+static T_void writeVCHDemuxSerial(T_vchDemux* demux, const T_uint8* pBuff, size_t len)
+{
+	ssize_t written;
+
+	while (NEQ(len, 0U)) {
+		written = write(demux->serial, pBuff, len);
+		if (LT(written, 0)) {
+			if (NEQ(errno, EINTR)) {
+				perror("serial");
+				vchDemuxStop = 1;
+				return;
+			}
+			continue;
+		}
+		pBuff += written;
+		len -= (size_t)written;
+	}
+}
+
+/**
+ *	@fn			T_void routeVCHDemuxFrame(T_vchDemux*)
+ *	@brief 		Checks a received frame and routes its payload.
+ *	@param		demux	Demultiplexer state.
+ *	@return		.
+ */
+static T_void routeVCHDemuxFrame(T_vchDemux* demux)
+{
+	T_uint8 frame[VCH_DEMUX_MAX_FRAME];
+	T_uint8 size;
+	T_uint8 channel;
+	long long now;
+
+	if (EQU(demux->length, 0U)) {
+		return;
+	}
+	size = COND(LEQ(demux->length, VCH_DEMUX_MAX_FRAME),
+		decodeTLMCOBS(frame, demux->encoded, (T_uint8)demux->length), 0U);
+	if (LT(size, TLM_HEADER_SIZE + TLM_CRC_SIZE)
+		|| NEQ(computeTLMCRC(frame, size - TLM_CRC_SIZE),
+		(T_uint16)(frame[size - 2U] | (frame[size - 1U] << 8U)))) {
+		demux->invalid++;
+		return;
+	}
+	size -= TLM_CRC_SIZE;
+	demux->frames++;
+	channel = frame[0];
+	if (EQU(channel, VCH_CONTROL_CHANNEL) && EQU(size, TLM_HEADER_SIZE + 2U)) {
+		/* monitor window announced */
+		now = getVCHDemuxMillis();
+		demux->window = TRUE;
+		demux->windowOpen = now + demux->guard;
+		demux->windowClose = now + (frame[2] | (frame[3] << 8U)) - demux->guard;
+		demux->windows++;
+	} else if (GEQ(channel, VCH_CHANNEL_BASE)
+		&& LT(channel, VCH_CHANNEL_BASE + demux->channelCount)) {
+		writeVCHDemuxPty(&demux->channels[channel - VCH_CHANNEL_BASE],
+			frame + TLM_HEADER_SIZE, size - TLM_HEADER_SIZE);
+	}
+}
+
+/**
+ *	@fn			T_void receiveVCHDemuxSerial(T_vchDemux*)
+ *	@brief 		Reads target bytes and routes them to the ptys.
+ *	@param		demux	Demultiplexer state.
+ *	@return		.
+ */
+static T_void receiveVCHDemuxSerial(T_vchDemux* demux)
+{
+	T_uint8 buffer[256];
+	ssize_t count = read(demux->serial, buffer, sizeof(buffer));
+	long long now = getVCHDemuxMillis();
+	ssize_t index;
+
+	if (LEQ(count, 0)) {
+		if (EQU(count, 0) || NEQ(errno, EINTR)) {
+			vchDemuxStop = 1;
+		}
+		return;
+	}
+	for (index = 0; LT(index, count); index++) {
+		if (IS(demux->window)) {
+			/* monitor bytes up to the delimiter opening the next application window */
+			if (NEQ(buffer[index], 0U) || LT(now, demux->windowClose)) {
+				writeVCHDemuxPty(&demux->monitor, &buffer[index], 1U);
+				demux->monitorBytes++;
+				continue;
+			}
+			demux->window = FALSE;
+			demux->length = 0U;
+		} else if (EQU(buffer[index], 0U)) {
+			routeVCHDemuxFrame(demux);
+			demux->length = 0U;
+		} else {
+			/* oversized frames are kept counting until their delimiter */
+			if (LT(demux->length, VCH_DEMUX_MAX_FRAME)) {
+				demux->encoded[demux->length] = buffer[index];
+			}
+			demux->length++;
+		}
+	}
+}
+
+/**
+ *	@fn			int runVCHDemux(T_vchDemux*)
+ *	@brief 		Runs the demultiplexer until stopped.
+ *	@param		demux	Demultiplexer state.
+ *	@return		exit status.
+ */
+static int runVCHDemux(T_vchDemux* demux)
+{
+	struct pollfd fds[2U + VCH_MAX_CHANNELS];
+	T_uint8 buffer[256];
+	T_bit sending;
+	long long now;
+	ssize_t count;
+	int timeout;
+	T_uint8 index;
+
+	while (NOT(vchDemuxStop)) {
+		now = getVCHDemuxMillis();
+		sending = (T_bit)(IS(demux->window) && GEQ(now, demux->windowOpen)
+			&& LT(now, demux->windowClose));
+		/* release held monitor host bytes within the window */
+		if (IS(sending) && NEQ(demux->holdCount, 0U)) {
+			writeVCHDemuxSerial(demux, demux->hold, demux->holdCount);
+			demux->holdCount = 0U;
+		}
+		timeout = -1;
+		if (IS(demux->window) && LT(now, demux->windowOpen)) {
+			timeout = (int)(demux->windowOpen - now);
+		}
+		fds[0].fd = demux->serial;
+		fds[0].events = POLLIN;
+		/* monitor host bytes are held while the hold buffer has room */
+		fds[1].fd = COND(LT(demux->holdCount, VCH_DEMUX_HOLD_SIZE),
+			demux->monitor.master, -1);
+		fds[1].events = POLLIN;
+		/* application host bytes are only sent outside monitor windows */
+		for (index = 0U; LT(index, demux->channelCount); index++) {
+			fds[2U + index].fd = COND(IS(demux->window), -1,
+				demux->channels[index].master);
+			fds[2U + index].events = POLLIN;
+		}
+		if (LT(poll(fds, 2U + demux->channelCount, timeout), 0)) {
+			if (NEQ(errno, EINTR)) {
+				perror("poll");
+				return 1;
+			}
+			continue;
+		}
+		if (NEQ(fds[0].revents, 0)) {
+			receiveVCHDemuxSerial(demux);
+		}
+		if (NEQ(fds[1].revents & POLLIN, 0)) {
+			count = read(demux->monitor.master, demux->hold + demux->holdCount,
+				VCH_DEMUX_HOLD_SIZE - demux->holdCount);
+			if (GT(count, 0)) {
+				demux->holdCount += (size_t)count;
+			}
+		}
+		for (index = 0U; LT(index, demux->channelCount); index++) {
+			if (NEQ(fds[2U + index].revents & POLLIN, 0)) {
+				count = read(demux->channels[index].master, buffer, sizeof(buffer));
+				if (GT(count, 0)) {
+					writeVCHDemuxSerial(demux, buffer, (size_t)count);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* ----------------------------------------------------------------------------
+**	Main Function.
+*/
+
+int main(int argc, char* argv[])
+{
+	static T_vchDemux demux;
+	const char* device = NULL;
+	speed_t speed = B38400;
+	char name[16];
+	unsigned long count;
+	unsigned long baud;
+	T_uint8 index;
+	int status;
+	int arg;
+
+	demux.channelCount = VCH_MAX_CHANNELS;
+	demux.guard = VCH_DEMUX_GUARD_MS;
+	for (arg = 1; LT(arg, argc); arg++) {
+		if (EQU(strcmp(argv[arg], "-c"), 0) && LT(arg + 1, argc)) {
+			count = strtoul(argv[++arg], NULL, 0);
+			demux.channelCount = (T_uint8)MIN(count, VCH_MAX_CHANNELS);
+		} else if (EQU(strcmp(argv[arg], "-g"), 0) && LT(arg + 1, argc)) {
+			demux.guard = (unsigned int)strtoul(argv[++arg], NULL, 0);
+		} else if (EQU(strcmp(argv[arg], "-s"), 0) && LT(arg + 1, argc)) {
+			baud = strtoul(argv[++arg], NULL, 0);
+			speed = COND(EQU(baud, 115200UL), B115200, COND(EQU(baud, 57600UL),
+				B57600, COND(EQU(baud, 19200UL), B19200, B38400)));
+		} else if (NEQ(argv[arg][0], '-') && EQU(device, NULL)) {
+			device = argv[arg];
+		} else {
+			device = NULL;
+			break;
+		}
+	}
+	if (EQU(device, NULL)) {
+		fprintf(stderr, "usage: %s [-c CHANNELS] [-g GUARD_MS] [-s BAUD] DEVICE\n",
+			argv[0]);
+		return 2;
+	}
+	demux.serial = openVCHDemuxSerial(device, speed);
+	if (LT(demux.serial, 0) || NEQ(openVCHDemuxPty(&demux.monitor, "monitor"), 0)) {
+		return 1;
+	}
+	for (index = 0U; LT(index, demux.channelCount); index++) {
+		snprintf(name, sizeof(name), "channel %u", index);
+		if (NEQ(openVCHDemuxPty(&demux.channels[index], name), 0)) {
+			return 1;
+		}
+	}
+	fflush(stdout);
+	signal(SIGINT, stopVCHDemux);
+	signal(SIGTERM, stopVCHDemux);
+	status = runVCHDemux(&demux);
+	fprintf(stderr, "%lu frames, %lu invalid, %lu monitor windows, %lu monitor bytes,"
+		" %lu monitor bytes dropped\n", demux.frames, demux.invalid, demux.windows,
+		demux.monitorBytes, demux.monitor.dropped);
+	for (index = 0U; LT(index, demux.channelCount); index++) {
+		fprintf(stderr, "channel %u: %lu bytes dropped\n", index,
+			demux.channels[index].dropped);
+	}
+
+	return status;
+}
+
+/* END OF VCH_DEMUX. */
@@ -0,0 +1,54 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Acceptance Filter Planner API Implementation								 */
+/**
+ *	@file		ACF/acf_api.c
+ *	@brief		This file contains ACF peripheral API functions implementation.
+ *	@details	Kept apart from ACF/acf_plan.c so that planning builds on host
+ *				without the CAN library.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <ACF/acf.h>
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void applyACF(const T_acfPlan*)
+ *	@brief 		Disables the message buffers of a plan, sets up acceptance
+ *				masks and message buffers, then enables the message buffers
+ *				again.
+ *	@param[in]	plan	ACF plan.
+ *	@return		.
+ */
+T_void applyACF(const T_acfPlan* plan)
+{
+	T_uint8 buffer;
+
+	/* masks and IDs may only change while their buffers are invalid */
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NEQ(ReadBit(plan->buffers, buffer), 0U)) {
+			DisableCANMsgBuff(buffer);
+		}
+	}
+	if (NEQ(plan->mask[0], 0UL)) {
+		SetCAN_AMR0(toIDRegMap(plan->mask[0]));
+	}
+	if (NEQ(plan->mask[1], 0UL)) {
+		SetCAN_AMR1(toIDRegMap(plan->mask[1]));
+	}
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (EQU(ReadBit(plan->buffers, buffer), 0U)) {
+			continue;
+		}
+		setupCANMessageBuffer((T_canMsgBuf)buffer, plan->format,
+			GetByteACFPrefix(plan->id[buffer]), GetWordACFSuffix(plan->id[buffer]),
+			plan->option[buffer], CAN_DLC_8BYTES, CAN_TX_INT_DISABLED,
+			CAN_RX_INT_ENABLED, CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+		SetCAN_IDR(buffer, toIDRegMap(plan->id[buffer]));
+		EnableCANMsgBuff(buffer);
+	}
+}
+
+/* END OF ACF_API. */
@@ -0,0 +1,507 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Acceptance Filter Planner Implementation									 */
+/**
+ *	@file		ACF/acf_plan.c
+ *	@brief		This file contains ACF planning API functions implementation.
+ *	@details	For a given pair of masks, the IDs fall into classes (IDs equal
+ *				outside the mask). Classes of two IDs or more are taken by the
+ *				lowest cost per buffer saved until the IDs fit in the buffers,
+ *				and the remaining IDs get full-bit comparison. Each mask step
+ *				only tries, for every ID, the bits differing from its nearest
+ *				ID, and each try evaluates classes in O(n^2) without traffic.
+ *				Class tables are static (planning is not reentrant), so that
+ *				stack use does not grow with ACF_MAX_IDS.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <ACF/acf.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+#if ACF_MAX_IDS > 255
+#error "ACF_MAX_IDS must fit the T_uint8 ID count"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for ACF planning context.
+ */
+typedef struct {
+	const T_dword* ids;
+	const T_acfTraffic* traffic;
+	T_dword bits;
+	T_uint16 trafficCount;
+	T_uint8 count;
+	T_uint8 buffers;
+} T_acfContext;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		acfLeader, acfSize, acfClassCost, acfCovered
+ *	@brief		Class leader (first ID of class), class size and class cost
+ *				per mask, and IDs covered by a selected class (see evaluateACF).
+ */
+static T_uint8 acfLeader[2U][ACF_MAX_IDS];
+static T_uint8 acfSize[2U][ACF_MAX_IDS];
+static T_uint32 acfClassCost[2U][ACF_MAX_IDS];
+static T_bit acfCovered[ACF_MAX_IDS];
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 countACFBits(T_dword)
+ *	@brief 		Counts set bits.
+ *	@param[in]	value	Bits to count.
+ *	@return		set bits.
+ */
+static T_uint8 countACFBits(T_dword value)
+{
+	T_uint8 count = 0U;
+
+	while (NEQ(value, 0UL)) {
+		value &= value - 1UL;
+		count++;
+	}
+
+	return count;
+}
+
+/**
+ *	@fn			T_uint32 addACFCost(T_uint32, T_uint32)
+ *	@brief 		Adds false accept counts (saturated).
+ *	@param[in]	lhs		False accepts.
+ *	@param[in]	rhs		False accepts.
+ *	@return		sum.
+ */
+static T_uint32 addACFCost(T_uint32 lhs, T_uint32 rhs)
+{
+	return COND(GT(rhs, ACF_MAX_COST - lhs), ACF_MAX_COST, lhs + rhs);
+}
+
+/**
+ *	@fn			T_bit checkACFWanted(const T_dword*, T_uint8, T_dword, T_dword)
+ *	@brief 		Checks if an ID is subscribed.
+ *	@param[in]	ids		Subscribed IDs.
+ *	@param[in]	count	Subscribed ID count.
+ *	@param[in]	id		ID to check.
+ *	@param[in]	bits	ID bits compared.
+ *	@return		subscription.
+ */
+static T_bit checkACFWanted(const T_dword* ids, T_uint8 count, T_dword id, T_dword bits)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, count); index++) {
+		if (EQU((ids[index] ^ id) & bits, 0UL)) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ *	@fn			T_uint32 costACFClass(const T_acfContext*, T_dword, T_dword)
+ *	@brief 		Counts false accepts of a class.
+ *	@param[in]	context		Planning context.
+ *	@param[in]	base		Class ID.
+ *	@param[in]	mask		Class mask.
+ *	@return		false accepts.
+ */
+static T_uint32 costACFClass(const T_acfContext* context, T_dword base, T_dword mask)
+{
+	T_dword compared = context->bits & ~mask;
+	T_uint32 cost = 0UL;
+	T_uint16 index;
+
+	if (EQU(context->traffic, NULL)) {
+		/* unwanted IDs of the class */
+		cost = (T_uint32)1UL << countACFBits(context->bits & mask);
+		for (index = 0U; LT(index, context->count); index++) {
+			if (EQU((context->ids[index] ^ base) & compared, 0UL)) {
+				cost--;
+			}
+		}
+	} else {
+		/* unwanted frames of the class */
+		for (index = 0U; LT(index, context->trafficCount); index++) {
+			if (EQU((context->traffic[index].id ^ base) & compared, 0UL)
+					&& NOT(checkACFWanted(context->ids, context->count,
+					context->traffic[index].id, context->bits))) {
+				cost = addACFCost(cost, context->traffic[index].frames);
+			}
+		}
+	}
+
+	return cost;
+}
+
+/**
+ *	@fn			T_uint8 evaluateACF(const T_acfContext*, const T_dword*,
+ *					T_uint32*, T_acfPlan*)
+ *	@brief 		Selects classes of a pair of masks until IDs fit in buffers.
+ *	@param[in]	context		Planning context.
+ *	@param[in]	mask		AMR0 and AMR1 masks.
+ *	@param[out]	pCost		False accepts.
+ *	@param[out]	plan		ACF plan (NULL for evaluation only).
+ *	@return		buffers needed.
+ */
+static T_uint8 evaluateACF(const T_acfContext* context, const T_dword* mask,
+	T_uint32* pCost, T_acfPlan* plan)
+{
+	T_uint32 score;
+	T_uint32 bestScore;
+	T_uint8 needed = context->count;
+	T_uint8 buffer = 0U;
+	T_uint8 bestSize;
+	T_uint8 bestMask = 0U;
+	T_uint8 bestID = 0U;
+	T_uint8 index, other, option;
+
+	/* class leader (first ID of class) and size of each class */
+	*pCost = 0UL;
+	for (index = 0U; LT(index, context->count); index++) {
+		acfCovered[index] = FALSE;
+		for (option = 0U; LT(option, 2U); option++) {
+			acfLeader[option][index] = index;
+			acfSize[option][index] = 0U;
+			if (EQU(mask[option], 0UL)) {
+				continue;
+			}
+			for (other = 0U; LT(other, index); other++) {
+				if (EQU((context->ids[other] ^ context->ids[index]) & context->bits
+						& ~mask[option], 0UL)) {
+					acfLeader[option][index] = acfLeader[option][other];
+					break;
+				}
+			}
+			acfSize[option][acfLeader[option][index]]++;
+		}
+	}
+	for (option = 0U; LT(option, 2U); option++) {
+		for (index = 0U; LT(index, context->count); index++) {
+			acfClassCost[option][index] = COND(LT(acfSize[option][index], 2U), 0UL,
+				costACFClass(context, context->ids[index], mask[option]));
+		}
+	}
+	while (GT(needed, context->buffers)) {
+		bestSize = 0U;
+		bestScore = ACF_MAX_COST;
+		/* lowest cost per buffer saved (larger class on tie) */
+		for (option = 0U; LT(option, 2U); option++) {
+			for (index = 0U; LT(index, context->count); index++) {
+				if (LT(acfSize[option][index], 2U)) {
+					continue;
+				}
+				score = acfClassCost[option][index] / (acfSize[option][index] - 1U);
+				if (LT(score, bestScore) || (EQU(score, bestScore)
+						&& GT(acfSize[option][index], bestSize))) {
+					bestScore = score;
+					bestSize = acfSize[option][index];
+					bestMask = option;
+					bestID = index;
+				}
+			}
+		}
+		if (EQU(bestSize, 0U)) {
+			break;
+		}
+		/* cover class IDs, which leave their class of the other mask */
+		for (other = 0U; LT(other, context->count); other++) {
+			if (EQU(acfLeader[bestMask][other], bestID) && NOT(acfCovered[other])) {
+				acfCovered[other] = TRUE;
+				if (NEQ(mask[1U - bestMask], 0UL)) {
+					acfSize[1U - bestMask][acfLeader[1U - bestMask][other]]--;
+				}
+			}
+		}
+		acfSize[bestMask][bestID] = 0U;
+		needed -= (T_uint8)(bestSize - 1U);
+		*pCost = addACFCost(*pCost, acfClassCost[bestMask][bestID]);
+		if (NEQ(plan, NULL) && LT(buffer, CAN_MB_SIZE)) {
+			plan->id[buffer] = context->ids[bestID] & context->bits & ~mask[bestMask];
+			plan->option[buffer++] = (T_canAccMaskOp)(CAN_USE_AMR0 + bestMask);
+		}
+	}
+	/* remaining IDs get full-bit comparison */
+	if (NEQ(plan, NULL)) {
+		for (index = 0U; LT(index, context->count) && LT(buffer, CAN_MB_SIZE); index++) {
+			if (NOT(acfCovered[index])) {
+				plan->id[buffer] = context->ids[index] & context->bits;
+				plan->option[buffer++] = CAN_FULL_BIT_CMP;
+			}
+		}
+		plan->buffers = buffer;
+	}
+
+	return needed;
+}
+
+/**
+ *	@fn			T_bit growACFMask(const T_acfContext*, T_dword*, T_uint8*,
+ *					T_uint32*)
+ *	@brief 		Extends a mask by the bits differing between an ID and its
+ *				nearest ID, choosing the lowest cost per buffer saved.
+ *	@param[in]	context		Planning context.
+ *	@param		mask		AMR0 and AMR1 masks.
+ *	@param		pNeeded		Buffers needed.
+ *	@param		pCost		False accepts.
+ *	@return		progress.
+ */
+static T_bit growACFMask(const T_acfContext* context, T_dword* mask,
+	T_uint8* pNeeded, T_uint32* pCost)
+{
+	T_dword trial[2U];
+	T_dword bestMask[2U] = { 0UL, 0UL };
+	T_dword diff, nearest;
+	T_uint32 cost, score;
+	T_uint32 bestScore = ACF_MAX_COST;
+	T_uint8 bestSaved = 0U;
+	T_uint8 bestNeeded = *pNeeded;
+	T_uint32 bestCost = *pCost;
+	T_uint8 needed, nearestBits, bits;
+	T_uint8 option, index, other;
+
+	for (option = 0U; LT(option, 2U); option++) {
+		/* both unused masks are alike */
+		if (EQU(option, 1U) && EQU(mask[0], 0UL) && EQU(mask[1], 0UL)) {
+			break;
+		}
+		for (index = 0U; LT(index, context->count); index++) {
+			nearest = 0UL;
+			nearestBits = 0xFFU;
+			for (other = 0U; LT(other, context->count); other++) {
+				diff = (context->ids[index] ^ context->ids[other]) & context->bits
+					& ~mask[option];
+				bits = countACFBits(diff);
+				if (NEQ(bits, 0U) && LT(bits, nearestBits)) {
+					nearest = diff;
+					nearestBits = bits;
+				}
+			}
+			if (EQU(nearest, 0UL)) {
+				continue;
+			}
+			trial[0] = mask[0];
+			trial[1] = mask[1];
+			trial[option] |= nearest;
+			needed = evaluateACF(context, trial, &cost, NULL);
+			if (GEQ(needed, *pNeeded)) {
+				continue;
+			}
+			score = COND(LEQ(cost, *pCost), 0UL, cost - *pCost) / (T_uint32)(*pNeeded - needed);
+			if (LT(score, bestScore)
+					|| (EQU(score, bestScore) && GT(*pNeeded - needed, bestSaved))) {
+				bestScore = score;
+				bestSaved = (T_uint8)(*pNeeded - needed);
+				bestNeeded = needed;
+				bestCost = cost;
+				bestMask[0] = trial[0];
+				bestMask[1] = trial[1];
+			}
+		}
+	}
+	if (EQU(bestSaved, 0U)) {
+		return FALSE;
+	}
+	mask[0] = bestMask[0];
+	mask[1] = bestMask[1];
+	*pNeeded = bestNeeded;
+	*pCost = bestCost;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_void trimACFMask(const T_acfContext*, T_dword*, T_uint32*)
+ *	@brief 		Clears every mask bit whose removal keeps IDs within buffers
+ *				and lowers the cost.
+ *	@param[in]	context		Planning context.
+ *	@param		mask		AMR0 and AMR1 masks.
+ *	@param		pCost		False accepts.
+ *	@return		.
+ */
+static T_void trimACFMask(const T_acfContext* context, T_dword* mask, T_uint32* pCost)
+{
+	T_dword trial[2U];
+	T_uint32 cost;
+	T_uint8 option, bit;
+
+	for (option = 0U; LT(option, 2U); option++) {
+		for (bit = 0U; LT(bit, 29U); bit++) {
+			if (EQU(ReadBit(mask[option], bit), 0UL)) {
+				continue;
+			}
+			trial[0] = mask[0];
+			trial[1] = mask[1];
+			trial[option] &= ~ToBit(bit);
+			if (LEQ(evaluateACF(context, trial, &cost, NULL), context->buffers)
+					&& LT(cost, *pCost)) {
+				mask[option] = trial[option];
+				*pCost = cost;
+			}
+		}
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_bit planACF(T_acfPlan*, const T_dword*, T_uint8, T_canIDFormat,
+ *					T_byte, const T_acfTraffic*, T_uint16)
+ *	@brief 		Plans message buffers and acceptance masks.
+ *	@param[out]	plan			ACF plan.
+ *	@param[in]	ids				Subscribed bit-ordered IDs.
+ *	@param[in]	count			Subscribed ID count.
+ *	@param[in]	format			ID format.
+ *	@param[in]	rxBufferBits	Reception message buffer bits available.
+ *	@param[in]	traffic			Bus traffic.
+ *	@param[in]	trafficCount	Bus traffic entry count.
+ *	@return		plan status.
+ */
+T_bit planACF(T_acfPlan* plan, const T_dword* ids, T_uint8 count,
+	T_canIDFormat format, T_byte rxBufferBits, const T_acfTraffic* traffic,
+	T_uint16 trafficCount)
+{
+	T_acfContext context;
+	T_dword mask[2U] = { 0UL, 0UL };
+	T_canMsgBuf buffers[CAN_MB_SIZE];
+	T_uint32 cost;
+	T_uint8 needed;
+	T_uint8 index;
+	T_uint8 buffer = 0U;
+
+	for (index = 0U; LT(index, CAN_MB_SIZE); index++) {
+		if (NEQ(ReadBit(rxBufferBits, index), 0U)) {
+			buffers[buffer++] = (T_canMsgBuf)index;
+		}
+	}
+	if (EQU(count, 0U) || EQU(buffer, 0U)) {
+		return FALSE;
+	}
+#if ACF_MAX_IDS < 255
+	if (GT(count, ACF_MAX_IDS)) {
+		return FALSE;
+	}
+#endif
+	context.ids = ids;
+	context.traffic = traffic;
+	context.bits = GetDWordACFBits(format);
+	context.trafficCount = trafficCount;
+	context.count = count;
+	context.buffers = buffer;
+	/* grow masks until IDs fit, then trim unneeded bits */
+	needed = evaluateACF(&context, mask, &cost, NULL);
+	while (GT(needed, context.buffers) && IS(growACFMask(&context, mask, &needed, &cost))) {
+		continue;
+	}
+	/* growth stalled: a single class through AMR0 */
+	if (GT(needed, context.buffers)) {
+		mask[0] = 0UL;
+		mask[1] = 0UL;
+		for (index = 1U; LT(index, count); index++) {
+			mask[0] |= (ids[index] ^ ids[0]) & context.bits;
+		}
+		needed = evaluateACF(&context, mask, &cost, NULL);
+	}
+	trimACFMask(&context, mask, &cost);
+	(T_void)evaluateACF(&context, mask, &cost, plan);
+	/* map plan entries to available buffers (highest index last) */
+	for (index = CAN_MB_SIZE; GT(index, 0U); index--) {
+		if (LT(index - 1U, plan->buffers)) {
+			plan->id[buffers[index - 1U]] = plan->id[index - 1U];
+			plan->option[buffers[index - 1U]] = plan->option[index - 1U];
+		}
+	}
+	buffer = plan->buffers;
+	plan->buffers = 0U;
+	for (index = 0U; LT(index, buffer); index++) {
+		plan->buffers |= (T_byte)ToBit(buffers[index]);
+	}
+	plan->mask[0] = mask[0];
+	plan->mask[1] = mask[1];
+	plan->format = format;
+	plan->falseAccepts = cost;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_bit checkACFAccepted(const T_acfPlan*, T_dword)
+ *	@brief 		Checks if a planned peripheral would accept an ID.
+ *	@param[in]	plan	ACF plan.
+ *	@param[in]	id		Bit-ordered ID.
+ *	@return		acceptance.
+ */
+T_bit checkACFAccepted(const T_acfPlan* plan, T_dword id)
+{
+	T_dword bits = GetDWordACFBits(plan->format);
+	T_dword mask;
+	T_uint8 buffer;
+
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (EQU(ReadBit(plan->buffers, buffer), 0U)) {
+			continue;
+		}
+		switch (plan->option[buffer]) {
+		case CAN_FULL_BIT_MASK:
+			return TRUE;
+		case CAN_USE_AMR0:
+			mask = plan->mask[0];
+			break;
+		case CAN_USE_AMR1:
+			mask = plan->mask[1];
+			break;
+		default:
+			mask = 0UL;
+			break;
+		}
+		if (EQU((id ^ plan->id[buffer]) & bits & ~mask, 0UL)) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ *	@fn			T_uint32 countACFFalseAccepts(const T_acfPlan*, const T_dword*,
+ *					T_uint8, const T_acfTraffic*, T_uint16)
+ *	@brief 		Counts frames of a bus traffic accepted but not subscribed.
+ *	@param[in]	plan			ACF plan.
+ *	@param[in]	ids				Subscribed bit-ordered IDs.
+ *	@param[in]	count			Subscribed ID count.
+ *	@param[in]	traffic			Bus traffic.
+ *	@param[in]	trafficCount	Bus traffic entry count.
+ *	@return		false accepts.
+ */
+T_uint32 countACFFalseAccepts(const T_acfPlan* plan, const T_dword* ids,
+	T_uint8 count, const T_acfTraffic* traffic, T_uint16 trafficCount)
+{
+	T_dword bits = GetDWordACFBits(plan->format);
+	T_uint32 falseAccepts = 0UL;
+	T_uint16 index;
+
+	for (index = 0U; LT(index, trafficCount); index++) {
+		if (IS(checkACFAccepted(plan, traffic[index].id))
+				&& NOT(checkACFWanted(ids, count, traffic[index].id, bits))) {
+			falseAccepts = addACFCost(falseAccepts, traffic[index].frames);
+		}
+	}
+
+	return falseAccepts;
+}
+
+/* END OF ACF_PLAN. */
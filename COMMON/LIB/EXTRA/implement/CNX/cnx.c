@@ -0,0 +1,478 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* CAN Extended Driver Implementation										 */
+/**
+ *	@file		CNX/cnx.c
+ *	@brief		This file contains CNX API functions and ISR implementation.
+ *	@details	The ISR keeps the ID register-mapped, so that the conversion to
+ *				bit order is done by readCNXFrame outside of interrupt context.
+ *				Completion and overrun bits are cleared by writing zero to the
+ *				bit alone (writing one has no effect) rather than by
+ *				read-modify-write, which would clear a bit set by the
+ *				controller in between. <br>
+ *				The controller reports neither lost arbitrations nor
+ *				retransmissions. A frame waiting longer than CNX_LATE_TICKS is
+ *				counted as delayed instead, and retransmissions are estimated
+ *				from the transmit error counter, which rises by 8 on every
+ *				transmission error and falls by 1 on every success.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <CNX/cnx.h>
+#if CNX_TX_QUEUE
+#include <CNX/cnxQueue.h>
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		CNX_FIFO_MASK
+ *	@brief 		Reception FIFO index mask.
+ */
+#define CNX_FIFO_MASK			(CNX_FIFO_SIZE - 1U)
+
+/**
+ * 	@def		CNX_STD_FRAME_BITS, CNX_EXT_FRAME_BITS
+ *	@brief 		Frame bits without data field and stuff bits (interframe space
+ *				included).
+ */
+#define CNX_STD_FRAME_BITS		(47U)
+#define CNX_EXT_FRAME_BITS		(67U)
+
+/**
+ * 	@def		CNX_WINDOW_BITS
+ *	@brief 		Bus bits within the sliding window.
+ */
+#define CNX_WINDOW_BITS \
+	((CNX_BIT_RATE / 1000UL) * CNX_LOAD_PERIOD_MS * CNX_LOAD_SLOTS)
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		cnxFIFO
+ *	@brief		Reception FIFO.
+ */
+static T_cnxFrame cnxFIFO[CNX_FIFO_SIZE];
+
+/**
+ *	@var		cnxFIFOHead, cnxFIFOTail
+ *	@brief		Free-running FIFO read and write (ISR) indices.
+ */
+static volatile T_uint8 cnxFIFOHead, cnxFIFOTail;
+
+/**
+ *	@var		cnxTxBits
+ *	@brief		Transmission message buffer bits.
+ */
+static T_byte cnxTxBits;
+
+/**
+ *	@var		cnxTxStamp
+ *	@brief		Transmission request timestamps.
+ */
+static T_uint16 cnxTxStamp[CAN_MB_SIZE];
+
+/**
+ *	@var		cnxLastTEC
+ *	@brief		Transmit error counter at last transmission interrupt.
+ */
+static T_uint8 cnxLastTEC;
+
+/**
+ *	@var		cnxLoadBits
+ *	@brief		Frame bits seen during current period (ISR).
+ */
+static volatile T_uint32 cnxLoadBits;
+
+/**
+ *	@var		cnxLoadSlots, cnxLoadSlot
+ *	@brief		Frame bits of last periods, and oldest period index.
+ */
+static T_uint32 cnxLoadSlots[CNX_LOAD_SLOTS];
+static T_uint8 cnxLoadSlot;
+
+#if CNX_RX_CALLBACK
+/**
+ *	@var		cnxRxCallbacks
+ *	@brief		Reception callbacks per message buffer.
+ */
+static T_cnxRxCallback cnxRxCallbacks[CAN_MB_SIZE];
+#endif
+
+/* ----------------------------------------------------------------------------
+**	External Variables.
+*/
+
+/**
+ *	@var		cnxStats
+ *	@brief		CAN bus statistics.
+ */
+volatile T_cnxStats cnxStats;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 countCNXFrameBits(T_uint8)
+ *	@brief 		Counts bits of a message buffer frame.
+ *	@param[in]	buffer	Message buffer index.
+ *	@return		frame bits (without stuff bits).
+ */
+static T_uint8 countCNXFrameBits(T_uint8 buffer)
+{
+	T_uint8 dlc = (T_uint8)MIN(GetCAN_DLCR(buffer) & 0x0FU, CAN_MB_BYTE_SIZE);
+
+	return (T_uint8)(COND(NEQ(ReadBit(GetCAN_IDER(), buffer), 0U), CNX_EXT_FRAME_BITS,
+		CNX_STD_FRAME_BITS) + (dlc << 3U));
+}
+
+/**
+ *	@fn			T_void countCNXNodeStatus(T_void)
+ *	@brief 		Counts node status transition and restarts bus operation
+ *				halted by bus off.
+ *	@param		.
+ *	@return		.
+ */
+static T_void countCNXNodeStatus(T_void)
+{
+	ClearCANNSTransition();
+	switch (GetCANNodeStatus()) {
+	case CAN_ERR_WARNING:
+		cnxStats.warnings++;
+		break;
+	case CAN_ERR_PASSIVE:
+		cnxStats.passives++;
+		break;
+	case CAN_BUS_OFF:
+		cnxStats.busOffs++;
+		break;
+	default:
+		/* back to error active: error counters were reset */
+		cnxLastTEC = 0U;
+		break;
+	}
+	if (IS(IsCANBusOpHalted())) {
+		StartCANBusOp();
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initCNX(T_byte, T_byte)
+ *	@brief 		Initialize FIFO reception and statistics, then enable reception,
+ *				transmission and node status interrupts.
+ * 	@param[in]	rxBufferBits 	Reception message buffer bits.
+ * 	@param[in]	txBufferBits 	Transmission message buffer bits.
+ * 	@return		.
+ */
+T_void initCNX(T_byte rxBufferBits, T_byte txBufferBits)
+{
+#if CNX_RX_CALLBACK
+	T_uint8 buffer;
+
+#endif
+	cnxFIFOHead = 0U;
+	cnxFIFOTail = 0U;
+	cnxTxBits = txBufferBits;
+#if CNX_RX_CALLBACK
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		cnxRxCallbacks[buffer] = NULL;
+	}
+#endif
+	clearCNXStats();
+	SetCAN_RIER(GetCAN_RIER() | rxBufferBits);
+	SetCAN_TIER(GetCAN_TIER() | txBufferBits);
+	EnableCANNSInterrupt();
+}
+
+/**
+ * 	@fn 		T_bit readCNXFrame(T_cnxFrame*)
+ *	@brief 		Pops the oldest received frame.
+ * 	@param[out]	frame		Received frame.
+ * 	@return		frame availability.
+ */
+T_bit readCNXFrame(T_cnxFrame* frame)
+{
+	if (EQU(cnxFIFOHead, cnxFIFOTail)) {
+		return FALSE;
+	}
+	*frame = cnxFIFO[cnxFIFOHead & CNX_FIFO_MASK];
+	cnxFIFOHead++;
+	frame->id = toIDBitOrder(frame->id);
+
+	return TRUE;
+}
+
+/**
+ * 	@fn 		T_uint8 countCNXFrames(T_void)
+ *	@brief 		Counts frames waiting in the FIFO.
+ * 	@param		.
+ * 	@return		waiting frames.
+ */
+T_uint8 countCNXFrames(T_void)
+{
+	return (T_uint8)(cnxFIFOTail - cnxFIFOHead);
+}
+
+/**
+ * 	@fn 		T_uint16 countCNXOverflows(T_void)
+ *	@brief 		Counts frames dropped because the FIFO was full.
+ * 	@param		.
+ * 	@return		dropped frames.
+ */
+T_uint16 countCNXOverflows(T_void)
+{
+	return cnxStats.rxOverflows;
+}
+
+/**
+ * 	@fn 		T_uint16 countCNXOverruns(T_void)
+ *	@brief 		Counts frames overwritten in a message buffer.
+ * 	@param		.
+ * 	@return		overwritten frames.
+ */
+T_uint16 countCNXOverruns(T_void)
+{
+	return cnxStats.rxOverruns;
+}
+
+#if CNX_RX_CALLBACK
+/**
+ * 	@fn 		T_void setCNXRxCallback(T_canMsgBuf, T_cnxRxCallback)
+ *	@brief 		Sets the reception callback of a message buffer.
+ * 	@param[in]	msgBuf		Message buffer.
+ * 	@param[in]	callback	Reception callback (NULL for the FIFO).
+ * 	@return		.
+ */
+T_void setCNXRxCallback(T_canMsgBuf msgBuf, T_cnxRxCallback callback)
+{
+	/* pointer store is not atomic on a 16-bit CPU */
+	DisableGlobalInterrupt();
+	cnxRxCallbacks[msgBuf] = callback;
+	EnableGlobalInterrupt();
+}
+#endif
+
+/**
+ * 	@fn 		T_void stampCNXTransmit(T_byte)
+ *	@brief 		Starts latency measurement of message buffers.
+ * 	@param[in]	bufferBits 	Message buffer bits about to be requested.
+ * 	@return		.
+ */
+T_void stampCNXTransmit(T_byte bufferBits)
+{
+	T_uint16 stamp = CNX_TIMESTAMP();
+	T_uint8 buffer;
+
+	for (buffer = 0U; NEQ(bufferBits, 0U); buffer++, bufferBits >>= 1U) {
+		if (NEQ(bufferBits & 1U, 0U)) {
+			cnxTxStamp[buffer] = stamp;
+		}
+	}
+}
+
+/**
+ * 	@fn 		T_void stampCNXBuffer(T_uint8, T_uint16)
+ *	@brief 		Starts latency measurement of a message buffer from an earlier
+ *				timestamp.
+ * 	@param[in]	buffer 		Message buffer index.
+ * 	@param[in]	stamp 		Timestamp.
+ * 	@return		.
+ */
+T_void stampCNXBuffer(T_uint8 buffer, T_uint16 stamp)
+{
+	cnxTxStamp[buffer] = stamp;
+}
+
+/**
+ * 	@fn 		T_void requestCNXTransmit(T_void)
+ *	@brief 		Starts latency measurement of transmission message buffers,
+ *				then calls requestCANTransmit.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void requestCNXTransmit(T_void)
+{
+	stampCNXTransmit(cnxTxBits);
+	requestCANTransmit();
+}
+
+/**
+ * 	@fn 		T_void manageCNXLoad(T_void)
+ *	@brief 		Closes a bus load period and updates the sliding window estimate.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void manageCNXLoad(T_void)
+{
+	T_uint32 bits;
+	T_uint8 slot;
+
+	/* take period bits atomically (32-bit on a 16-bit CPU) */
+	DisableGlobalInterrupt();
+	bits = cnxLoadBits;
+	cnxLoadBits = 0UL;
+	EnableGlobalInterrupt();
+	/* replace oldest period */
+	cnxLoadSlots[cnxLoadSlot] = bits;
+	cnxLoadSlot = (T_uint8)((cnxLoadSlot + 1U) % CNX_LOAD_SLOTS);
+	bits = 0UL;
+	for (slot = 0U; LT(slot, CNX_LOAD_SLOTS); slot++) {
+		bits += cnxLoadSlots[slot];
+	}
+	/* scale down first to avoid overflow on large windows */
+	cnxStats.busLoad = (T_uint16)MIN((bits / (CNX_WINDOW_BITS / 1000UL)), 1000UL);
+}
+
+/**
+ * 	@fn 		T_void clearCNXStats(T_void)
+ *	@brief 		Clears statistics.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void clearCNXStats(T_void)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_SIZE); index++) {
+		cnxStats.txFrames[index] = 0U;
+		cnxStats.rxFrames[index] = 0U;
+		cnxStats.txLatency[index] = 0U;
+		cnxStats.txLatencyMax[index] = 0U;
+		cnxStats.txDelayed[index] = 0U;
+	}
+	cnxStats.retransmissions = 0U;
+	cnxStats.warnings = 0U;
+	cnxStats.passives = 0U;
+	cnxStats.busOffs = 0U;
+	cnxStats.tecPeak = 0U;
+	cnxStats.recPeak = 0U;
+	cnxStats.rxOverflows = 0U;
+	cnxStats.rxOverruns = 0U;
+	cnxStats.busLoad = 0U;
+	for (index = 0U; LT(index, CNX_LOAD_SLOTS); index++) {
+		cnxLoadSlots[index] = 0UL;
+	}
+	cnxLoadSlot = 0U;
+	cnxLastTEC = (T_uint8)GetCAN_TEC();
+	DisableGlobalInterrupt();
+	cnxLoadBits = 0UL;
+	EnableGlobalInterrupt();
+}
+
+/**
+ * 	@fn 		T_void CNX_RX_IRQHandler(T_void)
+ *	@brief		Moves every received frame into the FIFO, or passes it to the
+ *				reception callback of its message buffer.
+ *  @param		.
+ *  @return		.
+ */
+#if USE_CNX_ISR
+ISR(CNX_RX_IRQHandler)
+{
+	T_cnxFrame* frame;
+	T_uint16 stamp = CNX_TIMESTAMP();
+	T_byte received = GetCAN_RCR() & GetCAN_RIER();
+	T_uint8 rec = (T_uint8)GetCAN_REC();
+	T_uint8 buffer;
+
+	cnxStats.recPeak = MAX(cnxStats.recPeak, rec);
+	for (buffer = 0U; NEQ(received, 0U); buffer++, received >>= 1U) {
+		if (EQU(received & 1U, 0U)) {
+			continue;
+		}
+		cnxStats.rxFrames[buffer]++;
+		cnxLoadBits += countCNXFrameBits(buffer);
+		if (NEQ(ReadBit(GetCAN_ROVRR(), buffer), 0U)) {
+			SetCAN_ROVRR((T_byte)~ToBit(buffer));
+			cnxStats.rxOverruns++;
+		}
+#if CNX_RX_CALLBACK
+		if (NEQ(cnxRxCallbacks[buffer], NULL)) {
+			/* data registers are read in place */
+			cnxRxCallbacks[buffer](buffer, GetCAN_IDR(buffer),
+				(T_uint8)(GetCAN_DLCR(buffer) & 0x0FU), &IO_CANID.DTR[buffer]);
+		} else
+#endif
+		if (GEQ((T_uint8)(cnxFIFOTail - cnxFIFOHead), CNX_FIFO_SIZE)) {
+			cnxStats.rxOverflows++;
+		} else {
+			frame = &cnxFIFO[cnxFIFOTail & CNX_FIFO_MASK];
+			frame->id = GetCAN_IDR(buffer);
+			frame->dlc = (T_uint8)(GetCAN_DLCR(buffer) & 0x0FU);
+			frame->data.WORD[0] = GetCAN_DTR_WORD(buffer, 0U);
+			frame->data.WORD[1] = GetCAN_DTR_WORD(buffer, 1U);
+			frame->data.WORD[2] = GetCAN_DTR_WORD(buffer, 2U);
+			frame->data.WORD[3] = GetCAN_DTR_WORD(buffer, 3U);
+			frame->stamp = stamp;
+			frame->buffer = buffer;
+			frame->extended = (T_bit)ReadBit(GetCAN_IDER(), buffer);
+			cnxFIFOTail++;
+		}
+		/* release message buffer */
+		SetCAN_RCR((T_byte)~ToBit(buffer));
+	}
+}
+#endif
+
+/**
+ * 	@fn 		T_void CNX_TX_IRQHandler(T_void)
+ *	@brief		Counts transmitted frames and their latency, and node status
+ *				transitions.
+ *  @param		.
+ *  @return		.
+ */
+#if USE_CNX_ISR
+ISR(CNX_TX_IRQHandler)
+{
+	T_uint16 stamp = CNX_TIMESTAMP();
+	T_byte completed = GetCAN_TCR() & GetCAN_TIER();
+#if CNX_TX_QUEUE
+	T_byte released = completed;
+#endif
+	T_uint8 tec = (T_uint8)GetCAN_TEC();
+	T_uint16 latency;
+	T_uint8 count = 0U;
+	T_uint8 buffer;
+
+	for (buffer = 0U; NEQ(completed, 0U); buffer++, completed >>= 1U) {
+		if (EQU(completed & 1U, 0U)) {
+			continue;
+		}
+		latency = (T_uint16)(stamp - cnxTxStamp[buffer]);
+		cnxStats.txFrames[buffer]++;
+		cnxStats.txLatency[buffer] = latency;
+		cnxStats.txLatencyMax[buffer] = MAX(cnxStats.txLatencyMax[buffer], latency);
+#if CNX_LATE_TICKS < 0xFFFFU
+		if (GT(latency, CNX_LATE_TICKS)) {
+			cnxStats.txDelayed[buffer]++;
+		}
+#endif
+		cnxLoadBits += countCNXFrameBits(buffer);
+		count++;
+		SetCAN_TCR((T_byte)~ToBit(buffer));
+	}
+	/* each error adds 8 to TEC, each success subtracts 1 */
+	if (GT(tec + count, cnxLastTEC)) {
+		cnxStats.retransmissions += (T_uint16)((tec + count - cnxLastTEC) >> 3U);
+	}
+	cnxLastTEC = tec;
+	cnxStats.tecPeak = MAX(cnxStats.tecPeak, tec);
+	if (IS(IsCANNSTransition())) {
+		countCNXNodeStatus();
+	}
+#if CNX_TX_QUEUE
+	/* refill released mailboxes */
+	feedCNXQueue(released);
+#endif
+}
+#endif
+
+/* END OF CNX. */
@@ -0,0 +1,276 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* CAN Extended Driver Priority Transmission Queue Implementation			 */
+/**
+ *	@file		CNX/cnx_queue.c
+ *	@brief		This file contains CNX queue API functions implementation.
+ *	@details	The queue is an array sorted by priority key, most urgent frame
+ *				last, so that taking the next frame does not move any other.
+ *				A frame is loaded into the lowest free pool message buffer
+ *				above every pending buffer holding a frame at least as urgent,
+ *				and pending buffers below it (less urgent frames, which the
+ *				controller would transmit first) are reclaimed. Cancel takes
+ *				effect at once unless the frame is already on the bus: its
+ *				transmission request stays set and the frame completes within
+ *				one frame time. A cancel which takes effect later (before a
+ *				retransmission) leaves the buffer with neither request nor
+ *				completion, and its frame is queued back on the next feed.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <CNX/cnxQueue.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		cnxQueue
+ *	@brief		Queued frames, most urgent last.
+ */
+static T_cnxFrame cnxQueue[CNX_QUEUE_SIZE];
+
+/**
+ *	@var		cnxQueueCount
+ *	@brief		Queued frame count.
+ */
+static volatile T_uint8 cnxQueueCount;
+
+/**
+ *	@var		cnxQueueLoaded
+ *	@brief		Frames loaded into pool message buffers.
+ */
+static T_cnxFrame cnxQueueLoaded[CAN_MB_SIZE];
+
+/**
+ *	@var		cnxQueueBits
+ *	@brief		Pool message buffer bits.
+ */
+static T_byte cnxQueueBits;
+
+/**
+ *	@var		cnxQueueBusy
+ *	@brief		Pool message buffer bits holding a frame.
+ */
+static T_byte cnxQueueBusy;
+
+/**
+ *	@var		cnxQueuePreemptions
+ *	@brief		Frames reclaimed from message buffers.
+ */
+static T_uint16 cnxQueuePreemptions;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_dword getCNXQueueKey(const T_cnxFrame*)
+ *	@brief 		Gets the arbitration priority key of a frame.
+ *	@param[in]	frame	CNX frame.
+ *	@return		key (lower is more urgent).
+ *	@note		Standard IDs are bit-ordered in bits 28 to 18, so the IDE bit
+ *				appended below the ID makes a standard frame win over an
+ *				extended frame of the same base ID, as on the bus.
+ */
+static T_dword getCNXQueueKey(const T_cnxFrame* frame)
+{
+	return (frame->id << 1U) | (T_dword)COND(IS(frame->extended), 1U, 0U);
+}
+
+/**
+ *	@fn			T_void pushCNXQueue(const T_cnxFrame*)
+ *	@brief 		Inserts a frame after less urgent frames and before frames at
+ *				least as urgent (first in first out on equal keys).
+ *	@param[in]	frame	CNX frame.
+ *	@return		.
+ *	@pre		Queue must not be full.
+ */
+static T_void pushCNXQueue(const T_cnxFrame* frame)
+{
+	T_dword key = getCNXQueueKey(frame);
+	T_uint8 index = cnxQueueCount;
+
+	while (NEQ(index, 0U) && LEQ(getCNXQueueKey(&cnxQueue[index - 1U]), key)) {
+		cnxQueue[index] = cnxQueue[index - 1U];
+		index--;
+	}
+	cnxQueue[index] = *frame;
+	cnxQueueCount++;
+}
+
+/**
+ *	@fn			T_bit reclaimCNXBuffer(T_uint8)
+ *	@brief 		Cancels a pending message buffer and queues its frame back.
+ *	@param[in]	buffer	Message buffer index.
+ *	@return		reclaimed (FALSE if on the bus, transmitted or queue full).
+ */
+static T_bit reclaimCNXBuffer(T_uint8 buffer)
+{
+	if (GEQ(cnxQueueCount, CNX_QUEUE_SIZE)) {
+		return FALSE;
+	}
+	CancelCANTransmit(buffer);
+	if (NEQ(ReadBit(GetCAN_TREQR() | GetCAN_TCR(), buffer), 0U)) {
+		return FALSE;
+	}
+	cnxQueueBusy &= (T_byte)~ToBit(buffer);
+	pushCNXQueue(&cnxQueueLoaded[buffer]);
+	cnxQueuePreemptions++;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_void loadCNXBuffer(T_uint8, const T_cnxFrame*)
+ *	@brief 		Loads a frame into a message buffer and requests transmission.
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	frame	CNX frame.
+ *	@return		.
+ */
+static T_void loadCNXBuffer(T_uint8 buffer, const T_cnxFrame* frame)
+{
+	cnxQueueLoaded[buffer] = *frame;
+	cnxQueueBusy |= (T_byte)ToBit(buffer);
+	DisableCANMsgBuff(buffer);
+	SetCAN_IDR(buffer, toIDRegMap(frame->id));
+	SetCAN_IDER((T_byte)ModBit(GetCAN_IDER(), buffer, frame->extended));
+	SetCAN_DLCR(buffer, frame->dlc);
+	SetCAN_DTR_WORD(buffer, 0U, frame->data.WORD[0]);
+	SetCAN_DTR_WORD(buffer, 1U, frame->data.WORD[1]);
+	SetCAN_DTR_WORD(buffer, 2U, frame->data.WORD[2]);
+	SetCAN_DTR_WORD(buffer, 3U, frame->data.WORD[3]);
+	EnableCANMsgBuff(buffer);
+	stampCNXBuffer(buffer, frame->stamp);
+	RequestCANTransmit(buffer);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initCNXQueue(T_byte)
+ *	@brief 		Initialize the transmission queue and its message buffer pool.
+ * 	@param[in]	bufferBits 	Pool message buffer bits.
+ * 	@return		.
+ */
+T_void initCNXQueue(T_byte bufferBits)
+{
+	cnxQueueCount = 0U;
+	cnxQueueBits = bufferBits;
+	cnxQueueBusy = 0U;
+	cnxQueuePreemptions = 0U;
+	SetCAN_TIER(GetCAN_TIER() | bufferBits);
+}
+
+/**
+ * 	@fn 		T_bit sendCNXFrame(const T_cnxFrame*)
+ *	@brief 		Queues a frame and feeds the message buffer pool.
+ * 	@param[in]	frame		Frame to transmit.
+ * 	@return		frame queued.
+ */
+T_bit sendCNXFrame(const T_cnxFrame* frame)
+{
+	T_cnxFrame queued = *frame;
+	T_bit done = FALSE;
+
+	queued.stamp = CNX_TIMESTAMP();
+	DisableGlobalInterrupt();
+	if (LT(cnxQueueCount, CNX_QUEUE_SIZE)) {
+		pushCNXQueue(&queued);
+		feedCNXQueue(0U);
+		done = TRUE;
+	}
+	EnableGlobalInterrupt();
+
+	return done;
+}
+
+/**
+ * 	@fn 		T_uint8 countCNXQueued(T_void)
+ *	@brief 		Counts frames waiting in the queue.
+ * 	@param		.
+ * 	@return		waiting frames.
+ */
+T_uint8 countCNXQueued(T_void)
+{
+	return cnxQueueCount;
+}
+
+/**
+ * 	@fn 		T_uint16 countCNXPreemptions(T_void)
+ *	@brief 		Counts frames taken back from message buffers.
+ * 	@param		.
+ * 	@return		reclaimed frames.
+ */
+T_uint16 countCNXPreemptions(T_void)
+{
+	return cnxQueuePreemptions;
+}
+
+/**
+ * 	@fn 		T_void feedCNXQueue(T_byte)
+ *	@brief 		Releases transmitted message buffers, then loads queued frames
+ *				into the pool.
+ * 	@param[in]	completed 	Transmitted message buffer bits.
+ * 	@return		.
+ */
+T_void feedCNXQueue(T_byte completed)
+{
+	T_cnxFrame frame;
+	T_dword key;
+	T_uint8 first;
+	T_uint8 buffer;
+	T_uint8 other;
+
+	cnxQueueBusy &= (T_byte)~completed;
+	/* queue back frames whose cancel took effect after a retransmission */
+	for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+		if (NEQ(ReadBit(cnxQueueBusy, buffer), 0U)
+			&& EQU(ReadBit(GetCAN_TREQR() | GetCAN_TCR(), buffer), 0U)
+			&& LT(cnxQueueCount, CNX_QUEUE_SIZE)) {
+			cnxQueueBusy &= (T_byte)~ToBit(buffer);
+			pushCNXQueue(&cnxQueueLoaded[buffer]);
+		}
+	}
+	while (NEQ(cnxQueueCount, 0U)) {
+		frame = cnxQueue[--cnxQueueCount];
+		key = getCNXQueueKey(&frame);
+		/* skip buffers up to the last one holding a frame at least as urgent */
+		first = 0U;
+		for (buffer = 0U; LT(buffer, CAN_MB_SIZE); buffer++) {
+			if (NEQ(ReadBit(cnxQueueBusy, buffer), 0U)
+				&& LEQ(getCNXQueueKey(&cnxQueueLoaded[buffer]), key)) {
+				first = (T_uint8)(buffer + 1U);
+			}
+		}
+		/* take the lowest free pool buffer above */
+		for (buffer = first; LT(buffer, CAN_MB_SIZE); buffer++) {
+			if (NEQ(ReadBit(cnxQueueBits & (T_byte)~cnxQueueBusy, buffer), 0U)) {
+				break;
+			}
+		}
+		if (EQU(buffer, CAN_MB_SIZE)) {
+			/* none free: reclaim the lowest pool buffer above */
+			for (buffer = first; LT(buffer, CAN_MB_SIZE); buffer++) {
+				if (NEQ(ReadBit(cnxQueueBits, buffer), 0U)) {
+					break;
+				}
+			}
+			if (EQU(buffer, CAN_MB_SIZE) || NOT(reclaimCNXBuffer(buffer))) {
+				/* wait for a transmission completion */
+				cnxQueue[cnxQueueCount++] = frame;
+				break;
+			}
+		}
+		/* reclaim less urgent frames which would be transmitted first */
+		for (other = first; LT(other, buffer); other++) {
+			if (NEQ(ReadBit(cnxQueueBusy, other), 0U)) {
+				(T_void)reclaimCNXBuffer(other);
+			}
+		}
+		loadCNXBuffer(buffer, &frame);
+	}
+}
+
+/* END OF CNX_QUEUE. */
@@ -0,0 +1,336 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Finite State Machine Explorer Implementation								 */
+/**
+ *	@file		FSM/fsmExplorer.c
+ *	@brief		This file contains FSM explorer API functions implementation.
+ *	@details	The explorer is intended to be built on the host together with
+ *				the project's FSM properties, state table and state callbacks,
+ *				with hardware readings stubbed through readFSMExplorerInput.
+ *				All storage is provided by the caller so that the number of
+ *				explored configurations is only limited by the pool given.
+ *				HOST/FSM/fsmx_host.c runs the exploration on several workers
+ *				through dispatchFSMExplorer and hashFSMExplorerConfig.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <FSM/fsmExplorer.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		fsmxInput
+ *	@brief		Input values of the dispatch being explored.
+ */
+static T_fsmxValue fsmxInput[FSMX_MAX_CHANNELS];
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void saveFSMXConfig(const T_fsm*, T_uint8*)
+ *	@brief 		Copies FSM control block and FSM data into a configuration.
+ *	@param[in]	automaton	FSM control block handler.
+ *	@param[out]	config		Configuration bytes.
+ *	@return		.
+ */
+static T_void saveFSMXConfig(const T_fsm* automaton, T_uint8* config)
+{
+	memcpy(config, automaton, SzBytes_(T_fsm));
+	memcpy(config + SzBytes_(T_fsm), automaton->fsmData, automaton->fsmDataSize);
+}
+
+/**
+ *	@fn			T_void loadFSMXConfig(T_fsm*, const T_uint8*)
+ *	@brief 		Restores FSM control block and FSM data from a configuration.
+ *	@param		automaton	FSM control block handler.
+ *	@param[in]	config		Configuration bytes.
+ *	@return		.
+ */
+static T_void loadFSMXConfig(T_fsm* automaton, const T_uint8* config)
+{
+	T_fsmData* data = automaton->fsmData;
+
+	memcpy(automaton, config, SzBytes_(T_fsm));
+	memcpy(data, config + SzBytes_(T_fsm), automaton->fsmDataSize);
+}
+
+/**
+ *	@fn			T_fsmxCount findFSMXSlot(const T_fsmExplorer*, const T_uint8*,
+ *					T_uint16, T_fsmxHash)
+ *	@brief 		Finds the table slot holding a configuration or the empty slot
+ *				where it shall be stored.
+ *	@param[in]	explorer	FSM explorer handler.
+ *	@param[in]	config		Configuration bytes.
+ *	@param[in]	size		Configuration size.
+ *	@param[in]	hash		Configuration hash.
+ *	@return		slot index (FSMX_EMPTY if table is full).
+ */
+static T_fsmxCount findFSMXSlot(const T_fsmExplorer* explorer,
+	const T_uint8* config, T_uint16 size, T_fsmxHash hash)
+{
+	T_fsmxCount mask = explorer->tableSize - 1UL;
+	T_fsmxCount slot = hash & mask;
+	T_fsmxCount probe;
+	T_fsmxCount entry;
+
+	/* linear probing until match or empty slot */
+	for (probe = 0UL; LT(probe, explorer->tableSize); probe++) {
+		entry = explorer->table[slot];
+		if (EQU(entry, FSMX_EMPTY)
+			|| EQU(memcmp(explorer->pool + (entry * size), config, size), 0)) {
+			return slot;
+		}
+		slot = (slot + 1UL) & mask;
+	}
+
+	return FSMX_EMPTY;
+}
+
+/**
+ *	@fn			T_bit stepFSMExplorer(T_fsm*, T_fsmxReport*)
+ *	@brief 		Dispatches FSM once the same way dispatchFSM does, except that a
+ *				chained transition re-entering a state is stopped.
+ *	@param		automaton	FSM control block handler.
+ *	@param[out]	report		Exploration findings.
+ *	@return		dispatch completed (FALSE on chain loop).
+ */
+static T_bit stepFSMExplorer(T_fsm* automaton, T_fsmxReport* report)
+{
+	T_uint8 chained[FSMX_MAP_SIZE];
+	T_fsmCB state;
+	T_fsmIndex from;
+
+	memset(chained, 0, SzBytes_(chained));
+	/* enter pending (reset or forced) state */
+	automaton->current = automaton->privileged.next;
+	from = automaton->current;
+	/* run state preprocess */
+	if (NEQ(automaton->privileged.preProcess, NULL)) {
+		automaton->privileged.preProcess(automaton);
+	}
+	do {
+		/* check if state re-entered within the same dispatch */
+		if (ReadBit(chained[automaton->current >> 3U], automaton->current & 7U)) {
+			WriteBit(report->looped[automaton->current >> 3U], automaton->current & 7U, TRUE);
+			report->chainLoops++;
+			return FALSE;
+		}
+		WriteBit(chained[automaton->current >> 3U], automaton->current & 7U, TRUE);
+		WriteBit(report->reached[automaton->current >> 3U], automaton->current & 7U, TRUE);
+		/* run state callback */
+		automaton->privileged.transitChain = FALSE;
+		state = automaton->properties->stateLUT[automaton->current].state;
+		if (NEQ(state, NULL)) {
+			state(automaton);
+		}
+		/* record leaving state */
+		if (NEQ(automaton->current, from)) {
+			WriteBit(report->exited[from >> 3U], from & 7U, TRUE);
+			from = automaton->current;
+		}
+	} while (IS(automaton->privileged.transitChain));
+	/* run state postprocess */
+	if (NEQ(automaton->privileged.postProcess, NULL)) {
+		automaton->privileged.postProcess(automaton);
+	}
+
+	return TRUE;
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initFSMExplorer(T_fsmExplorer*, T_fsm*, const T_fsmxChannel*,
+ *					T_uint8, T_uint8*, T_fsmxCount, T_fsmxCount*, T_fsmxCount)
+ *	@brief 		Initialize an FSM explorer.
+ *	@param		explorer		FSM explorer handler.
+ *	@param		automaton		Initialized FSM to explore.
+ *	@param[in]	channels		Nondeterministic input channels.
+ *	@param[in]	channelCount	Input channel count.
+ *	@param		pool			Configuration storage.
+ *	@param[in]	poolCapacity	Maximum configurations to store.
+ *	@param		table			Visited configuration table.
+ *	@param[in]	tableSize		Table entry count (power of 2).
+ *	@return		.
+ */
+T_void initFSMExplorer(T_fsmExplorer* explorer, T_fsm* automaton,
+	const T_fsmxChannel* channels, T_uint8 channelCount, T_uint8* pool,
+	T_fsmxCount poolCapacity, T_fsmxCount* table, T_fsmxCount tableSize)
+{
+	T_uint8 ch;
+
+	explorer->automaton = automaton;
+	explorer->channels = channels;
+	explorer->channelCount = MIN(channelCount, FSMX_MAX_CHANNELS);
+	explorer->pool = pool;
+	explorer->poolCapacity = poolCapacity;
+	explorer->table = table;
+	explorer->tableSize = tableSize;
+	/* count input combinations */
+	explorer->combos = 1UL;
+	for (ch = 0U; LT(ch, explorer->channelCount); ch++) {
+		explorer->combos *= channels[ch].valueCount;
+	}
+}
+
+/**
+ *	@fn			T_bit runFSMExplorer(T_fsmExplorer*, T_fsmxReport*)
+ *	@brief 		Explores every reachable configuration breadth-first.
+ *	@param		explorer	FSM explorer handler.
+ *	@param[out]	report		Exploration findings.
+ *	@return		exploration completed (FALSE if storage ran out).
+ */
+T_bit runFSMExplorer(T_fsmExplorer* explorer, T_fsmxReport* report)
+{
+	T_fsm* automaton = explorer->automaton;
+	T_uint16 size = GetFSMXConfigSize(*automaton);
+	T_uint8* next = explorer->pool + (explorer->poolCapacity - 1UL) * size;
+	T_fsmxCount head = 0UL;
+	T_fsmxCount combo;
+	T_fsmxCount slot;
+
+	memset(report, 0, SzBytes_(T_fsmxReport));
+	/* clear visited configuration table */
+	for (slot = 0UL; LT(slot, explorer->tableSize); slot++) {
+		explorer->table[slot] = FSMX_EMPTY;
+	}
+	/* store root configuration (last pool entry is scratch) */
+	if (LT(explorer->poolCapacity, 2UL) || EQU(explorer->combos, 0UL)) {
+		report->truncated = TRUE;
+		return FALSE;
+	}
+	saveFSMXConfig(automaton, explorer->pool);
+	slot = findFSMXSlot(explorer, explorer->pool, size, hashFSMExplorerConfig(explorer->pool, size));
+	explorer->table[slot] = 0UL;
+	report->explored = 1UL;
+	/* expand configurations in breadth-first order */
+	while (LT(head, report->explored) && NOT(report->truncated)) {
+		for (combo = 0UL; LT(combo, explorer->combos) && NOT(report->truncated); combo++) {
+			/* dispatch from restored configuration */
+			if (NOT(dispatchFSMExplorer(explorer, explorer->pool + head * size, combo,
+				next, report))) {
+				continue;
+			}
+			/* keep successor only if never seen before */
+			slot = findFSMXSlot(explorer, next, size, hashFSMExplorerConfig(next, size));
+			if (EQU(slot, FSMX_EMPTY)) {
+				report->truncated = TRUE;
+			} else if (EQU(explorer->table[slot], FSMX_EMPTY)) {
+				if (LT(report->explored, explorer->poolCapacity - 1UL)) {
+					memcpy(explorer->pool + report->explored * size, next, size);
+					explorer->table[slot] = report->explored++;
+				} else {
+					report->truncated = TRUE;
+				}
+			}
+		}
+		head++;
+	}
+	/* leave FSM at its root configuration */
+	loadFSMXConfig(automaton, explorer->pool);
+
+	return NOT(report->truncated);
+}
+
+/**
+ *	@fn			T_bit dispatchFSMExplorer(T_fsmExplorer*, const T_uint8*,
+ *					T_fsmxCount, T_uint8*, T_fsmxReport*)
+ *	@brief 		Dispatches a configuration once under an input combination.
+ *	@param		explorer	FSM explorer handler.
+ *	@param[in]	config		Configuration bytes.
+ *	@param[in]	combo		Input combination index.
+ *	@param[out]	successor	Successor configuration bytes.
+ *	@param[out]	report		Exploration findings.
+ *	@return		successor valid (FALSE on chain loop).
+ */
+T_bit dispatchFSMExplorer(T_fsmExplorer* explorer, const T_uint8* config,
+	T_fsmxCount combo, T_uint8* successor, T_fsmxReport* report)
+{
+	T_uint8 ch;
+
+	/* assign input values of this combination */
+	for (ch = 0U; LT(ch, explorer->channelCount); ch++) {
+		fsmxInput[ch] = explorer->channels[ch].values[combo % explorer->channels[ch].valueCount];
+		combo /= explorer->channels[ch].valueCount;
+	}
+	/* dispatch from restored configuration */
+	loadFSMXConfig(explorer->automaton, config);
+	report->dispatched++;
+	if (NOT(stepFSMExplorer(explorer->automaton, report))) {
+		return FALSE;
+	}
+	saveFSMXConfig(explorer->automaton, successor);
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_fsmxHash hashFSMExplorerConfig(const T_uint8*, T_uint16)
+ *	@brief 		Computes FNV-1a hash of a configuration.
+ *	@param[in]	config	Configuration bytes.
+ *	@param[in]	size	Configuration size.
+ *	@return		hash.
+ */
+T_fsmxHash hashFSMExplorerConfig(const T_uint8* config, T_uint16 size)
+{
+	T_fsmxHash hash = 0x811C9DC5UL;
+
+	/* fold every byte of the configuration */
+	while (NEQ(size, 0U)) {
+		hash ^= (T_fsmxHash)*config++;
+		hash *= 0x01000193UL;
+		size--;
+	}
+
+	return hash;
+}
+
+/**
+ *	@fn			T_fsmxValue readFSMExplorerInput(T_uint8)
+ *	@brief 		Reads the value assigned to an input channel.
+ *	@param[in]	channel		Input channel index.
+ *	@return		input value (zero if channel is out of range).
+ */
+T_fsmxValue readFSMExplorerInput(T_uint8 channel)
+{
+	return COND(LT(channel, FSMX_MAX_CHANNELS), fsmxInput[channel], 0L);
+}
+
+/**
+ *	@fn			T_void logFSMExplorerReport(const T_fsm*, const T_fsmxReport*)
+ *	@brief		Prints exploration counters and per-state findings.
+ *	@param[in]	automaton	Explored FSM.
+ *	@param[in]	report		Exploration findings.
+ *	@return		.
+ */
+T_void logFSMExplorerReport(const T_fsm* automaton, const T_fsmxReport* report)
+{
+	T_fsmIndex index;
+
+	/* print counters */
+	printf("explored: %lu dispatched: %lu chain loops: %lu%s\n",
+		(unsigned long)report->explored, (unsigned long)report->dispatched,
+		(unsigned long)report->chainLoops, COND(IS(report->truncated), " (truncated)", ""));
+	/* print states (null-state excluded) */
+	for (index = 1U; LT(index, GetByteFSMTotalStates(*automaton)); index++) {
+		if (NOT(IsFSMXStateReached(*report, index))) {
+			printf("unreachable: ");
+		} else if (IsFSMXStateChainLooped(*report, index)) {
+			printf("chain loop: ");
+		} else if (IsFSMXStateDeadEnd(*report, index)) {
+			printf("dead end: ");
+		} else {
+			continue;
+		}
+		printf("%s\n", GetStringFSMStateName(*automaton, index));
+	}
+}
+
+/* END OF FSMEXPLORER. */
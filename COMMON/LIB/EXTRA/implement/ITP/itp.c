@@ -0,0 +1,678 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* ISO-TP Transport Layer Implementation									 */
+/**
+ *	@file		ITP/itp.c
+ *	@brief		This file contains ITP API functions implementation.
+ *	@details	Transmission reads the payload in place (no copy), while
+ *				reception reassembles into a single buffer which stays locked
+ *				until readITP. A flow control frame owed to the peer takes
+ *				precedence over the next frame of our own transmission, since
+ *				both go through ITP_TX_BUFFER. With ITP_CNX, the CNX reception
+ *				ISR copies each frame into a ring that manageITP empties.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <ITP/itp.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		ITP_PCI_SF, ITP_PCI_FF, ITP_PCI_CF, ITP_PCI_FC
+ *	@brief 		Protocol control information (frame type, high nibble).
+ */
+#define ITP_PCI_SF				(0x00U)
+#define ITP_PCI_FF				(0x10U)
+#define ITP_PCI_CF				(0x20U)
+#define ITP_PCI_FC				(0x30U)
+
+/**
+ * 	@def		ITP_FC_CTS, ITP_FC_WAIT, ITP_FC_OVFLW
+ *	@brief 		Flow control status (continue to send, wait, overflow).
+ */
+#define ITP_FC_CTS				(0x00U)
+#define ITP_FC_WAIT				(0x01U)
+#define ITP_FC_OVFLW			(0x02U)
+
+/**
+ * 	@def		ITP_TX_NONE, ITP_TX_FIRST, ITP_TX_WAIT_FC, ITP_TX_CONSECUTIVE
+ *	@brief 		Transmission states.
+ */
+#define ITP_TX_NONE				(0U)
+#define ITP_TX_FIRST			(1U)
+#define ITP_TX_WAIT_FC			(2U)
+#define ITP_TX_CONSECUTIVE		(3U)
+
+/**
+ * 	@def		ITP_SF_SIZE, ITP_FF_SIZE, ITP_CF_SIZE
+ *	@brief 		Payload bytes carried by each frame type.
+ */
+#define ITP_SF_SIZE				(7U)
+#define ITP_FF_SIZE				(6U)
+#define ITP_CF_SIZE				(7U)
+
+/**
+ * 	@def		ITP_MAX_LENGTH
+ *	@brief 		Maximum payload size of a first frame length.
+ */
+#define ITP_MAX_LENGTH			(4095U)
+
+/**
+ * 	@def		ITP_RX_MASK
+ *	@brief 		Frame ring index mask.
+ */
+#define ITP_RX_MASK				(ITP_RX_FRAMES - 1U)
+
+#if ITP_CNX && !CNX_RX_CALLBACK
+#error "ITP_CNX needs CNX_RX_CALLBACK"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for received frame.
+ */
+typedef struct {
+	T_uint8 dlc;
+	T_uint8 data[CAN_MB_BYTE_SIZE];
+} T_itpFrame;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		itpBlockSize, itpStMin
+ *	@brief		Flow control parameters requested to the peer.
+ */
+static T_uint8 itpBlockSize, itpStMin;
+
+/**
+ *	@var		itpTxData
+ *	@brief		Payload being transmitted.
+ */
+static const T_uint8* itpTxData;
+
+/**
+ *	@var		itpTxLength, itpTxOffset
+ *	@brief		Payload size and offset of next byte to transmit.
+ */
+static T_uint16 itpTxLength, itpTxOffset;
+
+/**
+ *	@var		itpTxState, itpTxStatus
+ *	@brief		Transmission state and status.
+ */
+static T_uint8 itpTxState;
+static T_itpStatus itpTxStatus;
+
+/**
+ *	@var		itpTxSequence
+ *	@brief		Sequence number of next consecutive frame.
+ */
+static T_uint8 itpTxSequence;
+
+/**
+ *	@var		itpTxBlockSize, itpTxBlockCount
+ *	@brief		Block size granted by the peer and frames left in block.
+ */
+static T_uint8 itpTxBlockSize, itpTxBlockCount;
+
+/**
+ *	@var		itpTxStMin
+ *	@brief		Separation time granted by the peer (milliseconds).
+ */
+static T_uint8 itpTxStMin;
+
+/**
+ *	@var		itpTxWaits
+ *	@brief		Consecutive flow control wait frames received.
+ */
+static T_uint8 itpTxWaits;
+
+/**
+ *	@var		itpTxStamp
+ *	@brief		Time of last frame transmitted or flow control received.
+ */
+static T_uint32 itpTxStamp;
+
+/**
+ *	@var		itpRxBuffer
+ *	@brief		Payload being received.
+ */
+static T_uint8 itpRxBuffer[ITP_MAX_SIZE];
+
+/**
+ *	@var		itpRxLength, itpRxOffset
+ *	@brief		Payload size and offset of next byte to receive.
+ */
+static T_uint16 itpRxLength, itpRxOffset;
+
+/**
+ *	@var		itpRxStatus
+ *	@brief		Reception status.
+ */
+static volatile T_itpStatus itpRxStatus;
+
+/**
+ *	@var		itpRxSequence
+ *	@brief		Expected sequence number of next consecutive frame.
+ */
+static T_uint8 itpRxSequence;
+
+/**
+ *	@var		itpRxBlockCount
+ *	@brief		Frames left before next flow control.
+ */
+static T_uint8 itpRxBlockCount;
+
+/**
+ *	@var		itpRxStamp
+ *	@brief		Time of last frame received.
+ */
+static T_uint32 itpRxStamp;
+
+/**
+ *	@var		itpFCPending, itpFCStatus
+ *	@brief		Flow control frame owed to the peer and its status.
+ */
+static T_bit itpFCPending;
+static T_uint8 itpFCStatus;
+
+#if ITP_CNX
+/**
+ *	@var		itpRxRing, itpRxHead, itpRxTail
+ *	@brief		Frames received by the ISR (tail) and not yet processed (head).
+ */
+static T_itpFrame itpRxRing[ITP_RX_FRAMES];
+static volatile T_uint8 itpRxHead, itpRxTail;
+
+/**
+ *	@var		itpRxLost
+ *	@brief		Frame dropped on full ring.
+ */
+static volatile T_bit itpRxLost;
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void sendITPCANFrame(const T_uint8*)
+ *	@brief 		Loads a frame to the DTR then requests its transmission.
+ *	@param[in]	pFrame	Frame data (8 bytes).
+ *	@return		.
+ */
+static T_void sendITPCANFrame(const T_uint8* pFrame)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_WORD_SIZE); index++) {
+		SetCAN_DTR_WORD(ITP_TX_BUFFER, index,
+			(T_word)pFrame[index * 2U] | ((T_word)pFrame[(index * 2U) + 1U] << 8U));
+	}
+	RequestCANTransmit(ITP_TX_BUFFER);
+}
+
+/**
+ *	@fn			T_uint8 toITPStMin(T_uint8)
+ *	@brief 		Converts raw separation time to milliseconds (rounded up).
+ *	@param[in]	stMin	Raw separation time.
+ *	@return		separation time in milliseconds.
+ */
+static T_uint8 toITPStMin(T_uint8 stMin)
+{
+	if (LEQ(stMin, 0x7FU)) {
+		return stMin;
+	}
+	/* 100 to 900 us */
+	if (GEQ(stMin, 0xF1U) && LEQ(stMin, 0xF9U)) {
+		return 1U;
+	}
+
+	/* reserved values stand for the longest time */
+	return 0x7FU;
+}
+
+/**
+ *	@fn			T_void stopITPTx(T_itpStatus)
+ *	@brief 		Ends the transmission.
+ *	@param[in]	status	Transmission status.
+ *	@return		.
+ */
+static T_void stopITPTx(T_itpStatus status)
+{
+	itpTxState = ITP_TX_NONE;
+	itpTxStatus = status;
+}
+
+/**
+ *	@fn			T_void transmitITPNext(T_void)
+ *	@brief 		Transmits the owed flow control or the next payload frame.
+ *	@param		.
+ *	@return		.
+ */
+static T_void transmitITPNext(T_void)
+{
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 count = 0U;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_BYTE_SIZE); index++) {
+		frame[index] = ITP_PADDING;
+	}
+	if (IS(itpFCPending)) {
+		frame[0] = ITP_PCI_FC | itpFCStatus;
+		frame[1] = itpBlockSize;
+		frame[2] = itpStMin;
+		itpFCPending = FALSE;
+		sendITPCANFrame(frame);
+		return;
+	}
+	if (EQU(itpTxState, ITP_TX_FIRST)) {
+		if (LEQ(itpTxLength, ITP_SF_SIZE)) {
+			frame[0] = (T_uint8)(ITP_PCI_SF | itpTxLength);
+			count = (T_uint8)itpTxLength;
+			index = 1U;
+		} else {
+			frame[0] = (T_uint8)(ITP_PCI_FF | (itpTxLength >> 8U));
+			frame[1] = (T_uint8)itpTxLength;
+			count = ITP_FF_SIZE;
+			index = 2U;
+		}
+	} else if (EQU(itpTxState, ITP_TX_CONSECUTIVE)) {
+		if (LT(ITP_MILLIS() - itpTxStamp, itpTxStMin)) {
+			return;
+		}
+		frame[0] = ITP_PCI_CF | itpTxSequence;
+		itpTxSequence = (itpTxSequence + 1U) & 0x0FU;
+		count = (T_uint8)MIN(itpTxLength - itpTxOffset, ITP_CF_SIZE);
+		index = 1U;
+	} else {
+		return;
+	}
+	while (NEQ(count, 0U)) {
+		frame[index++] = itpTxData[itpTxOffset++];
+		count--;
+	}
+	sendITPCANFrame(frame);
+	itpTxStamp = ITP_MILLIS();
+	/* select next state */
+	if (GEQ(itpTxOffset, itpTxLength)) {
+		stopITPTx(ITP_DONE);
+	} else if (EQU(itpTxState, ITP_TX_FIRST)) {
+		itpTxState = ITP_TX_WAIT_FC;
+		itpTxWaits = 0U;
+	} else if (NEQ(itpTxBlockSize, 0U) && EQU(--itpTxBlockCount, 0U)) {
+		itpTxState = ITP_TX_WAIT_FC;
+	}
+}
+
+/**
+ *	@fn			T_void receiveITPFlowControl(const T_uint8*)
+ *	@brief 		Processes a flow control frame.
+ *	@param[in]	pData	Frame data.
+ *	@return		.
+ */
+static T_void receiveITPFlowControl(const T_uint8* pData)
+{
+	if (NEQ(itpTxState, ITP_TX_WAIT_FC)) {
+		return;
+	}
+	switch (pData[0] & 0x0FU) {
+	case ITP_FC_CTS:
+		itpTxBlockSize = pData[1];
+		itpTxBlockCount = pData[1];
+		itpTxStMin = toITPStMin(pData[2]);
+		itpTxWaits = 0U;
+		/* first consecutive frame goes without delay */
+		itpTxStamp = ITP_MILLIS() - itpTxStMin;
+		itpTxState = ITP_TX_CONSECUTIVE;
+		break;
+	case ITP_FC_WAIT:
+		itpTxStamp = ITP_MILLIS();
+		if (GT(++itpTxWaits, ITP_MAX_WAIT)) {
+			stopITPTx(ITP_TIMEOUT);
+		}
+		break;
+	default:
+		stopITPTx(ITP_OVERFLOW);
+		break;
+	}
+}
+
+/**
+ *	@fn			T_void receiveITPFirst(const T_uint8*, T_uint8)
+ *	@brief 		Processes a single or first frame.
+ *	@param[in]	pData	Frame data.
+ *	@param[in]	dlc		Frame data length.
+ *	@return		.
+ */
+static T_void receiveITPFirst(const T_uint8* pData, T_uint8 dlc)
+{
+	T_uint16 length;
+	T_uint8 index;
+
+	/* previous payload not read yet */
+	if (EQU(itpRxStatus, ITP_DONE)) {
+		if (EQU(pData[0] & 0xF0U, ITP_PCI_FF)) {
+			itpFCStatus = ITP_FC_OVFLW;
+			itpFCPending = TRUE;
+		}
+		return;
+	}
+	if (EQU(pData[0] & 0xF0U, ITP_PCI_SF)) {
+		length = pData[0] & 0x0FU;
+		if (EQU(length, 0U) || GEQ(length, dlc) || GT(length, ITP_MAX_SIZE)) {
+			return;
+		}
+		index = 1U;
+	} else {
+		length = ((T_uint16)(pData[0] & 0x0FU) << 8U) | pData[1];
+		if (LEQ(length, ITP_SF_SIZE) || LT(dlc, CAN_MB_BYTE_SIZE)) {
+			return;
+		}
+		if (GT(length, ITP_MAX_SIZE)) {
+			itpRxStatus = ITP_OVERFLOW;
+			itpFCStatus = ITP_FC_OVFLW;
+			itpFCPending = TRUE;
+			return;
+		}
+		index = 2U;
+	}
+	/* a new payload restarts any reception in progress */
+	itpRxLength = length;
+	itpRxOffset = 0U;
+	while (LT(index, CAN_MB_BYTE_SIZE) && LT(itpRxOffset, length)) {
+		itpRxBuffer[itpRxOffset++] = pData[index++];
+	}
+	if (GEQ(itpRxOffset, length)) {
+		itpRxStatus = ITP_DONE;
+	} else {
+		itpRxStatus = ITP_BUSY;
+		itpRxSequence = 1U;
+		itpRxBlockCount = itpBlockSize;
+		itpRxStamp = ITP_MILLIS();
+		itpFCStatus = ITP_FC_CTS;
+		itpFCPending = TRUE;
+	}
+}
+
+/**
+ *	@fn			T_void receiveITPConsecutive(const T_uint8*, T_uint8)
+ *	@brief 		Processes a consecutive frame.
+ *	@param[in]	pData	Frame data.
+ *	@param[in]	dlc		Frame data length.
+ *	@return		.
+ */
+static T_void receiveITPConsecutive(const T_uint8* pData, T_uint8 dlc)
+{
+	T_uint8 index = 1U;
+
+	if (NEQ(itpRxStatus, ITP_BUSY)) {
+		return;
+	}
+	if (NEQ(pData[0] & 0x0FU, itpRxSequence)) {
+		itpRxStatus = ITP_SEQUENCE;
+		return;
+	}
+	itpRxSequence = (itpRxSequence + 1U) & 0x0FU;
+	itpRxStamp = ITP_MILLIS();
+	while (LT(index, dlc) && LT(itpRxOffset, itpRxLength)) {
+		itpRxBuffer[itpRxOffset++] = pData[index++];
+	}
+	if (GEQ(itpRxOffset, itpRxLength)) {
+		itpRxStatus = ITP_DONE;
+	} else if (NEQ(itpBlockSize, 0U) && EQU(--itpRxBlockCount, 0U)) {
+		itpRxBlockCount = itpBlockSize;
+		itpFCStatus = ITP_FC_CTS;
+		itpFCPending = TRUE;
+	}
+}
+
+#if ITP_CNX
+/**
+ *	@fn			T_void receiveITPCANFrame(T_uint8, T_dword, T_uint8,
+ *					volatile T_canid_dtr const *)
+ *	@brief 		CNX reception callback copying a frame into the ring.
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	id		Register-mapped ID.
+ *	@param[in]	dlc		Data length code.
+ *	@param[in]	data	Data registers of the message buffer.
+ *	@return		.
+ */
+static T_void receiveITPCANFrame(T_uint8 buffer, T_dword id, T_uint8 dlc,
+	volatile T_canid_dtr const * data)
+{
+	T_itpFrame* frame;
+	T_uint8 index;
+
+	(T_void)buffer;
+	(T_void)id;
+	if (GEQ((T_uint8)(itpRxTail - itpRxHead), ITP_RX_FRAMES)) {
+		itpRxLost = TRUE;
+		return;
+	}
+	frame = &itpRxRing[itpRxTail & ITP_RX_MASK];
+	frame->dlc = (T_uint8)MIN(dlc, CAN_MB_BYTE_SIZE);
+	for (index = 0U; LT(index, frame->dlc); index++) {
+		frame->data[index] = data->BYTE[index];
+	}
+	itpRxTail++;
+}
+#endif
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initITP(T_byte, T_byte, T_uint8, T_uint8)
+ *	@brief 		Initialize ISO-TP and its message buffers.
+ *	@param[in]	txPrefix	Prefix of frames transmitted by this node.
+ *	@param[in]	rxPrefix	Prefix of frames transmitted by the peer.
+ *	@param[in]	blockSize	Block size requested to the peer.
+ *	@param[in]	stMin		Separation time requested to the peer.
+ *	@return		.
+ */
+T_void initITP(T_byte txPrefix, T_byte rxPrefix, T_uint8 blockSize, T_uint8 stMin)
+{
+#if ITP_CNX
+	itpRxHead = 0U;
+	itpRxTail = 0U;
+	itpRxLost = FALSE;
+#else
+	/* polled reception: consecutive frames no closer than two polls */
+	if (LT(toITPStMin(stMin), ITP_POLL_MS + 1U)) {
+		stMin = ITP_POLL_MS + 1U;
+	}
+#endif
+	itpBlockSize = blockSize;
+	itpStMin = stMin;
+	itpTxState = ITP_TX_NONE;
+	itpTxStatus = ITP_IDLE;
+	itpRxStatus = ITP_IDLE;
+	itpFCPending = FALSE;
+	/* transmit buffer: ID of the peer reception buffer */
+	setupCANMessageBuffer(ITP_TX_BUFFER, CAN_ID_EXT_FORMAT, txPrefix, ITP_SUFFIX,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	DisableCANMsgBuff(ITP_TX_BUFFER);
+	SetCAN_IDR(ITP_TX_BUFFER, toIDRegMap(formattedCANID(ITP_RX_BUFFER, txPrefix,
+		ITP_SUFFIX)));
+	/* receive buffer: peer prefix only */
+#if ITP_CNX
+	setupCANMessageBuffer(ITP_RX_BUFFER, CAN_ID_EXT_FORMAT, rxPrefix, ITP_SUFFIX,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_ENABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	setCNXRxCallback(ITP_RX_BUFFER, receiveITPCANFrame);
+#else
+	setupCANMessageBuffer(ITP_RX_BUFFER, CAN_ID_EXT_FORMAT, rxPrefix, ITP_SUFFIX,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+#endif
+	EnableCANMsgBuff(ITP_TX_BUFFER);
+	EnableCANMsgBuff(ITP_RX_BUFFER);
+}
+
+/**
+ *	@fn			T_bit sendITP(const T_uint8*, T_uint16)
+ *	@brief 		Starts the transmission of a payload.
+ *	@param[in]	pData	Payload.
+ *	@param[in]	len		Payload size in bytes.
+ *	@return		start status.
+ */
+T_bit sendITP(const T_uint8* pData, T_uint16 len)
+{
+	if (NEQ(itpTxState, ITP_TX_NONE) || EQU(len, 0U) || GT(len, ITP_MAX_LENGTH)) {
+		return FALSE;
+	}
+	itpTxData = pData;
+	itpTxLength = len;
+	itpTxOffset = 0U;
+	itpTxSequence = 1U;
+	itpTxStatus = ITP_BUSY;
+	itpTxState = ITP_TX_FIRST;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_uint16 readITP(T_uint8*, T_uint16)
+ *	@brief 		Reads the received payload and releases the reception buffer.
+ *	@param[out]	pDest	Payload destination.
+ *	@param[in]	size	Destination size in bytes.
+ *	@return		payload size.
+ */
+T_uint16 readITP(T_uint8* pDest, T_uint16 size)
+{
+	T_uint16 length = itpRxLength;
+	T_uint16 index;
+
+	if (NEQ(itpRxStatus, ITP_DONE)) {
+		return 0U;
+	}
+	size = MIN(size, length);
+	for (index = 0U; LT(index, size); index++) {
+		pDest[index] = itpRxBuffer[index];
+	}
+	/* release last so that reception never overwrites a payload being read */
+	itpRxStatus = ITP_IDLE;
+
+	return length;
+}
+
+/**
+ *	@fn			T_void receiveITPFrame(const T_uint8*, T_uint8)
+ *	@brief 		Processes a received frame.
+ *	@param[in]	pData	Frame data.
+ *	@param[in]	dlc		Frame data length.
+ *	@return		.
+ */
+T_void receiveITPFrame(const T_uint8* pData, T_uint8 dlc)
+{
+	if (EQU(dlc, 0U)) {
+		return;
+	}
+	dlc = MIN(dlc, CAN_MB_BYTE_SIZE);
+	switch (pData[0] & 0xF0U) {
+	case ITP_PCI_SF:
+	case ITP_PCI_FF:
+		receiveITPFirst(pData, dlc);
+		break;
+	case ITP_PCI_CF:
+		receiveITPConsecutive(pData, dlc);
+		break;
+	case ITP_PCI_FC:
+		if (GEQ(dlc, 3U)) {
+			receiveITPFlowControl(pData);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ *	@fn			T_void manageITP(T_void)
+ *	@brief 		Processes received frame, transmits next frame and checks
+ *				timeouts.
+ *	@param		.
+ *	@return		.
+ */
+T_void manageITP(T_void)
+{
+#if ITP_CNX
+	while (NEQ(itpRxHead, itpRxTail)) {
+		receiveITPFrame(itpRxRing[itpRxHead & ITP_RX_MASK].data,
+			itpRxRing[itpRxHead & ITP_RX_MASK].dlc);
+		itpRxHead++;
+	}
+	/* frame dropped on full ring */
+	if (IS(itpRxLost)) {
+		itpRxLost = FALSE;
+		if (EQU(itpRxStatus, ITP_BUSY)) {
+			itpRxStatus = ITP_SEQUENCE;
+		}
+	}
+#else
+	T_uint8 frame[CAN_MB_BYTE_SIZE];
+	T_uint8 dlc;
+	T_uint8 index;
+
+	if (IS(IsCANReceiveComp(ITP_RX_BUFFER))) {
+		dlc = (T_uint8)MIN(GetCAN_DLCR(ITP_RX_BUFFER) & 0x0FU, CAN_MB_BYTE_SIZE);
+		for (index = 0U; LT(index, dlc); index++) {
+			frame[index] = GetCAN_DTR_BYTE(ITP_RX_BUFFER, index);
+		}
+		/* release message buffer (single bit, others written as no effect) */
+		SetCAN_RCR((T_byte)~ToBit(ITP_RX_BUFFER));
+		/* previous frame overwritten */
+		if (IS(IsCANReceiveOvr(ITP_RX_BUFFER))) {
+			SetCAN_ROVRR((T_byte)~ToBit(ITP_RX_BUFFER));
+			if (EQU(itpRxStatus, ITP_BUSY)) {
+				itpRxStatus = ITP_SEQUENCE;
+			}
+		}
+		receiveITPFrame(frame, dlc);
+	}
+#endif
+	if (EQU(ReadBit(GetCAN_TREQR(), ITP_TX_BUFFER), 0U)) {
+		transmitITPNext();
+	}
+	/* N_Bs and N_Cr timeouts */
+	if (EQU(itpTxState, ITP_TX_WAIT_FC) && GT(ITP_MILLIS() - itpTxStamp, ITP_TIMEOUT_MS)) {
+		stopITPTx(ITP_TIMEOUT);
+	}
+	if (EQU(itpRxStatus, ITP_BUSY) && GT(ITP_MILLIS() - itpRxStamp, ITP_TIMEOUT_MS)) {
+		itpRxStatus = ITP_TIMEOUT;
+	}
+}
+
+/**
+ *	@fn			T_itpStatus getITPTxStatus(T_void)
+ *	@brief 		Gets status of the last transmission.
+ *	@param		.
+ *	@return		transmission status.
+ */
+T_itpStatus getITPTxStatus(T_void)
+{
+	return itpTxStatus;
+}
+
+/**
+ *	@fn			T_itpStatus getITPRxStatus(T_void)
+ *	@brief 		Gets status of the last reception.
+ *	@param		.
+ *	@return		reception status.
+ */
+T_itpStatus getITPRxStatus(T_void)
+{
+	return itpRxStatus;
+}
+
+/* END OF ITP. */
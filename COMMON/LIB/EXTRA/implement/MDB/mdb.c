@@ -0,0 +1,202 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* RS-485 Multi-Drop Bus Implementation										 */
+/**
+ *	@file		MDB/mdb.c
+ *	@brief		This file contains MDB API functions and ISR implementation.
+ *	@details	The data register is always read first to release the receiver
+ *				(erroneous frames included), then an unselected node leaves the
+ *				ISR after a single compare, which keeps the cost of foreign
+ *				traffic to a few instructions per frame. Data frames of the
+ *				selected node are enqueued in the SER reception buffer through
+ *				the same writer as SERRX_IRQHandler. HOST/MDB/mdb_bus.c replays
+ *				a 16-node bus through this ISR and reports the frames rejected
+ *				and enqueued per node.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <MDB/mdb.h>
+
+/* ----------------------------------------------------------------------------
+**	External Functions.
+*/
+
+/**
+ *	@fn			T_void writeSERReceivedData(T_uint8)
+ *	@brief 		Enqueues data in SER reception buffer (SER library function
+ *				used by SERRX_IRQHandler, not declared in COM/ser.h).
+ *	@param[in]	data	Received data.
+ *	@return		.
+ */
+extern T_void writeSERReceivedData(T_uint8 data);
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		mdbAddress
+ *	@brief		Node address.
+ */
+static T_uint8 mdbAddress;
+
+/**
+ *	@var		mdbState
+ *	@brief		Node selection state.
+ */
+static T_mdbState mdbState;
+
+/**
+ *	@var		mdbDiscarded
+ *	@brief		Data frames discarded while unselected.
+ */
+static T_uint16 mdbDiscarded;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void writeMDBFrame(T_uint8)
+ *	@brief 		Waits for transmit data register to be empty, then writes
+ *				a frame.
+ *	@param[in]	data	Data to transmit.
+ *	@return		.
+ */
+static T_void writeMDBFrame(T_uint8 data)
+{
+	while (NOT(IsSERTransmitDataRegEmpty())) {
+		/* wait for previous frame */
+	}
+	SetSER_SODR(data);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initMDB(T_uint8)
+ *	@brief 		Initialize multi-drop bus node.
+ * 	@param[in]	address		Node address.
+ * 	@return		.
+ */
+T_void initMDB(T_uint8 address)
+{
+	DisableSERReceiveInterrupt();
+	mdbAddress = address;
+	mdbState = MDB_UNSELECTED;
+	mdbDiscarded = 0U;
+	SetSERAsDataFrame();
+	EnableSERReceiveInterrupt();
+}
+
+/**
+ * 	@fn 		T_void selectMDBNode(T_uint8)
+ *	@brief 		Transmits an address frame.
+ * 	@param[in]	address		Node address.
+ * 	@return		.
+ */
+T_void selectMDBNode(T_uint8 address)
+{
+	/* let previous data frame go before changing A/D bit */
+	while (NOT(IsSERTransmitDataRegEmpty())) {
+		/* wait for previous frame */
+	}
+	SetSERAsAddressFrame();
+	writeMDBFrame(address);
+	/* wait for address frame to leave data register */
+	while (NOT(IsSERTransmitDataRegEmpty())) {
+		/* wait for address frame */
+	}
+	SetSERAsDataFrame();
+}
+
+/**
+ * 	@fn 		T_uint8 writeMDBBytes(const T_uint8*, T_uint8)
+ *	@brief 		Transmits data frames.
+ * 	@param[in]	pBuff	Pointer to array to retrieve data.
+ * 	@param[in]	len		Desired bytes to write or size of array.
+ * 	@return		number of bytes written.
+ */
+T_uint8 writeMDBBytes(const T_uint8* pBuff, T_uint8 len)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, len); index++) {
+		writeMDBFrame(pBuff[index]);
+	}
+
+	return len;
+}
+
+/**
+ * 	@fn 		T_mdbState getMDBState(T_void)
+ *	@brief 		Gets node selection state.
+ * 	@param		.
+ * 	@return		selection state.
+ */
+T_mdbState getMDBState(T_void)
+{
+	return mdbState;
+}
+
+/**
+ * 	@fn 		T_void releaseMDB(T_void)
+ *	@brief 		Deselects this node.
+ * 	@param		.
+ * 	@return		.
+ */
+T_void releaseMDB(T_void)
+{
+	mdbState = MDB_UNSELECTED;
+}
+
+/**
+ * 	@fn 		T_uint16 countMDBDiscarded(T_void)
+ *	@brief 		Counts data frames discarded while unselected.
+ * 	@param		.
+ * 	@return		discarded frames.
+ */
+T_uint16 countMDBDiscarded(T_void)
+{
+	return mdbDiscarded;
+}
+
+/**
+ * 	@fn 		T_void MDB_IRQHandler(T_void)
+ *	@brief		Filters received frames by node selection and enqueues data
+ *				frames of the selected node in SER reception buffer.
+ *  @param		.
+ *  @return		.
+ */
+#if USE_MDB_ISR
+ISR(MDB_IRQHandler)
+{
+	/* release receiver first (also on erroneous frame) */
+	T_uint8 data = GetSER_SIDR();
+
+	/* discard erroneous frame */
+	if (IsSERFramingError() || IsSEROverrunError() || IsSERParityError()) {
+		ClearSERReceiveErrorFlag();
+		return;
+	}
+	if (IsMDBAddressFrame()) {
+		/* (de)select on every address frame */
+		if (EQU(data, mdbAddress)) {
+			mdbState = MDB_SELECTED;
+		} else if (EQU(data, MDB_BROADCAST_ADDRESS)) {
+			mdbState = MDB_BROADCAST;
+		} else {
+			mdbState = MDB_UNSELECTED;
+		}
+	} else if (EQU(mdbState, MDB_UNSELECTED)) {
+		/* early reject of foreign traffic */
+		mdbDiscarded++;
+	} else {
+		/* hand over to SER receiving functions */
+		writeSERReceivedData(data);
+	}
+}
+#endif
+
+/* END OF MDB. */
@@ -0,0 +1,488 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing CAN Transport Implementation							 */
+/**
+ *	@file		NDS/nds_can.c
+ *	@brief		This file contains NDS CAN API functions implementation.
+ *	@details	Both directions go through a staging buffer: an outgoing region
+ *				is copied when its first segment is sent, and an incoming region
+ *				is copied when its last segment is received. The DTR is written
+ *				by words (little-endian byte pairs) as required by the CAN
+ *				controller, and the IDR only while the message buffer is
+ *				disabled. With NDS_CAN_CNX, the CNX reception ISR copies each
+ *				segment into a ring that manageNDSCanIncoming empties.
+ *				HOST/NDS/nds_can_loop.c checks both reception paths on the
+ *				virtual CAN bus.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NDS/ndsCan.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NDS_CAN_NONE
+ *	@brief 		No region index (no transfer in progress).
+ */
+#define NDS_CAN_NONE			(0xFFU)
+
+/**
+ * 	@def		NDS_CAN_RX_MASK
+ *	@brief 		Segment ring index mask.
+ */
+#define NDS_CAN_RX_MASK			(NDS_CAN_RX_SEGMENTS - 1U)
+
+#if NDS_CAN_CNX && !CNX_RX_CALLBACK
+#error "NDS_CAN_CNX needs CNX_RX_CALLBACK"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for received segment.
+ */
+typedef struct {
+	T_word suffix;
+	T_uint8 length;
+	T_uint8 data[CAN_MB_BYTE_SIZE];
+} T_ndsCanSegment;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsCanRegions
+ *	@brief		Registered regions.
+ */
+static T_ndsCanRegion ndsCanRegions[NDS_CAN_MAX_REGIONS];
+
+/**
+ *	@var		ndsCanRegionCount
+ *	@brief		Registered region count.
+ */
+static T_uint8 ndsCanRegionCount;
+
+/**
+ *	@var		ndsCanTxPrefix
+ *	@brief		Prefix of transmitted segments.
+ */
+static T_byte ndsCanTxPrefix;
+
+/**
+ *	@var		ndsCanTxStage
+ *	@brief		Outgoing region being transmitted (padded for odd sizes).
+ */
+static T_uint8 ndsCanTxStage[NDS_CAN_MAX_SIZE + 1U];
+
+/**
+ *	@var		ndsCanTxRegion
+ *	@brief		Index of region being transmitted.
+ */
+static T_uint8 ndsCanTxRegion;
+
+/**
+ *	@var		ndsCanTxOffset
+ *	@brief		Offset of next segment to transmit.
+ */
+static T_uint8 ndsCanTxOffset;
+
+/**
+ *	@var		ndsCanTxNext
+ *	@brief		Next region index to serve.
+ */
+static T_uint8 ndsCanTxNext;
+
+/**
+ *	@var		ndsCanRxStage
+ *	@brief		Incoming region being reassembled.
+ */
+static T_uint8 ndsCanRxStage[NDS_CAN_MAX_SIZE];
+
+/**
+ *	@var		ndsCanRxRegion
+ *	@brief		Index of region being reassembled.
+ */
+static T_uint8 ndsCanRxRegion;
+
+/**
+ *	@var		ndsCanRxOffset
+ *	@brief		Offset of next segment expected.
+ */
+static T_uint8 ndsCanRxOffset;
+
+/**
+ *	@var		ndsCanErrors
+ *	@brief		Dropped segments.
+ */
+static T_uint16 ndsCanErrors;
+
+#if NDS_CAN_CNX
+/**
+ *	@var		ndsCanRxRing, ndsCanRxHead, ndsCanRxTail
+ *	@brief		Segments received by the ISR (tail) and not yet stored (head).
+ */
+static T_ndsCanSegment ndsCanRxRing[NDS_CAN_RX_SEGMENTS];
+static volatile T_uint8 ndsCanRxHead, ndsCanRxTail;
+
+/**
+ *	@var		ndsCanRxOverflows
+ *	@brief		Segments dropped on full ring (counted by the ISR).
+ */
+static volatile T_uint16 ndsCanRxOverflows;
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint8 findNDSCanRegion(T_uint8, T_ndsDirection)
+ *	@brief 		Searches a region by ID and direction.
+ *	@param[in]	region		Region ID.
+ *	@param[in]	direction	Region direction.
+ *	@return		region index (NDS_CAN_NONE if not found).
+ */
+static T_uint8 findNDSCanRegion(T_uint8 region, T_ndsDirection direction)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, ndsCanRegionCount); index++) {
+		if (EQU(ndsCanRegions[index].id, region)
+				&& EQU(ndsCanRegions[index].direction, direction)) {
+			return index;
+		}
+	}
+
+	return NDS_CAN_NONE;
+}
+
+/**
+ *	@fn			T_void startNDSCanTransfer(T_void)
+ *	@brief 		Selects the next outgoing region (round-robin) and copies it.
+ *	@param		.
+ *	@return		.
+ */
+static T_void startNDSCanTransfer(T_void)
+{
+	T_ndsCanRegion* region;
+	T_uint8 visited;
+	T_uint8 index;
+
+	for (visited = 0U; LT(visited, ndsCanRegionCount); visited++) {
+		region = &ndsCanRegions[ndsCanTxNext];
+		index = ndsCanTxNext;
+		ndsCanTxNext = (T_uint8)COND(GEQ(ndsCanTxNext + 1U, ndsCanRegionCount), 0U,
+			ndsCanTxNext + 1U);
+		if (EQU(region->direction, NDS_OUT)) {
+			for (ndsCanTxOffset = 0U; LT(ndsCanTxOffset, region->size); ndsCanTxOffset++) {
+				ndsCanTxStage[ndsCanTxOffset] = region->pData[ndsCanTxOffset];
+			}
+			ndsCanTxRegion = index;
+			ndsCanTxOffset = 0U;
+			break;
+		}
+	}
+}
+
+/**
+ *	@fn			T_void dropNDSCanTransfer(T_void)
+ *	@brief 		Drops the region being reassembled.
+ *	@param		.
+ *	@return		.
+ */
+static T_void dropNDSCanTransfer(T_void)
+{
+	ndsCanRxRegion = NDS_CAN_NONE;
+	ndsCanErrors++;
+}
+
+/**
+ *	@fn			T_bit storeNDSCanSegment(const T_ndsCanSegment*)
+ *	@brief 		Stores a segment and updates its region once complete.
+ *	@param[in]	segment		Received segment.
+ *	@return		region update status.
+ */
+static T_bit storeNDSCanSegment(const T_ndsCanSegment* segment)
+{
+	T_ndsCanRegion* region;
+	T_uint8 length;
+	T_uint8 offset = (T_uint8)segment->suffix;
+	T_uint8 index;
+
+	/* first segment starts reassembly */
+	if (EQU(offset, 0U)) {
+		if (NEQ(ndsCanRxRegion, NDS_CAN_NONE)) {
+			dropNDSCanTransfer();
+		}
+		ndsCanRxRegion = findNDSCanRegion((T_uint8)(segment->suffix >> 8U), NDS_IN);
+		ndsCanRxOffset = 0U;
+		if (EQU(ndsCanRxRegion, NDS_CAN_NONE)) {
+			ndsCanErrors++;
+		}
+	} else if (EQU(ndsCanRxRegion, NDS_CAN_NONE)
+			|| NEQ(ndsCanRegions[ndsCanRxRegion].id, (T_uint8)(segment->suffix >> 8U))
+			|| NEQ(offset, ndsCanRxOffset)) {
+		/* segment out of order */
+		if (NEQ(ndsCanRxRegion, NDS_CAN_NONE)) {
+			dropNDSCanTransfer();
+		} else {
+			ndsCanErrors++;
+		}
+	}
+	if (EQU(ndsCanRxRegion, NDS_CAN_NONE)) {
+		return FALSE;
+	}
+	region = &ndsCanRegions[ndsCanRxRegion];
+	length = (T_uint8)MIN(segment->length, region->size - ndsCanRxOffset);
+	for (index = 0U; LT(index, length); index++) {
+		ndsCanRxStage[ndsCanRxOffset + index] = segment->data[index];
+	}
+	ndsCanRxOffset += length;
+	/* copy region once complete */
+	if (LT(ndsCanRxOffset, region->size)) {
+		return FALSE;
+	}
+	for (index = 0U; LT(index, region->size); index++) {
+		region->pData[index] = ndsCanRxStage[index];
+	}
+	region->updates++;
+	ndsCanRxRegion = NDS_CAN_NONE;
+
+	return TRUE;
+}
+
+#if NDS_CAN_CNX
+/**
+ *	@fn			T_void receiveNDSCanSegment(T_uint8, T_dword, T_uint8,
+ *					volatile T_canid_dtr const *)
+ *	@brief 		CNX reception callback copying a segment into the ring.
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	id		Register-mapped ID.
+ *	@param[in]	dlc		Data length code.
+ *	@param[in]	data	Data registers of the message buffer.
+ *	@return		.
+ */
+static T_void receiveNDSCanSegment(T_uint8 buffer, T_dword id, T_uint8 dlc,
+	volatile T_canid_dtr const * data)
+{
+	T_ndsCanSegment* segment;
+	T_uint8 index;
+
+	(T_void)buffer;
+	if (GEQ((T_uint8)(ndsCanRxTail - ndsCanRxHead), NDS_CAN_RX_SEGMENTS)) {
+		ndsCanRxOverflows++;
+		return;
+	}
+	segment = &ndsCanRxRing[ndsCanRxTail & NDS_CAN_RX_MASK];
+	segment->suffix = (T_word)toIDBitOrder(id);
+	segment->length = (T_uint8)MIN(dlc, CAN_MB_BYTE_SIZE);
+	for (index = 0U; LT(index, segment->length); index++) {
+		segment->data[index] = data->BYTE[index];
+	}
+	ndsCanRxTail++;
+}
+#endif
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initNDSCan(T_byte, T_byte)
+ *	@brief 		Initialize NDS CAN transport and its message buffers.
+ *	@param[in]	txPrefix	Prefix of segments transmitted by this node.
+ *	@param[in]	rxPrefix	Prefix of segments transmitted by the peer.
+ *	@return		.
+ */
+T_void initNDSCan(T_byte txPrefix, T_byte rxPrefix)
+{
+	ndsCanRegionCount = 0U;
+	ndsCanTxPrefix = txPrefix;
+	ndsCanTxRegion = NDS_CAN_NONE;
+	ndsCanTxNext = 0U;
+	ndsCanRxRegion = NDS_CAN_NONE;
+	ndsCanErrors = 0U;
+#if NDS_CAN_CNX
+	ndsCanRxHead = 0U;
+	ndsCanRxTail = 0U;
+	ndsCanRxOverflows = 0U;
+#endif
+	/* transmit buffer: ID set per segment */
+	setupCANMessageBuffer(NDS_CAN_TX_BUFFER, CAN_ID_EXT_FORMAT, txPrefix, 0U,
+		CAN_FULL_BIT_CMP, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	/* receive buffer: any suffix of peer prefix */
+	setupCANAcceptanceMask(CAN_USE_AMR1, 0x00U, 0xFFFFU);
+#if NDS_CAN_CNX
+	setupCANMessageBuffer(NDS_CAN_RX_BUFFER, CAN_ID_EXT_FORMAT, rxPrefix, 0U,
+		CAN_USE_AMR1, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_ENABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+	setCNXRxCallback(NDS_CAN_RX_BUFFER, receiveNDSCanSegment);
+#else
+	setupCANMessageBuffer(NDS_CAN_RX_BUFFER, CAN_ID_EXT_FORMAT, rxPrefix, 0U,
+		CAN_USE_AMR1, CAN_DLC_8BYTES, CAN_TX_INT_DISABLED, CAN_RX_INT_DISABLED,
+		CAN_TX_IMMEDIATELY, CAN_TX_DATA_FRAME);
+#endif
+	EnableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	EnableCANMsgBuff(NDS_CAN_RX_BUFFER);
+}
+
+/**
+ *	@fn			T_bit addNDSCanRegion(T_uint8, volatile T_void*, T_uint8, T_ndsDirection)
+ *	@brief 		Registers a shared region.
+ *	@param[in]	region		Region ID.
+ *	@param		pData		Region data.
+ *	@param[in]	size		Region size in bytes.
+ *	@param[in]	direction	Region direction.
+ *	@return		registration status.
+ */
+T_bit addNDSCanRegion(T_uint8 region, volatile T_void* pData, T_uint8 size,
+	T_ndsDirection direction)
+{
+	T_ndsCanRegion* entry;
+
+	if (GEQ(ndsCanRegionCount, NDS_CAN_MAX_REGIONS) || EQU(size, 0U)
+			|| GT(size, NDS_CAN_MAX_SIZE)) {
+		return FALSE;
+	}
+	entry = &ndsCanRegions[ndsCanRegionCount++];
+	entry->pData = (volatile T_uint8*)pData;
+	entry->id = region;
+	entry->size = size;
+	entry->direction = direction;
+	entry->updates = 0U;
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_bit manageNDSCanOutgoing(T_void)
+ *	@brief 		Transmits the next segment of outgoing regions.
+ *	@param		.
+ *	@return		transmission status.
+ */
+T_bit manageNDSCanOutgoing(T_void)
+{
+	T_ndsCanRegion* region;
+	T_uint8 length;
+	T_uint8 index;
+
+	/* check if previous segment is still pending */
+	if (NEQ(ReadBit(GetCAN_TREQR(), NDS_CAN_TX_BUFFER), 0U)) {
+		return FALSE;
+	}
+	if (EQU(ndsCanTxRegion, NDS_CAN_NONE)) {
+		startNDSCanTransfer();
+		if (EQU(ndsCanTxRegion, NDS_CAN_NONE)) {
+			return FALSE;
+		}
+	}
+	region = &ndsCanRegions[ndsCanTxRegion];
+	length = (T_uint8)MIN(region->size - ndsCanTxOffset, CAN_MB_BYTE_SIZE);
+	/* load segment (trailing byte of odd length is don't care) */
+	DisableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	for (index = 0U; LT(index, length); index += 2U) {
+		SetCAN_DTR_WORD(NDS_CAN_TX_BUFFER, index / 2U,
+			(T_word)ndsCanTxStage[ndsCanTxOffset + index]
+			| ((T_word)ndsCanTxStage[ndsCanTxOffset + index + 1U] << 8U));
+	}
+	SetCAN_IDR(NDS_CAN_TX_BUFFER, toIDRegMap(formattedCANID(NDS_CAN_RX_BUFFER,
+		ndsCanTxPrefix, GetWordNDSCanSuffix(region->id, ndsCanTxOffset))));
+	SetCAN_DLCR(NDS_CAN_TX_BUFFER, length);
+	EnableCANMsgBuff(NDS_CAN_TX_BUFFER);
+	RequestCANTransmit(NDS_CAN_TX_BUFFER);
+	/* check for last segment */
+	ndsCanTxOffset += length;
+	if (GEQ(ndsCanTxOffset, region->size)) {
+		region->updates++;
+		ndsCanTxRegion = NDS_CAN_NONE;
+	}
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_bit manageNDSCanIncoming(T_void)
+ *	@brief 		Receives segments and updates their regions once complete.
+ *	@param		.
+ *	@return		region update status.
+ */
+T_bit manageNDSCanIncoming(T_void)
+{
+#if NDS_CAN_CNX
+	T_bit updated = FALSE;
+
+	while (NEQ(ndsCanRxHead, ndsCanRxTail)) {
+		if (IS(storeNDSCanSegment(&ndsCanRxRing[ndsCanRxHead & NDS_CAN_RX_MASK]))) {
+			updated = TRUE;
+		}
+		ndsCanRxHead++;
+	}
+
+	return updated;
+#else
+	T_ndsCanSegment segment;
+	T_uint8 index;
+
+	if (NOT(IsCANReceiveComp(NDS_CAN_RX_BUFFER))) {
+		return FALSE;
+	}
+	/* previous segment overwritten */
+	if (IS(IsCANReceiveOvr(NDS_CAN_RX_BUFFER))) {
+		SetCAN_ROVRR((T_byte)~ToBit(NDS_CAN_RX_BUFFER));
+		if (NEQ(ndsCanRxRegion, NDS_CAN_NONE)) {
+			dropNDSCanTransfer();
+		}
+	}
+	segment.suffix = (T_word)toIDBitOrder(GetCAN_IDR(NDS_CAN_RX_BUFFER));
+	segment.length = (T_uint8)MIN(GetCAN_DLCR(NDS_CAN_RX_BUFFER) & 0x0FU, CAN_MB_BYTE_SIZE);
+	for (index = 0U; LT(index, segment.length); index++) {
+		segment.data[index] = GetCAN_DTR_BYTE(NDS_CAN_RX_BUFFER, index);
+	}
+	/* release message buffer (single bit, others written as no effect) */
+	SetCAN_RCR((T_byte)~ToBit(NDS_CAN_RX_BUFFER));
+
+	return storeNDSCanSegment(&segment);
+#endif
+}
+
+/**
+ *	@fn			T_uint16 countNDSCanUpdates(T_uint8)
+ *	@brief 		Counts complete transfers of a region.
+ *	@param[in]	region		Region ID.
+ *	@return		updates.
+ */
+T_uint16 countNDSCanUpdates(T_uint8 region)
+{
+	T_uint16 updates = 0U;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, ndsCanRegionCount); index++) {
+		if (EQU(ndsCanRegions[index].id, region)) {
+			updates += ndsCanRegions[index].updates;
+		}
+	}
+
+	return updates;
+}
+
+/**
+ *	@fn			T_uint16 countNDSCanErrors(T_void)
+ *	@brief 		Counts segments dropped.
+ *	@param		.
+ *	@return		dropped segments.
+ */
+T_uint16 countNDSCanErrors(T_void)
+{
+#if NDS_CAN_CNX
+	return ndsCanErrors + ndsCanRxOverflows;
+#else
+	return ndsCanErrors;
+#endif
+}
+
+/* END OF NDS_CAN. */
@@ -0,0 +1,194 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Delta Replication Implementation						 */
+/**
+ *	@file		NDS/nds_delta.c
+ *	@brief		This file contains NDS delta API functions implementation.
+ *	@details	Blocks are compared by words since the DTR is written by words
+ *				anyway. A block is loaded into its DTR only while no request is
+ *				pending on its message buffer, so a block changing faster than
+ *				the bus can carry it is sent with its latest content only.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NDS/ndsDelta.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsDeltaShadow
+ *	@brief		Outgoing blocks as last transmitted.
+ */
+static T_uint16 ndsDeltaShadow[CAN_MB_SIZE][CAN_MB_WORD_SIZE];
+
+/**
+ *	@var		ndsDeltaBits
+ *	@brief		Outgoing message buffer bits.
+ */
+static T_byte ndsDeltaBits;
+
+/**
+ *	@var		ndsDeltaDirty
+ *	@brief		Message buffer bits to transmit regardless of content.
+ */
+static T_byte ndsDeltaDirty;
+
+/**
+ *	@var		ndsDeltaCalls
+ *	@brief		Calls since last full refresh.
+ */
+static T_uint16 ndsDeltaCalls;
+
+/**
+ *	@var		ndsDeltaSent
+ *	@brief		Transmitted blocks.
+ */
+static T_uint32 ndsDeltaSent;
+
+/**
+ *	@var		ndsDeltaSkipped
+ *	@brief		Unchanged blocks not transmitted.
+ */
+static T_uint32 ndsDeltaSkipped;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_bit checkNDSBlockChanged(T_uint8)
+ *	@brief 		Compares an outgoing block against its shadow copy.
+ *	@param[in]	block	Message buffer index.
+ *	@return		changed.
+ */
+static T_bit checkNDSBlockChanged(T_uint8 block)
+{
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_WORD_SIZE); index++) {
+		if (NEQ(pTXCANBuffer[block].WORD[index], ndsDeltaShadow[block][index])) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ *	@fn			T_void sendNDSBlock(T_uint8)
+ *	@brief 		Loads an outgoing block to its DTR and shadow copy, then
+ *				requests its transmission.
+ *	@param[in]	block	Message buffer index.
+ *	@return		.
+ */
+static T_void sendNDSBlock(T_uint8 block)
+{
+	T_uint16 data;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, CAN_MB_WORD_SIZE); index++) {
+		data = pTXCANBuffer[block].WORD[index];
+		ndsDeltaShadow[block][index] = data;
+		SetCAN_DTR_WORD(block, index, data);
+	}
+	RequestCANTransmit(block);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initNDSDelta(T_byte)
+ *	@brief 		Initialize delta replication of outgoing shared data.
+ *	@param[in]	txBufferBits	Outgoing message buffer bits.
+ *	@return		.
+ */
+T_void initNDSDelta(T_byte txBufferBits)
+{
+	ndsDeltaBits = txBufferBits;
+	ndsDeltaDirty = txBufferBits;
+	ndsDeltaCalls = 0U;
+	ndsDeltaSent = 0UL;
+	ndsDeltaSkipped = 0UL;
+}
+
+/**
+ *	@fn			T_uint8 manageNDSDelta(T_void)
+ *	@brief 		Transmits outgoing blocks that changed, are marked or are due
+ *				for refresh.
+ *	@param		.
+ *	@return		number of blocks requested for transmission.
+ */
+T_uint8 manageNDSDelta(T_void)
+{
+	T_byte pending = GetCAN_TREQR();
+	T_uint8 count = 0U;
+	T_uint8 block;
+
+	/* check if full refresh is due */
+	if (NEQ(NDS_DELTA_REFRESH, 0U) && GEQ(++ndsDeltaCalls, NDS_DELTA_REFRESH)) {
+		ndsDeltaCalls = 0U;
+		ndsDeltaDirty = ndsDeltaBits;
+	}
+	for (block = 0U; LT(block, CAN_MB_SIZE); block++) {
+		/* skip unused message buffer or pending transmission */
+		if (EQU(ReadBit(ndsDeltaBits, block), 0U) || NEQ(ReadBit(pending, block), 0U)) {
+			continue;
+		}
+		if (NEQ(ReadBit(ndsDeltaDirty, block), 0U) || IS(checkNDSBlockChanged(block))) {
+			ndsDeltaDirty &= (T_byte)~(1U << block);
+			sendNDSBlock(block);
+			count++;
+		} else {
+			ndsDeltaSkipped++;
+		}
+	}
+	ndsDeltaSent += count;
+
+	return count;
+}
+
+/**
+ *	@fn			T_void markNDSDirty(const volatile T_void*, T_uint8)
+ *	@brief 		Forces transmission of the blocks covering outgoing data.
+ *	@param[in]	pData	Address within NDSAllocOutgoing space.
+ *	@param[in]	size	Data size in bytes.
+ *	@return		.
+ */
+T_void markNDSDirty(const volatile T_void* pData, T_uint8 size)
+{
+	T_uint8 first = GetByteNDSBlock(pData);
+	T_uint8 last = GetByteNDSBlock((const volatile T_uint8*)pData + MAX(size, 1U) - 1U);
+
+	while (LEQ(first, last) && LT(first, CAN_MB_SIZE)) {
+		ndsDeltaDirty |= (T_byte)(1U << first);
+		first++;
+	}
+	ndsDeltaDirty &= ndsDeltaBits;
+}
+
+/**
+ *	@fn			T_uint32 countNDSDeltaSent(T_void)
+ *	@brief 		Counts blocks transmitted since initialization.
+ *	@param		.
+ *	@return		transmitted blocks.
+ */
+T_uint32 countNDSDeltaSent(T_void)
+{
+	return ndsDeltaSent;
+}
+
+/**
+ *	@fn			T_uint32 countNDSDeltaSkipped(T_void)
+ *	@brief 		Counts unchanged blocks not transmitted since initialization.
+ *	@param		.
+ *	@return		skipped blocks.
+ */
+T_uint32 countNDSDeltaSkipped(T_void)
+{
+	return ndsDeltaSkipped;
+}
+
+/* END OF NDS_DELTA. */
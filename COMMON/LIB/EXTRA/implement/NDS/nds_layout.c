@@ -0,0 +1,156 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Compile-Time Layout Implementation						 */
+/**
+ *	@file		NDS/nds_layout.c
+ *	@brief		This file contains NDS API function implementation through the
+ *				compile-time layout.
+ *	@details	Each direction takes a single allocation of whole message
+ *				buffers, so region offsets do not depend on allocation order.
+ *				The layout hash is FNV-1a over region names, offsets and sizes
+ *				folded into a word.
+ *	@warning	Build exactly one of NDS/nds_api.c and this source: both
+ *				define NDSSharedData and the link fails with both.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NDS/ndsLayout.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsLayoutData
+ *	@brief		Data space allocated per direction.
+ */
+static volatile T_void* ndsLayoutData[2];
+
+/**
+ *	@var		ndsLayoutHash
+ *	@brief		Layout hash per direction.
+ */
+static T_uint16 ndsLayoutHash[2];
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint32 hashNDSByte(T_uint32, T_uint8)
+ *	@brief 		Appends a byte to FNV-1a hash.
+ *	@param[in]	hash	Hash so far.
+ *	@param[in]	value	Byte to hash.
+ *	@return		hash.
+ */
+static T_uint32 hashNDSByte(T_uint32 hash, T_uint8 value)
+{
+	return (hash ^ value) * 16777619UL;
+}
+
+/**
+ *	@fn			T_uint16 computeNDSLayoutHash(T_ndsDirection)
+ *	@brief 		Computes the layout hash of a direction.
+ *	@param[in]	direction	Layout direction.
+ *	@return		layout hash (never zero).
+ */
+static T_uint16 computeNDSLayoutHash(T_ndsDirection direction)
+{
+	T_uint32 hash = 2166136261UL;
+	const T_char* name;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, ndsRegionCount); index++) {
+		if (NEQ(ndsRegions[index].direction, direction)) {
+			continue;
+		}
+		for (name = ndsRegions[index].name; NEQ(*name, '\0'); name++) {
+			hash = hashNDSByte(hash, (T_uint8)*name);
+		}
+		hash = hashNDSByte(hash, ndsRegions[index].offset);
+		hash = hashNDSByte(hash, ndsRegions[index].size);
+	}
+	hash = (hash >> 16U) ^ (hash & 0xFFFFUL);
+
+	/* keep zero for "not received" */
+	return (T_uint16)COND(EQU(hash, 0UL), 1U, hash);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void NDSSharedData(T_void)
+ *	@brief 		NDS API function of allocating shared data.
+ *	@param		.
+ *	@return		.
+ */
+T_void NDSSharedData(T_void)
+{
+	ndsLayoutData[NDS_IN] = NDSAllocIncoming(GetByteNDSBlocks(ndsIncomingSize) * NDS_BLOCK_SIZE);
+	ndsLayoutData[NDS_OUT] = NDSAllocOutgoing(GetByteNDSBlocks(ndsOutgoingSize) * NDS_BLOCK_SIZE);
+	ndsLayoutHash[NDS_IN] = computeNDSLayoutHash(NDS_IN);
+	ndsLayoutHash[NDS_OUT] = computeNDSLayoutHash(NDS_OUT);
+	/* outgoing layout starts with its hash */
+	*(volatile T_uint16*)ndsLayoutData[NDS_OUT] = ndsLayoutHash[NDS_OUT];
+}
+
+/**
+ *	@fn			T_uint16 getNDSLayoutHash(T_ndsDirection)
+ *	@brief 		Gets the layout hash of a direction.
+ *	@param[in]	direction	Layout direction.
+ *	@return		layout hash.
+ */
+T_uint16 getNDSLayoutHash(T_ndsDirection direction)
+{
+	return ndsLayoutHash[direction];
+}
+
+/**
+ *	@fn			T_uint16 getNDSPeerHash(T_void)
+ *	@brief 		Gets the layout hash received from the peer.
+ *	@param		.
+ *	@return		peer outgoing layout hash.
+ */
+T_uint16 getNDSPeerHash(T_void)
+{
+	return *(const volatile T_uint16*)ndsLayoutData[NDS_IN];
+}
+
+/**
+ *	@fn			volatile T_void* getNDSLayoutData(T_ndsDirection)
+ *	@brief 		Gets the data space allocated to a layout.
+ *	@param[in]	direction	Layout direction.
+ *	@return		memory location.
+ */
+volatile T_void* getNDSLayoutData(T_ndsDirection direction)
+{
+	return ndsLayoutData[direction];
+}
+
+/**
+ *	@fn			T_void reportNDSLayout(T_ndsReport)
+ *	@brief 		Reports the footprint of every region, then of both layouts.
+ *	@param[in]	report		Report function.
+ *	@return		.
+ */
+T_void reportNDSLayout(T_ndsReport report)
+{
+	T_ndsRegion layout;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, ndsRegionCount); index++) {
+		report(&ndsRegions[index]);
+	}
+	layout.offset = 0U;
+	layout.name = "incoming";
+	layout.size = ndsIncomingSize;
+	layout.direction = NDS_IN;
+	report(&layout);
+	layout.name = "outgoing";
+	layout.size = ndsOutgoingSize;
+	layout.direction = NDS_OUT;
+	report(&layout);
+}
+
+/* END OF NDS_LAYOUT. */
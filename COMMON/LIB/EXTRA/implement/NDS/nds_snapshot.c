@@ -0,0 +1,109 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Consistent Snapshots Implementation					 */
+/**
+ *	@file		NDS/nds_snapshot.c
+ *	@brief		This file contains NDS snapshot API functions implementation.
+ *	@details	The counter is volatile so that the compiler neither caches it
+ *				nor moves its accesses across the data copy.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NDS/ndsSnapshot.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		ndsSequence
+ *	@brief		Update sequence counter.
+ */
+static volatile T_uint16 ndsSequence;
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void beginNDSUpdate(T_void)
+ *	@brief 		Marks the start of an incoming data update.
+ *	@param		.
+ *	@return		.
+ */
+T_void beginNDSUpdate(T_void)
+{
+	ndsSequence++;
+}
+
+/**
+ *	@fn			T_void endNDSUpdate(T_void)
+ *	@brief 		Marks the end of an incoming data update.
+ *	@param		.
+ *	@return		.
+ */
+T_void endNDSUpdate(T_void)
+{
+	ndsSequence++;
+}
+
+/**
+ *	@fn			T_void manageNDSSnapshot(T_uint8)
+ *	@brief 		Manages reception of shared data as a single update.
+ *	@param[in]	rxWaitCount		Reception wait count (0 for no waiting).
+ *	@return		.
+ */
+T_void manageNDSSnapshot(T_uint8 rxWaitCount)
+{
+	beginNDSUpdate();
+	manageNDSIncoming(rxWaitCount);
+	endNDSUpdate();
+}
+
+/**
+ *	@fn			T_bit readNDSSnapshot(T_void*, const volatile T_void*, T_uint8)
+ *	@brief 		Copies incoming data consistently.
+ *	@param[out]	pDest	Destination.
+ *	@param[in]	pSrc	Address within NDSAllocIncoming space.
+ *	@param[in]	size	Data size in bytes.
+ *	@return		consistency.
+ */
+T_bit readNDSSnapshot(T_void* pDest, const volatile T_void* pSrc, T_uint8 size)
+{
+	T_uint8* pByte;
+	const volatile T_uint8* pData;
+	T_uint16 sequence;
+	T_uint8 attempt;
+	T_uint8 index;
+
+	for (attempt = 0U; LT(attempt, NDS_SNAPSHOT_RETRIES); attempt++) {
+		sequence = ndsSequence;
+		/* wait for update in progress (retry) */
+		if (NEQ(sequence & 1U, 0U)) {
+			continue;
+		}
+		pByte = (T_uint8*)pDest;
+		pData = (const volatile T_uint8*)pSrc;
+		for (index = 0U; LT(index, size); index++) {
+			pByte[index] = pData[index];
+		}
+		/* check for update during copy */
+		if (EQU(ndsSequence, sequence)) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/**
+ *	@fn			T_uint16 getNDSSequence(T_void)
+ *	@brief 		Gets the update sequence counter.
+ *	@param		.
+ *	@return		sequence counter.
+ */
+T_uint16 getNDSSequence(T_void)
+{
+	return ndsSequence;
+}
+
+/* END OF NDS_SNAPSHOT. */
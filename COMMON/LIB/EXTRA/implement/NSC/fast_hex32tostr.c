@@ -0,0 +1,86 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Fast Hexadecimal Number to String Conversion Implementation				 */
+/**
+ *	@file		NSC/fast_hex32tostr.c
+ *	@brief		This file contains fast base 16 number to string conversion
+ *				API functions implementation.
+ *	@details	Upper case digits are taken from a lookup table per nibble
+ *				starting from the most significant non-zero nibble.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		hexDigitLUT
+ *	@brief		Hexadecimal digit lookup table.
+ */
+static const T_char hexDigitLUT[16] = "0123456789ABCDEF";
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			size_t putStr(T_char*, const T_char*)
+ *	@brief 		Writes a string without its null terminator.
+ *	@param[out]	buffer	Pointer to the destination character array.
+ *	@param[in]	str		Null terminated string (or NULL).
+ *	@return		number of written characters.
+ */
+static size_t putStr(T_char* buffer, const T_char* str)
+{
+	size_t count = 0U;
+
+	if (NEQ(str, NULL)) {
+		while (NEQ(str[count], ASCII_NULL)) {
+			buffer[count] = str[count];
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t fastHex32ToStr(T_char*, const T_char*,
+ *					const T_char*, T_uint32)
+ *	@brief 		Converts a base 16 number into a null terminated string.
+ *	@param[in]	buffer	Pointer to the destination character array.
+ *	@param[in]	prefix	Appended hexadecimal symbol before number.
+ *	@param[in]	postfix	Appended hexadecimal symbol after number.
+ *	@param[in]	number	The number to convert (dword).
+ *	@return		number of printed characters (word).
+ */
+size_t fastHex32ToStr(T_char* buffer, const T_char* prefix,
+	const T_char* postfix, T_uint32 number)
+{
+	size_t count = putStr(buffer, prefix);
+	T_uint8 shift = 28U;
+
+	/* skip leading zero nibbles (keep at least one digit) */
+	while (NEQ(shift, 0U) && EQU((number >> shift) & 0x0FUL, 0UL)) {
+		shift -= 4U;
+	}
+	for (;;) {
+		buffer[count++] = hexDigitLUT[(T_uint8)((number >> shift) & 0x0FUL)];
+		if (EQU(shift, 0U)) {
+			break;
+		}
+		shift -= 4U;
+	}
+	count += putStr(&buffer[count], postfix);
+	buffer[count] = ASCII_NULL;
+
+	return count;
+}
+
+/* END OF FAST_HEX32TOSTR. */
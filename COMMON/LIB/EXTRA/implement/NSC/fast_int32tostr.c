@@ -0,0 +1,112 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Fast Decimal Number to String Conversion Implementation					 */
+/**
+ *	@file		NSC/fast_int32tostr.c
+ *	@brief		This file contains fast base 10 number to string conversion
+ *				API functions implementation.
+ *	@details	Decimal conversion avoids 32-bit division per digit. A 32-bit
+ *				number is split into three groups of four digits by two 32-bit
+ *				divisions, then each group is split into digit pairs through
+ *				multiplication by the 16-bit reciprocal of 100 (5243 / 2^19,
+ *				exact for groups below 43699) and pairs are copied from a
+ *				two-digit lookup table.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		decPairLUT
+ *	@brief		Two-digit lookup table ("00" to "99").
+ */
+static const T_char decPairLUT[200] =
+	"00010203040506070809101112131415161718192021222324"
+	"25262728293031323334353637383940414243444546474849"
+	"50515253545556575859606162636465666768697071727374"
+	"75767778798081828384858687888990919293949596979899";
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void putDecGroup(T_char*, T_uint16)
+ *	@brief 		Writes a group of four decimal digits (zero padded).
+ *	@param[out]	digits	Destination of four characters.
+ *	@param[in]	group	Group value (0 to 9999).
+ *	@return		.
+ */
+static T_void putDecGroup(T_char* digits, T_uint16 group)
+{
+	T_uint16 upper = (T_uint16)(((T_uint32)group * 5243UL) >> 19U);
+	T_uint16 lower = group - (upper * 100U);
+
+	/* copy digit pairs */
+	digits[0] = decPairLUT[upper << 1U];
+	digits[1] = decPairLUT[(upper << 1U) + 1U];
+	digits[2] = decPairLUT[lower << 1U];
+	digits[3] = decPairLUT[(lower << 1U) + 1U];
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t fastDec32ToStr(T_char*, T_uint32, T_uint8)
+ *	@brief 		Converts an unsigned base 10 number into a null terminated
+ *				string with a minimum digit count.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The number to convert (dword).
+ *	@param[in]	minDigits	Minimum digit count (zero padded, up to 12).
+ *	@return		number of printed characters (word).
+ */
+size_t fastDec32ToStr(T_char* buffer, T_uint32 number, T_uint8 minDigits)
+{
+	T_char digits[12];
+	T_uint32 upper = number / 10000UL;
+	T_uint16 top = (T_uint16)(upper / 10000UL);
+	T_uint8 first;
+	T_uint8 index;
+
+	/* split into groups of four digits */
+	putDecGroup(&digits[8], (T_uint16)(number - (upper * 10000UL)));
+	putDecGroup(&digits[4], (T_uint16)(upper - ((T_uint32)top * 10000UL)));
+	putDecGroup(&digits[0], top);
+	/* skip leading zeros (keep at least one digit) */
+	for (first = 0U; LT(first, 11U) && EQU(digits[first], ASCII_ZERO)
+		&& GT(12U - first, minDigits); first++) {
+		/* do nothing */
+	}
+	for (index = first; LT(index, 12U); index++) {
+		*buffer++ = digits[index];
+	}
+	*buffer = ASCII_NULL;
+
+	return (size_t)(12U - first);
+}
+
+/**
+ *	@fn 		size_t fastInt32ToStr(T_char*, T_sint32, T_bit)
+ *	@brief 		Converts a base 10 number into a null terminated string.
+ *	@param[in]	buffer	Pointer to the destination character array.
+ *	@param[in]	number	The number to convert (dword).
+ *	@param[in]	sign	Signed or unsigned option (bit).
+ *	@return		number of printed characters (word).
+ */
+size_t fastInt32ToStr(T_char* buffer, T_sint32 number, T_bit sign)
+{
+	if (IS(sign) && LT(number, 0L)) {
+		buffer[0] = ASCII_MINUS;
+
+		return 1U + fastDec32ToStr(&buffer[1], (T_uint32)(-(number + 1L)) + 1UL, 1U);
+	}
+
+	return fastDec32ToStr(buffer, (T_uint32)number, 1U);
+}
+
+/* END OF FAST_INT32TOSTR. */
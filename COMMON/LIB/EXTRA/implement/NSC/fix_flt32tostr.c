@@ -0,0 +1,136 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Fixed Decimals Float to String Conversion Implementation					 */
+/**
+ *	@file		NSC/fix_flt32tostr.c
+ *	@brief		This file contains fixed decimals single precision floating
+ *				point to string conversion API functions implementation.
+ *	@details	No float operation is performed: the number is split from its
+ *				IEEE 754 bits into the integer part and the fractional bits of
+ *				the mantissa, then the fractional bits are scaled by 5^d and
+ *				shifted by (exponent - d) instead of multiplied by 10^d (10^d /
+ *				2^n is 5^d / 2^(n - d)). The 24-bit fraction is scaled in two
+ *				12-bit halves so that 16-bit by 16-bit products suffice.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		pow5LUT
+ *	@brief		Powers of 5 (up to 6 decimals).
+ */
+static const T_uint16 pow5LUT[7] = {
+	1U, 5U, 25U, 125U, 625U, 3125U, 15625U
+};
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint32 scaleFraction(T_uint32, T_uint8, T_uint8)
+ *	@brief 		Scales fractional bits to decimals, rounded to nearest.
+ *	@param[in]	bits		Fractional bits (below 2^24 and 2^shift).
+ *	@param[in]	shift		Fractional bit count (1 to 149).
+ *	@param[in]	decimals	Digits after decimal point (up to 6).
+ *	@return		scaled fractional part (up to 10^decimals).
+ */
+static T_uint32 scaleFraction(T_uint32 bits, T_uint8 shift, T_uint8 decimals)
+{
+	T_uint32 high = (bits >> 12U) * pow5LUT[decimals];
+	T_uint32 low = (bits & 0x0FFFUL) * pow5LUT[decimals];
+	T_uint8 right;
+
+	/* exact product of few bits */
+	if (LEQ(shift, decimals)) {
+		return (bits * pow5LUT[decimals]) << (decimals - shift);
+	}
+	right = shift - decimals;
+	if (LT(right, 12U)) {
+		/* below 2^32 as bits is below 2^(right + decimals) */
+		return (((high << 12U) + low) + (1UL << (right - 1U))) >> right;
+	}
+	/* (high * 2^12 + low) / 2^right with the 12 low bits of low dropped */
+	high += low >> 12U;
+	if (EQU(right, 12U)) {
+		return high + (((low & 0x0FFFUL) + 0x0800UL) >> 12U);
+	}
+	if (GEQ(right, 40U)) {
+		/* below half of the last decimal */
+		return 0UL;
+	}
+
+	return (high + (1UL << (right - 13U))) >> (right - 12U);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t fixFlt32ToStr(T_char*, T_float32, T_uint8)
+ *	@brief 		Converts a float into a string with fixed number of decimals.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The floating number to convert (float).
+ *	@param[in]	decimals	Digits after decimal point (up to 6).
+ *	@return		number of printed characters (word).
+ */
+size_t fixFlt32ToStr(T_char* buffer, T_float32 number, T_uint8 decimals)
+{
+	union {
+		T_float32 value;
+		T_uint32 bits;
+	} binary;
+	const T_char* special;
+	T_uint32 mantissa;
+	T_sint16 shift;
+	size_t count = 0U;
+
+	/* upper bits cleared where T_uint32 is wider than the float */
+	binary.bits = 0UL;
+	binary.value = number;
+	decimals = MIN(decimals, 6U);
+	mantissa = binary.bits & 0x007FFFFFUL;
+	shift = (T_sint16)((binary.bits >> 23U) & 0xFFUL);
+	/* check for NaN and infinity (exponent bits all set) */
+	if (EQU(shift, 0xFF)) {
+		special = COND(NEQ(mantissa, 0UL), "NaN", COND(binary.bits >> 31U, "-Inf", "+Inf"));
+		while (NEQ(special[count], ASCII_NULL)) {
+			buffer[count] = special[count];
+			count++;
+		}
+		buffer[count] = ASCII_NULL;
+
+		return count;
+	}
+	/* fractional bit count of the 24-bit mantissa (subnormal has no hidden bit) */
+	if (EQU(shift, 0)) {
+		shift = 149;
+	} else {
+		mantissa |= 0x00800000UL;
+		shift = 150 - shift;
+	}
+	if (LEQ(shift, 0)) {
+		/* beyond 32-bit integer part */
+		if (LT(shift, -8)) {
+			return flt32ToStr(buffer, number);
+		}
+
+		return fixedToStr(buffer, (T_bit)(binary.bits >> 31U), mantissa << (T_uint8)(-shift),
+			0UL, decimals);
+	}
+	if (GEQ(shift, 24)) {
+		return fixedToStr(buffer, (T_bit)(binary.bits >> 31U), 0UL,
+			scaleFraction(mantissa, (T_uint8)shift, decimals), decimals);
+	}
+
+	return fixedToStr(buffer, (T_bit)(binary.bits >> 31U), mantissa >> (T_uint8)shift,
+		scaleFraction(mantissa & ((1UL << (T_uint8)shift) - 1UL), (T_uint8)shift, decimals),
+		decimals);
+}
+
+/* END OF FIX_FLT32TOSTR. */
@@ -0,0 +1,63 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Fixed Decimals Number to String Conversion Implementation				 */
+/**
+ *	@file		NSC/fixedtostr.c
+ *	@brief		This file contains the API function writing a number split
+ *				into integer and scaled fractional parts, shared by the
+ *				fixed-point and fixed decimals float converters.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		pow10LUT
+ *	@brief		Powers of 10 (up to 6 decimals).
+ */
+static const T_uint32 pow10LUT[7] = {
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL
+};
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t fixedToStr(T_char*, T_bit, T_uint32, T_uint32, T_uint8)
+ *	@brief 		Writes sign, integer part and fixed number of decimals.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	negative	Number sign.
+ *	@param[in]	whole		Integer part.
+ *	@param[in]	fraction	Rounded scaled fractional part (up to
+ *							10^decimals, which carries into whole).
+ *	@param[in]	decimals	Digits after decimal point (up to 6).
+ *	@return		number of printed characters (word).
+ */
+size_t fixedToStr(T_char* buffer, T_bit negative, T_uint32 whole,
+	T_uint32 fraction, T_uint8 decimals)
+{
+	size_t count = 0U;
+
+	decimals = MIN(decimals, 6U);
+	if (GEQ(fraction, pow10LUT[decimals])) {
+		fraction -= pow10LUT[decimals];
+		whole++;
+	}
+	/* sign is omitted if rounded to zero */
+	if (IS(negative) && (NEQ(whole, 0UL) || NEQ(fraction, 0UL))) {
+		buffer[count++] = ASCII_MINUS;
+	}
+	count += fastDec32ToStr(&buffer[count], whole, 1U);
+	if (NEQ(decimals, 0U)) {
+		buffer[count++] = ASCII_DOT;
+		count += fastDec32ToStr(&buffer[count], fraction, decimals);
+	}
+
+	return count;
+}
+
+/* END OF FIXEDTOSTR. */
@@ -0,0 +1,284 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Command API Functions Table Implementation      */
+/**
+ *	@file		NSC/nsc_api_table.c
+ *	@brief		This file contains NSC API functions implementation dispatching
+ *				through the application dispatch table (NSC/nscTable.h).
+ *	@details	Commands are looked up by binary search and registered
+ *				variables are read or written according to their size and data
+ *				type, so that no switch statement has to be edited per project.
+ *	@warning	Do not confuse the compiler by implementing two or more similar
+ *				NSC-related API functions. Remove or exclude other similar
+ *				source codes from build except for the current or correct source.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/nscTable.h>
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_bit checkNSCTable(T_void)
+ *	@brief 		Checks if dispatch table is sorted.
+ *	@param		.
+ *	@return		boolean.
+ */
+T_bit checkNSCTable(T_void)
+{
+	T_uint16 index;
+
+	for (index = 1U; LT(index, nscTableSize); index++) {
+		if (GEQ(nscTable[index - 1U].address, nscTable[index].address)) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ *	@fn			T_uint16 searchNSCTable(T_nscAddress)
+ *	@brief 		Searches dispatch table for the first address not less than an
+ *				address (binary search).
+ *	@param[in]	address		Address to search.
+ *	@return		entry index.
+ */
+T_uint16 searchNSCTable(T_nscAddress address)
+{
+	T_uint16 low = 0U;
+	T_uint16 high = nscTableSize;
+	T_uint16 middle;
+
+	while (LT(low, high)) {
+		middle = (T_uint16)((low + high) >> 1U);
+		if (LT(nscTable[middle].address, address)) {
+			low = middle + 1U;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low;
+}
+
+/**
+ *	@fn			const T_nscEntry* findNSCEntry(T_nscAddress)
+ *	@brief 		Searches dispatch table for an address.
+ *	@param[in]	address		Address to search.
+ *	@return		table entry.
+ */
+const T_nscEntry* findNSCEntry(T_nscAddress address)
+{
+	T_uint16 index = searchNSCTable(address);
+
+	if (LT(index, nscTableSize) && EQU(nscTable[index].address, address)) {
+		return &nscTable[index];
+	}
+
+	return NULL;
+}
+
+/**
+ *	@fn			T_void readNSCEntry(const T_nscEntry*, T_nscParamData*)
+ *	@brief 		Reads a registered variable into parameter data.
+ *	@param[in]	entry		Table entry.
+ *	@param[out]	parameter	Parameter data.
+ *	@return		.
+ */
+T_void readNSCEntry(const T_nscEntry* entry, T_nscParamData* parameter)
+{
+	readNSCElement(entry, 0U, parameter);
+}
+
+/**
+ *	@fn			T_void readNSCElement(const T_nscEntry*, T_uint16, T_nscParamData*)
+ *	@brief 		Reads an element into parameter data.
+ *	@param[in]	entry		Table entry.
+ *	@param[in]	index		Element index.
+ *	@param[out]	parameter	Parameter data.
+ *	@return		.
+ */
+T_void readNSCElement(const T_nscEntry* entry, T_uint16 index, T_nscParamData* parameter)
+{
+	T_uint8 byte;
+
+	/* sign-extend signed decimal only */
+	switch (entry->size) {
+		case SzBytes_BYTE:
+			parameter->si32 = COND(EQU(entry->type, NSC_SINT),
+				(T_sint32)((T_sint8*)entry->pVar)[index], (T_sint32)((T_uint8*)entry->pVar)[index]);
+			break;
+
+		case SzBytes_WORD:
+			parameter->si32 = COND(EQU(entry->type, NSC_SINT),
+				(T_sint32)((T_sint16*)entry->pVar)[index], (T_sint32)((T_uint16*)entry->pVar)[index]);
+			break;
+
+		case SzBytes_DWORD:
+			/* 32-bit integer or float (same bits), 4 bytes even where long is
+			 * wider than 32 bits */
+			parameter->ui32 = 0UL;
+			for (byte = 0U; LT(byte, SzBytes_DWORD); byte++) {
+				parameter->ui8[byte] = ((T_uint8*)entry->pVar)[index * SzBytes_DWORD + byte];
+			}
+			break;
+
+		default:
+			/* T_uint32 wider than 32 bits (host builds), other sizes read 0 */
+			parameter->ui32 = COND(EQU(entry->size, SzBytes_(T_uint32)),
+				((T_uint32*)entry->pVar)[index], 0UL);
+			break;
+	}
+}
+
+/**
+ *	@fn			T_void writeNSCElement(const T_nscEntry*, T_uint16, T_nscParamData)
+ *	@brief 		Writes parameter data into an element.
+ *	@param[in]	entry		Table entry.
+ *	@param[in]	index		Element index.
+ *	@param[in]	parameter	Parameter data.
+ *	@return		.
+ */
+T_void writeNSCElement(const T_nscEntry* entry, T_uint16 index, T_nscParamData parameter)
+{
+	T_uint8 byte;
+
+	/* truncate to element size */
+	switch (entry->size) {
+		case SzBytes_BYTE:
+			((T_uint8*)entry->pVar)[index] = (T_uint8)parameter.ui32;
+			break;
+
+		case SzBytes_WORD:
+			((T_uint16*)entry->pVar)[index] = (T_uint16)parameter.ui32;
+			break;
+
+		case SzBytes_DWORD:
+			for (byte = 0U; LT(byte, SzBytes_DWORD); byte++) {
+				((T_uint8*)entry->pVar)[index * SzBytes_DWORD + byte] = parameter.ui8[byte];
+			}
+			break;
+
+		default:
+			/* T_uint32 wider than 32 bits (host builds), other sizes rejected */
+			if (EQU(entry->size, SzBytes_(T_uint32))) {
+				((T_uint32*)entry->pVar)[index] = parameter.ui32;
+			}
+			break;
+	}
+}
+
+/**
+ *	@fn			T_void NSCErrorCheck(T_nscErrCode)
+ *	@brief 		NSC API function for error messages.
+ *	@param[in]	errCode		Error code or number.
+ *	@return		.
+ */
+T_void NSCErrorCheck(T_nscErrCode errCode)
+{
+	/* refer to error code */
+	switch (errCode) {
+		case NSC_ERR_NONE:
+			/* no error */
+			break;
+
+		case NSC_ERR_STACK_EMPTY:
+		case NSC_ERR_ADDRESS:
+		case NSC_ERR_ACCESS:
+			/* dispatch table errors */
+			break;
+		default:
+			/* error not found */
+			break;
+	}
+}
+
+/**
+ *	@fn			T_nscErrCode NSCExecute(T_nscAddress)
+ *	@brief 		NSC API function for executable procedures.
+ *	@param[in]	address 	Address specific to command to execute.
+ *	@return		error code.
+ */
+T_nscErrCode NSCExecute(T_nscAddress address)
+{
+	const T_nscEntry* entry = findNSCEntry(address);
+
+	if (EQU(entry, NULL)) {
+		return NSC_ERR_ADDRESS;
+	}
+	if (EQU(entry->access & NSC_ACC_EXE, 0U) || EQU(entry->handler, NULL)) {
+		return NSC_ERR_ACCESS;
+	}
+
+	return entry->handler(address);
+}
+
+/**
+ *	@fn			T_nscErrCode NSCDataStore(T_nscAddress)
+ *	@brief 		NSC API function for data storing activity.
+ *	@param[in]	address 	Address specific to data to store.
+ *	@return		error code.
+ */
+T_nscErrCode NSCDataStore(T_nscAddress address)
+{
+	const T_nscEntry* entry;
+	T_nscParamData parameter;
+	T_uint16 index;
+
+	/* check if NSC stack is not empty */
+	if (IS(emptyNSCStackSpace())) {
+		return NSC_ERR_STACK_EMPTY;
+	}
+	entry = findNSCEntry(address);
+	if (EQU(entry, NULL)) {
+		return NSC_ERR_ADDRESS;
+	}
+	if (EQU(entry->access & NSC_ACC_WR, 0U) || EQU(entry->pVar, NULL)) {
+		return NSC_ERR_ACCESS;
+	}
+	/* pop into elements from last one (last pushed value) */
+	index = entry->count;
+	while (NEQ(index, 0U) && NOT(emptyNSCStackSpace())) {
+		index--;
+		if (EQU(entry->type, NSC_FLOAT)) {
+			parameter.fl32 = popNSCStackFloat();
+		} else {
+			parameter.si32 = popNSCStackInteger();
+		}
+		writeNSCElement(entry, index, parameter);
+	}
+
+	/* notify watched variable */
+	return COND(EQU(entry->handler, NULL), NSC_ERR_NONE, entry->handler(address));
+}
+
+/**
+ *	@fn			T_nscErrCode NSCDataTransfer(T_nscAddress)
+ *	@brief 		NSC API function for retrieving and transfering data.
+ *	@param[in]	address 	Address specific to data to transfer.
+ *	@return		error code.
+ */
+T_nscErrCode NSCDataTransfer(T_nscAddress address)
+{
+	const T_nscEntry* entry = findNSCEntry(address);
+	T_nscParamData parameter = {NULL};
+	T_uint16 index;
+
+	if (EQU(entry, NULL)) {
+		return NSC_ERR_ADDRESS;
+	}
+	if (EQU(entry->access & NSC_ACC_RD, 0U) || EQU(entry->pVar, NULL)) {
+		return NSC_ERR_ACCESS;
+	}
+	/* message response per element (data type considered) */
+	for (index = 0U; LT(index, entry->count); index++) {
+		readNSCElement(entry, index, &parameter);
+		manageNSCResponse(NSC_CMD_PSH, parameter, entry->type);
+	}
+
+	return NSC_ERR_NONE;
+}
+
+/* END OF NSC_API_TABLE. */
@@ -0,0 +1,212 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Batched Requests Implementation				 */
+/**
+ *	@file		NSC/nsc_batch.c
+ *	@brief		This file contains NSC batch handler functions implementation.
+ *	@details	Entries are appended to the current TLM frame, which is sent
+ *				whenever the next entry would not fit, so that a response of
+ *				any size only needs a single frame of RAM.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/nscBatch.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NSC_BATCH_LAST_FRAME
+ *	@brief 		Frame index flag of last response frame.
+ */
+#define NSC_BATCH_LAST_FRAME	(0x80U)
+
+/**
+ * 	@def		NSC_BATCH_ERROR
+ *	@brief 		Entry status flag of failed entry.
+ */
+#define NSC_BATCH_ERROR			(0x80U)
+
+#if !TLM_STX
+#error "NSC batch responses need TLM_STX (frames sent back to back)"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Types.
+*/
+
+/**
+ *	@brief		Data structure for NSC batch response under construction.
+ */
+typedef struct {
+	T_tlmFrame frame;
+	T_uint8 channel;
+	T_uint8 tag;
+	T_uint8 index;
+} T_nscBatch;
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		nscBatchList
+ *	@brief		Addresses of list read (popped in reverse order).
+ */
+static T_nscAddress nscBatchList[NSC_BATCH_MAX_ENTRIES];
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void beginNSCBatch(T_nscBatch*, T_uint8, T_uint8)
+ *	@brief 		Starts a response.
+ *	@param[out]	batch		Batch response.
+ *	@param[in]	channel		TLM channel ID.
+ *	@param[in]	tag			Request tag.
+ *	@return		.
+ */
+static T_void beginNSCBatch(T_nscBatch* batch, T_uint8 channel, T_uint8 tag)
+{
+	batch->channel = channel;
+	batch->tag = tag;
+	batch->index = 0U;
+	beginTLMFrame(&batch->frame, channel);
+	putTLMByte(&batch->frame, tag);
+	putTLMByte(&batch->frame, 0U);
+}
+
+/**
+ *	@fn			T_void putNSCBatchEntry(T_nscBatch*, const T_nscEntry*, T_bit)
+ *	@brief 		Appends an entry, sending current frame first if full.
+ *	@param		batch		Batch response.
+ *	@param[in]	entry		Table entry (NULL if not registered).
+ *	@param[in]	addressed	Entry starts with address (range read).
+ *	@return		.
+ */
+static T_void putNSCBatchEntry(T_nscBatch* batch, const T_nscEntry* entry, T_bit addressed)
+{
+	T_nscParamData parameter = {NULL};
+	T_uint8 size = (T_uint8)(SzBytes_BYTE + SzBytes_DWORD);
+	T_uint8 status;
+
+	if (IS(addressed)) {
+		size += SzBytes_DWORD;
+	}
+	/* send full frame and continue in next one */
+	if (GT(GetByteTLMPayloadSize(batch->frame) + size, TLM_MAX_PAYLOAD)) {
+		(T_void)sendTLMFrame(&batch->frame);
+		batch->index++;
+		beginTLMFrame(&batch->frame, batch->channel);
+		putTLMByte(&batch->frame, batch->tag);
+		putTLMByte(&batch->frame, batch->index);
+	}
+	if (IS(addressed)) {
+		putTLMDWord(&batch->frame, entry->address);
+	}
+	if (EQU(entry, NULL)) {
+		status = (T_uint8)(NSC_BATCH_ERROR | NSC_ERR_ADDRESS);
+	} else if (EQU(entry->access & NSC_ACC_RD, 0U) || EQU(entry->pVar, NULL)) {
+		status = (T_uint8)(NSC_BATCH_ERROR | NSC_ERR_ACCESS);
+	} else {
+		status = (T_uint8)entry->type;
+		readNSCEntry(entry, &parameter);
+	}
+	putTLMByte(&batch->frame, status);
+	putTLMDWord(&batch->frame, parameter.ui32);
+}
+
+/**
+ *	@fn			T_void sendNSCBatch(T_nscBatch*)
+ *	@brief 		Flags and sends last frame of a response.
+ *	@param		batch		Batch response.
+ *	@return		.
+ */
+static T_void sendNSCBatch(T_nscBatch* batch)
+{
+	batch->frame.data[TLM_HEADER_SIZE + 1U] |= NSC_BATCH_LAST_FRAME;
+	(T_void)sendTLMFrame(&batch->frame);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_nscErrCode NSCBatchList(T_nscAddress)
+ *	@brief 		Reads listed variables as a single response.
+ *	@param[in]	address 	Address of command.
+ *	@return		error code.
+ */
+T_nscErrCode NSCBatchList(T_nscAddress address)
+{
+	T_nscBatch batch;
+	T_uint8 count = 0U;
+	T_uint8 tag;
+
+	(T_void)address;
+	if (IS(emptyNSCStackSpace())) {
+		return NSC_ERR_STACK_EMPTY;
+	}
+	tag = (T_uint8)popNSCStackInteger();
+	/* pop addresses (last pushed first) */
+	while (NOT(emptyNSCStackSpace())) {
+		if (EQU(count, NSC_BATCH_MAX_ENTRIES)) {
+			clearNSCStackSpace();
+			return NSC_ERR_BATCH_SIZE;
+		}
+		nscBatchList[count++] = (T_nscAddress)popNSCStackInteger();
+	}
+	/* respond in pushing order */
+	beginNSCBatch(&batch, NSC_BATCH_CHANNEL, tag);
+	while (NEQ(count, 0U)) {
+		count--;
+		putNSCBatchEntry(&batch, findNSCEntry(nscBatchList[count]), FALSE);
+	}
+	sendNSCBatch(&batch);
+
+	return NSC_ERR_NONE;
+}
+
+/**
+ *	@fn			T_nscErrCode NSCBatchRange(T_nscAddress)
+ *	@brief 		Reads readable variables within a range as a single response.
+ *	@param[in]	address 	Address of command.
+ *	@return		error code.
+ */
+T_nscErrCode NSCBatchRange(T_nscAddress address)
+{
+	T_nscBatch batch;
+	T_nscAddress first, last;
+	T_uint16 index;
+	T_uint8 tag;
+
+	(T_void)address;
+	/* tag, last and first address are all required */
+	if (IS(emptyNSCStackSpace())) {
+		return NSC_ERR_STACK_EMPTY;
+	}
+	tag = (T_uint8)popNSCStackInteger();
+	if (IS(emptyNSCStackSpace())) {
+		return NSC_ERR_STACK_EMPTY;
+	}
+	last = (T_nscAddress)popNSCStackInteger();
+	if (IS(emptyNSCStackSpace())) {
+		return NSC_ERR_STACK_EMPTY;
+	}
+	first = (T_nscAddress)popNSCStackInteger();
+	/* walk table from first address */
+	beginNSCBatch(&batch, NSC_BATCH_CHANNEL + 1U, tag);
+	for (index = searchNSCTable(first); LT(index, nscTableSize)
+			&& LEQ(nscTable[index].address, last); index++) {
+		if (NEQ(nscTable[index].access & NSC_ACC_RD, 0U)) {
+			putNSCBatchEntry(&batch, &nscTable[index], TRUE);
+		}
+	}
+	sendNSCBatch(&batch);
+
+	return NSC_ERR_NONE;
+}
+
+/* END OF NSC_BATCH. */
@@ -0,0 +1,432 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Binary Mode Implementation						 */
+/**
+ *	@file		NSC/nsc_binary.c
+ *	@brief		This file contains NSC binary mode API functions implementation.
+ *	@details	Frames are decoded in place and checked by length, channel and
+ *				CRC-16 before any command is executed. Commands then go through
+ *				evaluateNSCSession as in text mode. Parameter data is assembled
+ *				byte per byte so that it does not depend on compiler memory
+ *				layout.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/nscBinary.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		NSC_BINARY_FRAME_SIZE
+ *	@brief 		Encoded block request size in bytes (zero delimiter excluded).
+ */
+#define NSC_BINARY_FRAME_SIZE	(NSC_BINARY_REQUEST_SIZE + (NSC_BINARY_MAX_VALUES * SzBytes_DWORD) + 1U)
+
+#if !TLM_STX
+#error "NSC binary mode needs TLM_STX (frames sent back to back)"
+#endif
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		nscBinaryRx
+ *	@brief		Received frame (decoded in place).
+ */
+static T_uint8 nscBinaryRx[NSC_BINARY_FRAME_SIZE];
+
+/**
+ *	@var		nscBinaryRxLength
+ *	@brief		Received frame length.
+ */
+static T_uint8 nscBinaryRxLength;
+
+/**
+ *	@var		nscBinaryMode
+ *	@brief		Binary mode negotiated.
+ */
+static T_bit nscBinaryMode;
+
+/**
+ *	@var		nscBinaryErrors
+ *	@brief		Bad frames in a row.
+ */
+static T_uint8 nscBinaryErrors;
+
+/**
+ *	@var		nscBinaryDiscard
+ *	@brief		Oversized frame being discarded up to its delimiter.
+ */
+static T_bit nscBinaryDiscard;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_uint32 getNSCBinaryDWord(const T_uint8*)
+ *	@brief 		Assembles a little-endian double word.
+ *	@param[in]	pBuff	Pointer to least significant byte.
+ *	@return		double word.
+ */
+static T_uint32 getNSCBinaryDWord(const T_uint8* pBuff)
+{
+	return (T_uint32)pBuff[0] | ((T_uint32)pBuff[1] << 8U)
+		| ((T_uint32)pBuff[2] << 16U) | ((T_uint32)pBuff[3] << 24U);
+}
+
+/**
+ *	@fn			T_void respondNSCBinary(T_uint8, T_nscCommand, T_nscRepType, T_uint32)
+ *	@brief 		Transmits a response frame.
+ *	@param[in]	sequence	Request sequence number.
+ *	@param[in]	command		Response command.
+ *	@param[in]	type		Data type parameter format.
+ *	@param[in]	value		Parameter data.
+ *	@return		.
+ */
+static T_void respondNSCBinary(T_uint8 sequence, T_nscCommand command,
+	T_nscRepType type, T_uint32 value)
+{
+	T_tlmFrame frame;
+
+	beginTLMFrame(&frame, NSC_BINARY_CHANNEL);
+	putTLMByte(&frame, sequence);
+	putTLMByte(&frame, (T_uint8)command);
+	putTLMByte(&frame, (T_uint8)type);
+	putTLMDWord(&frame, value);
+	(T_void)sendTLMFrame(&frame);
+}
+
+/**
+ *	@fn			T_bit pushNSCBinary(T_nscRepType, T_nscParamData)
+ *	@brief 		Pushes parameter data according to its type.
+ *	@param[in]	type		Data type parameter format.
+ *	@param[in]	parameter	Parameter data.
+ *	@return		push status.
+ */
+static T_bit pushNSCBinary(T_nscRepType type, T_nscParamData parameter)
+{
+	return COND(EQU(type, NSC_FLOAT), pushNSCStackFloat(parameter.fl32),
+		pushNSCStackInteger(parameter.si32));
+}
+
+/**
+ *	@fn			T_void respondNSCBinaryBlock(T_uint8, T_nscRepType, T_uint32,
+ *					const T_nscParamData*, T_uint8)
+ *	@brief 		Transmits a block response frame.
+ *	@param[in]	sequence	Request sequence number.
+ *	@param[in]	type		Data type parameter format.
+ *	@param[in]	block		Block parameter (offset and length).
+ *	@param[in]	values		Values.
+ *	@param[in]	count		Value count.
+ *	@return		.
+ */
+static T_void respondNSCBinaryBlock(T_uint8 sequence, T_nscRepType type,
+	T_uint32 block, const T_nscParamData* values, T_uint8 count)
+{
+	T_tlmFrame frame;
+	T_uint8 index;
+
+	beginTLMFrame(&frame, NSC_BINARY_CHANNEL);
+	putTLMByte(&frame, sequence);
+	putTLMByte(&frame, (T_uint8)NSC_CMD_PSH);
+	putTLMByte(&frame, (T_uint8)type);
+	putTLMDWord(&frame, block);
+	for (index = 0U; LT(index, count); index++) {
+		putTLMDWord(&frame, values[index].ui32);
+	}
+	(T_void)sendTLMFrame(&frame);
+}
+
+/**
+ *	@fn			T_nscParamData popNSCBinary(T_nscRepType)
+ *	@brief 		Pops parameter data according to its type.
+ *	@param[in]	type		Data type parameter format.
+ *	@return		parameter data.
+ */
+static T_nscParamData popNSCBinary(T_nscRepType type)
+{
+	T_nscParamData parameter;
+
+	if (EQU(type, NSC_FLOAT)) {
+		parameter.fl32 = popNSCStackFloat();
+	} else {
+		parameter.si32 = popNSCStackInteger();
+	}
+
+	return parameter;
+}
+
+/**
+ *	@fn			T_nscErrCode findNSCBinaryEntry(T_nscAddress, T_uint8, const T_nscEntry**)
+ *	@brief 		Searches a variable or array with access rights.
+ *	@param[in]	address		Address.
+ *	@param[in]	access		Required access rights.
+ *	@param[out]	entry		Table entry.
+ *	@return		error code.
+ */
+static T_nscErrCode findNSCBinaryEntry(T_nscAddress address, T_uint8 access,
+	const T_nscEntry** entry)
+{
+	*entry = findNSCEntry(address);
+	if (EQU(*entry, NULL)) {
+		return NSC_ERR_ADDRESS;
+	}
+	if (EQU((*entry)->access & access, 0U) || EQU((*entry)->pVar, NULL)) {
+		return NSC_ERR_ACCESS;
+	}
+
+	return NSC_ERR_NONE;
+}
+
+/**
+ *	@fn			T_void executeNSCBinary(const T_uint8*, T_uint8)
+ *	@brief 		Executes a valid request and answers it.
+ *	@param[in]	request		Decoded request (channel first).
+ *	@param[in]	count		Block value count following parameter data.
+ *	@return		.
+ */
+static T_void executeNSCBinary(const T_uint8* request, T_uint8 count)
+{
+	T_nscParamData values[NSC_BINARY_MAX_VALUES];
+	T_uint8 sequence = request[1];
+	T_nscCommand command = (T_nscCommand)request[2];
+	T_nscRepType type = (T_nscRepType)request[3];
+	T_nscAddress address = getNSCBinaryDWord(&request[4]);
+	T_nscParamData parameter;
+	T_nscErrCode errCode = NSC_ERR_NONE;
+	const T_nscEntry* entry;
+	T_uint16 offset, length, position;
+	T_uint8 index, chunk;
+
+	parameter.ui32 = getNSCBinaryDWord(&request[8]);
+	/* block offset and length (block commands only) */
+	offset = (T_uint16)(parameter.ui32 >> 16U);
+	length = (T_uint16)parameter.ui32;
+	for (index = 0U; LT(index, count); index++) {
+		values[index].ui32 = getNSCBinaryDWord(&request[12U + (index * SzBytes_DWORD)]);
+	}
+	/* session control and stack clearing as in text mode */
+	if (NEQ(evaluateNSCSession(command), command)) {
+		command = NSC_CMD_INV;
+		errCode = NSC_ERR_SESSION;
+	}
+	switch (command) {
+		case NSC_CMD_PSH:
+			if (EQU(count, 0U)) {
+				values[0] = parameter;
+				count = 1U;
+			} else if (NEQ(parameter.ui32, count)) {
+				errCode = NSC_ERR_BLOCK_SIZE;
+				count = 0U;
+			}
+			for (index = 0U; LT(index, count); index++) {
+				if (NOT(pushNSCBinary(type, values[index]))) {
+					errCode = NSC_ERR_STACK_FULL;
+					break;
+				}
+			}
+			break;
+
+		case NSC_CMD_POP:
+			if (IS(emptyNSCStackSpace())) {
+				errCode = NSC_ERR_STACK_EMPTY;
+			} else if (EQU(length, 0U)) {
+				respondNSCBinary(sequence, NSC_CMD_PSH, type, popNSCBinary(type).ui32);
+				return;
+			} else if (GT(length, NSC_BINARY_MAX_VALUES)) {
+				errCode = NSC_ERR_BLOCK_SIZE;
+			} else {
+				/* pop block in pushing order */
+				for (index = (T_uint8)length; NEQ(index, 0U) && NOT(emptyNSCStackSpace()); index--) {
+					values[index - 1U] = popNSCBinary(type);
+				}
+				respondNSCBinaryBlock(sequence, type, length - index, &values[index],
+					(T_uint8)(length - index));
+				return;
+			}
+			break;
+
+		case NSC_CMD_EXE:
+			errCode = NSCExecute(address);
+			break;
+
+		case NSC_CMD_TXD:
+			if (EQU(count, 0U)) {
+				if (NOT(pushNSCBinary(type, parameter))) {
+					errCode = NSC_ERR_STACK_FULL;
+				} else {
+					errCode = NSCDataStore(address);
+				}
+				break;
+			}
+			/* copy block directly into elements */
+			errCode = findNSCBinaryEntry(address, NSC_ACC_WR, &entry);
+			if (NEQ(errCode, NSC_ERR_NONE)) {
+				break;
+			}
+			if (NEQ(length, count) || GT((T_uint32)offset + length, entry->count)) {
+				errCode = NSC_ERR_BLOCK_SIZE;
+				break;
+			}
+			for (index = 0U; LT(index, count); index++) {
+				writeNSCElement(entry, offset + index, values[index]);
+			}
+			if (NEQ(entry->handler, NULL)) {
+				errCode = entry->handler(address);
+			}
+			break;
+
+		case NSC_CMD_RXD:
+			errCode = findNSCBinaryEntry(address, NSC_ACC_RD, &entry);
+			if (NEQ(errCode, NSC_ERR_NONE)) {
+				break;
+			}
+			if (EQU(length, 0U)) {
+				readNSCEntry(entry, &parameter);
+				respondNSCBinary(sequence, NSC_CMD_PSH, entry->type, parameter.ui32);
+				return;
+			}
+			if (GT((T_uint32)offset + length, entry->count)) {
+				errCode = NSC_ERR_BLOCK_SIZE;
+				break;
+			}
+			/* copy elements directly into one frame per NSC_BINARY_MAX_VALUES */
+			for (position = 0U; LT(position, length); position += chunk) {
+				chunk = (T_uint8)MIN((T_uint16)(length - position), (T_uint16)NSC_BINARY_MAX_VALUES);
+				for (index = 0U; LT(index, chunk); index++) {
+					readNSCElement(entry, offset + position + index, &values[index]);
+				}
+				respondNSCBinaryBlock(sequence, entry->type,
+					((T_uint32)(offset + position) << 16U) | chunk, values, chunk);
+			}
+			return;
+
+		case NSC_CMD_MSR:
+		case NSC_CMD_SLV:
+			/* session opened by evaluateNSCSession */
+			break;
+
+		case NSC_CMD_REL:
+			/* back to text mode */
+			clearNSCStackSpace();
+			nscBinaryMode = FALSE;
+			break;
+
+		case NSC_CMD_INV:
+			/* rejected by session */
+			break;
+		default:
+			errCode = NSC_ERR_COMMAND;
+			break;
+	}
+
+	if (NEQ(errCode, NSC_ERR_NONE)) {
+		NSCErrorCheck(errCode);
+		respondNSCBinary(sequence, NSC_CMD_ERR, NSC_UHEX, errCode);
+	} else {
+		respondNSCBinary(sequence, command, type, 0UL);
+	}
+}
+
+/**
+ *	@fn			T_bit checkNSCBinaryFrame(T_uint8*)
+ *	@brief 		Decodes received frame and validates it.
+ *	@param[out]	count		Block value count.
+ *	@return		validity.
+ */
+static T_bit checkNSCBinaryFrame(T_uint8* count)
+{
+	T_uint8 size;
+	T_uint16 crc;
+
+	size = decodeTLMCOBS(nscBinaryRx, nscBinaryRx, nscBinaryRxLength);
+	if (LT(size, NSC_BINARY_REQUEST_SIZE) || NEQ((size - NSC_BINARY_REQUEST_SIZE) % SzBytes_DWORD, 0U)
+			|| NEQ(nscBinaryRx[0], NSC_BINARY_CHANNEL)) {
+		return FALSE;
+	}
+	*count = (T_uint8)((size - NSC_BINARY_REQUEST_SIZE) / SzBytes_DWORD);
+	crc = (T_uint16)nscBinaryRx[size - 2U] | (T_uint16)((T_uint16)nscBinaryRx[size - 1U] << 8U);
+
+	return EQU(computeTLMCRC(nscBinaryRx, size - TLM_CRC_SIZE), crc);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_nscErrCode NSCBinaryMode(T_nscAddress)
+ *	@brief 		Switches request parsing to binary mode.
+ *	@param[in]	address 	Address of command.
+ *	@return		error code.
+ */
+T_nscErrCode NSCBinaryMode(T_nscAddress address)
+{
+	(T_void)address;
+	nscBinaryRxLength = 0U;
+	nscBinaryErrors = 0U;
+	nscBinaryDiscard = FALSE;
+	nscBinaryMode = TRUE;
+
+	return NSC_ERR_NONE;
+}
+
+/**
+ *	@fn			T_void manageNSCBinaryRequest(T_void)
+ *	@brief 		Collects, validates, executes and answers requests.
+ *	@param		.
+ *	@return		.
+ */
+T_void manageNSCBinaryRequest(T_void)
+{
+	T_uint8 data;
+	T_uint8 count;
+
+	while (IS(nscBinaryMode) && NEQ(countSERReceived(), 0U)) {
+		(T_void)readSERBytes(&data, 1U, 0U, FALSE);
+		if (EQU(data, 0U)) {
+			/* validate frame at delimiter */
+			if (IS(nscBinaryDiscard) || EQU(nscBinaryRxLength, 0U)) {
+				nscBinaryDiscard = FALSE;
+				nscBinaryRxLength = 0U;
+				continue;
+			}
+			if (IS(checkNSCBinaryFrame(&count))) {
+				nscBinaryErrors = 0U;
+				executeNSCBinary(nscBinaryRx, count);
+			} else {
+				nscBinaryErrors++;
+			}
+			nscBinaryRxLength = 0U;
+		} else if (IS(nscBinaryDiscard)) {
+			/* rest of oversized frame */
+			continue;
+		} else if (LT(nscBinaryRxLength, NSC_BINARY_FRAME_SIZE)) {
+			nscBinaryRx[nscBinaryRxLength++] = data;
+		} else {
+			/* oversized frame or text (discarded up to next delimiter) */
+			nscBinaryErrors++;
+			nscBinaryDiscard = TRUE;
+		}
+		/* peer does not speak binary (i.e. terminal) */
+		if (GEQ(nscBinaryErrors, NSC_BINARY_MAX_ERRORS)) {
+			nscBinaryMode = FALSE;
+		}
+	}
+}
+
+/**
+ *	@fn			T_bit getNSCBinaryMode(T_void)
+ *	@brief 		Gets negotiated mode.
+ *	@param		.
+ *	@return		boolean.
+ */
+T_bit getNSCBinaryMode(T_void)
+{
+	return nscBinaryMode;
+}
+
+/* END OF NSC_BINARY. */
@@ -0,0 +1,52 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Q15 Fixed-Point Number to String Conversion Implementation				 */
+/**
+ *	@file		NSC/q15tostr.c
+ *	@brief		This file contains Q15 fixed-point number to string
+ *				conversion API functions implementation.
+ *	@details	The fraction is scaled by a power of 5 and shifted instead of
+ *				divided (10^d / 2^15 is 5^d / 2^(15 - d)).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		q15Pow5LUT
+ *	@brief		Powers of 5 (up to 5 decimals).
+ */
+static const T_uint16 q15Pow5LUT[6] = {
+	1U, 5U, 25U, 125U, 625U, 3125U
+};
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t q15ToStr(T_char*, T_sint16, T_uint8)
+ *	@brief 		Converts a Q15 number into a string with fixed decimals.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The Q15 number to convert (word).
+ *	@param[in]	decimals	Digits after decimal point (up to 5).
+ *	@return		number of printed characters (word).
+ */
+size_t q15ToStr(T_char* buffer, T_sint16 number, T_uint8 decimals)
+{
+	T_uint16 magnitude = (T_uint16)COND(LT(number, 0), -(T_sint32)number, number);
+	T_uint8 shift;
+
+	decimals = MIN(decimals, 5U);
+	shift = 15U - decimals;
+
+	/* scale by 10^d / 2^15 (5^d / 2^(15 - d)) rounded to nearest */
+	return fixedToStr(buffer, (T_bit)LT(number, 0), (T_uint32)(magnitude >> 15U),
+		(((T_uint32)(magnitude & 0x7FFFU) * q15Pow5LUT[decimals])
+		+ (1UL << (shift - 1U))) >> shift, decimals);
+}
+
+/* END OF Q15TOSTR. */
@@ -0,0 +1,53 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Q16.16 Fixed-Point Number to String Conversion Implementation			 */
+/**
+ *	@file		NSC/q16tostr.c
+ *	@brief		This file contains Q16.16 fixed-point number to string
+ *				conversion API functions implementation.
+ *	@details	The fraction is scaled by a power of 5 and shifted instead of
+ *				divided (10^d / 2^16 is 5^d / 2^(16 - d)).
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		q16Pow5LUT
+ *	@brief		Powers of 5 (up to 5 decimals).
+ */
+static const T_uint16 q16Pow5LUT[6] = {
+	1U, 5U, 25U, 125U, 625U, 3125U
+};
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn 		size_t q16ToStr(T_char*, T_sint32, T_uint8)
+ *	@brief 		Converts a Q16.16 number into a string with fixed decimals.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The Q16.16 number to convert (dword).
+ *	@param[in]	decimals	Digits after decimal point (up to 5).
+ *	@return		number of printed characters (word).
+ */
+size_t q16ToStr(T_char* buffer, T_sint32 number, T_uint8 decimals)
+{
+	T_uint32 magnitude = COND(LT(number, 0L),
+		(T_uint32)(-(number + 1L)) + 1UL, (T_uint32)number);
+	T_uint8 shift;
+
+	decimals = MIN(decimals, 5U);
+	shift = 16U - decimals;
+
+	/* scale by 10^d / 2^16 (5^d / 2^(16 - d)) rounded to nearest */
+	return fixedToStr(buffer, (T_bit)LT(number, 0L), magnitude >> 16U,
+		(((magnitude & 0xFFFFUL) * q16Pow5LUT[decimals])
+		+ (1UL << (shift - 1U))) >> shift, decimals);
+}
+
+/* END OF Q16TOSTR. */
@@ -0,0 +1,270 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Serial Transmit Engine Implementation									 */
+/**
+ *	@file		STX/stx.c
+ *	@brief		This file contains STX API functions and ISR implementation.
+ *	@details	Pending data is kept as a queue of segments. A segment either
+ *				refers to a caller buffer (scatter-gather, transmitted in place)
+ *				or to bytes copied into the ring buffer (null buffer pointer).
+ *				Writers only touch the queue tail while the transmit interrupt
+ *				is disabled, and the ISR consumes the queue head one byte per
+ *				transmit interrupt.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <STX/stx.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Flags.
+*/
+
+/**
+ * 	@def		STX_BUFFER_MASK
+ *	@brief 		Transmit ring buffer index mask.
+ */
+#define STX_BUFFER_MASK			(STX_BUFFER_SIZE - 1U)
+
+/**
+ * 	@def		STX_SEGMENT_MASK
+ *	@brief 		Transmit segment queue index mask.
+ */
+#define STX_SEGMENT_MASK		(STX_SEGMENT_COUNT - 1U)
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		stxRing
+ *	@brief		Transmit ring buffer.
+ */
+static T_uint8 stxRing[STX_BUFFER_SIZE];
+
+/**
+ *	@var		stxRingHead, stxRingTail
+ *	@brief		Free-running ring buffer read (ISR) and write indices.
+ */
+static T_uint16 stxRingHead, stxRingTail;
+
+/**
+ *	@var		stxQueue
+ *	@brief		Transmit segment queue.
+ */
+static T_stxSegment stxQueue[STX_SEGMENT_COUNT];
+
+/**
+ *	@var		stxQueueHead, stxQueueCount
+ *	@brief		Segment queue head (ISR) index and segment count.
+ */
+static T_uint8 stxQueueHead, stxQueueCount;
+
+/**
+ *	@var		stxPending
+ *	@brief		Bytes waiting for transmission.
+ */
+static T_uint16 stxPending;
+
+/**
+ *	@var		stxThrottled
+ *	@brief		High watermark reached (low watermark callback armed).
+ */
+static T_bit stxThrottled;
+
+/**
+ *	@var		stxLowCB, stxHighCB
+ *	@brief		Watermark callbacks.
+ */
+static T_stxWatermarkCB stxLowCB, stxHighCB;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void raiseSTXHighWatermark(T_void)
+ *	@brief 		Calls high watermark callback once pending bytes reach it.
+ *	@param		.
+ *	@return		.
+ *	@pre		Transmit interrupt must be disabled, so that the ISR cannot
+ *				drain pending bytes below low watermark before the flag is set
+ *				(the low watermark callback would never be called).
+ */
+static T_void raiseSTXHighWatermark(T_void)
+{
+	/* check if pending bytes reached high watermark first time */
+	if (GEQ(stxPending, STX_HIGH_WATERMARK) && NOT(stxThrottled)) {
+		stxThrottled = TRUE;
+		if (NEQ(stxHighCB, NULL)) {
+			stxHighCB(stxPending);
+		}
+	}
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initSTX(T_stxWatermarkCB, T_stxWatermarkCB)
+ *	@brief 		Initialize serial transmit engine.
+ * 	@param[in]	lowWatermark	Low watermark callback (or NULL).
+ * 	@param[in]	highWatermark	High watermark callback (or NULL).
+ * 	@return		.
+ */
+T_void initSTX(T_stxWatermarkCB lowWatermark, T_stxWatermarkCB highWatermark)
+{
+	DisableSERTransmitInterrupt();
+	/* discard pending data */
+	stxRingHead = 0U;
+	stxRingTail = 0U;
+	stxQueueHead = 0U;
+	stxQueueCount = 0U;
+	stxPending = 0U;
+	stxThrottled = FALSE;
+	/* set watermark callbacks */
+	stxLowCB = lowWatermark;
+	stxHighCB = highWatermark;
+}
+
+/**
+ * 	@fn 		T_uint16 writeSTXBytes(const T_uint8*, T_uint16)
+ *	@brief 		Copies bytes to transmit ring buffer and starts transmission.
+ * 	@param[in]	pBuff	Pointer to array to retrieve data.
+ * 	@param[in]	len		Desired bytes to write or size of array.
+ * 	@return		number of bytes queued.
+ */
+T_uint16 writeSTXBytes(const T_uint8* pBuff, T_uint16 len)
+{
+	T_stxSegment* segment;
+	T_uint16 count;
+	T_uint16 index;
+
+	DisableSERTransmitInterrupt();
+	/* limit to free ring buffer space */
+	count = MIN(len, (T_uint16)(STX_BUFFER_SIZE - (T_uint16)(stxRingTail - stxRingHead)));
+	segment = &stxQueue[(stxQueueHead + stxQueueCount - 1U) & STX_SEGMENT_MASK];
+	/* check if a new ring segment is needed (none or last one is in place) */
+	if (NEQ(count, 0U) && (EQU(stxQueueCount, 0U) || NEQ(segment->pBuff, NULL))) {
+		if (LT(stxQueueCount, STX_SEGMENT_COUNT)) {
+			segment = &stxQueue[(stxQueueHead + stxQueueCount) & STX_SEGMENT_MASK];
+			segment->pBuff = NULL;
+			segment->len = 0U;
+			stxQueueCount++;
+		} else {
+			count = 0U;
+		}
+	}
+	/* copy bytes to ring buffer and extend ring segment */
+	for (index = 0U; LT(index, count); index++) {
+		stxRing[stxRingTail & STX_BUFFER_MASK] = pBuff[index];
+		stxRingTail++;
+	}
+	if (NEQ(count, 0U)) {
+		segment->len += count;
+		stxPending += count;
+	}
+	raiseSTXHighWatermark();
+	/* (re)start transmission */
+	if (NEQ(stxQueueCount, 0U)) {
+		EnableSERTransmitInterrupt();
+	}
+
+	return count;
+}
+
+/**
+ * 	@fn 		T_uint8 writeSTXSegments(const T_stxSegment*, T_uint8)
+ *	@brief 		Queues several buffers for in-place transmission.
+ * 	@param[in]	segments	Segments in transmission order.
+ * 	@param[in]	count		Segment count.
+ * 	@return		number of segments queued.
+ */
+T_uint8 writeSTXSegments(const T_stxSegment* segments, T_uint8 count)
+{
+	T_uint8 index;
+
+	DisableSERTransmitInterrupt();
+	/* queue segments while queue has space */
+	for (index = 0U; LT(index, count) && LT(stxQueueCount, STX_SEGMENT_COUNT); index++) {
+		/* skip empty segments (null buffer is reserved for ring segments) */
+		if (NEQ(segments[index].len, 0U) && NEQ(segments[index].pBuff, NULL)) {
+			stxQueue[(stxQueueHead + stxQueueCount) & STX_SEGMENT_MASK] = segments[index];
+			stxQueueCount++;
+			stxPending += segments[index].len;
+		}
+	}
+	raiseSTXHighWatermark();
+	/* (re)start transmission */
+	if (NEQ(stxQueueCount, 0U)) {
+		EnableSERTransmitInterrupt();
+	}
+
+	return index;
+}
+
+/**
+ * 	@fn 		T_uint16 countSTXPending(T_void)
+ *	@brief 		Counts bytes waiting for transmission.
+ * 	@param		.
+ * 	@return		pending bytes.
+ */
+T_uint16 countSTXPending(T_void)
+{
+	return stxPending;
+}
+
+/**
+ * 	@fn 		T_uint16 countSTXFree(T_void)
+ *	@brief 		Counts free bytes of transmit ring buffer.
+ * 	@param		.
+ * 	@return		free bytes.
+ */
+T_uint16 countSTXFree(T_void)
+{
+	return (T_uint16)(STX_BUFFER_SIZE - (T_uint16)(stxRingTail - stxRingHead));
+}
+
+/**
+ * 	@fn 		T_void STX_IRQHandler(T_void)
+ *	@brief		Transmits a single pending byte per transmit interrupt.
+ *  @param		.
+ *  @return		.
+ */
+#if USE_STX_ISR
+ISR(STX_IRQHandler)
+{
+	T_stxSegment* segment = &stxQueue[stxQueueHead];
+
+	/* check if there's something left to transmit */
+	if (NEQ(stxQueueCount, 0U)) {
+		/* write next byte of head segment */
+		if (EQU(segment->pBuff, NULL)) {
+			SetSER_SODR(stxRing[stxRingHead & STX_BUFFER_MASK]);
+			stxRingHead++;
+		} else {
+			SetSER_SODR(*segment->pBuff);
+			segment->pBuff++;
+		}
+		stxPending--;
+		/* release head segment once done */
+		segment->len--;
+		if (EQU(segment->len, 0U)) {
+			stxQueueHead = (stxQueueHead + 1U) & STX_SEGMENT_MASK;
+			stxQueueCount--;
+		}
+		/* check if pending bytes dropped to low watermark */
+		if (IS(stxThrottled) && LEQ(stxPending, STX_LOW_WATERMARK)) {
+			stxThrottled = FALSE;
+			if (NEQ(stxLowCB, NULL)) {
+				stxLowCB(stxPending);
+			}
+		}
+	}
+	/* stop transmit interrupt once nothing is left */
+	if (EQU(stxQueueCount, 0U)) {
+		DisableSERTransmitInterrupt();
+	}
+}
+#endif
+
+/* END OF STX. */
@@ -0,0 +1,312 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Binary Telemetry Implementation											 */
+/**
+ *	@file		TLM/tlm.c
+ *	@brief		This file contains TLM API functions implementation.
+ *	@details	Values are packed byte per byte by shifting so that payloads are
+ *				little-endian regardless of compiler memory layout. CRC-16 uses
+ *				a 16-entry table (one lookup per nibble) as a tradeoff between
+ *				ROM size and speed on a 16-bit CPU.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <TLM/tlm.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Constants.
+*/
+
+/**
+ *	@var		tlmCRCLUT
+ *	@brief		CRC-16/CCITT nibble lookup table (poly 0x1021).
+ */
+static const T_uint16 tlmCRCLUT[16] = {
+	0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
+	0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU
+};
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		tlmSequence
+ *	@brief		Sequence number per channel.
+ */
+static T_uint8 tlmSequence[TLM_MAX_CHANNELS];
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initTLM(T_void)
+ *	@brief 		Initialize telemetry.
+ *	@param		.
+ *	@return		.
+ */
+T_void initTLM(T_void)
+{
+	T_uint8 channel;
+
+	for (channel = 0U; LT(channel, TLM_MAX_CHANNELS); channel++) {
+		tlmSequence[channel] = 0U;
+	}
+}
+
+/**
+ *	@fn			T_void beginTLMFrame(T_tlmFrame*, T_uint8)
+ *	@brief 		Starts a frame on a channel.
+ *	@param[out]	frame		TLM frame.
+ *	@param[in]	channel		Channel ID.
+ *	@return		.
+ */
+T_void beginTLMFrame(T_tlmFrame* frame, T_uint8 channel)
+{
+	frame->data[0] = channel;
+	frame->data[1] = tlmSequence[channel % TLM_MAX_CHANNELS];
+	frame->length = TLM_HEADER_SIZE;
+	frame->overflow = FALSE;
+}
+
+/**
+ *	@fn			T_void putTLMByte(T_tlmFrame*, T_uint8)
+ *	@brief 		Appends a byte to frame payload.
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+T_void putTLMByte(T_tlmFrame* frame, T_uint8 value)
+{
+	if (LT(frame->length, TLM_HEADER_SIZE + TLM_MAX_PAYLOAD)) {
+		frame->data[frame->length++] = value;
+	} else {
+		frame->overflow = TRUE;
+	}
+}
+
+/**
+ *	@fn			T_void putTLMWord(T_tlmFrame*, T_uint16)
+ *	@brief 		Appends a word to frame payload (little-endian).
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+T_void putTLMWord(T_tlmFrame* frame, T_uint16 value)
+{
+	putTLMByte(frame, (T_uint8)value);
+	putTLMByte(frame, (T_uint8)(value >> 8U));
+}
+
+/**
+ *	@fn			T_void putTLMDWord(T_tlmFrame*, T_uint32)
+ *	@brief 		Appends a double word to frame payload (little-endian).
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+T_void putTLMDWord(T_tlmFrame* frame, T_uint32 value)
+{
+	putTLMWord(frame, (T_uint16)value);
+	putTLMWord(frame, (T_uint16)(value >> 16U));
+}
+
+/**
+ *	@fn			T_void putTLMFloat(T_tlmFrame*, T_float32)
+ *	@brief 		Appends a single precision float to frame payload.
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+T_void putTLMFloat(T_tlmFrame* frame, T_float32 value)
+{
+	union {
+		T_float32 value;
+		T_uint32 bits;
+	} binary;
+
+	binary.value = value;
+	putTLMDWord(frame, binary.bits);
+}
+
+/**
+ *	@fn			T_uint8 sendTLMFrame(T_tlmFrame*)
+ *	@brief 		Appends CRC-16, encodes and transmits a frame.
+ *	@param		frame	TLM frame.
+ *	@return		number of bytes transmitted.
+ */
+T_uint8 sendTLMFrame(T_tlmFrame* frame)
+{
+	T_uint8 encoded[TLM_FRAME_SIZE];
+	T_uint16 crc;
+	T_uint8 size;
+
+	/* drop incomplete frame */
+	if (IS(frame->overflow)) {
+		return 0U;
+	}
+	/* append CRC-16 (little-endian) */
+	crc = computeTLMCRC(frame->data, frame->length);
+	frame->data[frame->length++] = (T_uint8)crc;
+	frame->data[frame->length++] = (T_uint8)(crc >> 8U);
+	/* encode and transmit */
+	size = encodeTLMCOBS(encoded, frame->data, frame->length);
+	tlmSequence[frame->data[0] % TLM_MAX_CHANNELS]++;
+#if TLM_STX
+	/* wait for the whole frame to fit (never truncated on the line) */
+	while (LT(countSTXFree(), size)) {
+		continue;
+	}
+#endif
+
+	return (T_uint8)TLM_WRITE((const T_uint8*)encoded, size);
+}
+
+/**
+ *	@fn			T_uint8 sendTLMFloats(T_uint8, const T_float32*, T_uint8)
+ *	@brief 		Builds and transmits a frame of floats.
+ *	@param[in]	channel		Channel ID.
+ *	@param[in]	values		Values to transmit.
+ *	@param[in]	count		Value count.
+ *	@return		number of bytes transmitted.
+ */
+T_uint8 sendTLMFloats(T_uint8 channel, const T_float32* values, T_uint8 count)
+{
+	T_tlmFrame frame;
+	T_uint8 index;
+
+	beginTLMFrame(&frame, channel);
+	for (index = 0U; LT(index, count); index++) {
+		putTLMFloat(&frame, values[index]);
+	}
+
+	return sendTLMFrame(&frame);
+}
+
+/**
+ *	@fn			T_uint8 batchTLMFloats(T_tlmFrame*, const T_float32*, T_uint8,
+ *					T_uint8)
+ *	@brief 		Appends a sample of floats and transmits full frames.
+ *	@param		frame		TLM frame.
+ *	@param[in]	values		Sample values.
+ *	@param[in]	count		Value count per sample.
+ *	@param[in]	samples		Samples per frame.
+ *	@return		number of bytes transmitted.
+ */
+T_uint8 batchTLMFloats(T_tlmFrame* frame, const T_float32* values,
+	T_uint8 count, T_uint8 samples)
+{
+	T_uint16 sampleSize = (T_uint16)count * 4U;
+	T_uint8 channel = frame->data[0];
+	T_uint8 sent = 0U;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, count); index++) {
+		putTLMFloat(frame, values[index]);
+	}
+	/* transmit once enough samples are collected or the next one overflows */
+	if (GEQ(GetByteTLMPayloadSize(*frame), sampleSize * samples)
+		|| GT(GetByteTLMPayloadSize(*frame) + sampleSize, TLM_MAX_PAYLOAD)
+		|| IS(frame->overflow)) {
+		sent = sendTLMFrame(frame);
+		beginTLMFrame(frame, channel);
+	}
+
+	return sent;
+}
+
+/**
+ *	@fn			T_uint16 computeTLMCRC(const T_uint8*, T_uint8)
+ *	@brief 		Computes CRC-16/CCITT-FALSE.
+ *	@param[in]	pBuff	Data to check.
+ *	@param[in]	len		Data size.
+ *	@return		CRC-16.
+ */
+T_uint16 computeTLMCRC(const T_uint8* pBuff, T_uint8 len)
+{
+	T_uint16 crc = 0xFFFFU;
+
+	while (NEQ(len, 0U)) {
+		/* process high nibble then low nibble */
+		crc = (T_uint16)(crc << 4U) ^ tlmCRCLUT[(crc >> 12U) ^ (*pBuff >> 4U)];
+		crc = (T_uint16)(crc << 4U) ^ tlmCRCLUT[(crc >> 12U) ^ (*pBuff & 0x0FU)];
+		pBuff++;
+		len--;
+	}
+
+	return crc;
+}
+
+/**
+ *	@fn			T_uint8 encodeTLMCOBS(T_uint8*, const T_uint8*, T_uint8)
+ *	@brief 		Encodes data through COBS and appends the zero delimiter.
+ *	@param[out]	pDest	Encoded data.
+ *	@param[in]	pSrc	Data to encode.
+ *	@param[in]	len		Data size.
+ *	@return		encoded size (delimiter included).
+ */
+T_uint8 encodeTLMCOBS(T_uint8* pDest, const T_uint8* pSrc, T_uint8 len)
+{
+	T_uint8 codeIndex = 0U;
+	T_uint8 code = 1U;
+	T_uint8 size = 1U;
+	T_uint8 index;
+
+	for (index = 0U; LT(index, len); index++) {
+		if (EQU(pSrc[index], 0U)) {
+			/* close block with distance to this zero */
+			pDest[codeIndex] = code;
+			codeIndex = size++;
+			code = 1U;
+		} else {
+			pDest[size++] = pSrc[index];
+			code++;
+		}
+	}
+	/* close last block and delimit frame */
+	pDest[codeIndex] = code;
+	pDest[size++] = 0U;
+
+	return size;
+}
+
+/**
+ *	@fn			T_uint8 decodeTLMCOBS(T_uint8*, const T_uint8*, T_uint8)
+ *	@brief 		Decodes COBS data.
+ *	@param[out]	pDest	Decoded data.
+ *	@param[in]	pSrc	Data to decode.
+ *	@param[in]	len		Data size.
+ *	@return		decoded size.
+ */
+T_uint8 decodeTLMCOBS(T_uint8* pDest, const T_uint8* pSrc, T_uint8 len)
+{
+	T_uint8 size = 0U;
+	T_uint8 index = 0U;
+	T_uint8 code;
+	T_bit full;
+
+	while (LT(index, len)) {
+		code = pSrc[index++];
+		full = EQU(code, 0xFFU);
+		/* check for zero or block past end */
+		if (EQU(code, 0U) || GT(index + code - 1U, len)) {
+			return 0U;
+		}
+		code--;
+		while (NEQ(code, 0U)) {
+			if (EQU(pSrc[index], 0U)) {
+				return 0U;
+			}
+			pDest[size++] = pSrc[index++];
+			code--;
+		}
+		/* restore zero closing the block (except last or full one) */
+		if (NOT(full) && LT(index, len)) {
+			pDest[size++] = 0U;
+		}
+	}
+
+	return size;
+}
+
+/* END OF TLM. */
@@ -0,0 +1,293 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* KernelUART Virtual Channels Implementation								 */
+/**
+ *	@file		VCH/vch.c
+ *	@brief		This file contains VCH API functions implementation.
+ *	@details	Each call of manageVCH transmits at most a single TLM frame so
+ *				that the caller is never held for more than one frame time.
+ *				Channels are served round-robin and each one may send up to its
+ *				credit (byte budget) per round. The UART is handed to the
+ *				monitor once the SER TX ISR has emptied the transmit buffer
+ *				(transmit interrupt disabled, data register empty) and
+ *				VCH_DRAIN_MS more have elapsed.
+**/
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#include <VCH/vch.h>
+#include <TMR/tbt.h>
+
+/* ----------------------------------------------------------------------------
+**	Private Variables.
+*/
+
+/**
+ *	@var		vchChannels
+ *	@brief		Application channels.
+ */
+static T_vchChannel vchChannels[VCH_MAX_CHANNELS];
+
+/**
+ *	@var		vchMonitorShare
+ *	@brief		Monitor share of each round (percent).
+ */
+static T_uint8 vchMonitorShare;
+
+/**
+ *	@var		vchOwner
+ *	@brief		Current KernelUART owner.
+ */
+static T_vchOwner vchOwner;
+
+/**
+ *	@var		vchWindowStart
+ *	@brief		Start time of current window, or of empty transmit buffer
+ *				while draining (milliseconds).
+ */
+static T_uint32 vchWindowStart;
+
+/**
+ *	@var		vchNext
+ *	@brief		Next application channel to serve.
+ */
+static T_uint8 vchNext;
+
+/* ----------------------------------------------------------------------------
+**	Private Functions.
+*/
+
+/**
+ *	@fn			T_void startVCHApplicationWindow(T_void)
+ *	@brief 		Hands KernelUART to application and refills channel credits
+ *				proportionally to their shares.
+ *	@param		.
+ *	@return		.
+ */
+static T_void startVCHApplicationWindow(T_void)
+{
+	T_uint32 budget = ((T_uint32)(100U - vchMonitorShare) * VCH_ROUND_MS
+		* VCH_BYTES_PER_MS) / 100UL;
+	T_uint16 weights = 0U;
+	T_uint8 channel;
+
+	/* sum channel weights */
+	for (channel = 0U; LT(channel, VCH_MAX_CHANNELS); channel++) {
+		weights += vchChannels[channel].share;
+	}
+	/* split round budget */
+	for (channel = 0U; LT(channel, VCH_MAX_CHANNELS); channel++) {
+		vchChannels[channel].credit = COND(EQU(weights, 0U), 0U,
+			(T_uint16)((budget * vchChannels[channel].share) / weights));
+	}
+	if (NEQ(vchOwner, VCH_APPLICATION)) {
+		const T_uint8 delimiter = 0U;
+
+		setSERUsage(SER_APP);
+		vchOwner = VCH_APPLICATION;
+		/* terminate monitor bytes for the host */
+		(T_void)writeSERBytes(&delimiter, 1U);
+	}
+	vchWindowStart = GetDWordTBTMillis();
+}
+
+/**
+ *	@fn			T_void announceVCHMonitorWindow(T_void)
+ *	@brief 		Announces the monitor window to the host and waits for the
+ *				SER transmit buffer to drain.
+ *	@param		.
+ *	@return		.
+ */
+static T_void announceVCHMonitorWindow(T_void)
+{
+	T_tlmFrame frame;
+
+	beginTLMFrame(&frame, VCH_CONTROL_CHANNEL);
+	putTLMWord(&frame, (T_uint16)(((T_uint32)vchMonitorShare * VCH_ROUND_MS) / 100UL));
+	(T_void)sendTLMFrame(&frame);
+	vchOwner = VCH_DRAINING;
+	vchWindowStart = GetDWordTBTMillis();
+}
+
+/**
+ *	@fn			T_bit isVCHTransmitDrained(T_void)
+ *	@brief 		Checks if SER transmit buffer and data register are empty.
+ *	@param		.
+ *	@return		boolean.
+ */
+static T_bit isVCHTransmitDrained(T_void)
+{
+	return (T_bit)(NOT(IsSERTransmitInterruptEnabled())
+		&& IsSERTransmitDataRegEmpty());
+}
+
+/**
+ *	@fn			T_void sendVCHFrame(T_vchChannel*, T_uint8)
+ *	@brief 		Transmits queued bytes of a channel within its credit as a
+ *				single TLM frame.
+ *	@param		channel		Application channel.
+ *	@param[in]	index		Application channel index.
+ *	@return		.
+ */
+static T_void sendVCHFrame(T_vchChannel* channel, T_uint8 index)
+{
+	T_tlmFrame frame;
+	T_uint8 count = (T_uint8)MIN((T_uint16)channel->count, channel->credit);
+
+	count = MIN(count, TLM_MAX_PAYLOAD);
+	beginTLMFrame(&frame, VCH_CHANNEL_BASE + index);
+	channel->credit -= count;
+	channel->count -= count;
+	while (NEQ(count, 0U)) {
+		putTLMByte(&frame, channel->queue[channel->head]);
+		channel->head = (T_uint8)COND(EQU(channel->head, VCH_QUEUE_SIZE - 1U),
+			0U, channel->head + 1U);
+		count--;
+	}
+	(T_void)sendTLMFrame(&frame);
+}
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initVCH(T_uint8)
+ *	@brief 		Initialize virtual channels.
+ *	@param[in]	monitorShare	Monitor share of each round (percent).
+ *	@return		.
+ */
+T_void initVCH(T_uint8 monitorShare)
+{
+	T_uint8 channel;
+
+	for (channel = 0U; LT(channel, VCH_MAX_CHANNELS); channel++) {
+		vchChannels[channel].head = 0U;
+		vchChannels[channel].count = 0U;
+		vchChannels[channel].share = 0U;
+		vchChannels[channel].credit = 0U;
+		vchChannels[channel].dropped = 0U;
+	}
+	vchMonitorShare = MIN(monitorShare, 100U);
+	vchNext = 0U;
+	vchOwner = VCH_MONITOR;
+	startVCHApplicationWindow();
+	/* start with announced monitor window (if any) */
+	if (NEQ(vchMonitorShare, 0U)) {
+		announceVCHMonitorWindow();
+	}
+}
+
+/**
+ *	@fn			T_void setVCHShare(T_uint8, T_uint8)
+ *	@brief 		Sets bandwidth share of an application channel.
+ *	@param[in]	channel		Application channel index.
+ *	@param[in]	share		Relative weight among application channels.
+ *	@return		.
+ */
+T_void setVCHShare(T_uint8 channel, T_uint8 share)
+{
+	if (LT(channel, VCH_MAX_CHANNELS)) {
+		vchChannels[channel].share = share;
+	}
+}
+
+/**
+ *	@fn			T_uint8 writeVCHBytes(T_uint8, const T_uint8*, T_uint8)
+ *	@brief 		Queues bytes on an application channel without blocking.
+ *	@param[in]	channel		Application channel index.
+ *	@param[in]	pBuff		Pointer to array to retrieve data.
+ *	@param[in]	len			Desired bytes to write or size of array.
+ *	@return		number of bytes queued.
+ */
+T_uint8 writeVCHBytes(T_uint8 channel, const T_uint8* pBuff, T_uint8 len)
+{
+	T_vchChannel* vch;
+	T_uint16 tail;
+	T_uint8 count;
+	T_uint8 index;
+
+	if (GEQ(channel, VCH_MAX_CHANNELS)) {
+		return 0U;
+	}
+	vch = &vchChannels[channel];
+	count = (T_uint8)MIN(len, VCH_QUEUE_SIZE - vch->count);
+	tail = ((T_uint16)vch->head + vch->count) % VCH_QUEUE_SIZE;
+	for (index = 0U; LT(index, count); index++) {
+		vch->queue[tail] = pBuff[index];
+		tail = COND(EQU(tail, VCH_QUEUE_SIZE - 1U), 0U, tail + 1U);
+	}
+	vch->count += count;
+	vch->dropped += (T_uint16)(len - count);
+
+	return count;
+}
+
+/**
+ *	@fn			T_void manageVCH(T_void)
+ *	@brief 		Switches KernelUART owner and transmits application bytes.
+ *	@param		.
+ *	@return		.
+ */
+T_void manageVCH(T_void)
+{
+	T_uint32 elapsed = GetDWordTBTMillis() - vchWindowStart;
+	T_uint8 visited;
+
+	if (EQU(vchOwner, VCH_MONITOR)) {
+		/* check if monitor window is over */
+		if (GEQ(elapsed, ((T_uint32)vchMonitorShare * VCH_ROUND_MS) / 100UL)) {
+			startVCHApplicationWindow();
+		}
+	} else if (EQU(vchOwner, VCH_DRAINING)) {
+		/* hand over to monitor once the last character is out */
+		if (NOT(isVCHTransmitDrained())) {
+			vchWindowStart = GetDWordTBTMillis();
+		} else if (GEQ(elapsed, VCH_DRAIN_MS)) {
+			setSERUsage(SER_ACC);
+			vchOwner = VCH_MONITOR;
+			vchWindowStart = GetDWordTBTMillis();
+		}
+	} else if (GEQ(elapsed, ((T_uint32)(100U - vchMonitorShare) * VCH_ROUND_MS) / 100UL)) {
+		/* application window is over */
+		if (NEQ(vchMonitorShare, 0U)) {
+			announceVCHMonitorWindow();
+		} else {
+			startVCHApplicationWindow();
+		}
+	} else {
+		/* serve next channel having both data and credit */
+		for (visited = 0U; LT(visited, VCH_MAX_CHANNELS); visited++) {
+			T_vchChannel* vch = &vchChannels[vchNext];
+			T_uint8 index = vchNext;
+
+			vchNext = (T_uint8)((vchNext + 1U) % VCH_MAX_CHANNELS);
+			if (NEQ(vch->count, 0U) && NEQ(vch->credit, 0U)) {
+				sendVCHFrame(vch, index);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ *	@fn			T_vchOwner getVCHOwner(T_void)
+ *	@brief 		Gets current KernelUART owner.
+ *	@param		.
+ *	@return		KernelUART owner.
+ */
+T_vchOwner getVCHOwner(T_void)
+{
+	return vchOwner;
+}
+
+/**
+ *	@fn			T_uint16 countVCHDropped(T_uint8)
+ *	@brief 		Counts bytes dropped on an application channel.
+ *	@param[in]	channel		Application channel index.
+ *	@return		dropped bytes.
+ */
+T_uint16 countVCHDropped(T_uint8 channel)
+{
+	return COND(LT(channel, VCH_MAX_CHANNELS), vchChannels[channel].dropped, 0U);
+}
+
+/* END OF VCH. */
@@ -0,0 +1,217 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Acceptance Filter Planner											     */
+/**
+ *	@file		ACF/acf.h
+ *	@brief		This file contains ACF flags, types, getters, and API functions
+ *				for planning message buffer IDs, acceptance mask options and
+ *				acceptance masks (AMR0 and AMR1) from the set of IDs a node
+ *				subscribes to.
+ *	@details	A message buffer accepts a frame if the ID bits not masked
+ *				(mask bit 0, compared) are equal to its own ID. With full-bit
+ *				comparison, a buffer takes a single ID; with AMR0 or AMR1, it
+ *				takes the class of every ID equal to its own outside the mask
+ *				(2 ^ masked bits IDs), but both masks are shared by all
+ *				buffers. When there are more IDs than reception buffers,
+ *				planACF grows the two masks one pair of nearest IDs at a time
+ *				(the one reducing buffers needed at the lowest cost), then
+ *				drops every mask bit that is not needed anymore. The cost of a
+ *				class is its accepted-but-unwanted frames: counted against the
+ *				given bus traffic (distinct IDs with frame counts, i.e. from a
+ *				recorded bus log) or, without traffic, the unwanted IDs of the
+ *				class (uniform traffic). <br>
+ *				IDs and masks are bit-ordered (see toIDBitOrder), with
+ *				standard IDs in bits 28 to 18 like formattedCANID, so any ID
+ *				may be planned (not only formatted IDs). Planning does not
+ *				touch the CAN peripheral (acf_plan.c also builds on host, see
+ *				HOST/ACF), while applyACF writes the plan to the peripheral.
+ *	@note		planACF is a heuristic of O(n^3) per mask step (n IDs), meant to
+ *				run once at initialization (or on host). It is not reentrant.
+ *	@code
+ *		static const T_dword subscribed[] = { 0x123UL << 18U, ... };
+ *		T_acfPlan plan;
+ *
+ *		initCAN(CAN_DEF_BUS_SPEED, 0x00U, 0x0FU);
+ *		if (IS(planACF(&plan, subscribed, SzIndices_(subscribed),
+ *				CAN_ID_STD_FORMAT, 0xF0U, NULL, 0U))) {
+ *			applyACF(&plan);
+ *		}
+ *		startCAN();
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef ACF_H
+#define ACF_H
+
+#include <COM/can.h>
+
+/* ----------------------------------------------------------------------------
+**	ACF Flags.
+*/
+
+/**
+ * 	@def		ACF_MAX_IDS
+ *	@brief 		Maximum subscribed IDs of a plan (up to 255).
+ *	@note		Planning takes about 13 bytes of static RAM per ID.
+ */
+#ifndef ACF_MAX_IDS
+#define ACF_MAX_IDS				(32U)
+#endif
+
+/**
+ * 	@def		ACF_STD_BITS
+ *	@brief 		Bit-ordered ID bits compared for standard format.
+ */
+#define ACF_STD_BITS			(0x1FFC0000UL)
+
+/**
+ * 	@def		ACF_EXT_BITS
+ *	@brief 		Bit-ordered ID bits compared for extended format.
+ */
+#define ACF_EXT_BITS			(0x1FFFFFFFUL)
+
+/**
+ * 	@def		ACF_MAX_COST
+ *	@brief 		Saturated false accept count.
+ */
+#define ACF_MAX_COST			(0xFFFFFFFFUL)
+
+/* ----------------------------------------------------------------------------
+**	ACF Types.
+*/
+
+/**
+ *	@brief		Data structure for ACF bus traffic entry.
+ */
+typedef struct {
+	T_dword id;
+	T_uint32 frames;
+} T_acfTraffic;
+
+/**
+ *	@brief		Data structure for ACF plan.
+ */
+typedef struct {
+	T_dword mask[2];
+	T_dword id[CAN_MB_SIZE];
+	T_canAccMaskOp option[CAN_MB_SIZE];
+	T_canIDFormat format;
+	T_byte buffers;
+	T_uint32 falseAccepts;
+} T_acfPlan;
+
+/* ----------------------------------------------------------------------------
+**	ACF Getters.
+*/
+
+/**
+ *	@def 		GetDWordACFBits
+ *	@brief		Gets the bit-ordered ID bits compared for an ID format.
+ *	@param[in]	FORMAT	ID format.
+ *	@return		ID bits (dword).
+ */
+#define GetDWordACFBits(FORMAT) \
+	COND(EQU((FORMAT), CAN_ID_STD_FORMAT), ACF_STD_BITS, ACF_EXT_BITS)
+
+/**
+ *	@def 		GetByteACFPrefix
+ *	@brief		Gets the prefix (bits 28 to 21) of a bit-ordered ID or mask.
+ *	@param[in]	ID		Bit-ordered ID or mask.
+ *	@return		prefix (byte).
+ */
+#define GetByteACFPrefix(ID) \
+	((T_byte)((ID) >> 21U))
+
+/**
+ *	@def 		GetWordACFSuffix
+ *	@brief		Gets the suffix (bits 15 to 0) of a bit-ordered ID or mask.
+ *	@param[in]	ID		Bit-ordered ID or mask.
+ *	@return		suffix (word).
+ */
+#define GetWordACFSuffix(ID) \
+	((T_word)(ID))
+
+/* ----------------------------------------------------------------------------
+**	ACF API Functions.
+*/
+
+/**
+ *	@fn			T_bit planACF(T_acfPlan*, const T_dword*, T_uint8, T_canIDFormat,
+ *					T_byte, const T_acfTraffic*, T_uint16)
+ *	@brief 		Plans message buffers and acceptance masks receiving a set of
+ *				IDs with the fewest accepted-but-unwanted frames.
+ *	@param[out]	plan			ACF plan.
+ *	@param[in]	ids				Subscribed bit-ordered IDs (distinct).
+ *	@param[in]	count			Subscribed ID count (up to ACF_MAX_IDS).
+ *	@param[in]	format			ID format.
+ *	@param[in]	rxBufferBits	Reception message buffer bits available.
+ *	@param[in]	traffic			Bus traffic (NULL for uniform traffic).
+ *	@param[in]	trafficCount	Bus traffic entry count.
+ *	@return		plan status (FALSE if no ID, too many IDs or no buffer).
+ */
+extern T_bit planACF(T_acfPlan* plan, const T_dword* ids, T_uint8 count,
+	T_canIDFormat format, T_byte rxBufferBits, const T_acfTraffic* traffic,
+	T_uint16 trafficCount);
+
+/**
+ *	@fn			T_bit checkACFAccepted(const T_acfPlan*, T_dword)
+ *	@brief 		Checks if a planned peripheral would accept an ID.
+ *	@param[in]	plan	ACF plan.
+ *	@param[in]	id		Bit-ordered ID.
+ *	@return		acceptance.
+ */
+extern T_bit checkACFAccepted(const T_acfPlan* plan, T_dword id);
+
+/**
+ *	@fn			T_uint32 countACFFalseAccepts(const T_acfPlan*, const T_dword*,
+ *					T_uint8, const T_acfTraffic*, T_uint16)
+ *	@brief 		Counts frames of a bus traffic accepted but not subscribed.
+ *	@param[in]	plan			ACF plan.
+ *	@param[in]	ids				Subscribed bit-ordered IDs.
+ *	@param[in]	count			Subscribed ID count.
+ *	@param[in]	traffic			Bus traffic.
+ *	@param[in]	trafficCount	Bus traffic entry count.
+ *	@return		false accepts (frames).
+ */
+extern T_uint32 countACFFalseAccepts(const T_acfPlan* plan, const T_dword* ids,
+	T_uint8 count, const T_acfTraffic* traffic, T_uint16 trafficCount);
+
+/**
+ *	@fn			T_void applyACF(const T_acfPlan*)
+ *	@brief 		Disables the message buffers of a plan, sets up acceptance
+ *				masks and message buffers, then enables the message buffers
+ *				again.
+ *	@pre		initCAN must be called first (without the planned buffers).
+ *	@param[in]	plan	ACF plan.
+ *	@return		.
+ *	@note		Masks and IDs are written as is to AMR and IDR since their
+ *				buffer bits (20 to 18) may not be set through
+ *				setupCANAcceptanceMask and formattedCANID. Since the planned
+ *				buffers are invalid meanwhile, a plan may also be applied again
+ *				while CAN runs.
+ */
+extern T_void applyACF(const T_acfPlan* plan);
+
+#endif /* ACF_H. */
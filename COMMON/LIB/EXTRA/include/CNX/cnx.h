@@ -0,0 +1,409 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* CAN Extended Driver													     */
+/**
+ *	@file		CNX/cnx.h
+ *	@brief		This file contains CNX flags, types, getters, and API functions
+ *				for interrupt-driven CAN reception through a software FIFO and
+ *				CAN bus statistics.
+ *	@details	checkCANReceived copies the data registers of message buffers
+ *				only when polled, so a message buffer receiving twice between
+ *				two polls loses the older frame. The CNX reception ISR instead
+ *				moves every received frame (register-mapped ID, DLC, data and
+ *				timestamp) into a software FIFO as soon as it is received, and
+ *				readCNXFrame pops frames in arrival order. A frame is lost only
+ *				if the FIFO is full (overflow) or if the message buffer received
+ *				again before the ISR could run (overrun); both are counted. <br>
+ *				The CNX transmission ISR counts transmitted frames and measures
+ *				the latency from requestCNXTransmit to transmission completion
+ *				per message buffer, and counts node status transitions. Both
+ *				ISRs feed a sliding window bus load estimate. Statistics are
+ *				gathered in cnxStats, which can be exported through NSC with
+ *				CNX_NSC_ENTRIES. <br>
+ *				With CNX_RX_CALLBACK, a message buffer may have a reception
+ *				callback instead, which the reception ISR calls with the ID,
+ *				DLC and data registers of the message buffer: nothing is copied
+ *				but what the callback reads.
+ *	@code
+ *		initCAN(CAN_DEF_BUS_SPEED, 0xF0U, 0x0FU);
+ *		initCNX(0xF0U, 0x0FU);
+ *		startCAN();
+ *		...
+ *		T_cnxFrame frame;
+ *		while (IS(readCNXFrame(&frame))) {
+ *			...
+ *		}
+ *		requestCNXTransmit();
+ *		...
+ *		// CNX_RX_CALLBACK set
+ *		static T_void onEngine(T_uint8 buffer, T_dword id, T_uint8 dlc,
+ *			volatile T_canid_dtr const * data)
+ *		{
+ *			speed = data->WORD[0];
+ *		}
+ *		setCNXRxCallback(CAN_MB_4, onEngine);
+ *		...
+ *		// every CNX_LOAD_PERIOD_MS
+ *		manageCNXLoad();
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef CNX_H
+#define CNX_H
+
+#include <COM/can.h>
+#include <IO/iot_io.h>
+#include <MCU/cpu.h>
+
+/* ----------------------------------------------------------------------------
+**	CNX Flags.
+*/
+
+/**
+ * 	@def		CNX_FIFO_SIZE
+ *	@brief 		Reception FIFO size in frames (power of 2, up to 128).
+ *	@note		At 1 Mbit/s, a frame takes at least 47 us on the bus, so the
+ *				FIFO must hold the frames received during the longest interval
+ *				between two reads.
+ */
+#ifndef CNX_FIFO_SIZE
+#define CNX_FIFO_SIZE			(16U)
+#endif
+
+/**
+ * 	@def		CNX_TIMESTAMP
+ *	@brief 		Reception timestamp source (IO timer counter by default).
+ */
+#ifndef CNX_TIMESTAMP
+#define CNX_TIMESTAMP()			GetIOT_TCDT()
+#endif
+
+/**
+ * 	@def		CNX_TX_QUEUE
+ *	@brief 		Priority transmission queue use (see CNX/cnxQueue.h), fed by
+ *				CNX_TX_IRQHandler.
+ */
+#ifndef CNX_TX_QUEUE
+#define CNX_TX_QUEUE			(0U)
+#endif
+
+/**
+ * 	@def		CNX_RX_CALLBACK
+ *	@brief 		Reception callback use (see setCNXRxCallback), called by
+ *				CNX_RX_IRQHandler instead of the FIFO copy.
+ */
+#ifndef CNX_RX_CALLBACK
+#define CNX_RX_CALLBACK			(0U)
+#endif
+
+/**
+ * 	@def		CNX_LATE_TICKS
+ *	@brief 		Transmission latency (timestamp ticks) beyond which a frame is
+ *				counted as delayed.
+ *	@note		Set it to one frame time plus the longest expected ISR latency:
+ *				a frame exceeding it waited for the bus (lost arbitration or
+ *				bus busy) or was retransmitted. 0xFFFF disables the count.
+ */
+#ifndef CNX_LATE_TICKS
+#define CNX_LATE_TICKS			(0xFFFFU)
+#endif
+
+/**
+ * 	@def		CNX_BIT_RATE
+ *	@brief 		Bus bit rate (bit/s) used for bus load estimate (the default
+ *				matches CAN_DEF_BUS_SPEED).
+ */
+#ifndef CNX_BIT_RATE
+#define CNX_BIT_RATE			(1000000UL)
+#endif
+
+/**
+ * 	@def		CNX_LOAD_PERIOD_MS
+ *	@brief 		Call period of manageCNXLoad in milliseconds.
+ */
+#ifndef CNX_LOAD_PERIOD_MS
+#define CNX_LOAD_PERIOD_MS		(100U)
+#endif
+
+/**
+ * 	@def		CNX_LOAD_SLOTS
+ *	@brief 		Bus load sliding window length in periods.
+ */
+#ifndef CNX_LOAD_SLOTS
+#define CNX_LOAD_SLOTS			(10U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	CNX Types.
+*/
+
+/**
+ *	@brief		Data structure for CNX received frame.
+ */
+typedef struct {
+	T_dword id;
+	T_canid_dtr data;
+	T_uint16 stamp;
+	T_uint8 buffer;
+	T_uint8 dlc;
+	T_bit extended;
+} T_cnxFrame;
+
+/**
+ *	@brief		Type definition for CNX reception callback.
+ *	@param[in]	buffer	Message buffer index.
+ *	@param[in]	id		Register-mapped ID (see toIDRegMap).
+ *	@param[in]	dlc		Data length code.
+ *	@param[in]	data	Data registers of the message buffer.
+ */
+typedef T_void (*T_cnxRxCallback)(T_uint8 buffer, T_dword id, T_uint8 dlc,
+	volatile T_canid_dtr const * data);
+
+/**
+ *	@brief		Data structure for CNX statistics.
+ *	@note		Counters wrap around. Latencies are in timestamp ticks.
+ */
+typedef struct {
+	T_uint16 txFrames[CAN_MB_SIZE];		/**< transmitted frames */
+	T_uint16 rxFrames[CAN_MB_SIZE];		/**< received frames */
+	T_uint16 txLatency[CAN_MB_SIZE];	/**< last transmission latency */
+	T_uint16 txLatencyMax[CAN_MB_SIZE];	/**< peak transmission latency */
+	T_uint16 txDelayed[CAN_MB_SIZE];	/**< frames beyond CNX_LATE_TICKS */
+	T_uint16 retransmissions;			/**< estimated from TEC rises */
+	T_uint16 warnings;					/**< transitions to warning */
+	T_uint16 passives;					/**< transitions to error passive */
+	T_uint16 busOffs;					/**< transitions to bus off */
+	T_uint16 tecPeak;					/**< peak transmit error counter */
+	T_uint16 recPeak;					/**< peak receive error counter */
+	T_uint16 rxOverflows;				/**< frames dropped on full FIFO */
+	T_uint16 rxOverruns;				/**< frames overwritten in buffers */
+	T_uint16 busLoad;					/**< bus load (per mille) */
+} T_cnxStats;
+
+/* ----------------------------------------------------------------------------
+**	CNX External Variables.
+*/
+
+/**
+ * 	@var		cnxStats
+ *	@brief		CAN bus statistics (updated by CNX ISRs and manageCNXLoad).
+ */
+extern volatile T_cnxStats cnxStats;
+
+/* ----------------------------------------------------------------------------
+**	CNX Getters.
+*/
+
+/**
+ *	@def 		IsCNXFrameAvailable
+ *	@brief		Checks if a received frame is waiting in the FIFO.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsCNXFrameAvailable() \
+	NEQ(countCNXFrames(), 0U)
+
+/**
+ *	@def 		GetWordCNXBusLoad
+ *	@brief		Gets bus load over the sliding window.
+ *	@param		.
+ *	@return		bus load (per mille, word).
+ */
+#define GetWordCNXBusLoad() \
+	(cnxStats.busLoad)
+
+/**
+ *	@def 		CNX_NSC_ENTRIES
+ *	@brief		Read-only NSC table entries exporting cnxStats from an address
+ *				(14 consecutive addresses, per message buffer arrays first).
+ *	@param		BASE		First address.
+ *	@return		table entries.
+ */
+#define CNX_NSC_ENTRIES(BASE) \
+	NSC_ARRAY((BASE) + 0U, cnxStats.txFrames, NSC_UINT, NSC_ACC_RD), \
+	NSC_ARRAY((BASE) + 1U, cnxStats.rxFrames, NSC_UINT, NSC_ACC_RD), \
+	NSC_ARRAY((BASE) + 2U, cnxStats.txLatency, NSC_UINT, NSC_ACC_RD), \
+	NSC_ARRAY((BASE) + 3U, cnxStats.txLatencyMax, NSC_UINT, NSC_ACC_RD), \
+	NSC_ARRAY((BASE) + 4U, cnxStats.txDelayed, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 5U, cnxStats.retransmissions, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 6U, cnxStats.warnings, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 7U, cnxStats.passives, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 8U, cnxStats.busOffs, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 9U, cnxStats.tecPeak, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 10U, cnxStats.recPeak, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 11U, cnxStats.rxOverflows, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 12U, cnxStats.rxOverruns, NSC_UINT, NSC_ACC_RD), \
+	NSC_VARIABLE((BASE) + 13U, cnxStats.busLoad, NSC_UINT, NSC_ACC_RD)
+
+/* ----------------------------------------------------------------------------
+**	CNX API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initCNX(T_byte, T_byte)
+ *	@brief 		Initialize FIFO reception and statistics, then enable reception,
+ *				transmission and node status interrupts.
+ * 	@pre		CAN must be initialized first.
+ * 	@param[in]	rxBufferBits 	Reception message buffer bits.
+ * 	@param[in]	txBufferBits 	Transmission message buffer bits (the ones
+ *								requestCANTransmit requests).
+ * 	@return		.
+ */
+extern T_void initCNX(T_byte rxBufferBits, T_byte txBufferBits);
+
+/**
+ * 	@fn 		T_bit readCNXFrame(T_cnxFrame*)
+ *	@brief 		Pops the oldest received frame.
+ * 	@param[out]	frame		Received frame (bit-ordered ID).
+ * 	@return		frame availability.
+ */
+extern T_bit readCNXFrame(T_cnxFrame* frame);
+
+/**
+ * 	@fn 		T_uint8 countCNXFrames(T_void)
+ *	@brief 		Counts frames waiting in the FIFO.
+ * 	@param		.
+ * 	@return		waiting frames.
+ */
+extern T_uint8 countCNXFrames(T_void);
+
+/**
+ * 	@fn 		T_uint16 countCNXOverflows(T_void)
+ *	@brief 		Counts frames dropped because the FIFO was full (wraps around).
+ * 	@param		.
+ * 	@return		dropped frames.
+ */
+extern T_uint16 countCNXOverflows(T_void);
+
+/**
+ * 	@fn 		T_uint16 countCNXOverruns(T_void)
+ *	@brief 		Counts frames overwritten in a message buffer before the ISR
+ *				could move them (wraps around).
+ * 	@param		.
+ * 	@return		overwritten frames.
+ */
+extern T_uint16 countCNXOverruns(T_void);
+
+/**
+ * 	@fn 		T_void setCNXRxCallback(T_canMsgBuf, T_cnxRxCallback)
+ *	@brief 		Sets the reception callback of a message buffer.
+ * 	@param[in]	msgBuf		Message buffer (set up by setupCANMessageBuffer).
+ * 	@param[in]	callback	Reception callback (NULL for the FIFO).
+ * 	@return		.
+ *	@note		The callback runs in CNX_RX_IRQHandler and reads the data
+ *				registers in place, so it must copy what it needs (i.e.
+ *				data->BYTE[IDX], or an Unpack macro function generated by
+ *				sdb_gen on *data) and return quickly: the message buffer is
+ *				released when it returns. Frames of the message buffer no
+ *				longer go through the FIFO. Needs CNX_RX_CALLBACK.
+ */
+#if CNX_RX_CALLBACK
+extern T_void setCNXRxCallback(T_canMsgBuf msgBuf, T_cnxRxCallback callback);
+#endif
+
+/**
+ * 	@fn 		T_void stampCNXTransmit(T_byte)
+ *	@brief 		Starts latency measurement of message buffers.
+ * 	@param[in]	bufferBits 	Message buffer bits about to be requested.
+ * 	@return		.
+ *	@note		Call it right before RequestCANTransmit when not using
+ *				requestCNXTransmit.
+ */
+extern T_void stampCNXTransmit(T_byte bufferBits);
+
+/**
+ * 	@fn 		T_void stampCNXBuffer(T_uint8, T_uint16)
+ *	@brief 		Starts latency measurement of a message buffer from an earlier
+ *				timestamp (i.e. when the frame was queued).
+ * 	@param[in]	buffer 		Message buffer index.
+ * 	@param[in]	stamp 		Timestamp (CNX_TIMESTAMP).
+ * 	@return		.
+ */
+extern T_void stampCNXBuffer(T_uint8 buffer, T_uint16 stamp);
+
+/**
+ * 	@fn 		T_void requestCNXTransmit(T_void)
+ *	@brief 		Starts latency measurement of transmission message buffers,
+ *				then calls requestCANTransmit.
+ * 	@param		.
+ * 	@return		.
+ */
+extern T_void requestCNXTransmit(T_void);
+
+/**
+ * 	@fn 		T_void manageCNXLoad(T_void)
+ *	@brief 		Closes a bus load period and updates the sliding window estimate.
+ * 	@param		.
+ * 	@return		.
+ *	@note		Call it every CNX_LOAD_PERIOD_MS. Only frames seen by the node
+ *				(transmitted or accepted) are counted, without stuff bits, so
+ *				the estimate is a lower bound.
+ */
+extern T_void manageCNXLoad(T_void);
+
+/**
+ * 	@fn 		T_void clearCNXStats(T_void)
+ *	@brief 		Clears statistics (counters, latencies, peaks and bus load).
+ * 	@param		.
+ * 	@return		.
+ */
+extern T_void clearCNXStats(T_void);
+
+/**
+ * 	@fn 		T_void CNX_RX_IRQHandler(T_void)
+ *	@brief		Moves every received frame into the FIFO, or passes it to the
+ *				reception callback of its message buffer.
+ *  @param		.
+ *  @return		.
+ *  @note 		Replaces CANRX_IRQHandler on its interrupt vector. Thus,
+ *  			checkCANReceived gets nothing and frames must be read through
+ *  			readCNXFrame.
+ */
+#if USE_CNX_ISR
+#if NOSAVEREG_CNX_ISR
+NOSAVEREG
+#endif
+extern ISR(CNX_RX_IRQHandler);
+#endif
+
+/**
+ * 	@fn 		T_void CNX_TX_IRQHandler(T_void)
+ *	@brief		Counts transmitted frames and their latency, and node status
+ *				transitions, then clears transmit completion and node status
+ *				transition bits.
+ *  @param		.
+ *  @return		.
+ *  @note 		Replaces CANTX_IRQHandler on its interrupt vector and keeps its
+ *  			behaviour: CAN will (re)start if bus off node status yields bus
+ *  			halt.
+ */
+#if USE_CNX_ISR
+#if NOSAVEREG_CNX_ISR
+NOSAVEREG
+#endif
+extern ISR(CNX_TX_IRQHandler);
+#endif
+
+#endif /* CNX_H. */
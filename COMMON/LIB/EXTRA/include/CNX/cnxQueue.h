@@ -0,0 +1,144 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* CAN Extended Driver Priority Transmission Queue						     */
+/**
+ *	@file		CNX/cnxQueue.h
+ *	@brief		This file contains CNX queue flags, getters, and API functions
+ *				for transmitting frames in CAN ID priority order.
+ *	@details	requestCANTransmit requests all transmission buffers at once,
+ *				and the controller transmits pending message buffers lowest
+ *				number first regardless of their ID, so an urgent frame may
+ *				wait behind less urgent frames of the same node. sendCNXFrame
+ *				instead queues frames by arbitration priority (lower ID first,
+ *				standard before extended on equal base ID, then first in first
+ *				out) and feeds a pool of message buffers so that pending
+ *				buffers, taken in number order, always hold frames in priority
+ *				order. A queued frame more urgent than a pending one reclaims
+ *				its message buffer through transmission cancel, and the
+ *				reclaimed frame goes back to the queue. The queue is fed again
+ *				on every transmission completion (CNX_TX_IRQHandler), so the
+ *				most urgent frame waits at most for the frame already on the
+ *				bus, which cannot be cancelled.
+ *	@attention	CNX_TX_QUEUE must be set (library wide) so that
+ *				CNX_TX_IRQHandler feeds the queue. Pool message buffers must be
+ *				left out of the buffer bits given to initCAN and initCNX.
+ *	@code
+ *		initCAN(CAN_DEF_BUS_SPEED, 0xF0U, 0x00U);
+ *		initCNX(0xF0U, 0x00U);
+ *		initCNXQueue(0x0FU);			// message buffers 0 to 3
+ *		startCAN();
+ *		...
+ *		T_cnxFrame frame;
+ *		frame.id = 0x123UL << 18U;		// bit-ordered standard ID
+ *		frame.extended = FALSE;
+ *		frame.dlc = 2U;
+ *		frame.data.WORD[0] = setpoint;
+ *		(T_void)sendCNXFrame(&frame);
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef CNX_QUEUE_H
+#define CNX_QUEUE_H
+
+#include <CNX/cnx.h>
+
+/* ----------------------------------------------------------------------------
+**	CNX Queue Flags.
+*/
+
+/**
+ * 	@def		CNX_QUEUE_SIZE
+ *	@brief 		Transmission queue size in frames (up to 255).
+ *	@note		A full queue rejects new frames and keeps less urgent frames in
+ *				their message buffers instead of reclaiming them.
+ */
+#ifndef CNX_QUEUE_SIZE
+#define CNX_QUEUE_SIZE			(16U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	CNX Queue Getters.
+*/
+
+/**
+ *	@def 		IsCNXQueueFull
+ *	@brief		Checks if the transmission queue rejects new frames.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsCNXQueueFull() \
+	GEQ(countCNXQueued(), CNX_QUEUE_SIZE)
+
+/* ----------------------------------------------------------------------------
+**	CNX Queue API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initCNXQueue(T_byte)
+ *	@brief 		Initialize the transmission queue and its message buffer pool.
+ * 	@pre		CNX must be initialized first.
+ * 	@param[in]	bufferBits 	Pool message buffer bits.
+ * 	@return		.
+ */
+extern T_void initCNXQueue(T_byte bufferBits);
+
+/**
+ * 	@fn 		T_bit sendCNXFrame(const T_cnxFrame*)
+ *	@brief 		Queues a frame and feeds the message buffer pool.
+ * 	@param[in]	frame		Frame to transmit (bit-ordered ID, buffer and
+ *							stamp ignored).
+ * 	@return		frame queued (FALSE if the queue is full).
+ */
+extern T_bit sendCNXFrame(const T_cnxFrame* frame);
+
+/**
+ * 	@fn 		T_uint8 countCNXQueued(T_void)
+ *	@brief 		Counts frames waiting in the queue (not yet in message buffers).
+ * 	@param		.
+ * 	@return		waiting frames.
+ */
+extern T_uint8 countCNXQueued(T_void);
+
+/**
+ * 	@fn 		T_uint16 countCNXPreemptions(T_void)
+ *	@brief 		Counts frames taken back from message buffers for more urgent
+ *				frames (wraps around).
+ * 	@param		.
+ * 	@return		reclaimed frames.
+ */
+extern T_uint16 countCNXPreemptions(T_void);
+
+/**
+ * 	@fn 		T_void feedCNXQueue(T_byte)
+ *	@brief 		Releases transmitted message buffers, then loads queued frames
+ *				into the pool, reclaiming message buffers of less urgent frames.
+ * 	@param[in]	completed 	Transmitted message buffer bits.
+ * 	@return		.
+ *	@note		Called by CNX_TX_IRQHandler and by sendCNXFrame (interrupts
+ *				disabled).
+ */
+extern T_void feedCNXQueue(T_byte completed);
+
+#endif /* CNX_QUEUE_H. */
@@ -534,6 +534,80 @@ typedef struct fsm_t T_fsm;
 	} \
 }
 
+/**
+ *	@def		FSM_CASE
+ *	@brief		FSM specialized dispatcher state case (used by FSM_DEFINE).
+ *	@param		INDEX	FSM state index (byte).
+ *	@param		NAME	FSM state function name.
+ *	@return		.
+ */
+#define FSM_CASE(INDEX, NAME) \
+	case (INDEX): \
+		NAME(&FSM_THIS); \
+		break;
+
+/**
+ *	@def		FSM_DISPATCHER
+ *	@brief		FSM specialized dispatcher declaration macro alias.
+ *	@param		NAME	FSM specialized dispatcher function name.
+ *	@return		(bit-type).
+ */
+#define FSM_DISPATCHER(NAME)			T_bit NAME(T_fsm* automaton)
+
+/**
+ *	@def		FSM_DEFINE
+ *	@brief		Defines a specialized FSM dispatcher which executes single state
+ *				(with/without chained transition) exactly as dispatchFSM does,
+ *				but resolves state functions at compile time through a switch
+ *				over state indices instead of the state table callbacks.
+ *	@param		NAME			FSM specialized dispatcher function name.
+ *	@param		STATES			FSM state list macro which applies its only
+ *								argument to every (INDEX, NAME) state pair.
+ *	@param		PRE_PROCESS		FSM preprocessing statement (or FSM_NONE).
+ *	@param		POST_PROCESS	FSM postprocessing statement (or FSM_NONE).
+ *	@return		(function definition returning dispatch success, FALSE on
+ *				an unlisted state index like dispatchFSM on a state without
+ *				callback).
+ *	@note		Direct calls let the compiler inline static state functions and
+ *				FSM_NONE hooks leave no code behind, which spares the far
+ *				indirect calls and null checks of dispatchFSM. Set up the FSM
+ *				through initFSM as usual (state table is still required for
+ *				state names, bounds and logging) but leave the pre and post
+ *				functions unset since they are never called from here.
+ *	@note		Example:
+ *				#define LED_STATES(STATE) \
+ *					STATE(S_LED_START, LED_START) \
+ *					STATE(S_LED_POS_1, LED_POS_1)
+ *				static FSM_DEFINE(dispatchLED, LED_STATES,
+ *					LED_PREPROC(&FSM_THIS), FSM_NONE)
+ *	@note		HOST/FSM/fsmd_bench.c checks that both dispatchers leave the
+ *				same FSM control block and data, and compares their speed.
+ *	@warning	The null-state (FSM_SELF) must not be listed.
+ */
+#define FSM_DEFINE(NAME, STATES, PRE_PROCESS, POST_PROCESS) \
+FSM_DISPATCHER(NAME) \
+{ \
+	/* set current state index to next state index */ \
+	FSM_THIS.current = FSM_THIS.privileged.next; \
+	/* execute state preprocess */ \
+	PRE_PROCESS; \
+	do { \
+		/* clear state transition chain request */ \
+		FSM_THIS.privileged.transitChain = FALSE; \
+		/* execute current state */ \
+		switch (FSM_THIS.current) { \
+			STATES(FSM_CASE) \
+			default: \
+				/* unlisted state (no state function) */ \
+				return FALSE; \
+		} \
+	} while (IS(FSM_THIS.privileged.transitChain)); \
+	/* execute state postprocess */ \
+	POST_PROCESS; \
+	\
+	return TRUE; \
+}
+
 /* ----------------------------------------------------------------------------
 **	API Functions.
 */
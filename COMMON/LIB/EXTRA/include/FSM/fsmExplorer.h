@@ -0,0 +1,273 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Finite State Machine Explorer											 */
+/**
+ *	@file		FSM/fsmExplorer.h
+ *	@brief		This file contains flags, types, getters, and API functions
+ *				for exhaustive breadth-first exploration of finite state
+ *				machines (FSMs) driven by nondeterministic inputs.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef FSMEXPLORER_H
+#define FSMEXPLORER_H
+
+#include <FSM/fsm.h>
+
+/* ----------------------------------------------------------------------------
+**	Flags.
+*/
+
+/**
+ * 	@def		FSMX_MAX_CHANNELS
+ * 	@brief		Maximum number of nondeterministic input channels.
+ */
+#define FSMX_MAX_CHANNELS				(8U)
+
+/**
+ * 	@def		FSMX_MAP_SIZE
+ * 	@brief		Byte size of a state index bitmap (covers all 256 indices).
+ */
+#define FSMX_MAP_SIZE					(32U)
+
+/**
+ * 	@def		FSMX_EMPTY
+ * 	@brief		Empty slot marker of the visited configuration table.
+ */
+#define FSMX_EMPTY						(0xFFFFFFFFUL)
+
+/* ----------------------------------------------------------------------------
+**	Types.
+*/
+
+/**
+ * 	@brief		Defined type for FSM explorer input value (default: 32 bits).
+ */
+typedef T_sint32 T_fsmxValue;
+
+/**
+ * 	@brief		Defined type for FSM explorer counters and slots (default: 32 bits).
+ */
+typedef T_uint32 T_fsmxCount;
+
+/**
+ * 	@brief		Defined type for FSM explorer configuration hash (default: 32 bits).
+ */
+typedef T_uint32 T_fsmxHash;
+
+/**
+ *	@brief		Data structure for FSM explorer input channel (value domain).
+ *	@note		Each channel stands for one hardware reading (i.e. readDigital,
+ *				readAnalog) and lists every value the reading may return. Keep
+ *				domains small since every combination of every channel is
+ *				evaluated per explored configuration.
+ */
+typedef struct {
+	const T_fsmxValue* values;
+	T_uint8 valueCount;
+} T_fsmxChannel;
+
+/**
+ *	@brief		Data structure for FSM explorer findings.
+ */
+typedef struct {
+	/* exploration counters */
+	T_fsmxCount explored;
+	T_fsmxCount dispatched;
+	T_fsmxCount chainLoops;
+	/* exploration control */
+	T_bit truncated;
+	/* state index bitmaps */
+	T_uint8 reached[FSMX_MAP_SIZE];
+	T_uint8 exited[FSMX_MAP_SIZE];
+	T_uint8 looped[FSMX_MAP_SIZE];
+} T_fsmxReport;
+
+/**
+ *	@brief		Data structure for FSM explorer control block.
+ */
+typedef struct {
+	/* explored state machine */
+	T_fsm* automaton;
+	/* nondeterministic inputs */
+	const T_fsmxChannel* channels;
+	T_uint8 channelCount;
+	T_fsmxCount combos;
+	/* configuration storage (breadth-first queue) */
+	T_uint8* pool;
+	T_fsmxCount poolCapacity;
+	/* visited configuration table (open addressing) */
+	T_fsmxCount* table;
+	T_fsmxCount tableSize;
+} T_fsmExplorer;
+
+/* ----------------------------------------------------------------------------
+**	Getters.
+*/
+
+/**
+ *	@def 		GetFSMXConfigSize
+ *	@brief		Gets the byte size of a single stored configuration.
+ *	@param		FSM		FSM control block handler.
+ *	@return		configuration size (word).
+ *	@note		Use it to size the configuration pool of the explorer (pool
+ *				capacity multiplied by configuration size).
+ */
+#define GetFSMXConfigSize(FSM) \
+	(SzBytes_(T_fsm) + (FSM).fsmDataSize)
+
+/**
+ *	@def 		IsFSMXStateReached
+ *	@brief		Checks if a state was executed in any explored configuration.
+ *	@param		REPORT	FSM explorer report.
+ *	@param[in]	STATE	FSM state index (byte).
+ *	@return		boolean.
+ */
+#define IsFSMXStateReached(REPORT, STATE) \
+	IS(ReadBit((REPORT).reached[(STATE) >> 3U], (STATE) & 7U))
+
+/**
+ *	@def 		IsFSMXStateDeadEnd
+ *	@brief		Checks if a reached state never transits to any other state.
+ *	@param		REPORT	FSM explorer report.
+ *	@param[in]	STATE	FSM state index (byte).
+ *	@return		boolean.
+ *	@note		Final states (FSM_LAST with FSM_SELF) are expected dead ends.
+ */
+#define IsFSMXStateDeadEnd(REPORT, STATE) \
+	(IsFSMXStateReached(REPORT, STATE) \
+		&& NOT(ReadBit((REPORT).exited[(STATE) >> 3U], (STATE) & 7U)))
+
+/**
+ *	@def 		IsFSMXStateChainLooped
+ *	@brief		Checks if a state re-entered itself within a single dispatch
+ *				through chained transitions (StateRequestTransitChain).
+ *	@param		REPORT	FSM explorer report.
+ *	@param[in]	STATE	FSM state index (byte).
+ *	@return		boolean.
+ */
+#define IsFSMXStateChainLooped(REPORT, STATE) \
+	IS(ReadBit((REPORT).looped[(STATE) >> 3U], (STATE) & 7U))
+
+/* ----------------------------------------------------------------------------
+**	API Functions.
+*/
+
+/**
+ *	@fn			T_void initFSMExplorer(T_fsmExplorer*, T_fsm*, const T_fsmxChannel*,
+ *					T_uint8, T_uint8*, T_fsmxCount, T_fsmxCount*, T_fsmxCount)
+ *	@brief 		Initialize an FSM explorer.
+ *	@param		explorer		FSM explorer handler.
+ *	@param		automaton		Initialized FSM to explore (its current
+ *								configuration is the exploration root).
+ *	@param[in]	channels		Nondeterministic input channels.
+ *	@param[in]	channelCount	Input channel count (up to FSMX_MAX_CHANNELS).
+ *	@param		pool			Configuration storage (poolCapacity times
+ *								GetFSMXConfigSize bytes).
+ *	@param[in]	poolCapacity	Maximum configurations to store.
+ *	@param		table			Visited configuration table.
+ *	@param[in]	tableSize		Table entry count (power of 2, preferably
+ *								twice the pool capacity).
+ *	@return		.
+ *	@pre		Initialize the FSM (initFSM, setFSMPreAndPostFunctions) and set
+ *				its data size (SetFSMDataSize) first.
+ */
+extern T_void initFSMExplorer(T_fsmExplorer* explorer, T_fsm* automaton,
+	const T_fsmxChannel* channels, T_uint8 channelCount, T_uint8* pool,
+	T_fsmxCount poolCapacity, T_fsmxCount* table, T_fsmxCount tableSize);
+
+/**
+ *	@fn			T_bit runFSMExplorer(T_fsmExplorer*, T_fsmxReport*)
+ *	@brief 		Explores every configuration reachable from the root
+ *				breadth-first under every combination of input values.
+ *	@details	A configuration is the FSM control block together with its FSM
+ *				data. Each configuration is restored, dispatched once per input
+ *				combination, and its successor is hashed and kept only if it was
+ *				never seen before. Dispatching follows dispatchFSM (preprocess,
+ *				chained state callbacks, then postprocess) but stops a chain that
+ *				re-enters a state within the same dispatch and reports it
+ *				instead of looping forever.
+ *	@param		explorer	FSM explorer handler.
+ *	@param[out]	report		Exploration findings.
+ *	@return		exploration completed (FALSE if storage ran out).
+ *	@note		The FSM is left at its root configuration on return.
+ *	@warning	Only the control block and the FSM data are part of a
+ *				configuration. Static variables used by state callbacks are
+ *				not restored between dispatches.
+ */
+extern T_bit runFSMExplorer(T_fsmExplorer* explorer, T_fsmxReport* report);
+
+/**
+ *	@fn			T_bit dispatchFSMExplorer(T_fsmExplorer*, const T_uint8*,
+ *					T_fsmxCount, T_uint8*, T_fsmxReport*)
+ *	@brief 		Restores a configuration, dispatches it once under an input
+ *				combination (as runFSMExplorer does), and saves the successor.
+ *	@param		explorer	FSM explorer handler.
+ *	@param[in]	config		Configuration bytes (GetFSMXConfigSize).
+ *	@param[in]	combo		Input combination index (below explorer combos,
+ *								first channel varies fastest).
+ *	@param[out]	successor	Successor configuration bytes.
+ *	@param[out]	report		Exploration findings (dispatch counter, state
+ *								bitmaps and chain loops are updated).
+ *	@return		successor valid (FALSE on chain loop).
+ *	@note		It is the building block for drivers keeping their own
+ *				visited set (i.e. several workers sharing one table), each
+ *				worker owning its FSM, FSM data and explorer.
+ */
+extern T_bit dispatchFSMExplorer(T_fsmExplorer* explorer, const T_uint8* config,
+	T_fsmxCount combo, T_uint8* successor, T_fsmxReport* report);
+
+/**
+ *	@fn			T_fsmxHash hashFSMExplorerConfig(const T_uint8*, T_uint16)
+ *	@brief 		Computes the FNV-1a hash of a configuration.
+ *	@param[in]	config	Configuration bytes.
+ *	@param[in]	size	Configuration size (GetFSMXConfigSize).
+ *	@return		hash.
+ */
+extern T_fsmxHash hashFSMExplorerConfig(const T_uint8* config, T_uint16 size);
+
+/**
+ *	@fn			T_fsmxValue readFSMExplorerInput(T_uint8)
+ *	@brief 		Reads the value assigned to an input channel for the dispatch
+ *				being explored.
+ *	@param[in]	channel		Input channel index.
+ *	@return		input value (zero if channel is out of range).
+ *	@note		Hardware readings of the explored FSM (readDigital, readAnalog)
+ *				must be stubbed on the host to return this value. Hardware
+ *				outputs (writeDigital, pulseOutByFrequency) can be stubbed empty.
+ */
+extern T_fsmxValue readFSMExplorerInput(T_uint8 channel);
+
+/**
+ *	@fn			T_void logFSMExplorerReport(const T_fsm*, const T_fsmxReport*)
+ *	@brief		Prints (through standard output) exploration counters followed
+ *				by unreachable, dead-end and chain-looped states with their
+ *				names.
+ *	@param[in]	automaton	Explored FSM.
+ *	@param[in]	report		Exploration findings.
+ *	@return		.
+ */
+extern T_void logFSMExplorerReport(const T_fsm* automaton, const T_fsmxReport* report);
+
+#endif /* FSMEXPLORER_H. */
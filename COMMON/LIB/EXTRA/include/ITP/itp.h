@@ -0,0 +1,294 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* ISO-TP Transport Layer												     */
+/**
+ *	@file		ITP/itp.h
+ *	@brief		This file contains ITP flags, types, getters, and API functions
+ *				for ISO 15765-2 (ISO-TP) segmentation and reassembly of payloads
+ *				up to 4095 bytes over CAN.
+ *	@details	A payload of 7 bytes at most is sent as a single frame (SF).
+ *				A larger payload is sent as a first frame (FF, 6 bytes) and
+ *				then consecutive frames (CF, 7 bytes each, sequence number
+ *				modulo 16) paced by the flow control frame (FC) of the
+ *				receiver: block size (BS, consecutive frames before the next FC,
+ *				0 for none) and separation time (STmin, minimum gap between
+ *				consecutive frames, 0 to 127 ms or 100 to 900 us as 0xF1 to
+ *				0xF9). Normal addressing is used with 8-byte frames padded with
+ *				ITP_PADDING. Each frame is sent with the extended ID
+ *				formattedCANID(ITP_RX_BUFFER, prefix, ITP_SUFFIX) where prefix
+ *				is the sending node prefix, and is received in ITP_RX_BUFFER
+ *				with full-bit comparison against the peer prefix. <br>
+ *				Nothing ever waits: manageITP is meant to be called from a
+ *				periodic timer ISR (or task) of about 1 ms. Each call handles
+ *				the received frame (if any), sends at most one frame when the
+ *				transmission buffer is free and STmin elapsed, and checks the
+ *				N_Bs and N_Cr timeouts (ITP_TIMEOUT_MS). A frame received by
+ *				other means (i.e. from the CNX FIFO) may be given to
+ *				receiveITPFrame instead, within the same interrupt level as
+ *				manageITP. <br>
+ *				By default ITP_RX_BUFFER is polled by manageITP, so a frame
+ *				received before the previous one was polled overwrites it. The
+ *				STmin requested to the peer is therefore raised to
+ *				ITP_POLL_MS + 1 (one more for the phase between both timers),
+ *				which bounds reception to about 3.5 kB/s at 1 ms. With ITP_CNX,
+ *				the CNX reception ISR copies every frame into a ring of
+ *				ITP_RX_FRAMES emptied by manageITP, so any STmin may be
+ *				requested as long as the ring holds the frames received between
+ *				two calls (a whole block when STmin is below ITP_POLL_MS). <br>
+ *				HOST/ITP/itp_loop.c measures transfers of this implementation
+ *				against a simulated peer on a simulated bus.
+ *	@attention	Both buffers must be left out of the buffer bits given to
+ *				initCAN (and to initCNX, unless frames are handed over through
+ *				receiveITPFrame). With ITP_CNX, ITP_RX_BUFFER must be among the
+ *				reception buffer bits given to initCNX and CNX_RX_CALLBACK must
+ *				be set. Transmission is bounded by one frame per call of
+ *				manageITP (about 7 kB/s at 1 ms when the peer grants STmin 0).
+ *	@code
+ *		initCAN(CAN_DEF_BUS_SPEED, 0x0FU, 0xC0U);
+ *		initITP(NODE_A_PREFIX, NODE_B_PREFIX, 8U, 2U);
+ *		startCAN();
+ *		...
+ *		(T_void)sendITP(blob, SzBytes_(blob));
+ *		...
+ *		if (IS(IsITPReceived())) {
+ *			length = readITP(config, SzBytes_(config));
+ *		}
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef ITP_H
+#define ITP_H
+
+#include <COM/can.h>
+#include <TMR/tbt.h>
+
+/**
+ * 	@def		ITP_CNX
+ *	@brief 		Reception through the CNX reception ISR (see CNX/cnx.h) instead
+ *				of polling.
+ */
+#ifndef ITP_CNX
+#define ITP_CNX					(0U)
+#endif
+
+#if ITP_CNX
+#include <CNX/cnx.h>
+#endif
+
+/* ----------------------------------------------------------------------------
+**	ITP Flags.
+*/
+
+/**
+ * 	@def		ITP_TX_BUFFER
+ *	@brief 		Message buffer transmitting frames.
+ */
+#ifndef ITP_TX_BUFFER
+#define ITP_TX_BUFFER			CAN_MB_5
+#endif
+
+/**
+ * 	@def		ITP_RX_BUFFER
+ *	@brief 		Message buffer receiving frames (same on every node).
+ */
+#ifndef ITP_RX_BUFFER
+#define ITP_RX_BUFFER			CAN_MB_4
+#endif
+
+/**
+ * 	@def		ITP_SUFFIX
+ *	@brief 		Extended ID suffix of frames (both directions).
+ */
+#ifndef ITP_SUFFIX
+#define ITP_SUFFIX				(0x0000U)
+#endif
+
+/**
+ * 	@def		ITP_MAX_SIZE
+ *	@brief 		Reception buffer size in bytes (up to 4095).
+ */
+#ifndef ITP_MAX_SIZE
+#define ITP_MAX_SIZE			(256U)
+#endif
+
+/**
+ * 	@def		ITP_TIMEOUT_MS
+ *	@brief 		N_Bs (flow control) and N_Cr (consecutive frame) timeout in
+ *				milliseconds.
+ */
+#ifndef ITP_TIMEOUT_MS
+#define ITP_TIMEOUT_MS			(1000U)
+#endif
+
+/**
+ * 	@def		ITP_MAX_WAIT
+ *	@brief 		Maximum consecutive flow control wait frames (N_WFTmax).
+ */
+#ifndef ITP_MAX_WAIT
+#define ITP_MAX_WAIT			(8U)
+#endif
+
+/**
+ * 	@def		ITP_POLL_MS
+ *	@brief 		Call period of manageITP in milliseconds (polled reception
+ *				raises the requested STmin above it).
+ */
+#ifndef ITP_POLL_MS
+#define ITP_POLL_MS				(1U)
+#endif
+
+/**
+ * 	@def		ITP_RX_FRAMES
+ *	@brief 		Reception ring size in frames with ITP_CNX (power of 2, up to
+ *				128).
+ */
+#ifndef ITP_RX_FRAMES
+#define ITP_RX_FRAMES			(16U)
+#endif
+
+/**
+ * 	@def		ITP_PADDING
+ *	@brief 		Value of unused bytes of a frame.
+ */
+#ifndef ITP_PADDING
+#define ITP_PADDING				(0xCCU)
+#endif
+
+/**
+ * 	@def		ITP_MILLIS
+ *	@brief 		Millisecond time source.
+ */
+#ifndef ITP_MILLIS
+#define ITP_MILLIS()			GetDWordTBTMillis()
+#endif
+
+/* ----------------------------------------------------------------------------
+**	ITP Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for ITP transfer status.
+ */
+typedef enum {
+	ITP_IDLE,					/**< no transfer */
+	ITP_BUSY,					/**< transfer in progress */
+	ITP_DONE,					/**< transfer complete */
+	ITP_TIMEOUT,				/**< N_Bs or N_Cr timeout (or too many waits) */
+	ITP_OVERFLOW,				/**< payload too large for the receiver */
+	ITP_SEQUENCE				/**< consecutive frame out of sequence */
+} T_itpStatus;
+
+/* ----------------------------------------------------------------------------
+**	ITP Getters.
+*/
+
+/**
+ *	@def 		IsITPTransmitting
+ *	@brief		Checks if a payload is being transmitted.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsITPTransmitting() \
+	EQU(getITPTxStatus(), ITP_BUSY)
+
+/**
+ *	@def 		IsITPReceived
+ *	@brief		Checks if a received payload is waiting to be read.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsITPReceived() \
+	EQU(getITPRxStatus(), ITP_DONE)
+
+/* ----------------------------------------------------------------------------
+**	ITP API Functions.
+*/
+
+/**
+ *	@fn			T_void initITP(T_byte, T_byte, T_uint8, T_uint8)
+ *	@brief 		Initialize ISO-TP and its message buffers.
+ *	@pre		CAN must be initialized first.
+ *	@param[in]	txPrefix	Prefix of frames transmitted by this node.
+ *	@param[in]	rxPrefix	Prefix of frames transmitted by the peer.
+ *	@param[in]	blockSize	Block size requested to the peer (0 for none).
+ *	@param[in]	stMin		Separation time requested to the peer (raw, raised
+ *							to ITP_POLL_MS + 1 ms unless ITP_CNX).
+ *	@return		.
+ */
+extern T_void initITP(T_byte txPrefix, T_byte rxPrefix, T_uint8 blockSize, T_uint8 stMin);
+
+/**
+ *	@fn			T_bit sendITP(const T_uint8*, T_uint16)
+ *	@brief 		Starts the transmission of a payload.
+ *	@param[in]	pData	Payload (must stay unchanged until transmitted).
+ *	@param[in]	len		Payload size in bytes (1 to 4095).
+ *	@return		start status (FALSE if busy or invalid size).
+ */
+extern T_bit sendITP(const T_uint8* pData, T_uint16 len);
+
+/**
+ *	@fn			T_uint16 readITP(T_uint8*, T_uint16)
+ *	@brief 		Reads the received payload and releases the reception buffer.
+ *	@param[out]	pDest	Payload destination.
+ *	@param[in]	size	Destination size in bytes (excess is discarded).
+ *	@return		payload size (zero if none).
+ */
+extern T_uint16 readITP(T_uint8* pDest, T_uint16 size);
+
+/**
+ *	@fn			T_void receiveITPFrame(const T_uint8*, T_uint8)
+ *	@brief 		Processes a received frame.
+ *	@param[in]	pData	Frame data.
+ *	@param[in]	dlc		Frame data length.
+ *	@return		.
+ */
+extern T_void receiveITPFrame(const T_uint8* pData, T_uint8 dlc);
+
+/**
+ *	@fn			T_void manageITP(T_void)
+ *	@brief 		Processes received frame, transmits next frame and checks
+ *				timeouts.
+ *	@param		.
+ *	@return		.
+ */
+extern T_void manageITP(T_void);
+
+/**
+ *	@fn			T_itpStatus getITPTxStatus(T_void)
+ *	@brief 		Gets status of the last transmission.
+ *	@param		.
+ *	@return		transmission status.
+ */
+extern T_itpStatus getITPTxStatus(T_void);
+
+/**
+ *	@fn			T_itpStatus getITPRxStatus(T_void)
+ *	@brief 		Gets status of the last reception.
+ *	@param		.
+ *	@return		reception status.
+ */
+extern T_itpStatus getITPRxStatus(T_void);
+
+#endif /* ITP_H. */
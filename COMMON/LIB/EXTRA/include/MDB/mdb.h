@@ -0,0 +1,179 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* RS-485 Multi-Drop Bus													     */
+/**
+ *	@file		MDB/mdb.h
+ *	@brief		This file contains MDB flags, types, getters, and API functions
+ *				for RS-485 multi-drop communication through 9-bit address frames.
+ *	@details	SER must run in asynchronous multiprocessor mode so that every
+ *				frame carries an address / data (A/D) bit. The master selects a
+ *				node by sending its address as an address frame, then sends data
+ *				frames to it. Every node still takes a receive interrupt per
+ *				frame (the UART has no hardware address match), but MDB_IRQHandler
+ *				discards data frames of unselected nodes right after reading the
+ *				data register, so that no buffering nor message parsing is spent
+ *				on traffic meant for other nodes. Data frames of the selected
+ *				node go to the SER reception buffer, so that requests are read
+ *				through SER receiving functions as usual (i.e. by
+ *				manageNSCRequest or NSCBinaryMode). A node stays selected until
+ *				another address frame arrives or releaseMDB is called (i.e. once
+ *				the NSC session gets back to NSC_SSN_IDLE).
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef MDB_H
+#define MDB_H
+
+#include <COM/ser.h>
+
+/* ----------------------------------------------------------------------------
+**	MDB Flags.
+*/
+
+/**
+ * 	@def		MDB_BROADCAST_ADDRESS
+ *	@brief 		Address selecting every node at once (nodes must not respond).
+ */
+#ifndef MDB_BROADCAST_ADDRESS
+#define MDB_BROADCAST_ADDRESS	(0xFFU)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	MDB Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for MDB node selection state.
+ */
+typedef enum {
+	MDB_UNSELECTED,				/**< data frames are discarded */
+	MDB_SELECTED,				/**< addressed to this node (may respond) */
+	MDB_BROADCAST				/**< addressed to every node (no response) */
+} T_mdbState;
+
+/* ----------------------------------------------------------------------------
+**	MDB Getters.
+*/
+
+/**
+ *	@def 		IsMDBAddressFrame
+ *	@brief		Checks if the received frame is an address frame (A/D bit).
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsMDBAddressFrame() \
+	EQU(GetIOREGBitVar(IO_SCR1, AD), SER_FRAME_ADDRESS)
+
+/**
+ *	@def 		IsMDBSelected
+ *	@brief		Checks if this node is selected (individually or by broadcast).
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsMDBSelected() \
+	NEQ(getMDBState(), MDB_UNSELECTED)
+
+/* ----------------------------------------------------------------------------
+**	MDB API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initMDB(T_uint8)
+ *	@brief 		Initialize multi-drop bus node and enable reception.
+ * 	@pre		SER must be set up in asynchronous multiprocessor mode
+ * 				(setupSERTiming with SER_MODE_ASYNC_MULTI) and set to application
+ * 				usage (setSERUsage with SER_APP) first.
+ * 	@param[in]	address		Node address (other than MDB_BROADCAST_ADDRESS).
+ * 	@return		.
+ */
+extern T_void initMDB(T_uint8 address);
+
+/**
+ * 	@fn 		T_void selectMDBNode(T_uint8)
+ *	@brief 		Transmits an address frame selecting a node (master only).
+ * 	@param[in]	address		Node address or MDB_BROADCAST_ADDRESS.
+ * 	@return		.
+ *  @note		Waits until the address frame is moved to the shift register
+ *  			before switching back to data frames.
+ */
+extern T_void selectMDBNode(T_uint8 address);
+
+/**
+ * 	@fn 		T_uint8 writeMDBBytes(const T_uint8*, T_uint8)
+ *	@brief 		Transmits data frames (polled).
+ * 	@param[in]	pBuff	Pointer to array to retrieve data.
+ * 	@param[in]	len		Desired bytes to write or size of array.
+ * 	@return		number of bytes written.
+ *  @note		A slave node should only respond while it is selected.
+ */
+extern T_uint8 writeMDBBytes(const T_uint8* pBuff, T_uint8 len);
+
+/**
+ * 	@fn 		T_mdbState getMDBState(T_void)
+ *	@brief 		Gets node selection state.
+ * 	@param		.
+ * 	@return		selection state.
+ */
+extern T_mdbState getMDBState(T_void);
+
+/**
+ * 	@fn 		T_void releaseMDB(T_void)
+ *	@brief 		Deselects this node so that following data frames are discarded
+ *				until its address frame is received again.
+ * 	@param		.
+ * 	@return		.
+ *  @note		Call once the session is over (i.e. getNSCRxSession returns
+ *  			NSC_SSN_IDLE after a release command).
+ */
+extern T_void releaseMDB(T_void);
+
+/**
+ * 	@fn 		T_uint16 countMDBDiscarded(T_void)
+ *	@brief 		Counts data frames discarded while unselected (wraps around).
+ * 	@param		.
+ * 	@return		discarded frames.
+ */
+extern T_uint16 countMDBDiscarded(T_void);
+
+/**
+ * 	@fn 		T_void MDB_IRQHandler(T_void)
+ *	@brief		Reads received frame, updates node selection on address frames
+ *				and enqueues data frames in SER reception buffer only while
+ *				this node is selected.
+ *  @param		.
+ *  @return		.
+ *  @note 		Replaces SERRX_IRQHandler on its interrupt vector (transmission
+ *  			remains handled by SERTX_IRQHandler or STX_IRQHandler), and
+ *  			feeds the reception buffer of SER receiving functions
+ *  			(countSERReceived, readSERBytes, checkSERReceived).
+ *  @note 		Frames with parity, framing or overrun error are discarded.
+ */
+#if USE_MDB_ISR
+#if NOSAVEREG_MDB_ISR
+NOSAVEREG
+#endif
+extern ISR(MDB_IRQHandler);
+#endif
+
+#endif /* MDB_H. */
@@ -0,0 +1,238 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing CAN Transport										     */
+/**
+ *	@file		NDS/ndsCan.h
+ *	@brief		This file contains NDS CAN flags, getters, and API functions
+ *				for sharing regions of any size up to NDS_CAN_MAX_SIZE through a
+ *				single pair of message buffers.
+ *	@details	Regions are registered with an ID (0 to 255) agreed by both
+ *				nodes. An outgoing region is copied at once, then sent in
+ *				segments of 8 bytes at most, each with the extended ID
+ *				formattedCANID(NDS_CAN_RX_BUFFER, prefix, suffix). The prefix is
+ *				the sending node prefix. The suffix is the region ID (high byte)
+ *				and the segment offset (low byte), so a receiver knows where each
+ *				segment goes without any header in the data. Segments are sent
+ *				in order through NDS_CAN_TX_BUFFER, one per call of
+ *				manageNDSCanOutgoing while the buffer is free, and regions are
+ *				served round-robin. The receiver accepts every suffix of its
+ *				peer prefix in NDS_CAN_RX_BUFFER (AMR1), reassembles segments
+ *				in a staging buffer and copies the region only once its last
+ *				segment arrived in order, so a region is never seen half
+ *				updated. A missing segment drops the region until its next
+ *				transfer and is counted as an error. <br>
+ *				By default NDS_CAN_RX_BUFFER is polled by manageNDSCanIncoming,
+ *				so a segment received before the previous one was polled
+ *				overwrites it: the receiver must call manageNDSCanIncoming more
+ *				often than the peer calls manageNDSCanOutgoing (which sends one
+ *				segment per call), i.e. both from the same periodic task with
+ *				the receiver not slower. Segments sent back to back at bus speed
+ *				need NDS_CAN_CNX: the CNX reception ISR then copies every
+ *				segment into a ring of NDS_CAN_RX_SEGMENTS, emptied by
+ *				manageNDSCanIncoming.
+ *	@attention	Both buffers must be left out of the buffer bits given to
+ *				initCAN (and of NDS shared data). When polled, reception
+ *				interrupt of NDS_CAN_RX_BUFFER stays disabled so that no other
+ *				handler clears its reception complete bit. With NDS_CAN_CNX,
+ *				NDS_CAN_RX_BUFFER must be among the reception buffer bits given
+ *				to initCNX, and CNX_RX_CALLBACK must be set.
+ *	@code
+ *		initCAN(CAN_DEF_BUS_SPEED, 0x0FU, 0x30U);
+ *		initNDSCan(NODE_A_PREFIX, NODE_B_PREFIX);
+ *		(T_void)addNDSCanRegion(0U, &status, SzBytes_(status), NDS_OUT);
+ *		(T_void)addNDSCanRegion(1U, &command, SzBytes_(command), NDS_IN);
+ *		startCAN();
+ *		...
+ *		(T_void)manageNDSCanIncoming();
+ *		(T_void)manageNDSCanOutgoing();
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NDS_CAN_H
+#define NDS_CAN_H
+
+#include <NDS/ndsLayout.h>
+#include <COM/can.h>
+
+/**
+ * 	@def		NDS_CAN_CNX
+ *	@brief 		Reception through the CNX reception ISR (see CNX/cnx.h) instead
+ *				of polling.
+ */
+#ifndef NDS_CAN_CNX
+#define NDS_CAN_CNX				(0U)
+#endif
+
+#if NDS_CAN_CNX
+#include <CNX/cnx.h>
+#endif
+
+/* ----------------------------------------------------------------------------
+**	NDS CAN Flags.
+*/
+
+/**
+ * 	@def		NDS_CAN_TX_BUFFER
+ *	@brief 		Message buffer transmitting segments.
+ */
+#ifndef NDS_CAN_TX_BUFFER
+#define NDS_CAN_TX_BUFFER		CAN_MB_7
+#endif
+
+/**
+ * 	@def		NDS_CAN_RX_BUFFER
+ *	@brief 		Message buffer receiving segments (same on every node).
+ */
+#ifndef NDS_CAN_RX_BUFFER
+#define NDS_CAN_RX_BUFFER		CAN_MB_6
+#endif
+
+/**
+ * 	@def		NDS_CAN_MAX_REGIONS
+ *	@brief 		Number of regions (both directions).
+ */
+#ifndef NDS_CAN_MAX_REGIONS
+#define NDS_CAN_MAX_REGIONS		(8U)
+#endif
+
+/**
+ * 	@def		NDS_CAN_MAX_SIZE
+ *	@brief 		Maximum region size in bytes (up to 255).
+ */
+#ifndef NDS_CAN_MAX_SIZE
+#define NDS_CAN_MAX_SIZE		(64U)
+#endif
+
+/**
+ * 	@def		NDS_CAN_RX_SEGMENTS
+ *	@brief 		Reception ring size in segments with NDS_CAN_CNX (power of 2,
+ *				up to 128). It must hold the segments received during the
+ *				longest interval between two calls of manageNDSCanIncoming.
+ */
+#ifndef NDS_CAN_RX_SEGMENTS
+#define NDS_CAN_RX_SEGMENTS		(8U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	NDS CAN Types.
+*/
+
+/**
+ *	@brief		Data structure for NDS CAN region.
+ */
+typedef struct {
+	volatile T_uint8* pData;
+	T_uint8 id;
+	T_uint8 size;
+	T_ndsDirection direction;
+	T_uint16 updates;
+} T_ndsCanRegion;
+
+/* ----------------------------------------------------------------------------
+**	NDS CAN Getters.
+*/
+
+/**
+ *	@def 		GetByteNDSCanSegments
+ *	@brief		Gets the segment (frame) count of a region size.
+ *	@param[in]	SIZE	Region size in bytes.
+ *	@return		segment count (byte).
+ */
+#define GetByteNDSCanSegments(SIZE) \
+	GetByteNDSBlocks(SIZE)
+
+/**
+ *	@def 		GetWordNDSCanSuffix
+ *	@brief		Gets the extended ID suffix of a segment.
+ *	@param[in]	REGION	Region ID.
+ *	@param[in]	OFFSET	Segment offset in bytes.
+ *	@return		ID suffix (word).
+ */
+#define GetWordNDSCanSuffix(REGION, OFFSET) \
+	((T_word)(((T_word)(REGION) << 8U) | (T_uint8)(OFFSET)))
+
+/* ----------------------------------------------------------------------------
+**	NDS CAN API Functions.
+*/
+
+/**
+ *	@fn			T_void initNDSCan(T_byte, T_byte)
+ *	@brief 		Initialize NDS CAN transport and its message buffers.
+ *	@pre		CAN must be initialized first (and started afterwards).
+ *	@param[in]	txPrefix	Prefix of segments transmitted by this node.
+ *	@param[in]	rxPrefix	Prefix of segments transmitted by the peer.
+ *	@return		.
+ */
+extern T_void initNDSCan(T_byte txPrefix, T_byte rxPrefix);
+
+/**
+ *	@fn			T_bit addNDSCanRegion(T_uint8, volatile T_void*, T_uint8, T_ndsDirection)
+ *	@brief 		Registers a shared region.
+ *	@param[in]	region		Region ID (same on both nodes).
+ *	@param		pData		Region data.
+ *	@param[in]	size		Region size in bytes (1 to NDS_CAN_MAX_SIZE).
+ *	@param[in]	direction	Region direction.
+ *	@return		registration status (false if full or size is invalid).
+ */
+extern T_bit addNDSCanRegion(T_uint8 region, volatile T_void* pData, T_uint8 size,
+	T_ndsDirection direction);
+
+/**
+ *	@fn			T_bit manageNDSCanOutgoing(T_void)
+ *	@brief 		Transmits the next segment of outgoing regions.
+ *	@param		.
+ *	@return		transmission status (false if buffer busy or nothing to send).
+ *	@note		Call at least as often as the wanted segment rate.
+ */
+extern T_bit manageNDSCanOutgoing(T_void);
+
+/**
+ *	@fn			T_bit manageNDSCanIncoming(T_void)
+ *	@brief 		Receives segments and updates their regions once complete.
+ *	@param		.
+ *	@return		region update status.
+ *	@note		When polled, call more often than the peer transmits segments.
+ *				With NDS_CAN_CNX, every segment waiting in the ring is stored.
+ */
+extern T_bit manageNDSCanIncoming(T_void);
+
+/**
+ *	@fn			T_uint16 countNDSCanUpdates(T_uint8)
+ *	@brief 		Counts complete transfers of a region.
+ *	@param[in]	region		Region ID.
+ *	@return		updates (transmitted or received).
+ */
+extern T_uint16 countNDSCanUpdates(T_uint8 region);
+
+/**
+ *	@fn			T_uint16 countNDSCanErrors(T_void)
+ *	@brief 		Counts segments dropped (unknown region, out of order, missing
+ *				segment, or full ring with NDS_CAN_CNX).
+ *	@param		.
+ *	@return		dropped segments.
+ */
+extern T_uint16 countNDSCanErrors(T_void);
+
+#endif /* NDS_CAN_H. */
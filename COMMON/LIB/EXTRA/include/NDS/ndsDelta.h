@@ -0,0 +1,139 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Delta Replication									     */
+/**
+ *	@file		NDS/ndsDelta.h
+ *	@brief		This file contains NDS delta flags, getters, and API functions
+ *				for transmitting only the outgoing blocks that changed.
+ *	@details	Outgoing shared data is split in blocks of 8 bytes, one per
+ *				message buffer, so that a block offset is the message buffer
+ *				index carried by its formatted ID (see formattedCANID). Every
+ *				call of manageNDSDelta compares each outgoing block of the TX
+ *				buffer against a shadow copy of what was last transmitted and
+ *				loads and requests only the blocks that differ. The receiver
+ *				needs no change: manageNDSIncoming already stores each message
+ *				buffer received into its own block of the RX buffer, so blocks
+ *				that are not sent simply keep their last value.
+ *				Unchanged blocks are still sent once every NDS_DELTA_REFRESH
+ *				calls so that a lost frame or a node joining late catches up.
+ *				A block may be forced out even if its content did not change
+ *				(i.e. an event counter written twice with the same value)
+ *				through markNDSDirty, which acts as a write barrier.
+ *	@code
+ *		initNDS();
+ *		initNDSDelta(0x0FU);				// outgoing message buffers 0 to 3
+ *		...
+ *		pOut->speed = speed;				// write to NDSAllocOutgoing space
+ *		(T_void)manageNDSDelta();			// instead of manageNDSOutgoing
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NDS_DELTA_H
+#define NDS_DELTA_H
+
+#include <NDS/nds.h>
+#include <COM/can.h>
+
+/* ----------------------------------------------------------------------------
+**	NDS Delta Flags.
+*/
+
+/**
+ * 	@def		NDS_DELTA_REFRESH
+ *	@brief 		Calls of manageNDSDelta between full refreshes of outgoing
+ *				blocks (0 disables refresh).
+ */
+#ifndef NDS_DELTA_REFRESH
+#define NDS_DELTA_REFRESH		(100U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	NDS Delta Getters.
+*/
+
+/**
+ *	@def 		GetByteNDSBlock
+ *	@brief		Gets the block (message buffer index) of an outgoing address.
+ *	@param[in]	PTR		Address within NDSAllocOutgoing space.
+ *	@return		block index (byte).
+ */
+#define GetByteNDSBlock(PTR) \
+	((T_uint8)(((const volatile T_uint8*)(PTR) - pTXCANBuffer[PosX_BASE].BYTE) \
+		/ CAN_MB_BYTE_SIZE))
+
+/* ----------------------------------------------------------------------------
+**	NDS Delta API Functions.
+*/
+
+/**
+ *	@fn			T_void initNDSDelta(T_byte)
+ *	@brief 		Initialize delta replication of outgoing shared data.
+ *	@pre		NDS must be initialized first.
+ *	@param[in]	txBufferBits	Outgoing message buffer bits (same as given to
+ *								initCAN).
+ *	@return		.
+ *	@note		Every outgoing block is sent on the first call of manageNDSDelta.
+ */
+extern T_void initNDSDelta(T_byte txBufferBits);
+
+/**
+ *	@fn			T_uint8 manageNDSDelta(T_void)
+ *	@brief 		Transmits outgoing blocks that changed since they were last
+ *				transmitted (or are marked, or are due for refresh).
+ *	@param		.
+ *	@return		number of blocks requested for transmission.
+ *	@note		Replaces manageNDSOutgoing. It never waits: a block whose
+ *				previous transmission is still pending is kept for the next
+ *				call.
+ */
+extern T_uint8 manageNDSDelta(T_void);
+
+/**
+ *	@fn			T_void markNDSDirty(const volatile T_void*, T_uint8)
+ *	@brief 		Forces transmission of the blocks covering outgoing data on the
+ *				next call of manageNDSDelta.
+ *	@param[in]	pData	Address within NDSAllocOutgoing space.
+ *	@param[in]	size	Data size in bytes.
+ *	@return		.
+ */
+extern T_void markNDSDirty(const volatile T_void* pData, T_uint8 size);
+
+/**
+ *	@fn			T_uint32 countNDSDeltaSent(T_void)
+ *	@brief 		Counts blocks transmitted since initialization.
+ *	@param		.
+ *	@return		transmitted blocks.
+ */
+extern T_uint32 countNDSDeltaSent(T_void);
+
+/**
+ *	@fn			T_uint32 countNDSDeltaSkipped(T_void)
+ *	@brief 		Counts unchanged blocks not transmitted since initialization.
+ *	@param		.
+ *	@return		skipped blocks.
+ */
+extern T_uint32 countNDSDeltaSkipped(T_void);
+
+#endif /* NDS_DELTA_H. */
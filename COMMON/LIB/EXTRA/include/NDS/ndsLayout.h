@@ -0,0 +1,300 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Compile-Time Layout								     */
+/**
+ *	@file		NDS/ndsLayout.h
+ *	@brief		This file contains NDS layout flags, types, getters, macro
+ *				functions, and API functions for declaring shared data regions
+ *				with offsets fixed at compile time.
+ *	@details	Shared data is declared once as a list of NDS_REGION(name, type,
+ *				direction) where direction is NDS_IN or NDS_OUT. The list
+ *				expands into one structure per direction (T_ndsIncoming and
+ *				T_ndsOutgoing) so that every region offset is fixed by the
+ *				compiler rather than by the order of NDSAllocIncoming and
+ *				NDSAllocOutgoing calls, and sizes exceeding the eight message
+ *				buffers fail to compile. Both structures start with the layout
+ *				hash (a word computed over region names, offsets and sizes):
+ *				each node sends the hash of its outgoing layout and compares the
+ *				hash received with the one of its incoming layout. A node
+ *				declares the same regions as its peer with opposite directions.
+ *				<br>
+ *				There is no connect handshake: the hash travels in the first
+ *				message buffer of the outgoing data, so a mismatch is only
+ *				detected at run time, once the peer has transmitted that buffer
+ *				(getNDSPeerHash returns 0 until then). Incoming data must not be
+ *				used before IsNDSLayoutMatched, and IsNDSLayoutReceived tells a
+ *				silent peer from a mismatched one. <br>
+ *				NDSSharedData is implemented by NDS/nds_layout.c as a single
+ *				allocation per direction. Exactly one of NDS/nds_api.c and
+ *				NDS/nds_layout.c must be built: both define NDSSharedData.
+ *	@code
+ *		// appLayout.h (shared by the application sources)
+ *		#define NDS_LAYOUT(NDS_REGION) \
+ *			NDS_REGION(speed,	T_uint16,	NDS_OUT) \
+ *			NDS_REGION(status,	T_uint8,	NDS_OUT) \
+ *			NDS_REGION(torque,	T_float32,	NDS_IN)
+ *		#include <NDS/ndsLayout.h>
+ *
+ *		// one application source only
+ *		NDS_LAYOUT_TABLE
+ *
+ *		// anywhere
+ *		NDSOutgoing.speed = speed;
+ *		torque = NDSIncoming.torque;
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NDS_LAYOUT_H
+#define NDS_LAYOUT_H
+
+#include <NDS/nds.h>
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout Flags.
+*/
+
+/**
+ * 	@def		NDS_BUFFER_SIZE
+ *	@brief 		Data buffer size in bytes (eight message buffers).
+ */
+#define NDS_BUFFER_SIZE			(64U)
+
+/**
+ * 	@def		NDS_BLOCK_SIZE
+ *	@brief 		Message buffer data size in bytes.
+ */
+#define NDS_BLOCK_SIZE			(8U)
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for NDS region direction.
+ */
+typedef enum {
+	NDS_IN,						/**< incoming (RX buffer) */
+	NDS_OUT						/**< outgoing (TX buffer) */
+} T_ndsDirection;
+
+/**
+ *	@brief		Data structure for NDS region description.
+ */
+typedef struct {
+	const T_char* name;
+	T_uint8 offset;
+	T_uint8 size;
+	T_ndsDirection direction;
+} T_ndsRegion;
+
+/**
+ *	@brief		Defined function pointer type for NDS footprint report.
+ */
+typedef T_void (*T_ndsReport)(const T_ndsRegion*);
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout External Constants.
+*/
+
+/**
+ * 	@var		ndsRegions
+ *	@brief		Region descriptions (defined by NDS_LAYOUT_TABLE).
+ */
+extern const T_ndsRegion ndsRegions[];
+
+/**
+ * 	@var		ndsRegionCount
+ *	@brief		Region count.
+ */
+extern const T_uint8 ndsRegionCount;
+
+/**
+ * 	@var		ndsIncomingSize
+ *	@brief		Incoming layout size in bytes (layout hash included).
+ */
+extern const T_uint8 ndsIncomingSize;
+
+/**
+ * 	@var		ndsOutgoingSize
+ *	@brief		Outgoing layout size in bytes (layout hash included).
+ */
+extern const T_uint8 ndsOutgoingSize;
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout Getters.
+*/
+
+/**
+ *	@def 		GetByteNDSBlocks
+ *	@brief		Gets the message buffer count of a layout size.
+ *	@param[in]	SIZE	Layout size in bytes.
+ *	@return		message buffer count (byte).
+ */
+#define GetByteNDSBlocks(SIZE) \
+	((T_uint8)(((SIZE) + NDS_BLOCK_SIZE - 1U) / NDS_BLOCK_SIZE))
+
+/**
+ *	@def 		IsNDSLayoutReceived
+ *	@brief		Checks if the peer outgoing layout hash was received.
+ *	@return		boolean.
+ */
+#define IsNDSLayoutReceived() \
+	NEQ(getNDSPeerHash(), 0U)
+
+/**
+ *	@def 		IsNDSLayoutMatched
+ *	@brief		Checks if the peer outgoing layout hash received matches the
+ *				incoming layout hash.
+ *	@return		boolean (FALSE until the hash is received).
+ */
+#define IsNDSLayoutMatched() \
+	EQU(getNDSPeerHash(), getNDSLayoutHash(NDS_IN))
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout Macro Functions.
+*/
+
+/**
+ *	@def 		NDS_INCOMING_FIELD
+ *	@brief		Incoming structure member of an incoming region.
+ */
+#define NDS_IN_FIELD_NDS_IN(NAME, TYPE)		TYPE NAME;
+#define NDS_IN_FIELD_NDS_OUT(NAME, TYPE)
+#define NDS_INCOMING_FIELD(NAME, TYPE, DIR)	NDS_IN_FIELD_##DIR(NAME, TYPE)
+
+/**
+ *	@def 		NDS_OUTGOING_FIELD
+ *	@brief		Outgoing structure member of an outgoing region.
+ */
+#define NDS_OUT_FIELD_NDS_IN(NAME, TYPE)
+#define NDS_OUT_FIELD_NDS_OUT(NAME, TYPE)	TYPE NAME;
+#define NDS_OUTGOING_FIELD(NAME, TYPE, DIR)	NDS_OUT_FIELD_##DIR(NAME, TYPE)
+
+/**
+ *	@def 		NDS_REGION_ENTRY
+ *	@brief		Region description of a region.
+ */
+#define NDS_TYPE_NDS_IN			T_ndsIncoming
+#define NDS_TYPE_NDS_OUT		T_ndsOutgoing
+#define NDS_REGION_ENTRY(NAME, TYPE, DIR) \
+	{ #NAME, (T_uint8)offsetof(NDS_TYPE_##DIR, NAME), \
+		(T_uint8)SzBytes_(TYPE), (DIR) },
+
+/**
+ *	@def 		NDS_LAYOUT_TABLE
+ *	@brief		Defines region descriptions and layout sizes (one source only).
+ */
+#define NDS_LAYOUT_TABLE \
+	const T_ndsRegion ndsRegions[] = { \
+		NDS_LAYOUT(NDS_REGION_ENTRY) \
+		{ NULL, 0U, 0U, NDS_IN } \
+	}; \
+	const T_uint8 ndsRegionCount = (T_uint8)(SzIndices_(ndsRegions) - 1U); \
+	const T_uint8 ndsIncomingSize = (T_uint8)SzBytes_(T_ndsIncoming); \
+	const T_uint8 ndsOutgoingSize = (T_uint8)SzBytes_(T_ndsOutgoing);
+
+/**
+ *	@def 		NDSIncoming
+ *	@brief		Incoming layout (read-only).
+ */
+#define NDSIncoming				(*(const volatile T_ndsIncoming*)getNDSLayoutData(NDS_IN))
+
+/**
+ *	@def 		NDSOutgoing
+ *	@brief		Outgoing layout.
+ */
+#define NDSOutgoing				(*(volatile T_ndsOutgoing*)getNDSLayoutData(NDS_OUT))
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout Generated Types.
+*/
+
+#ifdef NDS_LAYOUT
+
+/**
+ *	@brief		Data structure for NDS incoming layout.
+ */
+typedef struct {
+	T_uint16 hash;
+	NDS_LAYOUT(NDS_INCOMING_FIELD)
+} T_ndsIncoming;
+
+/**
+ *	@brief		Data structure for NDS outgoing layout.
+ */
+typedef struct {
+	T_uint16 hash;
+	NDS_LAYOUT(NDS_OUTGOING_FIELD)
+} T_ndsOutgoing;
+
+/**
+ *	@brief		Compile-time check of layout sizes (negative array size if
+ *				both layouts do not fit in the eight message buffers).
+ */
+typedef T_uint8 T_ndsLayoutCheck[COND(LEQ(GetByteNDSBlocks(SzBytes_(T_ndsIncoming))
+	+ GetByteNDSBlocks(SzBytes_(T_ndsOutgoing)), NDS_BUFFER_SIZE / NDS_BLOCK_SIZE), 1, -1)];
+
+#endif
+
+/* ----------------------------------------------------------------------------
+**	NDS Layout API Functions.
+*/
+
+/**
+ *	@fn			T_uint16 getNDSLayoutHash(T_ndsDirection)
+ *	@brief 		Gets the layout hash of a direction.
+ *	@pre		NDS must be initialized first.
+ *	@param[in]	direction	Layout direction.
+ *	@return		layout hash.
+ */
+extern T_uint16 getNDSLayoutHash(T_ndsDirection direction);
+
+/**
+ *	@fn			T_uint16 getNDSPeerHash(T_void)
+ *	@brief 		Gets the layout hash received from the peer.
+ *	@param		.
+ *	@return		peer outgoing layout hash (0 until received).
+ */
+extern T_uint16 getNDSPeerHash(T_void);
+
+/**
+ *	@fn			volatile T_void* getNDSLayoutData(T_ndsDirection)
+ *	@brief 		Gets the data space allocated to a layout.
+ *	@pre		NDS must be initialized first.
+ *	@param[in]	direction	Layout direction.
+ *	@return		memory location.
+ */
+extern volatile T_void* getNDSLayoutData(T_ndsDirection direction);
+
+/**
+ *	@fn			T_void reportNDSLayout(T_ndsReport)
+ *	@brief 		Reports the footprint of every region, then of both layouts as
+ *				a whole (named "incoming" and "outgoing", layout hash included).
+ *	@param[in]	report		Report function (i.e. printing through SER).
+ *	@return		.
+ */
+extern T_void reportNDSLayout(T_ndsReport report);
+
+#endif /* NDS_LAYOUT_H. */
@@ -0,0 +1,134 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Data Sharing Consistent Snapshots								     */
+/**
+ *	@file		NDS/ndsSnapshot.h
+ *	@brief		This file contains NDS snapshot flags, getters, and API functions
+ *				for reading incoming shared data without torn updates.
+ *	@details	Incoming data spanning several words (or several message
+ *				buffers) may be read half old and half new if the reader is
+ *				preempted by manageNDSIncoming. Instead of masking interrupts
+ *				around every read, the update is guarded by a sequence counter
+ *				(seqlock): the writer makes the counter odd before updating the
+ *				RX buffer and even again afterwards, and a reader copies the data
+ *				then retries if the counter was odd or changed meanwhile. The
+ *				writer never waits for readers and readers never block the
+ *				writer. The counter is a word so that it is read and written in
+ *				a single access on the 16-bit CPU.
+ *	@code
+ *		// writer (i.e. timer ISR or higher priority task)
+ *		manageNDSSnapshot(0U);				// instead of manageNDSIncoming
+ *
+ *		// reader
+ *		T_status status;
+ *		if (IS(readNDSSnapshot(&status, pIn, SzBytes_(status)))) {
+ *			...
+ *		}
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NDS_SNAPSHOT_H
+#define NDS_SNAPSHOT_H
+
+#include <NDS/nds.h>
+
+/* ----------------------------------------------------------------------------
+**	NDS Snapshot Flags.
+*/
+
+/**
+ * 	@def		NDS_SNAPSHOT_RETRIES
+ *	@brief 		Read attempts before giving up (a reader running at a higher
+ *				priority than the writer would otherwise spin forever).
+ */
+#ifndef NDS_SNAPSHOT_RETRIES
+#define NDS_SNAPSHOT_RETRIES	(8U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	NDS Snapshot Getters.
+*/
+
+/**
+ *	@def 		IsNDSUpdating
+ *	@brief		Checks if incoming data is being updated.
+ *	@return		boolean.
+ */
+#define IsNDSUpdating() \
+	NEQ(getNDSSequence() & 1U, 0U)
+
+/* ----------------------------------------------------------------------------
+**	NDS Snapshot API Functions.
+*/
+
+/**
+ *	@fn			T_void beginNDSUpdate(T_void)
+ *	@brief 		Marks the start of an incoming data update (counter odd).
+ *	@param		.
+ *	@return		.
+ *	@note		Only needed by custom writers (i.e. copying message buffers
+ *				from the CAN reception ISR). Updates must not be nested.
+ */
+extern T_void beginNDSUpdate(T_void);
+
+/**
+ *	@fn			T_void endNDSUpdate(T_void)
+ *	@brief 		Marks the end of an incoming data update (counter even).
+ *	@param		.
+ *	@return		.
+ */
+extern T_void endNDSUpdate(T_void);
+
+/**
+ *	@fn			T_void manageNDSSnapshot(T_uint8)
+ *	@brief 		Manages reception of shared data as a single update.
+ *	@param[in]	rxWaitCount		Reception wait count (0 for no waiting).
+ *	@return		.
+ *	@note		Replaces manageNDSIncoming.
+ */
+extern T_void manageNDSSnapshot(T_uint8 rxWaitCount);
+
+/**
+ *	@fn			T_bit readNDSSnapshot(T_void*, const volatile T_void*, T_uint8)
+ *	@brief 		Copies incoming data consistently.
+ *	@param[out]	pDest	Destination.
+ *	@param[in]	pSrc	Address within NDSAllocIncoming space.
+ *	@param[in]	size	Data size in bytes.
+ *	@return		consistency (destination content is undefined if false).
+ *	@note		Fails only if the data kept changing over NDS_SNAPSHOT_RETRIES
+ *				attempts or an update was left open.
+ */
+extern T_bit readNDSSnapshot(T_void* pDest, const volatile T_void* pSrc, T_uint8 size);
+
+/**
+ *	@fn			T_uint16 getNDSSequence(T_void)
+ *	@brief 		Gets the update sequence counter.
+ *	@param		.
+ *	@return		sequence counter (odd while updating, incremented by two per
+ *				update).
+ */
+extern T_uint16 getNDSSequence(T_void);
+
+#endif /* NDS_SNAPSHOT_H. */
@@ -0,0 +1,154 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Batched Requests								     */
+/**
+ *	@file		NSC/nscBatch.h
+ *	@brief		This file contains NSC batch flags and handler functions for
+ *				reading many registered variables in a single transaction.
+ *	@details	Batch handlers are executable entries of the dispatch table
+ *				(NSC/nscTable.h) taking their arguments from the NSC stack, with
+ *				a request tag (sequence ID, 0 to 255) pushed last:
+ *				- list read: push address 1 to N, push tag, execute
+ *				  NSC_BATCH_LIST_ADDRESS;
+ *				- range read: push first address, push last address, push tag,
+ *				  execute NSC_BATCH_RANGE_ADDRESS (every readable variable within
+ *				  the range).
+ *				NSC text has no list form, so a text list read takes one
+ *				NSC_CMD_PSH request per address, N + 2 requests in all. A range
+ *				read takes 4 requests whatever its size, and a binary block push
+ *				(NSC/nscBinary.h) carries the N addresses in a single request.
+ *				Values are returned as one combined binary response made of TLM
+ *				frames (TLM/tlm.h), split when they exceed TLM_MAX_PAYLOAD. The
+ *				payload is request tag, frame index (bit 7 set on last frame)
+ *				and entries. A list entry is a status byte (T_nscRepType, or 0x80
+ *				plus error code) and the value (4 bytes, little-endian); a range
+ *				entry is the same preceded by the address (4 bytes).
+ *				Since NSC text never contains a zero byte, the host splits TLM
+ *				frames off the stream at zero delimiters. Requests may be sent
+ *				back-to-back without waiting for responses (as far as the SER
+ *				receive buffer holds them) and responses are matched by tag.
+ *	@attention	The frames of a response are sent back to back, which
+ *				writeSERBytes does not allow (1 ms between calls, COM/ser.h):
+ *				the project must be built with TLM_STX (TLM/tlm.h) set, so that
+ *				frames are queued by the serial transmit engine (STX/stx.h,
+ *				initSTX called at startup). nsc_batch.c refuses to build
+ *				otherwise.
+ *	@code
+ *		NSC_TABLE_BEGIN
+ *			NSC_VARIABLE(0x0100UL, setpoint, NSC_FLOAT, NSC_ACC_RW),
+ *			NSC_BATCH_FUNCTIONS
+ *		NSC_TABLE_END
+ *	@endcode
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NSC_BATCH_H
+#define NSC_BATCH_H
+
+#include <NSC/nscTable.h>
+#include <TLM/tlm.h>
+
+/* ----------------------------------------------------------------------------
+**	NSC Batch Flags.
+*/
+
+/**
+ * 	@def		NSC_BATCH_LIST_ADDRESS
+ *	@brief 		Address of list read handler.
+ */
+#ifndef NSC_BATCH_LIST_ADDRESS
+#define NSC_BATCH_LIST_ADDRESS	(0xFFFFFF00UL)
+#endif
+
+/**
+ * 	@def		NSC_BATCH_RANGE_ADDRESS
+ *	@brief 		Address of range read handler.
+ */
+#ifndef NSC_BATCH_RANGE_ADDRESS
+#define NSC_BATCH_RANGE_ADDRESS	(0xFFFFFF01UL)
+#endif
+
+/**
+ * 	@def		NSC_BATCH_CHANNEL
+ *	@brief 		TLM channel ID of list responses (range responses use the next
+ *				channel ID).
+ */
+#ifndef NSC_BATCH_CHANNEL
+#define NSC_BATCH_CHANNEL		(0x20U)
+#endif
+
+/**
+ * 	@def		NSC_BATCH_MAX_ENTRIES
+ *	@brief 		Maximum address count of list read (up to 127).
+ */
+#ifndef NSC_BATCH_MAX_ENTRIES
+#define NSC_BATCH_MAX_ENTRIES	(64U)
+#endif
+
+/**
+ * 	@def		NSC_ERR_BATCH_SIZE
+ *	@brief 		Too many addresses on stack for list read.
+ */
+#define NSC_ERR_BATCH_SIZE		(0x04UL)
+
+/* ----------------------------------------------------------------------------
+**	NSC Batch Macro Functions.
+*/
+
+/**
+ *	@def 		NSC_BATCH_FUNCTIONS
+ *	@brief		Dispatch table entries of batch handlers.
+ *	@param		.
+ *	@return		table entries.
+ *	@note		Place where the table stays sorted (last by default).
+ */
+#define NSC_BATCH_FUNCTIONS \
+	NSC_FUNCTION(NSC_BATCH_LIST_ADDRESS, NSCBatchList), \
+	NSC_FUNCTION(NSC_BATCH_RANGE_ADDRESS, NSCBatchRange)
+
+/* ----------------------------------------------------------------------------
+**	NSC Batch API Functions.
+*/
+
+/**
+ *	@fn			T_nscErrCode NSCBatchList(T_nscAddress)
+ *	@brief 		Reads listed variables and transmits their values as a single
+ *				response.
+ *	@param[in]	address 	Address of command (unused).
+ *	@return		error code.
+ *	@note		Unregistered or unreadable addresses are reported per entry.
+ */
+extern T_nscErrCode NSCBatchList(T_nscAddress address);
+
+/**
+ *	@fn			T_nscErrCode NSCBatchRange(T_nscAddress)
+ *	@brief 		Reads every readable variable within an address range and
+ *				transmits addresses and values as a single response.
+ *	@param[in]	address 	Address of command (unused).
+ *	@return		error code (NSC_ERR_STACK_EMPTY without tag, last and first
+ *				address on stack).
+ */
+extern T_nscErrCode NSCBatchRange(T_nscAddress address);
+
+#endif /* NSC_BATCH_H. */
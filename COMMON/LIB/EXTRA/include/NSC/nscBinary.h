@@ -0,0 +1,228 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Binary Mode									     */
+/**
+ *	@file		NSC/nscBinary.h
+ *	@brief		This file contains NSC binary mode flags, getters, and API
+ *				functions for exchanging commands and raw parameter data without
+ *				text conversion.
+ *	@details	Text mode stays the default for terminals. A host negotiates
+ *				binary mode by executing NSC_BINARY_MODE_ADDRESS in text mode and
+ *				leaves it through NSC_CMD_REL (or after NSC_BINARY_MAX_ERRORS bad
+ *				frames in a row). Binary requests are COBS frames with CRC-16,
+ *				built like TLM frames (TLM/tlm.h) on channel NSC_BINARY_CHANNEL:
+ *				channel, sequence number, command (T_nscCommand), type tag
+ *				(T_nscRepType), address (4 bytes) and parameter data (4 bytes),
+ *				all little-endian. Every request is answered by a TLM frame on
+ *				the same channel whose payload is request sequence number,
+ *				command, type tag and parameter data (4 bytes):
+ *				- NSC_CMD_PSH with the value for NSC_CMD_POP and NSC_CMD_RXD;
+ *				- NSC_CMD_ERR with the error code on failure;
+ *				- the request command with zero parameter otherwise.
+ *				Every command goes through evaluateNSCSession as in text mode
+ *				(session commands NSC_CMD_MSR, NSC_CMD_SLV and NSC_CMD_REL
+ *				included) and is answered by NSC_ERR_SESSION if rejected.
+ *				NSC_CMD_TXD carries its value inline (push and store at once) and
+ *				NSC_CMD_RXD reads registered variables of the dispatch table
+ *				(NSC/nscTable.h) directly.
+ *				Block commands move several values at once. Their parameter data
+ *				is the block length (low word) and, for arrays, the first
+ *				element (high word):
+ *				- NSC_CMD_PSH with up to NSC_BINARY_MAX_VALUES values appended
+ *				  to the request pushes them in order (parameter data is the
+ *				  value count);
+ *				- NSC_CMD_POP with length up to NSC_BINARY_MAX_VALUES pops up to
+ *				  length values;
+ *				- NSC_CMD_TXD with up to NSC_BINARY_MAX_VALUES values appended
+ *				  copies them into array elements without going through the
+ *				  stack;
+ *				- NSC_CMD_RXD with non-zero length reads array elements, any
+ *				  length within the array.
+ *				Block responses are NSC_CMD_PSH with the block parameter data
+ *				(first element and actual length of the frame) followed by the
+ *				values (4 bytes each). An NSC_CMD_RXD block longer than
+ *				NSC_BINARY_MAX_VALUES is answered by consecutive frames with
+ *				the same sequence number, read in a single call. Larger
+ *				requests are split by the host (NSC/nscClient.h block functions
+ *				of HOST), which keeps the node receive buffer at one frame.
+ *	@attention	Those consecutive frames, like the answers to requests
+ *				pipelined by the host, are sent back to back, which
+ *				writeSERBytes does not allow (1 ms between calls, COM/ser.h):
+ *				the project must be built with TLM_STX (TLM/tlm.h) set, so that
+ *				frames are queued by the serial transmit engine (STX/stx.h,
+ *				initSTX called at startup). nsc_binary.c refuses to build
+ *				otherwise.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NSC_BINARY_H
+#define NSC_BINARY_H
+
+#include <NSC/nscTable.h>
+#include <TLM/tlm.h>
+
+/* ----------------------------------------------------------------------------
+**	NSC Binary Flags.
+*/
+
+/**
+ * 	@def		NSC_BINARY_MODE_ADDRESS
+ *	@brief 		Address of binary mode negotiation handler.
+ */
+#ifndef NSC_BINARY_MODE_ADDRESS
+#define NSC_BINARY_MODE_ADDRESS	(0xFFFFFF10UL)
+#endif
+
+/**
+ * 	@def		NSC_BINARY_CHANNEL
+ *	@brief 		TLM channel ID of binary requests and responses.
+ */
+#ifndef NSC_BINARY_CHANNEL
+#define NSC_BINARY_CHANNEL		(0x30U)
+#endif
+
+/**
+ * 	@def		NSC_BINARY_MAX_ERRORS
+ *	@brief 		Bad frames in a row falling back to text mode.
+ */
+#ifndef NSC_BINARY_MAX_ERRORS
+#define NSC_BINARY_MAX_ERRORS	(3U)
+#endif
+
+/**
+ * 	@def		NSC_BINARY_MAX_VALUES
+ *	@brief 		Maximum value count of a block frame (limited by TLM payload
+ *				of block responses, 22 with default TLM_MAX_PAYLOAD). Raise
+ *				TLM_MAX_PAYLOAD (up to 249, so 60 values) for fewer frames per
+ *				block at the cost of frame buffers.
+ */
+#ifndef NSC_BINARY_MAX_VALUES
+#define NSC_BINARY_MAX_VALUES	((TLM_MAX_PAYLOAD - 7U) / SzBytes_DWORD)
+#endif
+
+/**
+ * 	@def		NSC_BINARY_REQUEST_SIZE
+ *	@brief 		Decoded request size in bytes without block values (CRC-16
+ *				included).
+ */
+#define NSC_BINARY_REQUEST_SIZE	(TLM_HEADER_SIZE + 10U + TLM_CRC_SIZE)
+
+/**
+ * 	@def		NSC_ERR_STACK_FULL
+ *	@brief 		No space on stack to push.
+ */
+#define NSC_ERR_STACK_FULL		(0x05UL)
+
+/**
+ * 	@def		NSC_ERR_COMMAND
+ *	@brief 		Command not supported in binary mode.
+ */
+#define NSC_ERR_COMMAND			(0x06UL)
+
+/**
+ * 	@def		NSC_ERR_BLOCK_SIZE
+ *	@brief 		Block length mismatch or out of array bounds.
+ */
+#define NSC_ERR_BLOCK_SIZE		(0x07UL)
+
+/**
+ * 	@def		NSC_ERR_SESSION
+ *	@brief 		Command rejected by session evaluation (evaluateNSCSession).
+ */
+#define NSC_ERR_SESSION			(0x08UL)
+
+/* ----------------------------------------------------------------------------
+**	NSC Binary Getters.
+*/
+
+/**
+ *	@def 		IsNSCBinaryMode
+ *	@brief		Checks if binary mode was negotiated.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsNSCBinaryMode() \
+	IS(getNSCBinaryMode())
+
+/* ----------------------------------------------------------------------------
+**	NSC Binary Macro Functions.
+*/
+
+/**
+ *	@def 		NSC_BINARY_FUNCTIONS
+ *	@brief		Dispatch table entry of binary mode negotiation handler.
+ *	@param		.
+ *	@return		table entry.
+ *	@note		Place where the table stays sorted (last by default).
+ */
+#define NSC_BINARY_FUNCTIONS \
+	NSC_FUNCTION(NSC_BINARY_MODE_ADDRESS, NSCBinaryMode)
+
+/**
+ *	@def 		ManageNSCRequests
+ *	@brief		Serves requests in the negotiated mode.
+ *	@param		WAIT	Reception wait count of text mode (0 for no waiting).
+ *	@return		.
+ */
+#define ManageNSCRequests(WAIT) { \
+	if (IsNSCBinaryMode()) { \
+		manageNSCBinaryRequest(); \
+	} else { \
+		manageNSCRequest(WAIT); \
+	} \
+}
+
+/* ----------------------------------------------------------------------------
+**	NSC Binary API Functions.
+*/
+
+/**
+ *	@fn			T_nscErrCode NSCBinaryMode(T_nscAddress)
+ *	@brief 		Switches request parsing to binary mode (the text response of
+ *				the command itself is still sent).
+ *	@param[in]	address 	Address of command (unused).
+ *	@return		error code.
+ */
+extern T_nscErrCode NSCBinaryMode(T_nscAddress address);
+
+/**
+ *	@fn			T_void manageNSCBinaryRequest(T_void)
+ *	@brief 		Collects received bytes into a frame, then validates, executes
+ *				and answers every complete request.
+ *	@param		.
+ *	@return		.
+ *	@note		Call instead of manageNSCRequest while in binary mode (see
+ *				ManageNSCRequests).
+ */
+extern T_void manageNSCBinaryRequest(T_void);
+
+/**
+ *	@fn			T_bit getNSCBinaryMode(T_void)
+ *	@brief 		Gets negotiated mode.
+ *	@param		.
+ *	@return		TRUE for binary mode, FALSE for text mode.
+ */
+extern T_bit getNSCBinaryMode(T_void);
+
+#endif /* NSC_BINARY_H. */
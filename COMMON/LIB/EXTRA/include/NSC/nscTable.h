@@ -0,0 +1,271 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Node Serial Communication Dispatch Table								     */
+/**
+ *	@file		NSC/nscTable.h
+ *	@brief		This file contains NSC dispatch table types, registration macros
+ *				and API functions.
+ *	@details	Instead of hand-written switch statements in NSC API functions,
+ *				addresses are bound to handler functions and typed variables in
+ *				a constant table sorted by address, which is searched by binary
+ *				search (O(log n), 9 compares for 500 addresses). Data commands
+ *				on registered variables are served without user code: transmit
+ *				data (NSC_CMD_TXD) pops the stack into the variable and request
+ *				data (NSC_CMD_RXD) pushes the variable as response. On arrays,
+ *				transmit data copies the whole stack into the array (last pushed
+ *				value into last element) and request data pushes every element.
+ *	@code
+ *		NSC_TABLE_BEGIN
+ *			NSC_FUNCTION(0x0010UL, resetController),
+ *			NSC_VARIABLE(0x0100UL, setpoint, NSC_FLOAT, NSC_ACC_RW),
+ *			NSC_VARIABLE(0x0101UL, mode, NSC_UINT, NSC_ACC_RW),
+ *			NSC_VARIABLE(0x0200UL, status, NSC_UHEX, NSC_ACC_RD),
+ *			NSC_ARRAY(0x0300UL, curve, NSC_FLOAT, NSC_ACC_RW)
+ *		NSC_TABLE_END
+ *	@endcode
+ *	@note		Build NSC/nsc_api_table.c instead of NSC/nsc_api.c.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef NSC_TABLE_H
+#define NSC_TABLE_H
+
+#include <NSC/nsc.h>
+
+/* ----------------------------------------------------------------------------
+**	NSC Table Flags.
+*/
+
+/**
+ * 	@def		NSC_ERR_NONE
+ *	@brief 		No error.
+ */
+#define NSC_ERR_NONE			(0x00UL)
+
+/**
+ * 	@def		NSC_ERR_STACK_EMPTY
+ *	@brief 		No data on stack to store.
+ */
+#define NSC_ERR_STACK_EMPTY		(0x01UL)
+
+/**
+ * 	@def		NSC_ERR_ADDRESS
+ *	@brief 		Address not registered.
+ */
+#define NSC_ERR_ADDRESS			(0x02UL)
+
+/**
+ * 	@def		NSC_ERR_ACCESS
+ *	@brief 		Command not allowed on registered address.
+ */
+#define NSC_ERR_ACCESS			(0x03UL)
+
+/* ----------------------------------------------------------------------------
+**	NSC Table Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for NSC table entry access rights.
+ */
+typedef enum {
+	NSC_ACC_EXE = 0x01U,		/**< executable (NSC_CMD_EXE) */
+	NSC_ACC_RD  = 0x02U,		/**< readable (NSC_CMD_RXD) */
+	NSC_ACC_WR  = 0x04U,		/**< writable (NSC_CMD_TXD) */
+	NSC_ACC_RW  = 0x06U			/**< readable and writable */
+} T_nscAccess;
+
+/**
+ *	@brief 		Callback type for NSC table handler functions.
+ *	@param		address		Address of command.
+ *	@return		error code.
+ */
+typedef T_nscErrCode (*T_nscHandler)(T_nscAddress address);
+
+/**
+ *	@brief		Data structure for NSC table entry.
+ */
+typedef struct {
+	T_nscAddress address;
+	T_nscRepType type;
+	T_uint8 size;
+	T_uint8 access;
+	T_uint16 count;
+	T_void* pVar;
+	T_nscHandler handler;
+} T_nscEntry;
+
+/* ----------------------------------------------------------------------------
+**	NSC Table Macro Functions.
+*/
+
+/**
+ *	@def 		NSC_FUNCTION
+ *	@brief		Entry binding an address to an executable handler.
+ *	@param		ADDR		Address.
+ *	@param		HANDLER		Handler function (T_nscHandler).
+ *	@return		table entry.
+ */
+#define NSC_FUNCTION(ADDR, HANDLER) \
+	{ (ADDR), NSC_SINT, 0U, NSC_ACC_EXE, 0U, NULL, (HANDLER) }
+
+/**
+ *	@def 		NSC_VARIABLE
+ *	@brief		Entry binding an address to a variable (8, 16 or 32 bits).
+ *	@param		ADDR		Address.
+ *	@param		VAR			Variable (NSC_FLOAT for T_float32 only).
+ *	@param		TYPE		Data type parameter format (T_nscRepType).
+ *	@param		ACCESS		Access rights (T_nscAccess).
+ *	@return		table entry.
+ */
+#define NSC_VARIABLE(ADDR, VAR, TYPE, ACCESS) \
+	{ (ADDR), (TYPE), (T_uint8)SzBytes_(VAR), (ACCESS), 1U, (T_void*)&(VAR), NULL }
+
+/**
+ *	@def 		NSC_ARRAY
+ *	@brief		Entry binding an address to an array (8, 16 or 32-bit elements).
+ *	@param		ADDR		Address.
+ *	@param		ARRAY		Array (NSC_FLOAT for T_float32 only).
+ *	@param		TYPE		Data type parameter format of elements (T_nscRepType).
+ *	@param		ACCESS		Access rights (T_nscAccess).
+ *	@return		table entry.
+ */
+#define NSC_ARRAY(ADDR, ARRAY, TYPE, ACCESS) \
+	{ (ADDR), (TYPE), (T_uint8)SzBytes_((ARRAY)[0U]), (ACCESS), \
+		(T_uint16)SzIndices_(ARRAY), (T_void*)(ARRAY), NULL }
+
+/**
+ *	@def 		NSC_WATCHED_VARIABLE
+ *	@brief		Entry binding an address to a variable with a handler called
+ *				right after every store.
+ *	@param		ADDR		Address.
+ *	@param		VAR			Variable.
+ *	@param		TYPE		Data type parameter format (T_nscRepType).
+ *	@param		ACCESS		Access rights (T_nscAccess).
+ *	@param		HANDLER		Handler function (T_nscHandler).
+ *	@return		table entry.
+ */
+#define NSC_WATCHED_VARIABLE(ADDR, VAR, TYPE, ACCESS, HANDLER) \
+	{ (ADDR), (TYPE), (T_uint8)SzBytes_(VAR), (ACCESS), 1U, (T_void*)&(VAR), (HANDLER) }
+
+/**
+ *	@def 		NSC_TABLE_BEGIN
+ *	@brief		Starts the dispatch table definition (entries sorted by address).
+ *	@param		.
+ *	@return		.
+ */
+#define NSC_TABLE_BEGIN \
+	const T_nscEntry nscTable[] = {
+
+/**
+ *	@def 		NSC_TABLE_END
+ *	@brief		Ends the dispatch table definition.
+ *	@param		.
+ *	@return		.
+ */
+#define NSC_TABLE_END \
+	}; \
+	const T_uint16 nscTableSize = (T_uint16)SzIndices_(nscTable);
+
+/* ----------------------------------------------------------------------------
+**	NSC Table External Constants.
+*/
+
+/**
+ *	@var		nscTable
+ *	@brief		Dispatch table (defined by the application).
+ */
+extern const T_nscEntry nscTable[];
+
+/**
+ *	@var		nscTableSize
+ *	@brief		Dispatch table entry count.
+ */
+extern const T_uint16 nscTableSize;
+
+/* ----------------------------------------------------------------------------
+**	NSC Table API Functions.
+*/
+
+/**
+ *	@fn			T_bit checkNSCTable(T_void)
+ *	@brief 		Checks if dispatch table is sorted by strictly increasing
+ *				address (required by binary search).
+ *	@param		.
+ *	@return		boolean.
+ *	@note		Call once at start-up (i.e. within an assertion).
+ */
+extern T_bit checkNSCTable(T_void);
+
+/**
+ *	@fn			T_uint16 searchNSCTable(T_nscAddress)
+ *	@brief 		Searches dispatch table for the first entry whose address is not
+ *				less than an address (binary search).
+ *	@param[in]	address		Address to search.
+ *	@return		entry index (nscTableSize if every address is less).
+ */
+extern T_uint16 searchNSCTable(T_nscAddress address);
+
+/**
+ *	@fn			const T_nscEntry* findNSCEntry(T_nscAddress)
+ *	@brief 		Searches dispatch table for an address.
+ *	@param[in]	address		Address to search.
+ *	@return		table entry (NULL if not registered).
+ */
+extern const T_nscEntry* findNSCEntry(T_nscAddress address);
+
+/**
+ *	@fn			T_void readNSCEntry(const T_nscEntry*, T_nscParamData*)
+ *	@brief 		Reads a registered variable into parameter data (signed decimal
+ *				is sign-extended, other types are zero-extended).
+ *	@param[in]	entry		Table entry of a variable.
+ *	@param[out]	parameter	Parameter data.
+ *	@return		.
+ */
+extern T_void readNSCEntry(const T_nscEntry* entry, T_nscParamData* parameter);
+
+/**
+ *	@fn			T_void readNSCElement(const T_nscEntry*, T_uint16, T_nscParamData*)
+ *	@brief 		Reads an element of a registered variable or array into
+ *				parameter data (32-bit elements are read as 4 bytes, elements
+ *				of other sizes read 0).
+ *	@param[in]	entry		Table entry of a variable or array.
+ *	@param[in]	index		Element index (less than entry count).
+ *	@param[out]	parameter	Parameter data.
+ *	@return		.
+ */
+extern T_void readNSCElement(const T_nscEntry* entry, T_uint16 index, T_nscParamData* parameter);
+
+/**
+ *	@fn			T_void writeNSCElement(const T_nscEntry*, T_uint16, T_nscParamData)
+ *	@brief 		Writes parameter data into an element of a registered variable
+ *				or array (truncated to element size, 32-bit elements written as
+ *				4 bytes, elements of other sizes left unchanged).
+ *	@param[in]	entry		Table entry of a variable or array.
+ *	@param[in]	index		Element index (less than entry count).
+ *	@param[in]	parameter	Parameter data.
+ *	@return		.
+ */
+extern T_void writeNSCElement(const T_nscEntry* entry, T_uint16 index, T_nscParamData parameter);
+
+#endif /* NSC_TABLE_H. */
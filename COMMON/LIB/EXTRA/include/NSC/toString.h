@@ -3,8 +3,9 @@
 /**
  *	@file		toString.h
  *	@brief		This file contains API functions of base 10 integer,
- *				base 16 integer and	single precision floating point for
- *				conversion to null-terminated character string.
+ *				base 16 integer, single precision floating point and Q15 or
+ *				Q16.16 fixed point for conversion to null-terminated character
+ *				string.
 **/
 /*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  *	This file is part of LibMB90385 (Software Library for MB90385 Series).
@@ -87,4 +88,105 @@ extern size_t int32ToStr(T_char* buffer, T_sint32 number, T_bit sign);
  */
 extern size_t flt32ToStr(T_char* buffer, T_float32 number);
 
+/**
+ *	@fn 		size_t fastInt32ToStr(T_char*, T_sint32, T_bit)
+ *	@brief 		Converts a base 10 number into a null terminated character
+ *  			string with signed / unsigned option (same as int32ToStr).
+ *	@details	Only two 32-bit divisions are performed to split the number
+ *				into groups of four digits. Each group is split into digit
+ *				pairs through 16-bit reciprocal multiplication and every pair
+ *				is copied from a two-digit lookup table.
+ *	@param[in]	buffer	Pointer to the destination character array.
+ *	@param[in]	number	The number to convert (dword).
+ *	@param[in]	sign	Signed or unsigned option (bit).
+ *	@return		number of printed characters (word).
+ */
+extern size_t fastInt32ToStr(T_char* buffer, T_sint32 number, T_bit sign);
+
+/**
+ *	@fn 		size_t fastDec32ToStr(T_char*, T_uint32, T_uint8)
+ *	@brief 		Converts an unsigned base 10 number into a null terminated
+ *  			character string with a minimum digit count (zero padded).
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The number to convert (dword).
+ *	@param[in]	minDigits	Minimum digit count (up to 12).
+ *	@return		number of printed characters (word).
+ */
+extern size_t fastDec32ToStr(T_char* buffer, T_uint32 number, T_uint8 minDigits);
+
+/**
+ *	@fn 		size_t fastHex32ToStr(T_char*, const T_char*,
+ *					const T_char*, T_uint32)
+ *	@brief 		Converts a base 16 number into a null terminated character
+ *  			string with prefix and/or postfix hexadecimal symbol.
+ *	@details	Upper case digits are taken from a lookup table per nibble
+ *				starting from the most significant non-zero nibble.
+ *	@param[in]	buffer	Pointer to the destination character array.
+ *	@param[in]	prefix	Appended hexadecimal symbol before number.
+ *	@param[in]	postfix	Appended hexadecimal symbol after number.
+ *	@param[in]	number	The number to convert (dword).
+ *	@return		number of printed characters (word).
+ */
+extern size_t fastHex32ToStr(T_char* buffer, const T_char* prefix,
+	const T_char* postfix, T_uint32 number);
+
+/**
+ *	@fn 		size_t fixFlt32ToStr(T_char*, T_float32, T_uint8)
+ *	@brief 		Converts a single precision floating-point number into a null
+ *  			terminated character string with fixed number of decimals.
+ *	@details	The number is split from its IEEE 754 bits into integer and
+ *				scaled fractional parts (rounded to nearest) with integer math
+ *				only, and both parts are converted as integers. Numbers beyond
+ *				32-bit integer range are converted through flt32ToStr instead.
+ *				Halves are rounded away from zero.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The floating number to convert (float).
+ *	@param[in]	decimals	Digits after decimal point (up to 6).
+ *	@return		number of printed characters (word).
+ *	@note		This function also checks whether the number is NaN, +Inf
+ *  			or -Inf and has corresponding string for each.
+ */
+extern size_t fixFlt32ToStr(T_char* buffer, T_float32 number, T_uint8 decimals);
+
+/**
+ *	@fn 		size_t fixedToStr(T_char*, T_bit, T_uint32, T_uint32, T_uint8)
+ *	@brief 		Converts a number split into sign, integer part and scaled
+ *  			fractional part into a null terminated character string with
+ *  			fixed number of decimals.
+ *	@details	A fraction of 10^decimals (rounded up) carries into the
+ *				integer part. The sign is omitted if both parts are zero.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	negative	Number sign (bit).
+ *	@param[in]	whole		Integer part (dword).
+ *	@param[in]	fraction	Fractional part times 10^decimals (dword).
+ *	@param[in]	decimals	Digits after decimal point (up to 6).
+ *	@return		number of printed characters (word).
+ */
+extern size_t fixedToStr(T_char* buffer, T_bit negative, T_uint32 whole,
+	T_uint32 fraction, T_uint8 decimals);
+
+/**
+ *	@fn 		size_t q15ToStr(T_char*, T_sint16, T_uint8)
+ *	@brief 		Converts a Q15 fixed-point number (-1.0 to 1.0) into a null
+ *  			terminated character string with fixed number of decimals.
+ *	@details	Halves are rounded away from zero.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The Q15 number to convert (word).
+ *	@param[in]	decimals	Digits after decimal point (up to 5).
+ *	@return		number of printed characters (word).
+ */
+extern size_t q15ToStr(T_char* buffer, T_sint16 number, T_uint8 decimals);
+
+/**
+ *	@fn 		size_t q16ToStr(T_char*, T_sint32, T_uint8)
+ *	@brief 		Converts a Q16.16 fixed-point number into a null terminated
+ *  			character string with fixed number of decimals.
+ *	@details	Halves are rounded away from zero.
+ *	@param[in]	buffer		Pointer to the destination character array.
+ *	@param[in]	number		The Q16.16 number to convert (dword).
+ *	@param[in]	decimals	Digits after decimal point (up to 5).
+ *	@return		number of printed characters (word).
+ */
+extern size_t q16ToStr(T_char* buffer, T_sint32 number, T_uint8 decimals);
+
 #endif /* TOSTRING_H. */
@@ -0,0 +1,246 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Serial Print Formatter												     */
+/**
+ *	@file		SPF/spf.h
+ *	@brief		This file contains SPF flags and macro functions of formatted
+ *				serial printing lowered at compile time into conversion steps
+ *				over a single stack buffer sent by a single transmission.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef SPF_H
+#define SPF_H
+
+#include <COM/ser.h>
+#include <NSC/toString.h>
+
+/* ----------------------------------------------------------------------------
+**	SPF Flags.
+*/
+
+/**
+ * 	@def		SPF_WIDTH_INT
+ *	@brief 		Maximum characters of a converted 32-bit decimal integer.
+ */
+#define SPF_WIDTH_INT			(11U)
+
+/**
+ * 	@def		SPF_WIDTH_HEX
+ *	@brief 		Maximum characters of a converted 32-bit hexadecimal with its
+ *				prefix ("0x").
+ */
+#define SPF_WIDTH_HEX			(10U)
+
+/**
+ * 	@def		SPF_WIDTH_FLT
+ *	@brief 		Maximum characters of a converted single precision float.
+ */
+#define SPF_WIDTH_FLT			(20U)
+
+/**
+ * 	@def		SPF_WRITE
+ *	@brief 		Transmitting function of the formatted buffer.
+ * 	@param[in]	BUFF	Pointer to formatted characters.
+ * 	@param[in]	LEN		Formatted character count.
+ *	@note		Define as writeSTXBytes (STX/stx.h) before including this file
+ *				to send through the serial transmit engine.
+ */
+#ifndef SPF_WRITE
+#define SPF_WRITE(BUFF, LEN)	writeSERBytes((BUFF), (T_uint8)(LEN))
+#endif
+
+/* ----------------------------------------------------------------------------
+**	SPF Macro Functions.
+*/
+
+/**
+ *	@def		SPF_BEGIN
+ *	@brief		Opens a formatted print block with its own stack buffer.
+ *	@param[in]	SIZE	Buffer size in characters (constant, up to 255 when
+ *						sent through writeSERBytes).
+ *	@return		.
+ *	@note		A formatted print is a block of conversion steps in output
+ *				order, which replaces the format string so that nothing is
+ *				parsed at runtime. For example:
+ *				SPF_BEGIN(32U)
+ *					SPF_STR("t=") SPF_UINT(ticks)
+ *					SPF_STR(" u=") SPF_FLT(output) SPF_LN()
+ *				SPF_END()
+ *	@note		A step which does not fit in the remaining buffer space is
+ *				skipped. Reserve SPF_WIDTH_xxx characters for each conversion.
+ *	@note		Each converter is a module of its own (NSC/xxxtostr.c), so
+ *				only the converters of used steps are linked: integer steps
+ *				pull no float code.
+ */
+#define SPF_BEGIN(SIZE) { \
+	T_char spfBuffer[(SIZE) + 1U]; \
+	const size_t spfSize = (SIZE); \
+	size_t spfLength = 0U; \
+	size_t spfIndex = 0U;
+
+/**
+ *	@def		SPF_STR
+ *	@brief		Appends a string literal (length resolved at compile time).
+ *	@param[in]	STR		String literal (anything else fails to compile).
+ *	@return		.
+ */
+#define SPF_STR(STR) { \
+	if (LEQ(spfLength + (SzBytes_("" STR) - 1U), spfSize)) { \
+		for (spfIndex = 0U; LT(spfIndex, SzBytes_("" STR) - 1U); spfIndex++) { \
+			spfBuffer[spfLength++] = ("" STR)[spfIndex]; \
+		} \
+	} \
+}
+
+/**
+ *	@def		SPF_CHAR
+ *	@brief		Appends a single character.
+ *	@param[in]	CH		Character.
+ *	@return		.
+ */
+#define SPF_CHAR(CH) { \
+	if (LT(spfLength, spfSize)) { \
+		spfBuffer[spfLength++] = (T_char)(CH); \
+	} \
+}
+
+/**
+ *	@def		SPF_INT
+ *	@brief		Appends a signed decimal integer.
+ *	@param[in]	VAL		Integer value (up to 32 bits).
+ *	@return		.
+ */
+#define SPF_INT(VAL) { \
+	if (LEQ(spfLength + SPF_WIDTH_INT, spfSize)) { \
+		spfLength += fastInt32ToStr(&spfBuffer[spfLength], (T_sint32)(VAL), TRUE); \
+	} \
+}
+
+/**
+ *	@def		SPF_UINT
+ *	@brief		Appends an unsigned decimal integer.
+ *	@param[in]	VAL		Integer value (up to 32 bits).
+ *	@return		.
+ */
+#define SPF_UINT(VAL) { \
+	if (LEQ(spfLength + SPF_WIDTH_INT, spfSize)) { \
+		spfLength += fastInt32ToStr(&spfBuffer[spfLength], (T_sint32)(VAL), FALSE); \
+	} \
+}
+
+/**
+ *	@def		SPF_HEX
+ *	@brief		Appends an unsigned hexadecimal integer with "0x" prefix.
+ *	@param[in]	VAL		Integer value (up to 32 bits).
+ *	@return		.
+ */
+#define SPF_HEX(VAL) { \
+	if (LEQ(spfLength + SPF_WIDTH_HEX, spfSize)) { \
+		spfLength += fastHex32ToStr(&spfBuffer[spfLength], "0x", "", (T_uint32)(VAL)); \
+	} \
+}
+
+/**
+ *	@def		SPF_FLT
+ *	@brief		Appends a single precision floating-point number.
+ *	@param[in]	VAL		Floating-point value (converted to T_float32, never
+ *						promoted to double).
+ *	@return		.
+ *	@note		Float conversion code is only linked if this step is used.
+ */
+#define SPF_FLT(VAL) { \
+	if (LEQ(spfLength + SPF_WIDTH_FLT, spfSize)) { \
+		spfLength += flt32ToStr(&spfBuffer[spfLength], (T_float32)(VAL)); \
+	} \
+}
+
+/**
+ *	@def		SPF_FIX
+ *	@brief		Appends a single precision floating-point number with fixed
+ *				number of decimals.
+ *	@param[in]	VAL		Floating-point value (converted to T_float32).
+ *	@param[in]	DEC		Digits after decimal point (up to 6).
+ *	@return		.
+ */
+#define SPF_FIX(VAL, DEC) { \
+	if (LEQ(spfLength + SPF_WIDTH_FLT, spfSize)) { \
+		spfLength += fixFlt32ToStr(&spfBuffer[spfLength], (T_float32)(VAL), (DEC)); \
+	} \
+}
+
+/**
+ *	@def		SPF_Q15
+ *	@brief		Appends a Q15 fixed-point number with fixed number of decimals.
+ *	@param[in]	VAL		Q15 value (word).
+ *	@param[in]	DEC		Digits after decimal point (up to 5).
+ *	@return		.
+ */
+#define SPF_Q15(VAL, DEC) { \
+	if (LEQ(spfLength + SPF_WIDTH_INT, spfSize)) { \
+		spfLength += q15ToStr(&spfBuffer[spfLength], (T_sint16)(VAL), (DEC)); \
+	} \
+}
+
+/**
+ *	@def		SPF_Q16
+ *	@brief		Appends a Q16.16 fixed-point number with fixed number of
+ *				decimals.
+ *	@param[in]	VAL		Q16.16 value (dword).
+ *	@param[in]	DEC		Digits after decimal point (up to 5).
+ *	@return		.
+ */
+#define SPF_Q16(VAL, DEC) { \
+	if (LEQ(spfLength + SPF_WIDTH_INT + 1U, spfSize)) { \
+		spfLength += q16ToStr(&spfBuffer[spfLength], (T_sint32)(VAL), (DEC)); \
+	} \
+}
+
+/**
+ *	@def		SPF_LN
+ *	@brief		Appends line feed and carriage return characters (similar
+ *				to printLn).
+ *	@param		.
+ *	@return		.
+ */
+#define SPF_LN() { \
+	if (LEQ(spfLength + 2U, spfSize)) { \
+		spfBuffer[spfLength++] = (T_char)ASCII_LF; \
+		spfBuffer[spfLength++] = (T_char)ASCII_CR; \
+	} \
+}
+
+/**
+ *	@def		SPF_END
+ *	@brief		Closes a formatted print block and sends the whole buffer
+ *				through a single transmission.
+ *	@param		.
+ *	@return		.
+ */
+#define SPF_END() \
+	(T_void)spfIndex; \
+	(T_void)SPF_WRITE((const T_uint8*)spfBuffer, spfLength); \
+}
+
+#endif /* SPF_H. */
@@ -0,0 +1,185 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Serial Transmit Engine												     */
+/**
+ *	@file		STX/stx.h
+ *	@brief		This file contains STX flags, types, getters, and API functions
+ *				for non-blocking interrupt-driven serial transmission.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef STX_H
+#define STX_H
+
+#include <IO/ser_io.h>
+#include <MCU/isr.h>
+
+/* ----------------------------------------------------------------------------
+**	STX Flags.
+*/
+
+/**
+ * 	@def		STX_BUFFER_SIZE
+ *	@brief 		Transmit ring buffer size in bytes (power of 2, up to 32768).
+ */
+#ifndef STX_BUFFER_SIZE
+#define STX_BUFFER_SIZE			(128U)
+#endif
+
+/**
+ * 	@def		STX_SEGMENT_COUNT
+ *	@brief 		Transmit segment queue size (power of 2, up to 128).
+ *	@note		Each scatter-gather buffer takes a segment while consecutive
+ *				ring buffer writes share a single segment.
+ */
+#ifndef STX_SEGMENT_COUNT
+#define STX_SEGMENT_COUNT		(8U)
+#endif
+
+/**
+ * 	@def		STX_LOW_WATERMARK
+ *	@brief 		Pending byte count at (or below) which producers may resume.
+ */
+#ifndef STX_LOW_WATERMARK
+#define STX_LOW_WATERMARK		(STX_BUFFER_SIZE / 4U)
+#endif
+
+/**
+ * 	@def		STX_HIGH_WATERMARK
+ *	@brief 		Pending byte count at (or above) which producers should throttle.
+ */
+#ifndef STX_HIGH_WATERMARK
+#define STX_HIGH_WATERMARK		((STX_BUFFER_SIZE / 4U) * 3U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	STX Types.
+*/
+
+/**
+ *	@brief 		Callback type for STX watermark functions.
+ *	@param		pending		Bytes still waiting for transmission.
+ */
+typedef T_void (*T_stxWatermarkCB)(T_uint16 pending);
+
+/**
+ *	@brief		Data structure for STX transmit segment (scatter-gather entry).
+ */
+typedef struct {
+	const T_uint8* pBuff;
+	T_uint16 len;
+} T_stxSegment;
+
+/* ----------------------------------------------------------------------------
+**	STX Getters.
+*/
+
+/**
+ *	@def 		IsSTXIdle
+ *	@brief		Checks if all queued bytes were already transmitted.
+ *	@param		.
+ *	@return		boolean.
+ */
+#define IsSTXIdle() \
+	EQU(countSTXPending(), 0U)
+
+/* ----------------------------------------------------------------------------
+**	STX API Functions.
+*/
+
+/**
+ * 	@fn 		T_void initSTX(T_stxWatermarkCB, T_stxWatermarkCB)
+ *	@brief 		Initialize serial transmit engine.
+ * 	@pre		SER must be initialized and set to application usage
+ * 				(setSERUsage with SER_APP) first.
+ * 	@param[in]	lowWatermark	Called once pending bytes drop to low watermark
+ * 								after high watermark was reached (or NULL).
+ * 	@param[in]	highWatermark	Called once pending bytes reach high watermark
+ * 								(or NULL).
+ * 	@return		.
+ *	@note		The low watermark callback is called from the STX ISR while the
+ *				high watermark callback is called from the writing function,
+ *				before the transmit interrupt is enabled again (keep it short).
+ */
+extern T_void initSTX(T_stxWatermarkCB lowWatermark, T_stxWatermarkCB highWatermark);
+
+/**
+ * 	@fn 		T_uint16 writeSTXBytes(const T_uint8*, T_uint16)
+ *	@brief 		Copies bytes to transmit ring buffer without waiting for free
+ *				space and starts transmission.
+ * 	@param[in]	pBuff	Pointer to array to retrieve data.
+ * 	@param[in]	len		Desired bytes to write or size of array.
+ * 	@return		number of bytes queued (less than len if buffer gets full).
+ */
+extern T_uint16 writeSTXBytes(const T_uint8* pBuff, T_uint16 len);
+
+/**
+ * 	@fn 		T_uint8 writeSTXSegments(const T_stxSegment*, T_uint8)
+ *	@brief 		Queues several buffers for transmission in a single call without
+ *				copying their contents and starts transmission.
+ * 	@param[in]	segments	Segments (buffer and length) in transmission order.
+ * 	@param[in]	count		Segment count.
+ * 	@return		number of segments queued (less than count if queue gets full).
+ *	@warning	The segment buffers are transmitted in place and must neither
+ *				be released nor modified until the STX is idle (IsSTXIdle).
+ */
+extern T_uint8 writeSTXSegments(const T_stxSegment* segments, T_uint8 count);
+
+/**
+ * 	@fn 		T_uint16 countSTXPending(T_void)
+ *	@brief 		Counts bytes (copied or in place) waiting for transmission.
+ * 	@param		.
+ * 	@return		pending bytes.
+ */
+extern T_uint16 countSTXPending(T_void);
+
+/**
+ * 	@fn 		T_uint16 countSTXFree(T_void)
+ *	@brief 		Counts free bytes of transmit ring buffer.
+ * 	@param		.
+ * 	@return		free bytes.
+ */
+extern T_uint16 countSTXFree(T_void);
+
+/**
+ * 	@fn 		T_void STX_IRQHandler(T_void)
+ *	@brief		Writes a single pending byte to data register per transmit
+ *				interrupt, then disables transmit interrupt once nothing is
+ *				left to transmit.
+ *  @param		.
+ *  @return		.
+ *  @note 		Replaces SERTX_IRQHandler on its interrupt vector (reception
+ *  			remains handled by SERRX_IRQHandler). Thus, SER transmitting
+ *  			functions (writeSERBytes and print functions) must not be used
+ *  			together with STX.
+ *  @warning	Leave NOSAVEREG_STX_ISR disabled if watermark callbacks are set.
+ */
+#if USE_STX_ISR
+#if NOSAVEREG_STX_ISR
+NOSAVEREG
+#endif
+extern ISR(STX_IRQHandler);
+#endif
+
+#endif /* STX_H. */
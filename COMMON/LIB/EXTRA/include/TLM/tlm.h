@@ -0,0 +1,301 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* Binary Telemetry														     */
+/**
+ *	@file		TLM/tlm.h
+ *	@brief		This file contains TLM flags, types, getters, and API functions
+ *				for COBS-framed binary telemetry with CRC-16 over serial.
+ *	@details	A frame before encoding is made of channel ID (1 byte), sequence
+ *				number (1 byte, per channel), payload (little-endian values)
+ *				and CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, 2 bytes,
+ *				little-endian) computed over channel ID up to the payload. The
+ *				frame is then COBS (Consistent Overhead Byte Stuffing) encoded
+ *				and terminated by a zero byte so that the receiver can
+ *				resynchronize on any zero byte. A float takes 4 bytes on the
+ *				line instead of about 10 characters in ASCII. <br>
+ *				Framing costs 6 bytes per frame, so several samples should be
+ *				batched per frame (batchTLMFloats). Against the ASCII line of
+ *				the PID demo carrying the same values with two decimals: <br>
+ *				2 floats (43 characters): 14 bytes per sample alone (3.1x),
+ *				9.5 bytes with 4 samples per frame (4.5x). <br>
+ *				3 floats (52 characters): 18 bytes per sample alone (2.9x),
+ *				12.75 bytes with 8 samples per frame (4.1x, default
+ *				TLM_MAX_PAYLOAD). <br>
+ *				HOST/TLM/tlm_decode.c turns the stream into CSV, and measures
+ *				these figures through this implementation (-b).
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef TLM_H
+#define TLM_H
+
+#include <COM/ser.h>
+
+/* ----------------------------------------------------------------------------
+**	TLM Flags.
+*/
+
+/**
+ * 	@def		TLM_MAX_PAYLOAD
+ *	@brief 		Maximum payload size in bytes (up to 249, so that an encoded
+ *				frame fits the byte sized length of encodeTLMCOBS and
+ *				writeSERBytes). The default batches 8 samples of 3 floats
+ *				per frame, 4 times fewer bytes than the ASCII line.
+ */
+#ifndef TLM_MAX_PAYLOAD
+#define TLM_MAX_PAYLOAD			(96U)
+#endif
+
+#if (TLM_MAX_PAYLOAD > 249U)
+#error "TLM_MAX_PAYLOAD exceeds 249 bytes (encoded frame over 255 bytes)"
+#endif
+
+/**
+ * 	@def		TLM_MAX_CHANNELS
+ *	@brief 		Number of channels with their own sequence number.
+ */
+#ifndef TLM_MAX_CHANNELS
+#define TLM_MAX_CHANNELS		(8U)
+#endif
+
+/**
+ * 	@def		TLM_HEADER_SIZE
+ *	@brief 		Channel ID and sequence number size in bytes.
+ */
+#define TLM_HEADER_SIZE			(2U)
+
+/**
+ * 	@def		TLM_CRC_SIZE
+ *	@brief 		CRC-16 size in bytes.
+ */
+#define TLM_CRC_SIZE			(2U)
+
+/**
+ * 	@def		TLM_FRAME_SIZE
+ *	@brief 		Maximum encoded frame size in bytes (COBS overhead and zero
+ *				delimiter included).
+ */
+#define TLM_FRAME_SIZE			(TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + TLM_CRC_SIZE + 2U)
+
+/**
+ * 	@def		TLM_STX
+ *	@brief 		Transmission through the serial transmit engine (STX/stx.h)
+ *				instead of writeSERBytes.
+ *	@note		writeSERBytes must not be called again within 1 ms (COM/ser.h),
+ *				whereas writeSTXBytes queues frames sent back to back. Modules
+ *				answering with several frames in a row (NSC batch and binary
+ *				block responses) need TLM_STX and refuse to build without it.
+ *				sendTLMFrame then waits for ring buffer space for the whole
+ *				frame, so it must not be called with interrupts disabled.
+ */
+#ifndef TLM_STX
+#define TLM_STX					(0U)
+#endif
+
+#if TLM_STX
+#include <STX/stx.h>
+
+#if (STX_BUFFER_SIZE < TLM_FRAME_SIZE)
+#error "STX_BUFFER_SIZE below TLM_FRAME_SIZE (frame never fits the ring)"
+#endif
+#endif
+
+/**
+ * 	@def		TLM_WRITE
+ *	@brief 		Transmitting function of the encoded frame.
+ * 	@param[in]	BUFF	Pointer to encoded frame.
+ * 	@param[in]	LEN		Encoded frame size.
+ *	@note		writeSTXBytes with TLM_STX, writeSERBytes otherwise. Define
+ *				before including this file for another transmitting function.
+ */
+#ifndef TLM_WRITE
+#if TLM_STX
+#define TLM_WRITE(BUFF, LEN)	writeSTXBytes((BUFF), (T_uint16)(LEN))
+#else
+#define TLM_WRITE(BUFF, LEN)	writeSERBytes((BUFF), (T_uint8)(LEN))
+#endif
+#endif
+
+/* ----------------------------------------------------------------------------
+**	TLM Types.
+*/
+
+/**
+ *	@brief		Data structure for TLM frame under construction.
+ */
+typedef struct {
+	T_uint8 data[TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + TLM_CRC_SIZE];
+	T_uint8 length;
+	T_bit overflow;
+} T_tlmFrame;
+
+/* ----------------------------------------------------------------------------
+**	TLM Getters.
+*/
+
+/**
+ *	@def 		GetByteTLMPayloadSize
+ *	@brief		Gets payload size of a frame under construction.
+ *	@param		FRAME	TLM frame.
+ *	@return		payload size (byte).
+ */
+#define GetByteTLMPayloadSize(FRAME) \
+	((T_uint8)((FRAME).length - TLM_HEADER_SIZE))
+
+/**
+ *	@def 		IsTLMFrameOverflow
+ *	@brief		Checks if a value did not fit in frame payload.
+ *	@param		FRAME	TLM frame.
+ *	@return		boolean.
+ */
+#define IsTLMFrameOverflow(FRAME) \
+	IS((FRAME).overflow)
+
+/* ----------------------------------------------------------------------------
+**	TLM API Functions.
+*/
+
+/**
+ *	@fn			T_void initTLM(T_void)
+ *	@brief 		Initialize telemetry (resets channel sequence numbers).
+ *	@pre		SER must be initialized and set to application usage.
+ *	@param		.
+ *	@return		.
+ */
+extern T_void initTLM(T_void);
+
+/**
+ *	@fn			T_void beginTLMFrame(T_tlmFrame*, T_uint8)
+ *	@brief 		Starts a frame on a channel.
+ *	@param[out]	frame		TLM frame.
+ *	@param[in]	channel		Channel ID.
+ *	@return		.
+ */
+extern T_void beginTLMFrame(T_tlmFrame* frame, T_uint8 channel);
+
+/**
+ *	@fn			T_void putTLMByte(T_tlmFrame*, T_uint8)
+ *	@brief 		Appends a byte to frame payload.
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+extern T_void putTLMByte(T_tlmFrame* frame, T_uint8 value);
+
+/**
+ *	@fn			T_void putTLMWord(T_tlmFrame*, T_uint16)
+ *	@brief 		Appends a word to frame payload (little-endian).
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+extern T_void putTLMWord(T_tlmFrame* frame, T_uint16 value);
+
+/**
+ *	@fn			T_void putTLMDWord(T_tlmFrame*, T_uint32)
+ *	@brief 		Appends a double word to frame payload (little-endian).
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+extern T_void putTLMDWord(T_tlmFrame* frame, T_uint32 value);
+
+/**
+ *	@fn			T_void putTLMFloat(T_tlmFrame*, T_float32)
+ *	@brief 		Appends a single precision float to frame payload (IEEE 754,
+ *				little-endian).
+ *	@param		frame	TLM frame.
+ *	@param[in]	value	Payload value.
+ *	@return		.
+ */
+extern T_void putTLMFloat(T_tlmFrame* frame, T_float32 value);
+
+/**
+ *	@fn			T_uint8 sendTLMFrame(T_tlmFrame*)
+ *	@brief 		Appends CRC-16, encodes and transmits a frame, then advances the
+ *				channel sequence number.
+ *	@param		frame	TLM frame.
+ *	@return		number of bytes transmitted (zero if frame overflowed).
+ */
+extern T_uint8 sendTLMFrame(T_tlmFrame* frame);
+
+/**
+ *	@fn			T_uint8 sendTLMFloats(T_uint8, const T_float32*, T_uint8)
+ *	@brief 		Builds and transmits a frame of floats (i.e. setpoint, process
+ *				value and controller output).
+ *	@param[in]	channel		Channel ID.
+ *	@param[in]	values		Values to transmit.
+ *	@param[in]	count		Value count.
+ *	@return		number of bytes transmitted (zero if values do not fit).
+ */
+extern T_uint8 sendTLMFloats(T_uint8 channel, const T_float32* values, T_uint8 count);
+
+/**
+ *	@fn			T_uint8 batchTLMFloats(T_tlmFrame*, const T_float32*, T_uint8,
+ *					T_uint8)
+ *	@brief 		Appends a sample of floats to a frame, and transmits the frame
+ *				once it holds the given number of samples (or earlier if the
+ *				next sample would not fit), starting the next frame on the same
+ *				channel.
+ *	@param		frame		TLM frame (started through beginTLMFrame).
+ *	@param[in]	values		Sample values.
+ *	@param[in]	count		Value count per sample (same for every sample).
+ *	@param[in]	samples		Samples per frame.
+ *	@return		number of bytes transmitted (zero while collecting samples).
+ *	@note		The payload is made of whole samples back to back, so the
+ *				receiver needs the value count per sample.
+ */
+extern T_uint8 batchTLMFloats(T_tlmFrame* frame, const T_float32* values,
+	T_uint8 count, T_uint8 samples);
+
+/**
+ *	@fn			T_uint16 computeTLMCRC(const T_uint8*, T_uint8)
+ *	@brief 		Computes CRC-16/CCITT-FALSE (4-bit table driven).
+ *	@param[in]	pBuff	Data to check.
+ *	@param[in]	len		Data size.
+ *	@return		CRC-16.
+ */
+extern T_uint16 computeTLMCRC(const T_uint8* pBuff, T_uint8 len);
+
+/**
+ *	@fn			T_uint8 encodeTLMCOBS(T_uint8*, const T_uint8*, T_uint8)
+ *	@brief 		Encodes data through COBS and appends the zero delimiter.
+ *	@param[out]	pDest	Encoded data (len + 2 bytes at most, up to 253 input).
+ *	@param[in]	pSrc	Data to encode.
+ *	@param[in]	len		Data size.
+ *	@return		encoded size (delimiter included).
+ */
+extern T_uint8 encodeTLMCOBS(T_uint8* pDest, const T_uint8* pSrc, T_uint8 len);
+
+/**
+ *	@fn			T_uint8 decodeTLMCOBS(T_uint8*, const T_uint8*, T_uint8)
+ *	@brief 		Decodes COBS data (received frame without zero delimiter).
+ *	@param[out]	pDest	Decoded data (len - 1 bytes at most, may be pSrc).
+ *	@param[in]	pSrc	Data to decode.
+ *	@param[in]	len		Data size.
+ *	@return		decoded size (zero if data is malformed).
+ */
+extern T_uint8 decodeTLMCOBS(T_uint8* pDest, const T_uint8* pSrc, T_uint8 len);
+
+#endif /* TLM_H. */
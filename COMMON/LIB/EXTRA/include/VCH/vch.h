@@ -0,0 +1,213 @@
+/*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+/* KernelUART Virtual Channels											     */
+/**
+ *	@file		VCH/vch.h
+ *	@brief		This file contains VCH flags, types, getters, and API functions
+ *				for sharing the KernelUART between the Accemic MDE monitor and
+ *				several application streams.
+ *	@details	The monitor kernel speaks its own protocol and owns the UART
+ *				whenever SER usage is SER_ACC, so its traffic cannot be framed.
+ *				The UART is therefore shared in rounds: the monitor is given a
+ *				time window (its share of each round) with SER usage set to
+ *				SER_ACC, then the application channels are given the rest of
+ *				the round with SER usage set to SER_APP. Application bytes are
+ *				sent as TLM frames whose channel ID is VCH_CHANNEL_BASE plus the
+ *				channel index, with a byte budget per round proportional to each
+ *				channel share (deficit round-robin). <br>
+ *				Each monitor window is announced by a TLM frame on
+ *				VCH_CONTROL_CHANNEL carrying the window length in milliseconds
+ *				(16-bit), and the UART is only handed to the monitor once that
+ *				frame has left the SER transmit buffer. Each application window
+ *				starts with a lone delimiter so that the host resynchronizes
+ *				after the monitor bytes. <br>
+ *				Limitation: the monitor traffic itself is not framed, so the
+ *				channels are time-sliced. Monitor host bytes received during an
+ *				application window are taken by the SER reception of the
+ *				application and never reach the monitor. The monitor host must
+ *				thus only send within announced windows, and its timeout must
+ *				exceed VCH_ROUND_MS. HOST/VCH/vch_demux.c does so: it holds
+ *				monitor host bytes until a window is announced, routes target
+ *				bytes of the window to the monitor pty and TLM frames of the
+ *				application channels to one pty each.
+**/
+/*++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *	This file is part of LibMB90385 (Software Library for MB90385 Series).
+ *
+ *	Copyright (C) 2015-2017 Xeno Xerxes Masong (xxmasong@gmail.com)
+ *
+ *	LibMB90385 does not guarantee that it shall fulfill its task under all
+ *	circumstances. Thus, the author/developer shall not be held liable for
+ *	any damages that might be incurred by the device using LibMB90385, or
+ *	for any reason whatsoever.
+ *
+ *	LibMB90385 is free software: you can redistribute it and/or modify it
+ *	under the terms of the GNU General Public License as published by the
+ *	Free Software Foundation, either version 3 of the License, or (at your
+ *	option) any later version.
+ *
+ *	LibMB90385 is distributed in the hope that it will be useful, but WITHOUT
+ *	ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *	FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ *	for more details.
+ *
+ *	You should have received a copy of the GNU General Public License along
+ *	with LibMB90385. If not, see <https://www.gnu.org/licenses/>.
+ *+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
+
+#ifndef VCH_H
+#define VCH_H
+
+#include <TLM/tlm.h>
+
+/* ----------------------------------------------------------------------------
+**	VCH Flags.
+*/
+
+/**
+ * 	@def		VCH_MAX_CHANNELS
+ *	@brief 		Number of application channels.
+ */
+#ifndef VCH_MAX_CHANNELS
+#define VCH_MAX_CHANNELS		(4U)
+#endif
+
+/**
+ * 	@def		VCH_QUEUE_SIZE
+ *	@brief 		Queue size in bytes per application channel (up to 255).
+ */
+#ifndef VCH_QUEUE_SIZE
+#define VCH_QUEUE_SIZE			(64U)
+#endif
+
+/**
+ * 	@def		VCH_CHANNEL_BASE
+ *	@brief 		TLM channel ID of the first application channel.
+ */
+#ifndef VCH_CHANNEL_BASE
+#define VCH_CHANNEL_BASE		(0x10U)
+#endif
+
+/**
+ * 	@def		VCH_CONTROL_CHANNEL
+ *	@brief 		TLM channel ID of monitor window announcements.
+ */
+#ifndef VCH_CONTROL_CHANNEL
+#define VCH_CONTROL_CHANNEL		(0x0FU)
+#endif
+
+/**
+ * 	@def		VCH_ROUND_MS
+ *	@brief 		Sharing round period in milliseconds.
+ */
+#ifndef VCH_ROUND_MS
+#define VCH_ROUND_MS			(100U)
+#endif
+
+/**
+ * 	@def		VCH_BYTES_PER_MS
+ *	@brief 		UART throughput in bytes per millisecond (3 at 38461 baud).
+ */
+#ifndef VCH_BYTES_PER_MS
+#define VCH_BYTES_PER_MS		(3U)
+#endif
+
+/**
+ * 	@def		VCH_DRAIN_MS
+ *	@brief 		Delay in milliseconds between an empty SER transmit buffer and
+ *				the hand over to the monitor (last character shifting out).
+ */
+#ifndef VCH_DRAIN_MS
+#define VCH_DRAIN_MS			(2U)
+#endif
+
+/* ----------------------------------------------------------------------------
+**	VCH Types.
+*/
+
+/**
+ * 	@brief		Defined enumerated type for VCH KernelUART owner.
+ */
+typedef enum {
+	VCH_MONITOR,				/**< monitor window (SER_ACC) */
+	VCH_APPLICATION,			/**< application window (SER_APP) */
+	VCH_DRAINING				/**< monitor window announced (SER_APP until
+									 the SER transmit buffer is empty) */
+} T_vchOwner;
+
+/**
+ *	@brief		Data structure for VCH application channel.
+ */
+typedef struct {
+	/* channel queue */
+	T_uint8 queue[VCH_QUEUE_SIZE];
+	T_uint8 head;
+	T_uint8 count;
+	/* bandwidth share */
+	T_uint8 share;
+	T_uint16 credit;
+	/* statistics */
+	T_uint16 dropped;
+} T_vchChannel;
+
+/* ----------------------------------------------------------------------------
+**	VCH API Functions.
+*/
+
+/**
+ *	@fn			T_void initVCH(T_uint8)
+ *	@brief 		Initialize virtual channels and hand KernelUART to the monitor.
+ *	@pre		SER, TBT and TLM must be initialized first.
+ *	@param[in]	monitorShare	Monitor share of each round (percent, 0 gives
+ *								the whole UART to application channels).
+ *	@return		.
+ *	@note		Application channel shares are zero (disabled) until set.
+ */
+extern T_void initVCH(T_uint8 monitorShare);
+
+/**
+ *	@fn			T_void setVCHShare(T_uint8, T_uint8)
+ *	@brief 		Sets bandwidth share (weight) of an application channel.
+ *	@param[in]	channel		Application channel index.
+ *	@param[in]	share		Relative weight among application channels (0
+ *							disables transmission of the channel).
+ *	@return		.
+ */
+extern T_void setVCHShare(T_uint8 channel, T_uint8 share);
+
+/**
+ *	@fn			T_uint8 writeVCHBytes(T_uint8, const T_uint8*, T_uint8)
+ *	@brief 		Queues bytes on an application channel without blocking.
+ *	@param[in]	channel		Application channel index.
+ *	@param[in]	pBuff		Pointer to array to retrieve data.
+ *	@param[in]	len			Desired bytes to write or size of array.
+ *	@return		number of bytes queued (the rest is counted as dropped).
+ */
+extern T_uint8 writeVCHBytes(T_uint8 channel, const T_uint8* pBuff, T_uint8 len);
+
+/**
+ *	@fn			T_void manageVCH(T_void)
+ *	@brief 		Switches KernelUART owner at window boundaries and transmits
+ *				queued application bytes within their round budget.
+ *	@param		.
+ *	@return		.
+ *	@note		Call periodically (i.e. from a scheduler task or main loop).
+ */
+extern T_void manageVCH(T_void);
+
+/**
+ *	@fn			T_vchOwner getVCHOwner(T_void)
+ *	@brief 		Gets current KernelUART owner.
+ *	@param		.
+ *	@return		KernelUART owner.
+ */
+extern T_vchOwner getVCHOwner(T_void);
+
+/**
+ *	@fn			T_uint16 countVCHDropped(T_uint8)
+ *	@brief 		Counts bytes dropped on an application channel (queue full).
+ *	@param[in]	channel		Application channel index.
+ *	@return		dropped bytes.
+ */
+extern T_uint16 countVCHDropped(T_uint8 channel);
+
+#endif /* VCH_H. */
@@ -566,6 +566,16 @@ typedef enum {
 	SetIOREGBitVar(IO_SSR1, RIE, SER_INT_DISABLED); \
 }
 
+/**
+ *	@def 		IsSERTransmitInterruptEnabled
+ *	@brief 		Transmit Interrupt Checker (the SER TX ISR disables it once
+ *				the transmit buffer is empty).
+ * 	@param		.
+ * 	@return		boolean.
+ */
+#define IsSERTransmitInterruptEnabled() \
+  EQU(GetIOREGBitVar(IO_SSR1, TIE), SER_INT_ENABLED)
+
 /**
  *	@def 		IsSERTransmitDataRegEmpty
  *	@brief 		Transmit Data Register Empty Checker.
@@ -62,6 +62,7 @@
 
 #define NOSAVEREG_ADC_ISR		ISR_DISABLE
 #define NOSAVEREG_CAN_ISR		ISR_DISABLE
+#define NOSAVEREG_CNX_ISR		ISR_DISABLE
 #define NOSAVEREG_DIG_ISR		ISR_DISABLE
 #define NOSAVEREG_EXI45_ISR		ISR_DISABLE
 #define NOSAVEREG_EXI67_ISR		ISR_DISABLE
@@ -70,11 +71,13 @@
 #define NOSAVEREG_ICU1_ISR		ISR_DISABLE
 #define NOSAVEREG_ICU23_ISR		ISR_DISABLE
 #define NOSAVEREG_IOT_ISR		ISR_DISABLE
+#define NOSAVEREG_MDB_ISR		ISR_DISABLE
 #define NOSAVEREG_PPG01_ISR		ISR_DISABLE
 #define NOSAVEREG_PPG23_ISR		ISR_DISABLE
 #define NOSAVEREG_RLT0_ISR		ISR_DISABLE
 #define NOSAVEREG_RLT1_ISR		ISR_DISABLE
 #define NOSAVEREG_SER_ISR		ISR_DISABLE
+#define NOSAVEREG_STX_ISR		ISR_DISABLE
 #define NOSAVEREG_TBT_ISR		ISR_DISABLE
 #define NOSAVEREG_WTT_ISR		ISR_DISABLE
 
@@ -88,6 +91,9 @@
 #ifdef USE_PREDEF_CAN_ISR
 #define USE_CAN_ISR				ISR_ENABLE
 #endif
+#ifdef USE_PREDEF_CNX_ISR
+#define USE_CNX_ISR				ISR_ENABLE
+#endif
 #ifdef USE_PREDEF_DIG_ISR
 #define USE_DIG_ISR				ISR_ENABLE
 #endif
@@ -121,6 +127,9 @@
 #ifdef USE_PREDEF_IOT_ISR
 #define USE_IOT_ISR				ISR_ENABLE
 #endif
+#ifdef USE_PREDEF_MDB_ISR
+#define USE_MDB_ISR				ISR_ENABLE
+#endif
 #ifdef USE_PREDEF_PPG0_ISR
 #define USE_PPG0_ISR			ISR_ENABLE
 #endif
@@ -148,6 +157,9 @@
 #ifdef USE_PREDEF_SER_ISR
 #define USE_SER_ISR				ISR_ENABLE
 #endif
+#ifdef USE_PREDEF_STX_ISR
+#define USE_STX_ISR				ISR_ENABLE
+#endif
 #ifdef USE_PREDEF_TBT_ISR
 #define USE_TBT_ISR				ISR_ENABLE
 #endif
@@ -66,6 +66,9 @@
 #if USE_CAN_ISR
 #include <COM/can.h>
 #endif
+#if USE_CNX_ISR
+#include <CNX/cnx.h>
+#endif
 #if USE_DIG_ISR
 #include <MCU/dig.h>
 #endif
@@ -78,6 +81,9 @@
 #if USE_IOT_ISR
 #include <TMR/iot.h>
 #endif
+#if USE_MDB_ISR
+#include <MDB/mdb.h>
+#endif
 #if ((USE_PPG01_ISR || (USE_PPG0_ISR || USE_PPG1_ISR)) || (USE_PPG23_ISR || (USE_PPG2_ISR || USE_PPG3_ISR)))
 #include <TMR/ppg.h>
 #endif
@@ -87,6 +93,9 @@
 #if USE_SER_ISR
 #include <COM/ser.h>
 #endif
+#if USE_STX_ISR
+#include <STX/stx.h>
+#endif
 #if USE_TBT_ISR
 #include <TMR/tbt.h>
 #endif
@@ -102,11 +111,16 @@
 
 #pragma intvect _start					0x08		0x0
 
-#if USE_CAN_ISR
+#if USE_CAN_ISR && !USE_CNX_ISR
 #pragma intvect CANRX_IRQHandler		0x0B
 #pragma intvect CANTX_IRQHandler		0x0C
 #endif
 
+#if USE_CNX_ISR
+#pragma intvect CNX_RX_IRQHandler		0x0B
+#pragma intvect CNX_TX_IRQHandler		0x0C
+#endif
+
 #if USE_EXIRX_ISR
 #pragma intvect EXIRX_IRQHandler		0x0F
 #endif
@@ -164,9 +178,21 @@
 #endif
 
 #if USE_SER_ISR
+#if !USE_MDB_ISR
 #pragma intvect SERRX_IRQHandler		0x25
+#endif
+#if !USE_STX_ISR
 #pragma intvect SERTX_IRQHandler		0x26
 #endif
+#endif
+
+#if USE_MDB_ISR
+#pragma intvect MDB_IRQHandler			0x25
+#endif
+
+#if USE_STX_ISR
+#pragma intvect STX_IRQHandler			0x26
+#endif
 
 #if USE_DIG_ISR
 #pragma intvect DIG_IRQHandler			0x2A